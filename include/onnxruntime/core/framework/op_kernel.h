@@ -129,6 +129,37 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function, together with UsePersistedPrePackedBuffers(), to allow the session to persist the
+  // pre-packed weights of the kernel in the on-disk cache (see kOrtSessionOptionsConfigPrePackedWeightsCacheDir).
+  // It is called after PrePack() has been called for all the constant inputs of the kernel.
+  // @param input_idx: The input index of a tensor for which PrePack() set is_packed to true
+  // @param buffers: The buffers holding the complete pre-packed state of the input, including anything that
+  //                 PrePack() folded into them from other inputs. They remain owned by the kernel.
+  //                 Leave it empty if the state of the input cannot be persisted.
+  virtual Status GetPrePackedBuffersToPersist(int /*input_idx*/,
+                                              /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const {
+    buffers.clear();
+    return Status::OK();
+  }
+
+  // Override this function to restore the pre-packed state of an input from the buffers returned by
+  // GetPrePackedBuffersToPersist() for the same node in an earlier session. PrePack() is not called for the input
+  // if the kernel uses the buffers, and PrePack() calls for the other inputs must not modify them.
+  // @param prepacked_buffers: The persisted buffers, in the order they were returned. As with
+  //                           UseSharedPrePackedBuffers() the deleter is NULL, and the buffers are read-only.
+  // @param buffer_sizes: The sizes in bytes of the persisted buffers
+  // @param tensor: The initialized constant tensor the buffers were computed from
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_persisted_buffers: Set it to true if the kernel restored its state from the buffers. The
+  //                                session falls back to calling PrePack() otherwise.
+  virtual Status UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                              gsl::span<const size_t> /*buffer_sizes*/,
+                                              const Tensor& /*tensor*/, int /*input_idx*/,
+                                              /*out*/ bool& used_persisted_buffers) {
+    used_persisted_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -39,6 +39,7 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <chrono>
 #include <memory>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
@@ -231,6 +232,8 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t){};
   void LogThreadId(int) {};
   void LogRun(int) {};
+  bool Enabled() const { return false; }
+  void LogWorkerTime(int, uint64_t, uint64_t, uint64_t) {};
   std::string DumpChildThreadStat() { return {}; }
 };
 #else
@@ -257,7 +260,10 @@ class ThreadPoolProfiler {
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
   void LogRun(int thread_idx);                      // called in child thread to log num of run
-  std::string DumpChildThreadStat();                // return all child statitics collected so far
+  bool Enabled() const { return enabled_; }
+  // called in child thread to log the time it spent spinning, parked and running tasks
+  void LogWorkerTime(int thread_idx, uint64_t spin_us, uint64_t park_us, uint64_t work_us);
+  std::string DumpChildThreadStat();  // return all child statitics collected so far
 
  private:
   static const char* GetEventName(ThreadPoolEvent);
@@ -284,6 +290,9 @@ class ThreadPoolProfiler {
   struct ORT_ALIGN_TO_AVOID_FALSE_SHARING ChildThreadStat {
     std::thread::id thread_id_;
     uint64_t num_run_ = 0;
+    uint64_t spin_us_ = 0;
+    uint64_t park_us_ = 0;
+    uint64_t work_us_ = 0;
     onnxruntime::TimePoint last_logged_point_ = Clock::now();
     int32_t core_ = -1;  // core that the child thread is running on
   };
@@ -773,6 +782,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -1483,15 +1493,44 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       status.store(ThreadStatus::Spinning, std::memory_order_relaxed);
     }
 
+    // Moving average of the time between the thread running out of work and receiving its next task.
+    // Only used by the thread itself, with adaptive spinning.
+    uint64_t expected_idle_us{kMaxAdaptiveSpinMicros / 2};
+
    private:
     std::atomic<ThreadStatus> status{ThreadStatus::Spinning};
     OrtMutex mutex;
     OrtCondVar cv;
   };
 
+  // Bounds of the time an idle worker spins before it parks with adaptive spinning.  The upper bound is
+  // well above the cost of a futex wake-up, so a worker only spins that long if work usually arrives
+  // within that time.
+  static constexpr uint64_t kMinAdaptiveSpinMicros = 20;
+  static constexpr uint64_t kMaxAdaptiveSpinMicros = 1000;
+
+  // Returns how long the worker should spin for work before parking.  Workers whose work usually arrives
+  // soon after they run out of it spin a little longer than the expected wait, so they pick up the next
+  // task without an OS wake-up.  Workers that usually wait longer than kMaxAdaptiveSpinMicros park almost
+  // immediately instead of burning the core.
+  static uint64_t AdaptiveSpinMicros(const WorkerData& td) {
+    if (td.expected_idle_us > kMaxAdaptiveSpinMicros) {
+      return kMinAdaptiveSpinMicros;
+    }
+    return std::min(std::max(2 * td.expected_idle_us, kMinAdaptiveSpinMicros), kMaxAdaptiveSpinMicros);
+  }
+
+  static uint64_t MicrosBetween(std::chrono::steady_clock::time_point start,
+                                std::chrono::steady_clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+  }
+
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
+  // Tune the spin duration of each worker from the observed wait times instead of spinning for spin_count
+  // iterations every time the worker runs out of work.
+  const bool adaptive_spinning_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
@@ -1542,6 +1581,11 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     while (!should_exit) {
       Task t = q.PopFront();
       if (!t) {
+        // The clock is only read when the adaptive policy or the profiler need it.
+        const bool timed = adaptive_spinning_ || profiler_.Enabled();
+        const auto idle_start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        const uint64_t spin_limit_us = adaptive_spinning_ ? AdaptiveSpinMicros(td) : 0;
+
         // Spin waiting for work.
         for (int i = 0; i < spin_count && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
@@ -1554,8 +1598,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
             break;
           }
+          if (adaptive_spinning_ && (i & 63) == 63 &&
+              MicrosBetween(idle_start, std::chrono::steady_clock::now()) >= spin_limit_us) {
+            break;
+          }
           onnxruntime::concurrency::SpinPause();
         }
+        const auto spin_end = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
 
         // Attempt to block
         if (!t) {
@@ -1621,11 +1670,27 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           if (!t) t = q.PopFront();
           if (!t) t = Steal(StealAttemptKind::TRY_ALL);
         }
+
+        if (timed) {
+          const auto idle_end = std::chrono::steady_clock::now();
+          if (adaptive_spinning_ && t) {
+            // moving average with a weight of 1/8 for the latest wait
+            const uint64_t idle_us = MicrosBetween(idle_start, idle_end);
+            td.expected_idle_us = td.expected_idle_us - td.expected_idle_us / 8 + idle_us / 8;
+          }
+          profiler_.LogWorkerTime(thread_id, MicrosBetween(idle_start, spin_end), MicrosBetween(spin_end, idle_end), 0);
+        }
       }
 
       if (t) {
         td.SetActive();
-        t();
+        if (profiler_.Enabled()) {
+          const auto work_start = std::chrono::steady_clock::now();
+          t();
+          profiler_.LogWorkerTime(thread_id, 0, 0, MicrosBetween(work_start, std::chrono::steady_clock::now()));
+        } else {
+          t();
+        }
         profiler_.LogRun(thread_id);
         td.SetSpinning();
       }
@@ -16,6 +16,7 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 #include <functional>
@@ -213,6 +214,30 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Marks the calling thread as busy running an inter-op task, such as a graph node, for the
+  // lifetime of the object.
+  //
+  // When a pool is created with ThreadOptions::unified_scheduling it is used for both the
+  // inter-op tasks of a session and the parallel loops of the kernels those tasks run.  Each
+  // parallel loop then only enlists the calling thread and the workers that are not inside an
+  // InterOpTaskScope, so independent nodes running concurrently share the threads of the pool
+  // instead of queueing loop shards behind each other.  The executors enter a scope in every
+  // inter-op task they schedule: the streams of the execution plan, their downstream tasks and the
+  // nodes run by the critical path scheduler.
+  //
+  // Has no effect if tp is nullptr, the pool does not use unified scheduling, the calling thread
+  // does not belong to the pool, or it is already inside a scope.
+
+  class InterOpTaskScope {
+   public:
+    explicit InterOpTaskScope(ThreadPool* tp);
+    ~InterOpTaskScope();
+
+   private:
+    ThreadPool* tp_{nullptr};
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InterOpTaskScope);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -384,6 +409,10 @@ class ThreadPool {
   // by fn() is safe from concurrent access once RunWithHelp returns.
   void RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size);
 
+  // Returns the number of threads a parallel loop started by the calling thread may use, including
+  // the calling thread.  Only differs from NumThreads() + 1 with unified scheduling.
+  unsigned AvailableParallelism() const;
+
   // Divides the work represented by the range [0, total) into k shards.
   // Calls fn(i*block_size, (i+1)*block_size) from the ith shard (0 <= i < k).
   // Each shard may be executed on a different thread in parallel, depending on
@@ -428,6 +457,9 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Number of threads of the pool inside an InterOpTaskScope.  Only maintained with unified scheduling.
+  std::atomic<int> num_busy_workers_{0};
 };
 
 }  // namespace concurrency
@@ -2805,6 +2805,10 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_local_cache_max_bytes": Maximum number of bytes of freed small chunks each thread may keep in a
+   *  thread local cache in front of the arena. Allocations served from the cache do not take the arena lock,
+   *  which reduces lock contention with concurrent Run() calls. The caches are drained back to the arena on overflow
+   *  and when the arena is shrunk. Use 0 or -1 to disable the caches (default).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -117,6 +117,14 @@ static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure whether the intra_op threads adapt how long they spin before blocking to how long they usually wait
+// for work. Threads that usually receive work within about a millisecond keep spinning a little longer than their
+// typical wait, threads that usually wait longer block almost immediately. Has no effect if spinning is disabled.
+// The time each thread spent spinning, blocked and running work is reported by the thread pool profiler.
+// "0": default, thread will spin a fixed number of times before blocking
+// "1": thread will spin for an adaptive duration before blocking
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -135,6 +143,30 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+// Memory-map an ORT format model loaded from a file instead of reading it into a buffer. The initializers used on
+// CPU refer to the mapped pages instead of being copied, so processes serving the same model share its memory
+// through the page cache. The mapping is kept until the session is destroyed and the file must not be modified
+// while it is mapped.
+// Initializer data is used in place only if it is aligned for its element type. ORT format models saved by this
+// version align the data of initializers of 128 bytes or more to 64 bytes. Smaller initializers are copied.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigUseMmapForOrtModel = "session.use_mmap_for_ort_model";
+
+// Number of threads asking the OS to read the external data files of the initializers of an ONNX model and its
+// subgraphs into the page cache while the graph is optimized, so that loading the initializers afterwards is served
+// from memory. The reads are requested with posix_fadvise(POSIX_FADV_WILLNEED), or F_RDADVISE on macOS, and are
+// done by the OS without copying the data. Several threads keep enough reads in flight to reach the bandwidth of
+// NVMe and network storage. Has no effect on platforms without such a hint, e.g. Windows.
+// The amount of data requested is logged. The time taken to save the external initializers is recorded in the
+// session profile as the "external_initializers_load" event, with or without prefetching. It reports the bytes read
+// in that time, those of initializers copied to a device, and their throughput. The data of initializers kept on CPU
+// is memory-mapped and read when the kernels use it, it is reported as mapped bytes without a throughput.
+// "0": disabled. [DEFAULT]
+// "<n>": use n threads.
+static const char* const kOrtSessionOptionsConfigExternalDataPrefetchThreads =
+    "session.external_data_prefetch_threads";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -278,11 +310,106 @@ static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_context
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// Gemm fastmath mode for all platforms: fp32 MatMul and Gemm use the bfloat16 GEMM of MLAS,
+// which is implemented with the BF16 extension on arm64 and with AVX512-BF16 or AMX-BF16 on x64. Inputs are rounded
+// to bfloat16 and accumulated in fp32. It is ignored when the CPU has no bfloat16 support.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathBfloat16 = "mlas.enable_gemm_fastmath_bfloat16";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
 static const char* const kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel = "session.qdq_matmulnbits_accuracy_level";
 
+// Run the attention of the CPU QAttention operator with int8 matrix products instead of in fp32.
+// Q, K and V are quantized per head after the input projection, Q x K' and softmax(Q x K') x V use the quantized
+// GEMM of MLAS, and the softmax probabilities are quantized with a fixed 1/255 scale. The results differ from the
+// fp32 attention by the quantization error. Falls back to fp32 attention when the past state input is given.
+// Option values:
+// - "0": fp32 attention. [DEFAULT]
+// - "1": int8 attention.
+static const char* const kOrtSessionOptionsQAttentionInt8Attention = "session.qattention_int8_attention";
+
+// Controls how input shapes are mapped to cached memory patterns when memory pattern optimization is enabled.
+// By default a memory pattern is planned and cached for every distinct set of input shapes. With bucketing, the
+// input dimensions are rounded up to a bucket and one planned arena layout is reused for all shapes in the bucket.
+// Option values:
+// - "" or "exact": no bucketing. [DEFAULT]
+// - "pow2": round dimensions up to the next power of two.
+// - ","-delimited list of strictly increasing positive values, e.g. "32,64,128,256,512": round dimensions up to the
+//   smallest listed value that is not less than them. Larger dimensions are not bucketed.
+// Not supported in training builds.
+static const char* const kOrtSessionOptionsConfigMemoryPatternBuckets = "session.memory_pattern_buckets";
+
+// Upper bound in bytes on the sum of the peak sizes of the cached memory patterns of a graph.
+// Least recently used patterns are evicted once the bound is exceeded, with or without bucketing.
+// The most recently used pattern is always kept.
+// "0" means unbounded. [DEFAULT]
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheMaxBytes = "session.memory_pattern_cache_max_bytes";
+
+// Warm up the memory pattern cache during session initialization so the first request of each size does not pay the
+// planning cost. Each ";"-delimited entry assigns values to the symbolic dimensions of the graph inputs and triggers
+// one Run() with zero filled inputs of the resolved shapes, e.g. "batch=1,seq=128;batch=1,seq=512".
+// When bucketing is enabled, use the upper bound of each bucket so the planned layout covers the whole bucket.
+// All graph inputs must be tensors whose shapes are fully resolved by the given values. Entries that resolve to an
+// input without elements, or with which the model fails to run, are skipped with a warning.
+// Default is "" (no warm up).
+static const char* const kOrtSessionOptionsConfigMemoryPatternPrewarmDims = "session.memory_pattern_prewarm_dims";
+
+// Plan the activation memory of the main graph ahead of time when the shapes of all graph inputs and all planned
+// activations are known when the session is created. The buffer lifetimes are taken from the execution plan and
+// packed into a single buffer per device with fixed offsets, so the first Run() uses the planned layout instead of
+// tracing allocations. Only applies when memory pattern optimization is enabled and the plan has a single stream.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigStaticMemoryPlan = "session.static_memory_plan";
+
+// Schedule the nodes of the graph dynamically when the session uses ExecutionMode::ORT_PARALLEL and all nodes are
+// assigned to the CPU. Ready nodes are run by the calling thread and the inter-op thread pool workers in the order of
+// their estimated distance to the end of the graph (critical path first). Idle workers steal ready nodes from busy
+// ones. Without this option a CPU only graph runs its nodes one after another even in parallel mode.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigCriticalPathScheduling = "session.critical_path_scheduling";
+
+// Use a single per session thread pool for both inter-op and intra-op parallelism when the session uses
+// ExecutionMode::ORT_PARALLEL. The intra-op thread pool also runs the inter-op tasks and the inter-op thread pool is
+// not created, so the session never uses more threads than intra_op_num_threads. The parallel loops of a node only
+// use the threads that are not busy running other nodes.
+// Ignored when the session uses global thread pools or an external intra-op thread pool.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigUnifiedThreadPool = "session.unified_thread_pool";
+
+// Run the session on one NUMA node of a multi-socket system. The intra-op threads are bound to the physical cores of
+// the node, one thread per core unless intra_op_num_threads is set, and the memory of the default CPU execution
+// provider (arena regions, initializers and prepacked weights) is placed on the node.
+// Ignored on systems with a single NUMA node, on platforms where the NUMA topology is not known and when the session
+// uses the global thread pools. Threads are not bound when session.intra_op_thread_affinities is set or the session
+// uses an external intra-op thread pool. The thread calling Run() and the inter-op threads are never bound.
+// Memory is only placed on the node when the CPU memory arena is enabled, the arena binds each region it allocates
+// once instead of every allocation.
+// "": disabled. [DEFAULT]
+// "<n>": run on NUMA node n.
+// "auto": use NUMA node (session id % number of NUMA nodes). The session id counts every session created by the
+// process, including destroyed ones, so the sessions alive at a time are not necessarily balanced over the nodes. The
+// intra-op thread pool of the session is bound to that node only, it is not partitioned over the nodes, and the
+// threads that are not bound may run on another node than the memory.
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
+
+// Directory of an on-disk cache of the weights prepacked by the CPU execution provider kernels.
+// The prepacked buffers of the kernels that support it are written to the directory the first time a model is
+// loaded and memory-mapped from it by later sessions on the same machine, so they skip prepacking and share the
+// buffers through the page cache. Entries are keyed by the node, the contents of its constant inputs, the CPU
+// features and the onnxruntime version, so a stale entry is never used. The weights are still read and hashed when
+// the session is created. The directory is created if needed and it is up to the user to remove unused entries.
+// Ignored for initializers shared through a PrepackedWeightsContainer.
+// "": disabled. [DEFAULT]
+// "<path>": cache directory.
+static const char* const kOrtSessionOptionsConfigPrePackedWeightsCacheDir = "session.prepacked_weights_cache_dir";
+
 // THIS OPTION IS NOT A REGULAR SESSION OPTION SINCE IT CAN BE MODIFIED AT ANY TIME
 // Meant to be used with SetEpDynamicOptions
 // Specify the type of workload for this session.
@@ -10,6 +10,9 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -34,6 +37,9 @@ class GQAAttentionBase {
     use_smooth_softmax_ = info.GetAttrOrDefault<int64_t>("smooth_softmax", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -46,6 +52,9 @@ class GQAAttentionBase {
 
   bool use_smooth_softmax_;
 
+  bool disable_flash_;
+  int l2_cache_size_;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
@@ -74,6 +83,15 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && !use_smooth_softmax_ && l2_cache_size_ > 0) {
+        ApplyFlashAttention(Q, K, V, past_key, past_value, output, present_key, present_value,
+                            seqlens_k->Data<int32_t>(), parameters, seqlen_past_kv_cache, seqlen_present_kv_cache,
+                            allocator, tp);
+        return Status::OK();
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
     auto attention_probs = allocator->Alloc(bytes);
@@ -103,6 +121,123 @@ class GQAAttentionBase {
   }
 
  private:
+  // Computes the attention with the tiled online softmax of MlasFlashAttention, so that the
+  // BxNxSxT attention probs are never materialized. K and V are appended to the present
+  // buffers first, then every query head group attends to its shared key and value head.
+  void ApplyFlashAttention(const float* Q,                             // Q data with shape BxNxSxH
+                           const float* K,                             // K data with shape BxN_kvxSxH
+                           const float* V,                             // V data with shape BxN_kvxSxH
+                           const Tensor* past_key,                     // past K input tensor
+                           const Tensor* past_value,                   // past V input tensor
+                           Tensor* output,                             // output tensor
+                           Tensor* present_key,                        // present K output tensor
+                           Tensor* present_value,                      // present V output tensor
+                           const int32_t* seqlens_k,                   // total - 1 sequence lengths
+                           const GroupQueryAttentionParameters& parameters,
+                           const int past_buffer_sequence_length,      // sequence length of past state
+                           const int present_buffer_sequence_length,   // sequence length of present state
+                           AllocatorPtr allocator,                     // allocator for temporary buffer
+                           ThreadPool* tp) const {
+    const bool is_prompt = parameters.is_first_prompt;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+
+    const float* past_key_data = past_key != nullptr ? past_key->Data<float>() : nullptr;
+    float* present_key_data = present_key->MutableData<float>();
+    const float* past_value_data = past_value != nullptr ? past_value->Data<float>() : nullptr;
+    float* present_value_data = present_value->MutableData<float>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = SafeInt<size_t>(sequence_length) * head_size;               // S x H
+    const size_t past_buff_chunk_length = SafeInt<size_t>(past_buffer_sequence_length) * head_size;  // L x H
+    const size_t present_buff_chunk_length =
+        SafeInt<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length * sizeof(float);
+      memset(present_key_data, 0, present_bytes);
+      memset(present_value_data, 0, present_bytes);
+    }
+
+    const float* k = packed_qkv ? Q + num_heads_ * kv_input_chunk_length : K;
+    const float* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * kv_input_chunk_length : V;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = 0;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+
+    ThreadPool::TryParallelFor(tp, batch_size * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t past_chunk_length = past_seqlen * head_size;
+
+        const ptrdiff_t input_offset = packed_qkv
+                                           ? packed_batch_stride * batch_index + kv_input_chunk_length * head_index
+                                           : kv_input_chunk_length * i;
+        ConcatStateChunkGQA(past_key_data, k + input_offset, present_key_data, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+        ConcatStateChunkGQA(past_value_data, v + input_offset, present_value_data, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+      }
+    });
+
+    std::vector<int> kv_sequence_lengths(batch_size);
+    for (int b = 0; b < batch_size; b++) {
+      kv_sequence_lengths[b] = seqlens_k[b] + 1;
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.kv_num_heads = kv_num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = present_buffer_sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    args.softcap = softcap_;
+    args.is_causal = true;
+    args.local_window_size = local_window_size_ > 0 ? local_window_size_ : -1;
+
+    // Block sizes are chosen as in MultiHeadAttention so that the working set stays in L2 cache.
+    // The rows of a query block may span all the query heads that share a KV head.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, 2 * head_size);
+    args.kv_block_size = std::min(args.kv_block_size, present_buffer_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, (num_heads_ / kv_num_heads_) * sequence_length);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                  sizeof(float);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query_batch_stride = packed_qkv ? static_cast<size_t>(packed_batch_stride)
+                                         : SafeInt<size_t>(num_heads_) * kv_input_chunk_length;
+    args.kv_sequence_lengths = kv_sequence_lengths.data();
+    args.query = Q;
+    args.key = present_key_data;
+    args.value = present_value_data;
+    args.output = output->MutableData<float>();
+
+    MlasFlashAttention(&args, tp);
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
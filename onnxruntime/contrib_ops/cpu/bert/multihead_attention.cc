@@ -158,11 +158,15 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     MlasFlashAttentionThreadedArgs args;
     args.batch_size = batch_size;
     args.num_heads = num_heads_;
+    args.kv_num_heads = num_heads_;
     args.q_sequence_length = q_sequence_length;
     args.kv_sequence_length = kv_sequence_length;
     args.qk_head_size = qk_head_size;
     args.v_head_size = v_head_size;
     args.scale = (scale_ == 0.0f) ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
+    args.softcap = 0.0f;
+    args.is_causal = false;
+    args.local_window_size = -1;
     /*
       q_block_size, kv_block_size correspond to Br, Bc in the FlashAttention paper.
       Let M = l2_cache_size / sizeof(float)
@@ -199,6 +203,8 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
 
     args.buffer = reinterpret_cast<float*>(buffer.get());
+    args.query_batch_stride = static_cast<size_t>(num_heads_) * q_sequence_length * qk_head_size;
+    args.kv_sequence_lengths = nullptr;
 
     args.query = Q.Get<Tensor>().Data<float>();
     args.key = K.Get<Tensor>().Data<float>();
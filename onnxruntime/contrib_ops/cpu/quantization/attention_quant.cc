@@ -10,6 +10,7 @@
 #include "core/common/safeint.h"
 #include "core/platform/threadpool.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using onnxruntime::concurrency::ThreadPool;
 
@@ -32,10 +33,15 @@ class QAttention : public OpKernel, public AttentionCPUBase {
                                    /*out*/ bool& used_shared_buffers) override;
 
  private:
+  Status ApplyQuantizedAttention(const T* Q, const T* K, const T* V, const Tensor* mask_index, Tensor* output,
+                                 int batch_size, int sequence_length, int head_size, int hidden_size,
+                                 OpKernelContext* context) const;
+
   IAllocatorUniquePtr<void> packed_weights_;
   size_t packed_weights_size_;
   TensorShape weight_shape_;
   bool weights_is_signed_;
+  bool use_int8_attention_;
 };
 
 // These ops are internal-only, so register outside of onnx
@@ -54,6 +60,8 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
 
 template <typename T>
 QAttention<T>::QAttention(const OpKernelInfo& info) : OpKernel(info), AttentionCPUBase(info, true) {
+  use_int8_attention_ =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsQAttentionInt8Attention, "0") == "1";
 }
 
 template <typename T>
@@ -287,6 +295,11 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
     MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
   }
 
+  if (use_int8_attention_ && past_tensor == nullptr) {
+    return ApplyQuantizedAttention(Q, K, V, mask_index, output, batch_size, sequence_length, head_size, hidden_size,
+                                   context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past_tensor, nullptr /* past_key */, nullptr /* past_value*/,
                         output, nullptr /* present_key */, nullptr /* present_value */,
@@ -294,5 +307,210 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
                         head_size, head_size, hidden_size, nullptr /* rel_pos_bias */, context);
 }
 
+// Computes softmax(scale x Q x K' + mask) x V with int8 matrix products. Per head, Q is quantized to uint8 with a
+// zero point, K and V are quantized symmetrically to int8 and the softmax probabilities are quantized to uint8 with
+// the fixed scale 1/255, so no range has to be searched for them. The int32 products are scaled back to float by the
+// output processors of MlasGemmBatch.
+// The U8S8 kernels of x64 CPUs without VNNI add pairs of products in int16, which saturates for these full range
+// operands. On those CPUs K and V are shifted to uint8 with the zero point 128 and the exact U8U8 kernels are used.
+template <typename T>
+Status QAttention<T>::ApplyQuantizedAttention(const T* Q, const T* K, const T* V, const Tensor* mask_index,
+                                              Tensor* output, int batch_size, int sequence_length, int head_size,
+                                              int hidden_size, OpKernelContext* context) const {
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  int past_sequence_length = 0;
+  Tensor* present = GetPresent(context, nullptr, batch_size, head_size, sequence_length, past_sequence_length);
+  if (present != nullptr) {
+    // K and V are adjacent in the QKV buffer, which matches the layout of present: (2, B, N, S, H)
+    memcpy(present->MutableData<T>(), K,
+           SafeInt<size_t>(2) * batch_size * sequence_length * hidden_size * sizeof(T));
+  }
+
+  const bool causal = (is_unidirectional_ && sequence_length > 1);
+  BufferUniquePtr mask_data_buffer;
+  T* mask_data = nullptr;
+  if (mask_index != nullptr || causal) {
+    size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * sequence_length * sizeof(T);
+    mask_data = static_cast<T*>(allocator->Alloc(mask_data_bytes));
+    mask_data_buffer = BufferUniquePtr(mask_data, BufferDeleter(allocator));
+    memset(mask_data, 0, mask_data_bytes);
+    PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                mask_data, causal, batch_size, sequence_length, past_sequence_length, mask_filter_value_);
+  }
+
+  const int loop_len = batch_size * num_heads_;
+  const size_t head_elements = SafeInt<size_t>(sequence_length) * head_size;          // S x H
+  const size_t probs_elements = SafeInt<size_t>(sequence_length) * sequence_length;   // S x S
+
+  // Quantized Q, K' and V followed by the quantized probabilities, for all heads.
+  const size_t quant_bytes = SafeInt<size_t>(loop_len) * (3 * head_elements + probs_elements);
+  const size_t probs_bytes = SafeInt<size_t>(loop_len) * probs_elements * sizeof(float);
+  void* scratch = allocator->Alloc(SafeInt<size_t>(quant_bytes) + probs_bytes);
+  BufferUniquePtr scratch_buffer(scratch, BufferDeleter(std::move(allocator)));
+
+  float* probs = static_cast<float*>(scratch);
+  uint8_t* q_quant = reinterpret_cast<uint8_t*>(probs + SafeInt<size_t>(loop_len) * probs_elements);
+  int8_t* k_quant = reinterpret_cast<int8_t*>(q_quant + SafeInt<size_t>(loop_len) * head_elements);
+  int8_t* v_quant = k_quant + SafeInt<size_t>(loop_len) * head_elements;
+  uint8_t* probs_quant = reinterpret_cast<uint8_t*>(v_quant + SafeInt<size_t>(loop_len) * head_elements);
+
+  const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+  constexpr float probs_scale = 1.0f / 255.0f;
+
+  std::vector<uint8_t> q_zero_points(loop_len);
+  std::vector<float> qk_scales(loop_len);
+  std::vector<float> pv_scales(loop_len);
+
+#ifdef MLAS_TARGET_AMD64_IX86
+  const bool b_is_signed = !MlasPlatformU8S8Overflow();
+#else
+  const bool b_is_signed = true;
+#endif
+
+  const auto symmetric_scale = [](const float* data, size_t count) {
+    float min;
+    float max;
+    MlasFindMinMaxElement(data, &min, &max, count);
+    const float max_abs = std::max(std::abs(min), std::abs(max));
+    return max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+  };
+
+  // STEP.1: quantize Q, K and V of each head. K is transposed so that Q x K' is a plain GEMM.
+  TensorOpCost quant_cost{static_cast<double>(3 * head_elements * sizeof(T)),
+                          static_cast<double>(3 * head_elements),
+                          static_cast<double>(12 * head_elements)};
+  ThreadPool::TryParallelFor(tp, loop_len, quant_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const T* q = Q + head_elements * i;
+      const T* k = K + head_elements * i;
+      const T* v = V + head_elements * i;
+
+      float q_scale;
+      GetQuantizationParameter(q, static_cast<int64_t>(head_elements), q_scale, q_zero_points[i], nullptr);
+      MlasQuantizeLinear(q, q_quant + head_elements * i, head_elements, q_scale, q_zero_points[i]);
+
+      const float k_scale = symmetric_scale(k, head_elements);
+      const float k_inverse_scale = 1.0f / k_scale;
+      int8_t* k_transposed = k_quant + head_elements * i;
+      for (int s = 0; s < sequence_length; s++) {
+        for (int h = 0; h < head_size; h++) {
+          const float value = std::nearbyint(k[s * head_size + h] * k_inverse_scale);
+          k_transposed[h * sequence_length + s] = static_cast<int8_t>(std::clamp(value, -127.0f, 127.0f));
+        }
+      }
+
+      const float v_scale = symmetric_scale(v, head_elements);
+      MlasQuantizeLinear(v, v_quant + head_elements * i, head_elements, v_scale, static_cast<int8_t>(0));
+
+      if (!b_is_signed) {
+        // flipping the sign bit adds 128 to an int8 value read as uint8
+        auto* k_unsigned = reinterpret_cast<uint8_t*>(k_transposed);
+        auto* v_unsigned = reinterpret_cast<uint8_t*>(v_quant + head_elements * i);
+        for (size_t j = 0; j < head_elements; j++) {
+          k_unsigned[j] ^= 0x80;
+          v_unsigned[j] ^= 0x80;
+        }
+      }
+
+      qk_scales[i] = alpha * q_scale * k_scale;
+      pv_scales[i] = probs_scale * v_scale;
+    }
+  });
+
+  const uint8_t zero_point_b = b_is_signed ? 0 : 128;
+
+  // STEP.2: probs(B, N, S, S) = scale x Q(B, N, S, H) x K'(B, N, H, S)
+  {
+    MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+    gemm_shape.M = sequence_length;
+    gemm_shape.N = sequence_length;
+    gemm_shape.K = head_size;
+    gemm_shape.BIsSigned = b_is_signed;
+
+    std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(loop_len);
+    std::vector<MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR> scale_procs;
+    scale_procs.reserve(loop_len);
+
+    for (int i = 0; i < loop_len; i++) {
+      float* probs_dest = probs + probs_elements * i;
+      scale_procs.emplace_back(probs_dest, sequence_length, &qk_scales[i], nullptr);
+
+      auto& gemm_params = gemm_data_vec[i];
+      gemm_params.A = q_quant + head_elements * i;
+      gemm_params.lda = head_size;
+      gemm_params.ZeroPointA = q_zero_points[i];
+      gemm_params.B = k_quant + head_elements * i;
+      gemm_params.ldb = sequence_length;
+      gemm_params.ZeroPointB = &zero_point_b;
+      gemm_params.C = reinterpret_cast<int32_t*>(probs_dest);
+      gemm_params.ldc = sequence_length;
+      gemm_params.OutputProcessor = &(scale_procs[i]);
+    }
+
+    MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+  }
+
+  // STEP.3: probs = Softmax(probs + mask), quantized with the fixed scale 1/255
+  TensorOpCost softmax_cost{static_cast<double>(probs_elements * sizeof(float)),
+                            static_cast<double>(probs_elements),
+                            static_cast<double>(8 * probs_elements)};
+  ThreadPool::TryParallelFor(tp, loop_len, softmax_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      float* head_probs = probs + probs_elements * i;
+      if (mask_data != nullptr) {
+        const T* head_mask = mask_data + probs_elements * (i / num_heads_);
+        for (size_t j = 0; j < probs_elements; j++) {
+          head_probs[j] += head_mask[j];
+        }
+      }
+      MlasComputeSoftmax(head_probs, head_probs, sequence_length, sequence_length, false, false, nullptr);
+      MlasQuantizeLinear(head_probs, probs_quant + probs_elements * i, probs_elements, probs_scale,
+                         static_cast<uint8_t>(0));
+    }
+  });
+
+  // STEP.4: output(B, S, N, H) = probs(B, N, S, S) x V(B, N, S, H), written in place of the transpose
+  {
+    MLAS_GEMM_QUANT_SHAPE_PARAMS gemm_shape;
+    gemm_shape.M = sequence_length;
+    gemm_shape.N = head_size;
+    gemm_shape.K = sequence_length;
+    gemm_shape.BIsSigned = b_is_signed;
+
+    std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(loop_len);
+    std::vector<MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR> scale_procs;
+    scale_procs.reserve(loop_len);
+
+    T* output_data = output->MutableData<T>();
+    for (int i = 0; i < loop_len; i++) {
+      const int batch_index = i / num_heads_;
+      const int head_index = i % num_heads_;
+      float* output_dest =
+          output_data + (SafeInt<ptrdiff_t>(batch_index) * sequence_length * num_heads_ + head_index) * head_size;
+      scale_procs.emplace_back(output_dest, hidden_size, &pv_scales[i], nullptr);
+
+      auto& gemm_params = gemm_data_vec[i];
+      gemm_params.A = probs_quant + probs_elements * i;
+      gemm_params.lda = sequence_length;
+      gemm_params.ZeroPointA = 0;
+      gemm_params.B = v_quant + head_elements * i;
+      gemm_params.ldb = head_size;
+      gemm_params.ZeroPointB = &zero_point_b;
+      gemm_params.C = reinterpret_cast<int32_t*>(output_dest);
+      gemm_params.ldc = hidden_size;
+      gemm_params.OutputProcessor = &(scale_procs[i]);
+    }
+
+    MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
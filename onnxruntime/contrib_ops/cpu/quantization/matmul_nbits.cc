@@ -4,7 +4,9 @@
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
 #include <cstdint>
+#include <optional>
 #include <type_traits>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/common/narrow.h"
@@ -50,6 +52,45 @@ int64_t GetAccuracyLevel(size_t nbits, size_t block_size, int64_t accuracy_level
 
   return effective_accuracy_level;
 }
+
+// Computes Y = SiLU(gate) * up, where each row of `gate_up` holds the gate values followed by the up values.
+template <typename T>
+void ComputeSiluMul(const T* gate_up, T* y, size_t rows, size_t n, concurrency::ThreadPool* thread_pool) {
+  const TensorOpCost cost{static_cast<double>(2 * n * sizeof(T)), static_cast<double>(n * sizeof(T)),
+                          static_cast<double>(n) * 8.0};
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(rows), cost,
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        std::vector<float> buffer;
+        if constexpr (std::is_same_v<T, MLFloat16>) {
+          buffer.resize(3 * n);
+        }
+
+        for (std::ptrdiff_t row = begin; row < end; ++row) {
+          const T* gate = gate_up + row * 2 * n;
+          const T* up = gate + n;
+          T* y_row = y + row * n;
+
+          if constexpr (std::is_same_v<T, MLFloat16>) {
+            float* gate_f = buffer.data();
+            float* up_f = gate_f + n;
+            float* y_f = up_f + n;
+            MlasConvertHalfToFloatBuffer(gate, gate_f, n);
+            MlasConvertHalfToFloatBuffer(up, up_f, n);
+            MlasComputeLogistic(gate_f, y_f, n);
+            for (size_t i = 0; i < n; ++i) {
+              y_f[i] *= gate_f[i] * up_f[i];
+            }
+            MlasConvertFloatToHalfBuffer(y_f, y_row, n);
+          } else {
+            MlasComputeLogistic(gate, y_row, n);
+            for (size_t i = 0; i < n; ++i) {
+              y_row[i] *= gate[i] * up[i];
+            }
+          }
+        }
+      });
+}
 }  // namespace
 
 bool GetType(const NodeArg& node_arg, int32_t& type) {
@@ -66,9 +107,9 @@ bool GetType(const NodeArg& node_arg, int32_t& type) {
 // T1 is the type of the input matrix A, scales and biases.
 // Use class level template to facilitate specialization for different types.
 template <typename T1>
-class MatMulNBits final : public OpKernel {
+class MatMulNBits : public OpKernel {
  public:
-  MatMulNBits(const OpKernelInfo& info)
+  MatMulNBits(const OpKernelInfo& info, bool fuse_silu_mul = false)
       : OpKernel(info),
         K_{narrow<size_t>(info.GetAttr<int64_t>("K"))},
         N_{narrow<size_t>(info.GetAttr<int64_t>("N"))},
@@ -77,7 +118,8 @@ class MatMulNBits final : public OpKernel {
         accuracy_level_{GetAccuracyLevel(nbits_, block_size_, info.GetAttr<int64_t>("accuracy_level"))},
         has_g_idx_{info.GetInputCount() > InputIndex::g_idx && info.node().InputDefs()[InputIndex::g_idx]->Exists()},
         has_bias_{info.GetInputCount() > InputIndex::bias && info.node().InputDefs()[InputIndex::bias]->Exists()},
-        compute_type_{static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_)} {
+        compute_type_{static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_)},
+        fuse_silu_mul_{fuse_silu_mul} {
     const auto& node = info.node();
     auto input_defs = node.InputDefs();
     const NodeArg* zero_point_arg =
@@ -89,8 +131,9 @@ class MatMulNBits final : public OpKernel {
       has_unquantized_zero_point_ = type != ONNX_NAMESPACE::TensorProto_DataType_UINT8;
     }
 
-    ORT_ENFORCE(nbits_ == 4,
-                "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(nbits_ >= 2 && nbits_ <= 4,
+                "Only 2b, 3b and 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(!fuse_silu_mul_ || N_ % 2 == 0, "N must be even when SiLU(gate) * up is fused, got ", N_);
     const Tensor* tensor_zero_point = nullptr;
     has_zp_input_ = info.TryGetConstantInput(InputIndex::zero_points, &tensor_zero_point);
   }
@@ -104,6 +147,14 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status GetPrePackedBuffersToPersist(int input_idx,
+                                      /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const override;
+
+  Status UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      gsl::span<const size_t> buffer_sizes,
+                                      const Tensor& tensor, int input_idx,
+                                      /*out*/ bool& used_persisted_buffers) override;
+
  private:
   const size_t K_;
   const size_t N_;
@@ -113,10 +164,15 @@ class MatMulNBits final : public OpKernel {
   const bool has_g_idx_;
   const bool has_bias_;
   const MLAS_SQNBIT_GEMM_COMPUTE_TYPE compute_type_;
+  // the first and second halves of the N output features are the gate and up projections of a gated MLP,
+  // and the op output is SiLU(gate) * up
+  const bool fuse_silu_mul_;
   bool has_unquantized_zero_point_{false};
   const bool column_wise_quant_{true};
   IAllocatorUniquePtr<void> packed_b_{};
   size_t packed_b_size_{0};
+  // packed_b_ was restored from the on-disk cache and already holds the packed scales and zero points
+  bool packed_b_is_persisted_{false};
   IAllocatorUniquePtr<float> scales_fp32_{};
   IAllocatorUniquePtr<float> bias_fp32_{};
 
@@ -170,7 +226,7 @@ Status MatMulNBits<T1>::PrePack(const Tensor& tensor, int input_idx, /*out*/ All
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type_, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
-  } else if (compute_type_ == CompInt8) {
+  } else if (compute_type_ == CompInt8 && nbits_ == 4 && !packed_b_is_persisted_) {
 #ifdef MLAS_TARGET_AMD64_IX86
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
       auto sptr = tensor.Data<float>();
@@ -224,7 +280,7 @@ Status MatMulNBits<MLFloat16>::PrePack(const Tensor& tensor, int input_idx, /*ou
     MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type_, qptr, packed_b_.get(),
                                  nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
-  } else if (compute_type_ == CompInt8) {
+  } else if (compute_type_ == CompInt8 && nbits_ == 4 && !packed_b_is_persisted_) {
 #ifdef MLAS_TARGET_AMD64_IX86
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
       MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type_, nullptr, packed_b_.get(),
@@ -255,6 +311,41 @@ Status MatMulNBits<T1>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>&
   return Status::OK();
 }
 
+template <typename T1>
+Status MatMulNBits<T1>::GetPrePackedBuffersToPersist(int input_idx,
+                                                     /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const {
+  buffers.clear();
+
+  if (input_idx == InputIndex::B && packed_b_ != nullptr) {
+    buffers.emplace_back(static_cast<const uint8_t*>(packed_b_.get()), packed_b_size_);
+  }
+
+  return Status::OK();
+}
+
+template <typename T1>
+Status MatMulNBits<T1>::UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                     gsl::span<const size_t> buffer_sizes,
+                                                     const Tensor& /*tensor*/, int input_idx,
+                                                     /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (input_idx != InputIndex::B || prepacked_buffers.size() != 1 || has_g_idx_ || has_unquantized_zero_point_ ||
+      !MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type_)) {
+    return Status::OK();
+  }
+
+  const size_t packed_b_size = MlasSQNBitGemmPackQuantBDataSize(N_, K_, nbits_, block_size_, compute_type_);
+  if (packed_b_size != 0 && buffer_sizes[0] == packed_b_size) {
+    used_persisted_buffers = true;
+    packed_b_is_persisted_ = true;
+    packed_b_size_ = packed_b_size;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 template <>
 Status MatMulNBits<float>::ComputeBPacked(const Tensor* a,
                                           const Tensor* scales,
@@ -411,8 +502,21 @@ Status MatMulNBits<float>::ComputeBUnpacked(const Tensor* a,
   // TODO(fajin): move B dequant to prepack
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_, true);
 
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
-    // dequantize b, only 4b quantization is supported for now
+  if (nbits_ != 4) {
+    ORT_ENFORCE(column_wise_quant_, "Row-wise quantization is not supported for now");
+    if (zero_points && zero_points->IsDataType<float>()) {
+      DequantizeBlockwiseNBits<float, float>(
+          tmp_b_data_ptr.get(), b_data, scales_data, static_cast<const float*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    } else {
+      DequantizeBlockwiseNBits<float, uint8_t>(
+          tmp_b_data_ptr.get(), b_data, scales_data, static_cast<const uint8_t*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    }
+  } else if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
+    // dequantize b, 4b quantization
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
         b_data,                                         // quantized input
@@ -529,8 +633,21 @@ Status MatMulNBits<MLFloat16>::ComputeBUnpacked(const Tensor* a,
   // TODO(fajin): move B dequant to prepack
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_, true);
 
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<MLFloat16>())) {
-    // dequantize b, only 4b quantization is supported for now
+  if (nbits_ != 4) {
+    ORT_ENFORCE(column_wise_quant_, "Row-wise quantization is not supported for now");
+    if (zero_points && zero_points->IsDataType<MLFloat16>()) {
+      DequantizeBlockwiseNBits<float, MLFloat16>(
+          tmp_b_data_ptr.get(), b_data, scales_ptr, static_cast<const MLFloat16*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    } else {
+      DequantizeBlockwiseNBits<float, uint8_t>(
+          tmp_b_data_ptr.get(), b_data, scales_ptr, static_cast<const uint8_t*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    }
+  } else if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<MLFloat16>())) {
+    // dequantize b, 4b quantization
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
         b_data,                                         // quantized input
@@ -636,7 +753,11 @@ Status MatMulNBits<T1>::Compute(OpKernelContext* ctx) const {
   MatMulComputeHelper helper;
   ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape, false, true));
 
-  Tensor* y = ctx->Output(0, helper.OutputShape());
+  TensorShape y_shape = helper.OutputShape();
+  if (fuse_silu_mul_) {
+    y_shape[y_shape.NumDimensions() - 1] /= 2;
+  }
+  Tensor* y = ctx->Output(0, y_shape);
 
   // Bail out early if the output is going to be empty
   if (y->Shape().Size() == 0) {
@@ -646,6 +767,14 @@ Status MatMulNBits<T1>::Compute(OpKernelContext* ctx) const {
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
 
+  // With the fused SiLU(gate) * up, the GEMM produces both halves into a scratch tensor first.
+  std::optional<Tensor> gate_up;
+  Tensor* gemm_y = y;
+  if (fuse_silu_mul_) {
+    gate_up.emplace(y->DataType(), helper.OutputShape(), allocator);
+    gemm_y = &*gate_up;
+  }
+
   // clang-format off
   const bool has_single_b_matrix = std::all_of(
       helper.RightOffsets().begin(),
@@ -653,21 +782,35 @@ Status MatMulNBits<T1>::Compute(OpKernelContext* ctx) const {
       [](size_t offset) { return offset == 0; });
   // clang-format on
 
-  if (has_single_b_matrix &&
-      packed_b_) {  // Assume that MlasSQNBitGemmBatch() always requires packed B.
-                    // If this changes, i.e., if MlasIsSQNBitGemmAvailable() can return true while
-                    // MlasSQNBitGemmPackQuantBDataSize() returns 0, we can consider calling MlasSQNBitGemmBatch()
-                    // with B directly too.
-    if (MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type_)) {
-      return ComputeBPacked(a, scales, zero_points, bias, y, allocator, thread_pool, helper);
-    }
+  // Assume that MlasSQNBitGemmBatch() always requires packed B.
+  // If this changes, i.e., if MlasIsSQNBitGemmAvailable() can return true while
+  // MlasSQNBitGemmPackQuantBDataSize() returns 0, we can consider calling MlasSQNBitGemmBatch()
+  // with B directly too.
+  if (has_single_b_matrix && packed_b_ &&
+      MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type_)) {
+    ORT_RETURN_IF_ERROR(ComputeBPacked(a, scales, zero_points, bias, gemm_y, allocator, thread_pool, helper));
+  } else {
+    // If B is prepacked, B would have been removed from the context
+    const Tensor* b = ctx->Input<Tensor>(InputIndex::B);
+    ORT_RETURN_IF_ERROR(ComputeBUnpacked(a, b, scales, zero_points, reorder_idx, bias, gemm_y, allocator, thread_pool,
+                                         helper));
+  }
+
+  if (fuse_silu_mul_) {
+    ComputeSiluMul(gate_up->Data<T1>(), y->MutableData<T1>(),
+                   static_cast<size_t>(y_shape.SizeToDimension(y_shape.NumDimensions() - 1)),
+                   N_ / 2, thread_pool);
   }
 
-  // If B is prepacked, B would have been removed from the context
-  const Tensor* b = ctx->Input<Tensor>(InputIndex::B);
-  return ComputeBUnpacked(a, b, scales, zero_points, reorder_idx, bias, y, allocator, thread_pool, helper);
+  return Status::OK();
 }
 
+template <typename T1>
+class MatMulNBitsSiluMul final : public MatMulNBits<T1> {
+ public:
+  MatMulNBitsSiluMul(const OpKernelInfo& info) : MatMulNBits<T1>(info, /*fuse_silu_mul*/ true) {}
+};
+
 #define REGISTER_MatMulNBits(T1)                                            \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                            \
       MatMulNBits,                                                          \
@@ -687,5 +830,24 @@ Status MatMulNBits<T1>::Compute(OpKernelContext* ctx) const {
 REGISTER_MatMulNBits(float);
 REGISTER_MatMulNBits(MLFloat16);
 
+#define REGISTER_MatMulNBitsSiluMul(T1)                                     \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                            \
+      MatMulNBitsSiluMul,                                                   \
+      kMSDomain,                                                            \
+      1,                                                                    \
+      T1,                                                                   \
+      kCpuExecutionProvider,                                                \
+      KernelDefBuilder()                                                    \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<T1>())          \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())     \
+          .TypeConstraint("T3", {DataTypeImpl::GetTensorType<uint8_t>(),    \
+                                 DataTypeImpl::GetTensorType<float>(),      \
+                                 DataTypeImpl::GetTensorType<MLFloat16>()}) \
+          .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),    \
+      MatMulNBitsSiluMul<T1>);
+
+REGISTER_MatMulNBitsSiluMul(float);
+REGISTER_MatMulNBitsSiluMul(MLFloat16);
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -117,5 +117,79 @@ template void DequantizeBlockwise<float, MLFloat16>(
     const MLFloat16* zero_points, const int32_t* reorder_idx, int32_t block_size,
     bool columnwise, int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
 
+namespace {
+
+// Reads the `bits`-wide value at index `idx` from a little-endian bitstream.
+inline uint32_t ReadBitstreamValue(const uint8_t* data, int64_t idx, int bits) {
+  const int64_t bit_offset = idx * bits;
+  const uint8_t* p = data + bit_offset / 8;
+  const int shift = static_cast<int>(bit_offset % 8);
+  uint32_t v = p[0];
+  if (shift + bits > 8) {
+    v |= static_cast<uint32_t>(p[1]) << 8;
+  }
+  return (v >> shift) & ((1u << bits) - 1);
+}
+
+}  // namespace
+
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,              // dequantized output
+    const uint8_t* quant_data,   // quantized input
+    const inputT* scales_data,   // quantization scales
+    const zeroT* zero_points,    // quantization zero points
+    const int32_t* reorder_idx,  // reorder_idx for groupwise quantization
+    int32_t bits,                // number of bits per quantized value
+    int32_t block_size,          // quantization block size
+    int32_t K,                   // number of rows in quantized input
+    int32_t N,                   // number of columns in quantized input
+    onnxruntime::concurrency::ThreadPool* pool) {
+  ORT_ENFORCE(bits >= 2 && bits <= 8, "bits must be in [2, 8], got ", bits);
+
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t col_data_bytes = (blocks_per_col * block_size * bits + 7) / 8;
+  const int64_t col_zp_bytes = (blocks_per_col * bits + 7) / 8;
+  const float default_zp = static_cast<float>(1 << (bits - 1));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      pool, static_cast<std::ptrdiff_t>(N),
+      [&](std::ptrdiff_t n) {
+        const uint8_t* col_data = quant_data + n * col_data_bytes;
+        const inputT* col_scales = scales_data + n * blocks_per_col;
+        inputT* col_output = output + n * static_cast<int64_t>(K);
+
+        for (int32_t k = 0; k < K; k++) {
+          const int32_t rid = reorder_idx ? reorder_idx[k] : k / block_size;
+          const float scale = static_cast<float>(col_scales[rid]);
+          float zp = default_zp;
+          if (zero_points) {
+            if constexpr (std::is_same_v<zeroT, uint8_t>) {
+              zp = static_cast<float>(ReadBitstreamValue(zero_points + n * col_zp_bytes, rid, bits));
+            } else {
+              zp = static_cast<float>(zero_points[n * blocks_per_col + rid]);
+            }
+          }
+          const float q = static_cast<float>(ReadBitstreamValue(col_data, k, bits));
+          col_output[k] = static_cast<inputT>((q - zp) * scale);
+        }
+      });
+}
+
+template void DequantizeBlockwiseNBits<float, uint8_t>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const uint8_t* zero_points, const int32_t* reorder_idx, int32_t bits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, float>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const float* zero_points, const int32_t* reorder_idx, int32_t bits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, MLFloat16>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const MLFloat16* zero_points, const int32_t* reorder_idx, int32_t bits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
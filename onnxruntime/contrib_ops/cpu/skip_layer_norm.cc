@@ -39,30 +39,26 @@ REGISTER_KERNEL_TYPED(MLFloat16)
 
 namespace {
 
-template <typename T, typename = std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>, void>>
+template <typename T, typename = std::enable_if_t<std::is_same_v<T, double>, void>>
 void ComputeJob(
     const T* input_data,
     const T* skip_data,
     const T* gamma_data,
     const T* beta_data,
     const T* bias_data,
-    IAllocatorUniquePtr<float>& skip_float_uptr,
-    IAllocatorUniquePtr<float>& gamma_float_uptr,
-    IAllocatorUniquePtr<float>& beta_float_uptr,
-    IAllocatorUniquePtr<float>& bias_float_uptr,
+    const float* gamma_float_ptr,
+    const float* beta_float_ptr,
+    const float* bias_float_ptr,
     ptrdiff_t task_idx,
     int hidden_size,
     int64_t skip_size,
     float epsilon,
     bool simplified,
     T* output_data,
-    T* skip_input_bias_add_output_data,
-    AllocatorPtr alloc) {
-  ORT_UNUSED_PARAMETER(skip_float_uptr);   // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(gamma_float_uptr);  // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(beta_float_uptr);   // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(bias_float_uptr);   // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(alloc);
+    T* skip_input_bias_add_output_data) {
+  ORT_UNUSED_PARAMETER(gamma_float_ptr);  // only used in float/MLFloat16 overloads
+  ORT_UNUSED_PARAMETER(beta_float_ptr);   // only used in float/MLFloat16 overloads
+  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in float/MLFloat16 overloads
 
   auto offset = task_idx * hidden_size;
   const T* p_input = input_data + offset;
@@ -107,99 +103,79 @@ void ComputeJob(
   }
 }
 
+// float and MLFloat16 rows are normalized by MLAS in a single fused call, which reads half precision
+// input and skip directly. gamma, beta and bias are single precision for both.
+template <typename T>
+void ComputeJobMlas(
+    const T* input_data,
+    const T* skip_data,
+    const float* gamma_float_ptr,
+    const float* beta_float_ptr,
+    const float* bias_float_ptr,
+    ptrdiff_t task_idx,
+    int hidden_size,
+    int64_t skip_size,
+    float epsilon,
+    bool simplified,
+    T* output_data,
+    T* skip_input_bias_add_output_data) {
+  auto offset = task_idx * hidden_size;
+  const T* p_input = input_data + offset;
+  const T* p_skip = skip_data + (offset % skip_size);
+  T* p_output = output_data + offset;
+  T* p_skip_input_bias_add_output = skip_input_bias_add_output_data == nullptr ? nullptr : skip_input_bias_add_output_data + offset;
+
+  MlasLayerNormalization(p_input, p_skip, bias_float_ptr, gamma_float_ptr, beta_float_ptr, p_output,
+                         p_skip_input_bias_add_output, static_cast<size_t>(hidden_size), epsilon, simplified,
+                         nullptr, nullptr);
+}
+
+void ComputeJob(
+    const float* input_data,
+    const float* skip_data,
+    const float* gamma_data,
+    const float* beta_data,
+    const float* bias_data,
+    const float* gamma_float_ptr,
+    const float* beta_float_ptr,
+    const float* bias_float_ptr,
+    ptrdiff_t task_idx,
+    int hidden_size,
+    int64_t skip_size,
+    float epsilon,
+    bool simplified,
+    float* output_data,
+    float* skip_input_bias_add_output_data) {
+  ORT_UNUSED_PARAMETER(gamma_float_ptr);  // only used in MLFloat16 overload
+  ORT_UNUSED_PARAMETER(beta_float_ptr);   // only used in MLFloat16 overload
+  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in MLFloat16 overload
+
+  ComputeJobMlas(input_data, skip_data, gamma_data, beta_data, bias_data, task_idx, hidden_size, skip_size, epsilon,
+                 simplified, output_data, skip_input_bias_add_output_data);
+}
+
 void ComputeJob(
     const MLFloat16* input_data,
     const MLFloat16* skip_data,
     const MLFloat16* gamma_data,
     const MLFloat16* beta_data,
     const MLFloat16* bias_data,
-    IAllocatorUniquePtr<float>& skip_float_uptr,
-    IAllocatorUniquePtr<float>& gamma_float_uptr,
-    IAllocatorUniquePtr<float>& beta_float_uptr,
-    IAllocatorUniquePtr<float>& bias_float_uptr,
+    const float* gamma_float_ptr,
+    const float* beta_float_ptr,
+    const float* bias_float_ptr,
     ptrdiff_t task_idx,
     int hidden_size,
     int64_t skip_size,
     float epsilon,
     bool simplified,
     MLFloat16* output_data,
-    MLFloat16* skip_input_bias_add_output_data,
-    AllocatorPtr alloc) {
-  auto offset = task_idx * hidden_size;
-  const MLFloat16* p_input = input_data + offset;
-  const MLFloat16* p_skip = skip_data + (offset % skip_size);
-  MLFloat16* p_output = output_data + offset;
-  MLFloat16* p_skip_input_bias_add_output = skip_input_bias_add_output_data == nullptr ? nullptr : skip_input_bias_add_output_data + offset;
-
-  float mean(0.0f);
-  float mean_square(0.0f);
-  const size_t num_elems = static_cast<size_t>(hidden_size);
-
-  IAllocatorUniquePtr<float> input_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  MlasConvertHalfToFloatBuffer(p_input, input_float_uptr.get(), num_elems);
-
-  if (!skip_float_uptr) {
-    skip_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-    MlasConvertHalfToFloatBuffer(p_skip, skip_float_uptr.get(), num_elems);
-  }
-
-  if (bias_data && !bias_float_uptr) {
-    bias_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-    MlasConvertHalfToFloatBuffer(bias_data, bias_float_uptr.get(), num_elems);
-  }
-
-  IAllocatorUniquePtr<float> output_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  float* output_float_ptr = output_float_uptr.get();
+    MLFloat16* skip_input_bias_add_output_data) {
+  ORT_UNUSED_PARAMETER(gamma_data);  // only used in float/double overloads
+  ORT_UNUSED_PARAMETER(beta_data);   // only used in float/double overloads
+  ORT_UNUSED_PARAMETER(bias_data);   // only used in float/double overloads
 
-  const float* input_float_ptr = input_float_uptr.get();
-  const float* skip_float_ptr = skip_float_uptr.get();
-  const float* bias_float_ptr = bias_float_uptr.get();
-  for (size_t h = 0; h < num_elems; h++) {
-    float val = input_float_ptr[h] + skip_float_ptr[h];
-
-    if (bias_float_uptr) {
-      val += bias_float_ptr[h];
-    }
-
-    output_float_ptr[h] = val;
-    mean += val;
-    mean_square += val * val;
-  }
-
-  if (nullptr != p_skip_input_bias_add_output) {
-    MlasConvertFloatToHalfBuffer(output_float_ptr, p_skip_input_bias_add_output, num_elems);
-  }
-
-  mean = mean / hidden_size;
-  if (simplified) {
-    mean_square = sqrt(mean_square / hidden_size + epsilon);
-  } else {
-    mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
-  }
-
-  if (!gamma_float_uptr) {
-    gamma_float_uptr = std::move(input_float_uptr);  // overwrite input with gamma values, since they have the same size
-    MlasConvertHalfToFloatBuffer(gamma_data, gamma_float_uptr.get(), num_elems);
-  }
-
-  if (beta_data && !beta_float_uptr) {
-    beta_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-    MlasConvertHalfToFloatBuffer(beta_data, beta_float_uptr.get(), num_elems);
-  }
-
-  const float* gamma_float_ptr = gamma_float_uptr.get();
-  const float* beta_float_ptr = beta_float_uptr.get();
-  for (size_t h = 0; h < num_elems; h++) {
-    if (simplified) {
-      output_float_ptr[h] = output_float_ptr[h] / mean_square * gamma_float_ptr[h];
-    } else if (nullptr == beta_float_uptr) {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * gamma_float_ptr[h];
-    } else {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * gamma_float_ptr[h] + beta_float_ptr[h];
-    }
-  }
-
-  MlasConvertFloatToHalfBuffer(output_float_ptr, p_output, num_elems);
+  ComputeJobMlas(input_data, skip_data, gamma_float_ptr, beta_float_ptr, bias_float_ptr, task_idx, hidden_size,
+                 skip_size, epsilon, simplified, output_data, skip_input_bias_add_output_data);
 }
 
 void ConvertMLFloat16ToFloatIfNeeded(const Tensor& tensor, AllocatorPtr alloc, IAllocatorUniquePtr<float>& dest, bool& is_packed) {
@@ -214,11 +190,36 @@ void ConvertMLFloat16ToFloatIfNeeded(const Tensor& tensor, AllocatorPtr alloc, I
   }
 }
 
+// Returns the single precision data of an optional MLFloat16 input, using the data converted by PrePack
+// when the input is a constant initializer and converting it into `buffer` otherwise.
+template <typename T>
+const float* GetFloatDataIfNeeded(const T* data, const IAllocatorUniquePtr<float>& prepacked, int hidden_size,
+                                  AllocatorPtr alloc, IAllocatorUniquePtr<float>& buffer) {
+  if constexpr (std::is_same_v<T, MLFloat16>) {
+    if (prepacked) {
+      return prepacked.get();
+    }
+    if (data == nullptr) {
+      return nullptr;
+    }
+    buffer = IAllocator::MakeUniquePtr<float>(alloc, static_cast<size_t>(hidden_size));
+    MlasConvertHalfToFloatBuffer(data, buffer.get(), static_cast<size_t>(hidden_size));
+    return buffer.get();
+  } else {
+    ORT_UNUSED_PARAMETER(data);
+    ORT_UNUSED_PARAMETER(prepacked);
+    ORT_UNUSED_PARAMETER(hidden_size);
+    ORT_UNUSED_PARAMETER(alloc);
+    ORT_UNUSED_PARAMETER(buffer);
+    return nullptr;
+  }
+}
+
 }  // namespace
 
 template <typename T, bool simplified>
 SkipLayerNorm<T, simplified>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
-    : OpKernel(op_kernel_info), skip_fp32_(nullptr), gamma_fp32_(nullptr), beta_fp32_(nullptr), bias_fp32_(nullptr) {
+    : OpKernel(op_kernel_info), gamma_fp32_(nullptr), beta_fp32_(nullptr), bias_fp32_(nullptr) {
   ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
   ORT_ENFORCE(epsilon_ >= 0);
 }
@@ -264,12 +265,19 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
 
+  IAllocatorUniquePtr<float> gamma_fp32;
+  IAllocatorUniquePtr<float> beta_fp32;
+  IAllocatorUniquePtr<float> bias_fp32;
+  const float* gamma_float_ptr = GetFloatDataIfNeeded(gamma_data, gamma_fp32_, hidden_size, alloc, gamma_fp32);
+  const float* beta_float_ptr = GetFloatDataIfNeeded(beta_data, beta_fp32_, hidden_size, alloc, beta_fp32);
+  const float* bias_float_ptr = GetFloatDataIfNeeded(bias_data, bias_fp32_, hidden_size, alloc, bias_fp32);
+
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
       [&](ptrdiff_t task_idx) {
-        ComputeJob(input_data, skip_data, gamma_data, beta_data, bias_data, skip_fp32_, gamma_fp32_, beta_fp32_,
-                   bias_fp32_, task_idx, hidden_size, skip_size, epsilon_, simplified, output_data,
-                   skip_input_bias_add_output_data, alloc);
+        ComputeJob(input_data, skip_data, gamma_data, beta_data, bias_data, gamma_float_ptr, beta_float_ptr,
+                   bias_float_ptr, task_idx, hidden_size, skip_size, epsilon_, simplified, output_data,
+                   skip_input_bias_add_output_data);
       },
       0);
 
@@ -282,9 +290,7 @@ Status SkipLayerNorm<T, simplified>::PrePack(const Tensor& tensor, int input_idx
   ORT_UNUSED_PARAMETER(prepacked_weights);
 
   is_packed = false;
-  if (input_idx == 1) {  // skip
-    ConvertMLFloat16ToFloatIfNeeded(tensor, alloc, skip_fp32_, is_packed);
-  } else if (input_idx == 2) {  // gamma
+  if (input_idx == 2) {  // gamma
     ConvertMLFloat16ToFloatIfNeeded(tensor, alloc, gamma_fp32_, is_packed);
   } else if (input_idx == 3) {  // beta
     ConvertMLFloat16ToFloatIfNeeded(tensor, alloc, beta_fp32_, is_packed);
@@ -230,11 +230,23 @@ void ThreadPoolProfiler::LogRun(int thread_idx) {
   }
 }
 
+void ThreadPoolProfiler::LogWorkerTime(int thread_idx, uint64_t spin_us, uint64_t park_us, uint64_t work_us) {
+  if (enabled_) {
+    auto& stat = child_thread_stats_[thread_idx];
+    stat.spin_us_ += spin_us;
+    stat.park_us_ += park_us;
+    stat.work_us_ += work_us;
+  }
+}
+
 std::string ThreadPoolProfiler::DumpChildThreadStat() {
   std::stringstream ss;
   for (int i = 0; i < num_threads_; ++i) {
     ss << "\"" << child_thread_stats_[i].thread_id_ << "\": {"
        << "\"num_run\": " << child_thread_stats_[i].num_run_ << ", "
+       << "\"spin_us\": " << child_thread_stats_[i].spin_us_ << ", "
+       << "\"park_us\": " << child_thread_stats_[i].park_us_ << ", "
+       << "\"work_us\": " << child_thread_stats_[i].work_us_ << ", "
        << "\"core\": " << child_thread_stats_[i].core_ << "}"
        << (i == num_threads_ - 1 ? "" : ",");
   }
@@ -495,6 +507,26 @@ std::string ThreadPool::StopProfiling() {
 
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+// true while the current thread is counted as busy by an InterOpTaskScope
+thread_local bool in_inter_op_task_scope = false;
+}
+
+ThreadPool::InterOpTaskScope::InterOpTaskScope(ThreadPool* tp) {
+  // the calling thread is not available to other loops while it runs the task. the thread that runs the
+  // session is not a worker of the pool, so it is never counted. a task the pool ran inline from another task
+  // runs on a thread that is already counted.
+  if (tp && tp->thread_options_.unified_scheduling && !in_inter_op_task_scope && tp->CurrentThreadId() != -1) {
+    tp_ = tp;
+    in_inter_op_task_scope = true;
+    tp_->num_busy_workers_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ThreadPool::InterOpTaskScope::~InterOpTaskScope() {
+  if (tp_) {
+    tp_->num_busy_workers_.fetch_sub(1, std::memory_order_relaxed);
+    in_inter_op_task_scope = false;
+  }
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
@@ -517,6 +549,15 @@ ThreadPool::ParallelSection::~ParallelSection() {
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
+    if (thread_options_.unified_scheduling) {
+      // the work items claim iterations until the loop is done, so fewer items than requested
+      // still run all of the loop, just on fewer threads.
+      n = std::min(n, AvailableParallelism());
+      if (n <= 1 && !current_parallel_section.has_value()) {
+        fn(0);
+        return;
+      }
+    }
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
@@ -530,6 +571,13 @@ void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n,
   }
 }
 
+unsigned ThreadPool::AvailableParallelism() const {
+  // the calling thread runs one of the work items whether or not it is busy with an inter-op task itself,
+  // every other item needs a worker that is not running one.
+  const int available = NumThreads() + 1 - num_busy_workers_.load(std::memory_order_relaxed);
+  return static_cast<unsigned>(std::max(available, 1));
+}
+
 bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                                        const std::ptrdiff_t block_size) const {
   // Do not parallelize trivial loops, with only a single block of work
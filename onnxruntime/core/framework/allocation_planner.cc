@@ -1854,7 +1854,9 @@ class PlannerImpl {
             break;
           }
         }
-        if (is_all_consumer_same_stream) {
+        // under critical path scheduling the nodes of a stream may be run out of order so the last consumer in the
+        // stream is not necessarily the last one to run.
+        if (is_all_consumer_same_stream && !context_->IsCriticalPathSchedulingEnabled()) {
           // all the consumers are on the same stream, so the first element is the last consumer int the stream.
           process_consumer(release_action_idx, ortvalue_to_consumers_map[i][0]);
         } else {
@@ -43,6 +43,10 @@ class ISequentialPlannerContext {
   // see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
 
+  // If it returns true, the nodes of a stream may run out of order (see CriticalPathSchedule),
+  // so the planner releases values by reference count instead of after the last consumer in the stream.
+  virtual bool IsCriticalPathSchedulingEnabled() const { return false; }
+
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
@@ -51,10 +55,12 @@ class ISequentialPlannerContext {
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           bool critical_path_scheduling = false)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        critical_path_scheduling_(critical_path_scheduling) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -63,6 +69,10 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool IsParallelExecutionEnabled() const override { return execution_mode_ == ExecutionMode::ORT_PARALLEL; }
 
+  bool IsCriticalPathSchedulingEnabled() const override {
+    return IsParallelExecutionEnabled() && critical_path_scheduling_;
+  }
+
   ExecutionOrder GetExecutionOrder() const override { return execution_order_; }
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
@@ -71,6 +81,7 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  bool critical_path_scheduling_ = false;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -22,6 +22,10 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  // Allocations served from / missed by the thread local caches of an arena based allocator.
+  // Chunks held in those caches are counted in bytes_in_use.
+  int64_t num_thread_local_cache_hits;
+  int64_t num_thread_local_cache_misses;
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +39,8 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_thread_local_cache_hits = 0;
+    this->num_thread_local_cache_misses = 0;
   }
 
   std::string DebugString() const {
@@ -48,6 +54,10 @@ struct AllocatorStats {
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
        << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+    if (this->num_thread_local_cache_hits + this->num_thread_local_cache_misses > 0) {
+      ss << "ThreadLocalCacheHits:     " << this->num_thread_local_cache_hits << "\n"
+         << "ThreadLocalCacheMisses:   " << this->num_thread_local_cache_misses << "\n";
+    }
     return ss.str();
   }
 };
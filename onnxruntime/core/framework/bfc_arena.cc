@@ -3,16 +3,111 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <algorithm>
+#include <atomic>
 #include <type_traits>
 
+#include <gsl/gsl>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/spin_pause.h"
+
 namespace onnxruntime {
+
+namespace {
+std::atomic<uint64_t> next_thread_local_cache_arena_id{0};
+}  // namespace
+
+// Shared by an arena and the thread local caches created for it, so that a thread exiting after the arena was
+// destroyed knows it must not return its chunks.
+struct BFCArena::ThreadLocalCacheRegistry {
+  OrtMutex mutex;
+  // nullptr once the arena has been destroyed.
+  BFCArena* arena = nullptr;
+  // The caches of the threads that have used the arena and not exited yet.
+  std::vector<ThreadLocalCache*> caches;
+  // Hits and misses of the caches of the threads that have exited.
+  int64_t num_hits = 0;
+  int64_t num_misses = 0;
+};
+
+// Chunks handed out and freed by one thread. Only that thread allocates from and frees to the cache. Shrink() and
+// frees of its chunks on other threads take the cache over for a moment through in_use, which is otherwise only
+// touched by the owner thread.
+struct BFCArena::ThreadLocalCache {
+  static constexpr int kNumBins = 9;  // BinNumForSize(kThreadLocalCacheMaxChunkSize) + 1
+
+  uint64_t arena_id = 0;
+  std::shared_ptr<ThreadLocalCacheRegistry> registry;
+  // Set while a thread reads or writes the members below.
+  std::atomic<bool> in_use{false};
+  // (chunk pointer, chunk size) of the cached chunks, indexed by the arena bin of the chunk size.
+  std::array<std::vector<std::pair<void*, size_t>>, kNumBins> bins;
+  size_t cached_bytes = 0;
+  // Size of the chunks handed out by the cache that have not been freed yet.
+  InlinedHashMap<const void*, size_t> handed_out;
+  // Chunks of handed_out freed by other threads while the cache was in use. Guarded by the arena lock.
+  std::vector<void*> remote_frees;
+  std::atomic<bool> has_remote_frees{false};
+  // Only written by the owner thread.
+  std::atomic<int64_t> num_hits{0};
+  std::atomic<int64_t> num_misses{0};
+
+  void Acquire() {
+    while (in_use.exchange(true, std::memory_order_acquire)) {
+      concurrency::SpinPause();
+    }
+  }
+
+  // seq_cst, see BFCArena::EndThreadLocalCacheUse
+  bool TryAcquire() { return !in_use.exchange(true); }
+  void Release() { in_use.store(false); }
+
+  std::vector<std::pair<void*, size_t>> TakeAll() {
+    std::vector<std::pair<void*, size_t>> chunks;
+    for (auto& bin : bins) {
+      chunks.insert(chunks.end(), bin.begin(), bin.end());
+      bin.clear();
+    }
+    cached_bytes = 0;
+    return chunks;
+  }
+
+  // Returns the chunks to the arena if it still exists and removes the cache from its registry.
+  void Unregister() {
+    std::lock_guard<OrtMutex> lock(registry->mutex);
+    if (registry->arena != nullptr) {
+      registry->arena->DetachThreadLocalCache(*this);
+      registry->num_hits += num_hits.load(std::memory_order_relaxed);
+      registry->num_misses += num_misses.load(std::memory_order_relaxed);
+      auto& caches = registry->caches;
+      caches.erase(std::remove(caches.begin(), caches.end(), this), caches.end());
+    }
+  }
+};
+
+// The caches of the current thread, one per arena it has used. Chunks are returned to their arena on thread exit.
+struct BFCArena::ThreadLocalCacheMap {
+  std::vector<std::unique_ptr<ThreadLocalCache>> caches;
+
+  ~ThreadLocalCacheMap() {
+    // allocations made by the destructors of thread local objects that run after this one go to the arena directly
+    CurrentThreadLocalCache() = nullptr;
+    ThreadLocalCachesDestroyed() = true;
+    for (auto& cache : caches) {
+      cache->Unregister();
+    }
+  }
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_local_cache_max_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,15 +120,26 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_local_cache_max_bytes_(thread_local_cache_max_bytes > 0
+                                        ? static_cast<size_t>(thread_local_cache_max_bytes)
+                                        : 0),
+      thread_local_cache_arena_id_(next_thread_local_cache_arena_id++) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_local_cache_max_bytes: " << thread_local_cache_max_bytes_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
+  if (ThreadLocalCacheEnabled()) {
+    ORT_ENFORCE(BinNumForSize(kThreadLocalCacheMaxChunkSize) < ThreadLocalCache::kNumBins);
+    thread_local_cache_registry_ = std::make_shared<ThreadLocalCacheRegistry>();
+    thread_local_cache_registry_->arena = this;
+  }
+
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, static_cast<size_t>(initial_chunk_size_bytes_)));
@@ -78,6 +184,14 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
 }
 
 BFCArena::~BFCArena() {
+  // Detach the thread local caches so threads exiting later do not return chunks to this arena.
+  // The cached chunks are released along with the regions below.
+  if (thread_local_cache_registry_) {
+    std::lock_guard<OrtMutex> lock(thread_local_cache_registry_->mutex);
+    thread_local_cache_registry_->arena = nullptr;
+    thread_local_cache_registry_->caches.clear();
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -269,9 +383,238 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (ThreadLocalCacheEnabled() && size > 0 && RoundedBytes(size) <= kThreadLocalCacheMaxChunkSize) {
+    return AllocFromThreadLocalCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+BFCArena::ThreadLocalCache*& BFCArena::CurrentThreadLocalCache() {
+  // the cache of the arena the current thread used last. A raw pointer has no thread exit destructor so reading it
+  // does not go through the initialization guard of a thread local object.
+  thread_local ThreadLocalCache* cache = nullptr;
+  return cache;
+}
+
+bool& BFCArena::ThreadLocalCachesDestroyed() {
+  thread_local bool destroyed = false;
+  return destroyed;
+}
+
+BFCArena::ThreadLocalCache* BFCArena::GetThreadLocalCache() {
+  ThreadLocalCache*& current = CurrentThreadLocalCache();
+  if (current == nullptr || current->arena_id != thread_local_cache_arena_id_) {
+    if (ThreadLocalCachesDestroyed()) {
+      return nullptr;
+    }
+    current = FindOrCreateThreadLocalCache();
+  }
+  return current;
+}
+
+BFCArena::ThreadLocalCache* BFCArena::FindOrCreateThreadLocalCache() {
+  thread_local ThreadLocalCacheMap thread_caches;
+
+  for (const auto& cache : thread_caches.caches) {
+    if (cache->arena_id == thread_local_cache_arena_id_) {
+      return cache.get();
+    }
+  }
+
+  // drop the caches of arenas that no longer exist before adding a new one
+  thread_caches.caches.erase(
+      std::remove_if(thread_caches.caches.begin(), thread_caches.caches.end(),
+                     [](const auto& cache) {
+                       std::lock_guard<OrtMutex> lock(cache->registry->mutex);
+                       return cache->registry->arena == nullptr;
+                     }),
+      thread_caches.caches.end());
+
+  auto cache = std::make_unique<ThreadLocalCache>();
+  cache->arena_id = thread_local_cache_arena_id_;
+  cache->registry = thread_local_cache_registry_;
+  {
+    std::lock_guard<OrtMutex> lock(thread_local_cache_registry_->mutex);
+    thread_local_cache_registry_->caches.push_back(cache.get());
+  }
+  thread_caches.caches.push_back(std::move(cache));
+  return thread_caches.caches.back().get();
+}
+
+void BFCArena::EndThreadLocalCacheUse(ThreadLocalCache& cache) {
+  cache.Release();
+  // A thread freeing a chunk of this cache while it was in use queued the chunk and then tried to take the cache over.
+  // Its store to has_remote_frees is ordered before that attempt, so either it saw the cache released above and
+  // returned the chunk itself, or the load below sees the queued chunk.
+  if (cache.has_remote_frees.load()) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    if (cache.TryAcquire()) {
+      FreeRemoteFreesLocked(cache);
+      cache.Release();
+    }
+  }
+}
+
+void BFCArena::FreeRemoteFreesLocked(ThreadLocalCache& cache) {
+  cache.has_remote_frees.store(false);
+  for (void* p : cache.remote_frees) {
+    cache.handed_out.erase(p);
+    DeallocateRawInternal(p);
+  }
+  cache.remote_frees.clear();
+}
+
+void* BFCArena::AllocFromThreadLocalCache(size_t num_bytes) {
+  auto* cache = GetThreadLocalCache();
+  if (cache == nullptr) {
+    return AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+  }
+
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  auto& bin = cache->bins[BinNumForSize(rounded_bytes)];
+
+  cache->Acquire();
+  auto end_use = gsl::finally([this, cache]() { EndThreadLocalCacheUse(*cache); });
+
+  // most recently freed first as it is the most likely to still be in the CPU caches
+  for (auto it = bin.rbegin(); it != bin.rend(); ++it) {
+    if (it->second >= rounded_bytes) {
+      void* ptr = it->first;
+      const size_t chunk_size = it->second;
+      bin.erase(std::next(it).base());
+      cache->cached_bytes -= chunk_size;
+      cache->handed_out.insert_or_assign(ptr, chunk_size);
+      cache->num_hits.fetch_add(1, std::memory_order_relaxed);
+      return ptr;
+    }
+  }
+
+  cache->num_misses.fetch_add(1, std::memory_order_relaxed);
+  return AllocateRawInternal(num_bytes, false, nullptr, false, nullptr, cache);
+}
+
+bool BFCArena::FreeToThreadLocalCache(void* p) {
+  auto* cache = GetThreadLocalCache();
+  if (cache == nullptr) {
+    return false;
+  }
+
+  std::vector<std::pair<void*, size_t>> overflow;
+  {
+    cache->Acquire();
+    auto end_use = gsl::finally([this, cache]() { EndThreadLocalCacheUse(*cache); });
+
+    auto it = cache->handed_out.find(p);
+    if (it == cache->handed_out.end()) {
+      // not allocated through the cache of this thread
+      return false;
+    }
+    const size_t chunk_size = it->second;
+    cache->handed_out.erase(it);
+
+    cache->bins[BinNumForSize(chunk_size)].emplace_back(p, chunk_size);
+    cache->cached_bytes += chunk_size;
+
+    if (cache->cached_bytes > thread_local_cache_max_bytes_) {
+      // drain the least recently freed chunks until the cache is at half of its budget
+      for (auto& bin : cache->bins) {
+        auto bin_it = bin.begin();
+        for (; bin_it != bin.end() && cache->cached_bytes > thread_local_cache_max_bytes_ / 2; ++bin_it) {
+          cache->cached_bytes -= bin_it->second;
+          overflow.push_back(*bin_it);
+        }
+        bin.erase(bin.begin(), bin_it);
+      }
+    }
+  }
+
+  ReturnToArena(overflow);
+  return true;
+}
+
+bool BFCArena::FreeToOwnerThreadLocalCacheLocked(void* p) {
+  BFCArena::ChunkHandle h = region_manager_.get_handle(p);
+  ORT_ENFORCE(h != kInvalidChunkHandle);
+  ThreadLocalCache* owner = ChunkFromHandle(h)->thread_local_cache;
+  if (owner == nullptr) {
+    return false;
+  }
+
+  // The chunk stays in use until it is removed from owner->handed_out, so it cannot be handed out again meanwhile.
+  owner->remote_frees.push_back(p);
+  owner->has_remote_frees.store(true);
+  if (owner->TryAcquire()) {
+    FreeRemoteFreesLocked(*owner);
+    owner->Release();
+  }
+  // else the owner returns the chunk when it stops using its cache, see EndThreadLocalCacheUse
+  return true;
+}
+
+void BFCArena::AssignChunkToThreadLocalCache(Chunk* chunk, ThreadLocalCache* cache) {
+  // the calling thread owns the cache and holds it in use
+  chunk->thread_local_cache = cache;
+  cache->handed_out.insert_or_assign(chunk->ptr, chunk->size);
+}
+
+void BFCArena::DetachThreadLocalCache(ThreadLocalCache& cache) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  FreeRemoteFreesLocked(cache);
+  for (const auto& chunk : cache.TakeAll()) {
+    DeallocateRawInternal(chunk.first);
+  }
+  // chunks still handed out are returned to the arena directly when they are freed
+  for (const auto& chunk : cache.handed_out) {
+    BFCArena::ChunkHandle h = region_manager_.get_handle(chunk.first);
+    ORT_ENFORCE(h != kInvalidChunkHandle);
+    ChunkFromHandle(h)->thread_local_cache = nullptr;
+  }
+  cache.handed_out.clear();
+}
+
+void BFCArena::ReturnToArena(const std::vector<std::pair<void*, size_t>>& chunks) {
+  if (chunks.empty()) {
+    return;
+  }
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (const auto& chunk : chunks) {
+    DeallocateRawInternal(chunk.first);
+  }
+}
+
+void BFCArena::DrainThreadLocalCaches() {
+  // Holding the registry mutex keeps the caches alive. Their owners never take it while a cache is in use, and
+  // lock_ is not held while waiting for them.
+  std::lock_guard<OrtMutex> registry_lock(thread_local_cache_registry_->mutex);
+  std::vector<std::pair<void*, size_t>> chunks;
+  for (auto* cache : thread_local_cache_registry_->caches) {
+    cache->Acquire();
+    auto cache_chunks = cache->TakeAll();
+    cache->Release();
+    chunks.insert(chunks.end(), cache_chunks.begin(), cache_chunks.end());
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (const auto& chunk : chunks) {
+    DeallocateRawInternal(chunk.first);
+  }
+  // chunks freed by other threads while their cache was taken over above
+  for (auto* cache : thread_local_cache_registry_->caches) {
+    if (cache->has_remote_frees.load() && cache->TryAcquire()) {
+      FreeRemoteFreesLocked(*cache);
+      cache->Release();
+    }
+  }
+}
+
+size_t BFCArena::NumThreadLocalCaches() {
+  if (!ThreadLocalCacheEnabled()) {
+    return 0;
+  }
+  std::lock_guard<OrtMutex> lock(thread_local_cache_registry_->mutex);
+  return thread_local_cache_registry_->caches.size();
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -312,7 +655,8 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                                     bool dump_log_on_failure,
                                     Stream* stream,
                                     bool enable_cross_stream_reusing,
-                                    WaitNotificationFn wait_fn) {
+                                    WaitNotificationFn wait_fn,
+                                    ThreadLocalCache* thread_local_cache) {
   if (num_bytes == 0) {
     LOGS_DEFAULT(VERBOSE) << "tried to allocate 0 bytes";
     return nullptr;
@@ -341,6 +685,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (stream)
         chunk->stream_timestamp = stream->GetCurrentTimestamp();
     }
+    if (thread_local_cache != nullptr) {
+      AssignChunkToThreadLocalCache(chunk, thread_local_cache);
+    }
     return chunk->ptr;
   }
 
@@ -356,6 +703,9 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
       if (chunk->stream == nullptr && stream) {
         chunk->stream = stream;
       }
+      if (thread_local_cache != nullptr) {
+        AssignChunkToThreadLocalCache(chunk, thread_local_cache);
+      }
       return chunk->ptr;
     } else {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
@@ -377,8 +727,19 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
-  std::lock_guard<OrtMutex> lock(lock_);
-  *stats = stats_;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    *stats = stats_;
+  }
+  if (ThreadLocalCacheEnabled()) {
+    std::lock_guard<OrtMutex> lock(thread_local_cache_registry_->mutex);
+    stats->num_thread_local_cache_hits = thread_local_cache_registry_->num_hits;
+    stats->num_thread_local_cache_misses = thread_local_cache_registry_->num_misses;
+    for (const auto* cache : thread_local_cache_registry_->caches) {
+      stats->num_thread_local_cache_hits += cache->num_hits.load(std::memory_order_relaxed);
+      stats->num_thread_local_cache_misses += cache->num_misses.load(std::memory_order_relaxed);
+    }
+  }
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +857,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (ThreadLocalCacheEnabled() && FreeToThreadLocalCache(p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -503,12 +867,16 @@ void BFCArena::Free(void* p) {
     stats_.bytes_in_use -= it->second;
     stats_.total_allocated_bytes -= it->second;
     reserved_chunks_.erase(it);
-  } else {
+  } else if (!ThreadLocalCacheEnabled() || !FreeToOwnerThreadLocalCacheLocked(p)) {
     DeallocateRawInternal(p);
   }
 }
 
 Status BFCArena::Shrink() {
+  if (ThreadLocalCacheEnabled()) {
+    DrainThreadLocalCaches();
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
@@ -577,6 +945,7 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   // Find the chunk from the ptr.
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
   ORT_ENFORCE(h != kInvalidChunkHandle);
+  ChunkFromHandle(h)->thread_local_cache = nullptr;
 
   // Consider coalescing it.
   FreeAndMaybeCoalesce(h);
@@ -61,6 +61,7 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int64_t DEFAULT_THREAD_LOCAL_CACHE_MAX_BYTES = 0;  // disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +74,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_local_cache_max_bytes = DEFAULT_THREAD_LOCAL_CACHE_MAX_BYTES);
 
   ~BFCArena() override;
 
@@ -86,6 +88,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // The chunks held in the thread local caches of all threads are returned to the arena first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -101,6 +104,9 @@ class BFCArena : public IAllocator {
 
   size_t AllocatedSize(const void* ptr);
 
+  // Number of threads that have a thread local cache for this arena and have not exited yet.
+  size_t NumThreadLocalCaches();
+
   ArenaType GetArenaType() const { return arena_type_; }
 
   virtual void SecureTheChunk(Stream* /*chunk_stream*/,
@@ -108,11 +114,15 @@ class BFCArena : public IAllocator {
                               WaitNotificationFn /*wait_fn*/) const {}
 
  protected:
+  // See the private section below.
+  struct ThreadLocalCache;
+
   void* AllocateRawInternal(size_t num_bytes,
                             bool dump_log_on_failure,
                             Stream* stream,
                             bool enable_cross_stream_reusing,
-                            WaitNotificationFn wait_fn);
+                            WaitNotificationFn wait_fn,
+                            ThreadLocalCache* thread_local_cache = nullptr);
 #ifdef ORT_ENABLE_STREAM
   // for any chunk that associated with target stream, reset it to default (nullptr in stream, timestamp 0)
   // perform coalesce if coalesce_flag is true
@@ -123,6 +133,37 @@ class BFCArena : public IAllocator {
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Optional per-thread caches of recently freed small chunks, similar to the per-thread caches of tcmalloc.
+  // A cached chunk stays in use from the point of view of the arena, so Alloc/Free of small sizes
+  // can be served without taking lock_. A thread finds its cache through a thread local pointer and registers
+  // it with the arena once. Each cache tracks the chunks it handed out, so a thread freeing its own chunks only
+  // touches its own cache. A chunk freed by another thread is found through Chunk::thread_local_cache under lock_
+  // and handed back to the cache that owns it.
+  struct ThreadLocalCacheRegistry;
+  struct ThreadLocalCacheMap;
+
+  static constexpr size_t kThreadLocalCacheMaxChunkSize = 64 * 1024;
+
+  bool ThreadLocalCacheEnabled() const { return thread_local_cache_max_bytes_ > 0; }
+  static ThreadLocalCache*& CurrentThreadLocalCache();
+  static bool& ThreadLocalCachesDestroyed();
+  // Returns nullptr if called while the thread local objects of the current thread are destroyed.
+  ThreadLocalCache* GetThreadLocalCache();
+  ThreadLocalCache* FindOrCreateThreadLocalCache();
+  // Ends a use of the cache by its owner thread and returns the chunks other threads freed meanwhile.
+  void EndThreadLocalCacheUse(ThreadLocalCache& cache);
+  void FreeRemoteFreesLocked(ThreadLocalCache& cache);
+  void* AllocFromThreadLocalCache(size_t num_bytes);
+  // Returns false if p was not handed out by the cache of the calling thread.
+  bool FreeToThreadLocalCache(void* p);
+  // Returns false if p was not handed out by the cache of any thread. lock_ must be held.
+  bool FreeToOwnerThreadLocalCacheLocked(void* p);
+  // Called while the cache of the exiting thread is removed from the arena.
+  void DetachThreadLocalCache(ThreadLocalCache& cache);
+  // Returns chunks removed from the thread local caches to the arena. lock_ must not be held.
+  void ReturnToArena(const std::vector<std::pair<void*, size_t>>& chunks);
+  void DrainThreadLocalCaches();
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -170,6 +211,9 @@ class BFCArena : public IAllocator {
 
     uint64_t stream_timestamp = 0;
 
+    // The thread local cache that handed out the chunk, if any. Cleared when the chunk is returned to the arena.
+    ThreadLocalCache* thread_local_cache = nullptr;
+
     bool in_use() const { return allocation_id != -1; }
 
     std::string DebugString(BFCArena* a, bool recurse) {
@@ -378,6 +422,9 @@ class BFCArena : public IAllocator {
                                 bool allow_chunk_from_different_stream,
                                 WaitNotificationFn wait_fn = nullptr);
 
+  // Records that 'chunk' is handed out by 'cache', which the calling thread owns.
+  void AssignChunkToThreadLocalCache(Chunk* chunk, ThreadLocalCache* cache);
+
   // Splits the chunk specified by 'h' into two chunks, one at least
   // of size 'num_bytes'.
   void SplitChunk(ChunkHandle h, size_t num_bytes);
@@ -514,6 +561,12 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Maximum number of bytes each thread may hold in its cache of freed chunks. 0 disables the caches.
+  const size_t thread_local_cache_max_bytes_;
+  // Identifies this arena in the thread local cache maps. Unlike the address it is never reused.
+  const uint64_t thread_local_cache_arena_id_;
+  std::shared_ptr<ThreadLocalCacheRegistry> thread_local_cache_registry_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
@@ -0,0 +1,414 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/critical_path_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/stream_execution_context.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// value of a dimension if it is known, or 1 otherwise. negative axes count from the back.
+double DimOrOne(const NodeArg* arg, int axis) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 1.0;
+  }
+
+  const auto& shape = *arg->Shape();
+  const int rank = shape.dim_size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  if (axis < 0 || axis >= rank) {
+    return 1.0;
+  }
+
+  const auto& dim = shape.dim(axis);
+  return dim.has_dim_value() && dim.dim_value() > 0 ? static_cast<double>(dim.dim_value()) : 1.0;
+}
+
+double NumElementsOrOne(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 1.0;
+  }
+
+  double num_elements = 1.0;
+  for (int i = 0, end = arg->Shape()->dim_size(); i < end; ++i) {
+    num_elements *= DimOrOne(arg, i);
+  }
+  return num_elements;
+}
+
+double EstimateNodeCost(const Node& node) {
+  double output_elements = 0.0;
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists()) {
+      output_elements += NumElementsOrOne(output);
+    }
+  }
+
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+  double reduction_size = 1.0;
+  if (inputs.size() >= 2) {
+    if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul" ||
+        op_type == "MatMulNBits" || op_type == "Gemm") {
+      // K is the last dimension of A, unless A is transposed in Gemm
+      bool trans_a = false;
+      if (op_type == "Gemm") {
+        const auto& attrs = node.GetAttributes();
+        auto it = attrs.find("transA");
+        trans_a = it != attrs.end() && it->second.i() != 0;
+      }
+      reduction_size = DimOrOne(inputs[0], trans_a ? 0 : -1);
+    } else if (op_type == "Conv" || op_type == "ConvInteger" || op_type == "FusedConv" ||
+               op_type == "NhwcConv" || op_type == "ConvTranspose") {
+      // every output element reduces over C/group times the kernel spatial size, i.e. all but the first weight dim
+      reduction_size = NumElementsOrOne(inputs[1]) / DimOrOne(inputs[1], 0);
+    } else if (op_type == "QLinearMatMul") {
+      reduction_size = DimOrOne(inputs[0], -1);
+    } else if (op_type == "QLinearConv" && inputs.size() >= 4) {
+      reduction_size = NumElementsOrOne(inputs[3]) / DimOrOne(inputs[3], 0);
+    }
+  }
+
+  // add a constant for the per node overhead so chains of tiny nodes are not treated as free
+  return 1.0 + output_elements * reduction_size;
+}
+
+}  // namespace
+
+std::unique_ptr<CriticalPathSchedule> CriticalPathSchedule::Create(const GraphViewer& graph_viewer,
+                                                                   const SequentialExecutionPlan& plan) {
+  const SequentialExecutionPlan::LogicStream* stream = nullptr;
+  size_t stream_idx = 0;
+  for (size_t i = 0; i < plan.execution_plan.size(); ++i) {
+    const auto& logic_stream = plan.execution_plan[i];
+    if (!logic_stream || logic_stream->steps_.empty()) {
+      continue;
+    }
+    if (stream != nullptr) {
+      return nullptr;
+    }
+    stream = logic_stream.get();
+    stream_idx = i;
+  }
+
+  // a single CPU stream only contains kernel launches, so there is one step per node
+  if (stream == nullptr || stream->device_.Type() != OrtDevice::CPU ||
+      stream->steps_.size() != static_cast<size_t>(graph_viewer.NumberOfNodes()) ||
+      plan.num_barriers != 0 || !plan.notification_owners.empty()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<CriticalPathSchedule> schedule{new CriticalPathSchedule()};
+  schedule->stream_idx_ = stream_idx;
+  auto& nodes = schedule->nodes_;
+  nodes.reserve(stream->steps_.size());
+
+  InlinedHashMap<NodeIndex, size_t> node_positions;
+  node_positions.reserve(stream->steps_.size());
+  for (const auto& step : stream->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    if (graph_viewer.GetNode(node_index) == nullptr || !node_positions.emplace(node_index, nodes.size()).second) {
+      return nullptr;
+    }
+    nodes.push_back(NodeInfo{node_index, 0.0, 0, {}});
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const Node& node = *graph_viewer.GetNode(nodes[i].node_index);
+    InlinedHashSet<size_t> consumers;
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      auto consumer = node_positions.find(it->Index());
+      if (consumer != node_positions.end() && consumers.insert(consumer->second).second) {
+        nodes[i].consumers.push_back(consumer->second);
+        ++nodes[consumer->second].num_dependencies;
+      }
+    }
+  }
+
+  // the steps are in topological order so the priorities can be computed in a single reverse pass
+  for (size_t i = nodes.size(); i-- > 0;) {
+    double max_consumer_priority = 0.0;
+    for (auto consumer : nodes[i].consumers) {
+      if (consumer <= i) {
+        // not in topological order
+        return nullptr;
+      }
+      max_consumer_priority = std::max(max_consumer_priority, nodes[consumer].priority);
+    }
+    nodes[i].priority = EstimateNodeCost(*graph_viewer.GetNode(nodes[i].node_index)) + max_consumer_priority;
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i].num_dependencies == 0) {
+      schedule->roots_.push_back(i);
+    }
+  }
+
+  return schedule;
+}
+
+namespace {
+
+// state shared by the workers of one execution
+class CriticalPathExecution {
+ public:
+  CriticalPathExecution(const CriticalPathSchedule& schedule, StreamExecutionContext& ctx,
+                        SessionScope& session_scope, concurrency::ThreadPool* tp, const bool& terminate_flag,
+                        size_t num_workers)
+      : schedule_(schedule),
+        ctx_(ctx),
+        session_scope_(session_scope),
+        tp_(tp),
+        terminate_flag_(terminate_flag),
+        queues_(num_workers),
+        pending_dependencies_(new std::atomic_int[schedule.NumNodes()]),
+        remaining_nodes_(schedule.NumNodes()) {
+    const auto& nodes = schedule_.Nodes();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      pending_dependencies_[i].store(nodes[i].num_dependencies, std::memory_order_relaxed);
+    }
+
+    // the helpers steal the roots from the queue of the calling thread
+    for (auto root : schedule_.Roots()) {
+      Push(0, root);
+    }
+
+    for (size_t worker = num_workers; worker-- > 1;) {
+      free_helpers_.push_back(worker);
+    }
+  }
+
+  // runs nodes on the calling thread until all of them have run or one has failed
+  void Run() {
+    StartHelpers(schedule_.Roots().size() - 1);
+    RunWorker(0);
+
+    // the helpers reference this object, so wait for all of them to exit. a helper may only start after the other
+    // nodes have run, e.g. if the pool is busy with another request, so block instead of spinning.
+    std::unique_lock<OrtMutex> lock(helpers_mutex_);
+    helpers_cv_.wait(lock, [this]() { return running_helpers_ == 0; });
+  }
+
+ private:
+  struct ReadyNode {
+    double priority;
+    size_t node;
+    bool operator<(const ReadyNode& other) const { return priority < other.priority; }
+  };
+
+  struct ReadyQueue {
+    OrtMutex mutex;
+    // max heap on priority
+    std::vector<ReadyNode> heap;
+  };
+
+  bool IsDone() const {
+    return remaining_nodes_.load(std::memory_order_acquire) == 0 || failed_.load(std::memory_order_acquire);
+  }
+
+  // worker 0 is the calling thread, which waits for new ready nodes until the execution is done. the helpers run on
+  // the thread pool and exit as soon as they find no ready node, so they never hold a pool thread that the parallel
+  // loops of the running kernels could use.
+  void RunWorker(size_t worker) {
+    while (!IsDone()) {
+      size_t node = 0;
+      if (!Pop(worker, node)) {
+        if (worker != 0) {
+          return;
+        }
+        std::unique_lock<OrtMutex> lock(idle_mutex_);
+        idle_cv_.wait(lock, [this]() { return IsDone() || num_ready_.load(std::memory_order_acquire) > 0; });
+        continue;
+      }
+
+      if (IsDone()) {
+        return;
+      }
+
+      if (!RunNode(worker, node)) {
+        failed_.store(true, std::memory_order_release);
+        WakeAll();
+        return;
+      }
+
+      if (remaining_nodes_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        WakeAll();
+        return;
+      }
+    }
+  }
+
+  // starts up to num_helpers helpers on the thread pool, as long as there are free worker slots
+  void StartHelpers(size_t num_helpers) {
+    InlinedVector<size_t> workers;
+    {
+      std::lock_guard<OrtMutex> lock(helpers_mutex_);
+      while (workers.size() < num_helpers && !free_helpers_.empty()) {
+        workers.push_back(free_helpers_.back());
+        free_helpers_.pop_back();
+        ++running_helpers_;
+      }
+    }
+
+    // the pool may run a task inline, so schedule without holding the lock
+    for (auto worker : workers) {
+      concurrency::ThreadPool::Schedule(tp_, [this, worker]() {
+        RunWorker(worker);
+        // notify while holding the lock so the waiting thread cannot return and destroy the condition variable first
+        std::lock_guard<OrtMutex> lock(helpers_mutex_);
+        free_helpers_.push_back(worker);
+        if (--running_helpers_ == 0) {
+          helpers_cv_.notify_all();
+        }
+      });
+    }
+  }
+
+  void Push(size_t worker, size_t node) {
+    auto& queue = queues_[worker];
+    {
+      std::lock_guard<OrtMutex> lock(queue.mutex);
+      queue.heap.push_back({schedule_.Nodes()[node].priority, node});
+      std::push_heap(queue.heap.begin(), queue.heap.end());
+      num_ready_.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  bool TryPop(size_t worker, size_t& node) {
+    auto& queue = queues_[worker];
+    std::lock_guard<OrtMutex> lock(queue.mutex);
+    if (queue.heap.empty()) {
+      return false;
+    }
+    std::pop_heap(queue.heap.begin(), queue.heap.end());
+    node = queue.heap.back().node;
+    queue.heap.pop_back();
+    num_ready_.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  // take the most critical node of the own queue, or steal one from the other workers
+  bool Pop(size_t worker, size_t& node) {
+    if (TryPop(worker, node)) {
+      return true;
+    }
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      if (TryPop((worker + i) % queues_.size(), node)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool RunNode(size_t worker, size_t node) {
+    if (terminate_flag_) {
+      Status status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      SetStatus(status);
+      return false;
+    }
+
+    const auto& node_info = schedule_.Nodes()[node];
+    Status status;
+    ORT_TRY {
+      // lets the parallel loops of the kernels running concurrently on a unified pool share its threads
+      concurrency::ThreadPool::InterOpTaskScope task_scope(tp_);
+      status = ExecuteKernel(ctx_, node_info.node_index, schedule_.StreamIndex(), terminate_flag_, session_scope_);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    if (!status.IsOK()) {
+      SetStatus(status);
+      return false;
+    }
+
+    size_t num_new_ready = 0;
+    for (auto consumer : node_info.consumers) {
+      if (pending_dependencies_[consumer].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        Push(worker, consumer);
+        ++num_new_ready;
+      }
+    }
+
+    // this worker picks up one of the new nodes itself. wake the calling thread in case it is waiting and start
+    // helpers for the others.
+    if (num_new_ready > 1) {
+      {
+        std::lock_guard<OrtMutex> lock(idle_mutex_);
+        idle_cv_.notify_all();
+      }
+      StartHelpers(num_new_ready - 1);
+    }
+
+    return true;
+  }
+
+  void SetStatus(Status& status) {
+    std::lock_guard<OrtMutex> lock(status_mutex_);
+    ctx_.SetStatus(status);
+  }
+
+  void WakeAll() {
+    std::lock_guard<OrtMutex> lock(idle_mutex_);
+    idle_cv_.notify_all();
+  }
+
+  const CriticalPathSchedule& schedule_;
+  StreamExecutionContext& ctx_;
+  SessionScope& session_scope_;
+  concurrency::ThreadPool* tp_;
+  const bool& terminate_flag_;
+
+  std::vector<ReadyQueue> queues_;
+  std::unique_ptr<std::atomic_int[]> pending_dependencies_;
+  std::atomic<size_t> remaining_nodes_;
+  std::atomic<size_t> num_ready_{0};
+  std::atomic<bool> failed_{false};
+
+  OrtMutex idle_mutex_;
+  OrtCondVar idle_cv_;
+  OrtMutex status_mutex_;
+
+  // worker slots of the helpers that are not running, and the number of running helpers
+  OrtMutex helpers_mutex_;
+  OrtCondVar helpers_cv_;
+  InlinedVector<size_t> free_helpers_;
+  size_t running_helpers_{0};
+};
+
+}  // namespace
+
+void ExecuteCriticalPathSchedule(const CriticalPathSchedule& schedule,
+                                 StreamExecutionContext& ctx,
+                                 SessionScope& session_scope,
+                                 concurrency::ThreadPool* tp,
+                                 const bool& terminate_flag) {
+  if (schedule.NumNodes() == 0) {
+    return;
+  }
+
+  // DegreeOfParallelism includes the calling thread. there is no point in having more workers than nodes.
+  const int degree_of_parallelism = std::max(concurrency::ThreadPool::DegreeOfParallelism(tp), 1);
+  const size_t num_workers = std::min(static_cast<size_t>(degree_of_parallelism), schedule.NumNodes());
+
+  CriticalPathExecution execution(schedule, ctx, session_scope, tp, terminate_flag, num_workers);
+  execution.Run();
+}
+
+}  // namespace onnxruntime
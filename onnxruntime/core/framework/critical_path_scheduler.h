@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class SessionScope;
+class StreamExecutionContext;
+struct SequentialExecutionPlan;
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+Static information used to execute the nodes of a graph out of order in ExecutionMode::ORT_PARALLEL.
+
+Each node is assigned a priority equal to the estimated cost of the longest path from the node to the end of the
+graph, i.e. its position on the critical path. The costs are estimated from the static shapes of the node inputs and
+outputs: matrix multiplications and convolutions are weighted by their reduction size, other nodes by the number of
+output elements. Unknown dimensions count as 1, so only the relative order of the estimates matters.
+
+Only created for plans with a single logic stream on CPU. The planner does not reuse buffers in parallel mode and
+releases values by reference count, so the nodes of that stream can run in any order consistent with the graph.
+*/
+class CriticalPathSchedule {
+ public:
+  // Returns nullptr if the plan is not supported.
+  static std::unique_ptr<CriticalPathSchedule> Create(const GraphViewer& graph_viewer,
+                                                      const SequentialExecutionPlan& plan);
+
+  size_t StreamIndex() const noexcept { return stream_idx_; }
+  size_t NumNodes() const noexcept { return nodes_.size(); }
+
+  struct NodeInfo {
+    NodeIndex node_index;
+    // estimated cost of the longest path from this node to the end of the graph, including the node itself
+    double priority;
+    // number of distinct nodes this node depends on
+    int num_dependencies;
+    // positions in nodes_ of the distinct nodes that depend on this node
+    InlinedVector<size_t> consumers;
+  };
+
+  const std::vector<NodeInfo>& Nodes() const noexcept { return nodes_; }
+
+  // positions in nodes_ of the nodes without dependencies
+  const InlinedVector<size_t>& Roots() const noexcept { return roots_; }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CriticalPathSchedule);
+
+ private:
+  CriticalPathSchedule() = default;
+
+  size_t stream_idx_{0};
+  std::vector<NodeInfo> nodes_;
+  InlinedVector<size_t> roots_;
+};
+
+/**
+Execute the nodes of the schedule on the calling thread and up to DegreeOfParallelism(tp) - 1 helpers on the
+inter-op thread pool.
+
+Each worker owns a queue of ready nodes ordered by priority. A worker runs the highest priority node of its own
+queue, and steals the highest priority node of another worker's queue when its own is empty. The nodes made ready by
+a completed node are queued on the worker that ran it so the most critical successor usually runs on the same thread
+as its producer.
+
+Helpers are only started when more nodes are ready than the running workers take, and exit as soon as they find no
+ready node. They do not hold pool threads while the graph is narrow, so with a unified thread pool the parallel loops
+of the running kernels can use those threads.
+
+Returns once all the nodes have run or one of them has failed. Errors are reported through ctx.SetStatus.
+*/
+void ExecuteCriticalPathSchedule(const CriticalPathSchedule& schedule,
+                                 StreamExecutionContext& ctx,
+                                 SessionScope& session_scope,
+                                 concurrency::ThreadPool* tp,
+                                 const bool& terminate_flag);
+
+}  // namespace onnxruntime
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/external_data_prefetcher.h"
+
+#include <algorithm>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Large enough to amortize the cost of a request, small enough to spread a single big weight across the threads.
+constexpr size_t kChunkSize = size_t{8} << 20;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+ExternalDataPrefetcher::ExternalDataPrefetcher(const Graph& graph, const std::filesystem::path& model_path,
+                                               int num_threads, const logging::Logger& logger)
+    : logger_(logger) {
+  std::vector<Chunk> ranges;
+  CollectRanges(graph, model_path, ranges);
+
+  if (ranges.empty() || num_threads <= 0) {
+    return;
+  }
+
+  // Merge the ranges of each file so shared or adjacent data is read once and in large requests.
+  std::sort(ranges.begin(), ranges.end(), [](const Chunk& a, const Chunk& b) {
+    return a.file_path != b.file_path ? a.file_path < b.file_path : a.offset < b.offset;
+  });
+
+  std::vector<Chunk> merged;
+  for (auto& range : ranges) {
+    if (!merged.empty()) {
+      auto& last = merged.back();
+      const FileOffsetType last_end = last.offset + static_cast<FileOffsetType>(last.length);
+      if (last.file_path == range.file_path && range.offset <= last_end) {
+        const FileOffsetType end = std::max(last_end, range.offset + static_cast<FileOffsetType>(range.length));
+        last.length = static_cast<size_t>(end - last.offset);
+        continue;
+      }
+    }
+    merged.push_back(std::move(range));
+  }
+
+  for (const auto& range : merged) {
+    for (size_t done = 0; done < range.length; done += kChunkSize) {
+      chunks_.push_back({range.file_path, range.offset + static_cast<FileOffsetType>(done),
+                         std::min(kChunkSize, range.length - done)});
+    }
+  }
+
+  const int threads = static_cast<int>(std::min(static_cast<size_t>(num_threads), chunks_.size()));
+  start_time_ = std::chrono::steady_clock::now();
+  // the pool has degree_of_parallelism - 1 threads. all of them submit requests, the caller goes on with the
+  // session setup.
+  thread_pool_ = std::make_unique<concurrency::ThreadPool>(&Env::Default(), ThreadOptions(),
+                                                           ORT_TSTR("ort_ext_data_prefetch"), threads + 1,
+                                                           /*low_latency_hint*/ false);
+  for (int i = 0; i < threads; ++i) {
+    concurrency::ThreadPool::Schedule(thread_pool_.get(), [this]() { RequestChunks(); });
+  }
+}
+
+void ExternalDataPrefetcher::CollectRanges(const Graph& graph, const std::filesystem::path& model_path,
+                                           std::vector<Chunk>& ranges) {
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    const auto& tensor_proto = *entry.second;
+    if (!utils::HasExternalData(tensor_proto)) {
+      continue;
+    }
+
+    Chunk range{};
+    if (!utils::GetExtDataFileLocationFromTensorProto(model_path, tensor_proto, range.file_path, range.offset,
+                                                      range.length)
+             .IsOK() ||
+        range.length == 0) {
+      continue;
+    }
+
+    ranges.push_back(std::move(range));
+  }
+
+  // the external data of a subgraph is relative to the model path too.
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      CollectRanges(*subgraph, model_path, ranges);
+    }
+  }
+}
+
+ExternalDataPrefetcher::~ExternalDataPrefetcher() {
+  cancelled_ = true;
+  thread_pool_.reset();
+}
+
+void ExternalDataPrefetcher::Wait() {
+  if (!thread_pool_) {
+    return;
+  }
+
+  thread_pool_.reset();
+  const auto end_time = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(end_time_ns_.load()));
+  request_duration_ = std::max(std::chrono::nanoseconds(0),
+                               std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time_));
+}
+
+void ExternalDataPrefetcher::RequestChunks() {
+  const auto& env = Env::Default();
+  for (size_t i = next_chunk_++; i < chunks_.size() && !cancelled_; i = next_chunk_++) {
+    const auto& chunk = chunks_[i];
+    auto status = env.PrefetchFileRange(chunk.file_path.c_str(), chunk.offset, chunk.length);
+    if (!status.IsOK()) {
+      if (!logged_error_.exchange(true)) {
+        LOGS(logger_, WARNING) << "Failed to prefetch external initializer data: " << status.ErrorMessage();
+      }
+      continue;
+    }
+
+    bytes_requested_ += chunk.length;
+  }
+
+  const int64_t now = NowNs();
+  int64_t end = end_time_ns_.load();
+  while (end < now && !end_time_ns_.compare_exchange_weak(end, now)) {
+  }
+}
+
+}  // namespace onnxruntime
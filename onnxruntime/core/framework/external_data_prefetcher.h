@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Graph;
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+Asks the OS to read the external data files of the initializers of a graph and its subgraphs into the page cache in
+the background, so that the data is in memory by the time the session state memory-maps or reads it.
+
+The byte ranges used by the initializers are merged per file and split into chunks. A small pool of threads passes
+them to Env::PrefetchFileRange (posix_fadvise(POSIX_FADV_WILLNEED) on POSIX), which queues the reads without copying
+the data, so several requests are in flight on storage that only reaches its bandwidth with a deep queue. It is
+started before the graph transformations so the reads overlap with them. Nothing needs to wait for the reads: loading
+an initializer only waits for the pages that are not in the cache yet. Errors are only logged, loading the
+initializers reports them.
+*/
+class ExternalDataPrefetcher {
+ public:
+  ExternalDataPrefetcher(const Graph& graph, const std::filesystem::path& model_path, int num_threads,
+                         const logging::Logger& logger);
+
+  // Stops submitting requests and waits for the threads.
+  ~ExternalDataPrefetcher();
+
+  // Waits for all the requests to be submitted.
+  void Wait();
+
+  // Number of bytes requested so far.
+  size_t BytesRequested() const noexcept { return bytes_requested_.load(std::memory_order_relaxed); }
+
+  // Time from the first request to the last one. Only valid after Wait().
+  std::chrono::nanoseconds RequestDuration() const noexcept { return request_duration_; }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExternalDataPrefetcher);
+
+ private:
+  struct Chunk {
+    std::basic_string<ORTCHAR_T> file_path;
+    FileOffsetType offset;
+    size_t length;
+  };
+
+  static void CollectRanges(const Graph& graph, const std::filesystem::path& model_path, std::vector<Chunk>& ranges);
+
+  void RequestChunks();
+
+  const logging::Logger& logger_;
+  std::vector<Chunk> chunks_;
+  std::atomic<size_t> next_chunk_{0};
+  std::atomic<size_t> bytes_requested_{0};
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> logged_error_{false};
+  std::chrono::steady_clock::time_point start_time_;
+  std::atomic<int64_t> end_time_ns_{0};
+  std::chrono::nanoseconds request_duration_{0};
+  std::unique_ptr<concurrency::ThreadPool> thread_pool_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/hash_combine.h"
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+Status MemoryPatternBucketPolicy::Parse(std::string_view config, MemoryPatternBucketPolicy& policy) {
+  policy = MemoryPatternBucketPolicy{};
+
+  if (config.empty() || config == "exact") {
+    return Status::OK();
+  }
+
+  if (config == "pow2") {
+    policy.mode_ = Mode::kPowerOfTwo;
+    return Status::OK();
+  }
+
+  for (const auto& bucket_str : utils::SplitString(config, ",")) {
+    int64_t bucket = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(bucket_str, bucket) && bucket > 0,
+                      "Invalid memory pattern bucket value '", bucket_str, "' in '", config, "'");
+    ORT_RETURN_IF_NOT(policy.buckets_.empty() || bucket > policy.buckets_.back(),
+                      "Memory pattern bucket values must be strictly increasing: '", config, "'");
+    policy.buckets_.push_back(bucket);
+  }
+
+  ORT_RETURN_IF(policy.buckets_.empty(), "No memory pattern bucket values found in '", config, "'");
+  policy.mode_ = Mode::kList;
+  return Status::OK();
+}
+
+int64_t MemoryPatternBucketPolicy::GetBucket(int64_t dim) const {
+  switch (mode_) {
+    case Mode::kPowerOfTwo: {
+      if (dim <= 1) {
+        return dim;
+      }
+      int64_t bucket = 1;
+      while (bucket < dim && bucket <= (std::numeric_limits<int64_t>::max() >> 1)) {
+        bucket <<= 1;
+      }
+      return bucket < dim ? dim : bucket;
+    }
+    case Mode::kList: {
+      auto it = std::lower_bound(buckets_.cbegin(), buckets_.cend(), dim);
+      return it == buckets_.cend() ? dim : *it;
+    }
+    default:
+      return dim;
+  }
+}
+
+MemoryPatternCache::Key MemoryPatternCache::CalculateKey(gsl::span<const OrtValue> tensor_inputs) const {
+  size_t key = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      HashCombine(policy_.GetBucket(dim), key);
+    }
+  }
+  return key;
+}
+
+namespace {
+
+InlinedVector<int64_t> FlattenDims(gsl::span<const OrtValue> tensor_inputs) {
+  InlinedVector<int64_t> dims;
+  for (const auto& input : tensor_inputs) {
+    const auto input_dims = input.Get<Tensor>().Shape().GetDims();
+    dims.insert(dims.end(), input_dims.begin(), input_dims.end());
+  }
+  return dims;
+}
+
+// true if every dimension of the inputs is within the dimensions the cached pattern was traced for.
+bool Covers(gsl::span<const int64_t> cached_dims, gsl::span<const OrtValue> tensor_inputs) {
+  size_t i = 0;
+  for (const auto& input : tensor_inputs) {
+    for (auto dim : input.Get<Tensor>().Shape().GetDims()) {
+      if (i >= cached_dims.size() || dim > cached_dims[i]) {
+        return false;
+      }
+      ++i;
+    }
+  }
+  return i == cached_dims.size();
+}
+
+size_t TotalPeakSize(const MemoryPatternGroup& mem_patterns) {
+  size_t num_bytes = 0;
+  for (const auto& pattern : mem_patterns.patterns) {
+    num_bytes += pattern.PeakSize();
+  }
+  return num_bytes;
+}
+
+}  // namespace
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Find(Key key, gsl::span<const OrtValue> tensor_inputs) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  auto& entry = it->second;
+  if (policy_.IsBucketed() && !Covers(entry.dims, tensor_inputs)) {
+    // the inputs are larger than what the cached layout was traced for. report a miss so a new layout is traced.
+    return nullptr;
+  }
+
+  Touch(entry);
+  return entry.mem_patterns;
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Insert(Key key, gsl::span<const OrtValue> tensor_inputs,
+                                                                     MemoryPatternGroup mem_patterns) {
+  const size_t num_bytes = TotalPeakSize(mem_patterns);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    auto& entry = it->second;
+    if (policy_.IsBucketed() && !Covers(entry.dims, tensor_inputs)) {
+      // The cached layout was not traced for these inputs. Replace it so that the recorded dims always describe the
+      // layout that is handed out. If they are covered another Run traced the same bucket first, keep its layout.
+      total_bytes_ = total_bytes_ - entry.num_bytes + num_bytes;
+      entry.mem_patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+      entry.dims = FlattenDims(tensor_inputs);
+      entry.num_bytes = num_bytes;
+    }
+
+    // Do not update if present in exact mode, as the pointer to the existing one is cached
+    Touch(entry);
+    auto result = entry.mem_patterns;
+    EvictIfNeeded();
+    return result;
+  }
+
+  lru_.push_front(key);
+
+  Entry entry;
+  entry.mem_patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+  if (policy_.IsBucketed()) {
+    entry.dims = FlattenDims(tensor_inputs);
+  }
+  entry.num_bytes = num_bytes;
+  entry.lru_it = lru_.begin();
+  auto result = entry.mem_patterns;
+
+  entries_.emplace(key, std::move(entry));
+  total_bytes_ += num_bytes;
+
+  EvictIfNeeded();
+  return result;
+}
+
+void MemoryPatternCache::Touch(Entry& entry) {
+  lru_.splice(lru_.begin(), lru_, entry.lru_it);
+}
+
+void MemoryPatternCache::EvictIfNeeded() {
+  if (max_bytes_ == 0) {
+    return;
+  }
+
+  // always keep the most recently used entry, even if on its own it exceeds the budget
+  while (total_bytes_ > max_bytes_ && lru_.size() > 1) {
+    auto it = entries_.find(lru_.back());
+    ORT_ENFORCE(it != entries_.end());
+    total_bytes_ -= it->second.num_bytes;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+}  // namespace onnxruntime
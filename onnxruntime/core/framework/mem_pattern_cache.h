@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string_view>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+/**
+Policy that maps an input dimension to the bucket it belongs to when looking up cached memory patterns.
+Inputs whose dimensions fall into the same buckets share one cached MemoryPatternGroup.
+*/
+class MemoryPatternBucketPolicy {
+ public:
+  MemoryPatternBucketPolicy() = default;
+
+  /**
+  Parse a policy from its config string.
+  - "" or "exact": no bucketing, the cache is keyed on the exact input shapes.
+  - "pow2": dimensions are rounded up to the next power of two.
+  - comma separated list of increasing positive values, e.g. "16,32,64,128": dimensions are rounded up to the
+    smallest listed value that is not less than them. Dimensions larger than the last value are used as is.
+  */
+  static Status Parse(std::string_view config, MemoryPatternBucketPolicy& policy);
+
+  bool IsBucketed() const noexcept { return mode_ != Mode::kExact; }
+
+  int64_t GetBucket(int64_t dim) const;
+
+ private:
+  enum class Mode {
+    kExact,
+    kPowerOfTwo,
+    kList,
+  };
+
+  Mode mode_{Mode::kExact};
+  InlinedVector<int64_t> buckets_;
+};
+
+/**
+Cache of the memory patterns generated for the input shapes seen by a session.
+
+In the default exact mode an entry is inserted once per input shape key and is never replaced,
+which matches the original SessionState behavior.
+
+In bucketed mode the key is computed from the bucketed input dimensions so one planned layout is reused for
+every shape in a bucket. Each entry records the input dimensions its layout was traced for; a lookup with
+inputs that exceed any of those dimensions is treated as a miss so the caller traces a new layout, which then
+replaces the entry.
+
+In both modes, if a byte budget is set, the least recently used entries are evicted once the sum of the pattern
+peak sizes exceeds it. The most recently used entry is always kept.
+
+Entries are handed out as shared pointers so that eviction or replacement never invalidates a pattern that an
+in-flight ExecutionFrame is still using.
+
+Not thread-safe. SessionState serializes access.
+*/
+class MemoryPatternCache {
+ public:
+  using Key = size_t;
+
+  // max_bytes of 0 means the cache is unbounded.
+  MemoryPatternCache(MemoryPatternBucketPolicy policy, size_t max_bytes)
+      : policy_(std::move(policy)), max_bytes_(max_bytes) {}
+
+  bool IsBucketed() const noexcept { return policy_.IsBucketed(); }
+
+  // All inputs must be tensors.
+  Key CalculateKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  std::shared_ptr<const MemoryPatternGroup> Find(Key key, gsl::span<const OrtValue> tensor_inputs);
+
+  // Returns the cached entry for the key, which may be an existing one if it was not replaced.
+  std::shared_ptr<const MemoryPatternGroup> Insert(Key key, gsl::span<const OrtValue> tensor_inputs,
+                                                   MemoryPatternGroup mem_patterns);
+
+  size_t NumEntries() const noexcept { return entries_.size(); }
+
+  size_t TotalBytes() const noexcept { return total_bytes_; }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+ private:
+  struct Entry {
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    // flattened input dimensions the pattern covers. only used in bucketed mode.
+    InlinedVector<int64_t> dims;
+    size_t num_bytes{0};
+    std::list<Key>::iterator lru_it;
+  };
+
+  void Touch(Entry& entry);
+  void EvictIfNeeded();
+
+  const MemoryPatternBucketPolicy policy_;
+  const size_t max_bytes_;
+
+  InlinedHashMap<Key, Entry> entries_;
+  // most recently used entry is at the front
+  std::list<Key> lru_;
+  size_t total_bytes_{0};
+};
+
+}  // namespace onnxruntime
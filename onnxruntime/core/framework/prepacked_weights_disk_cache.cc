@@ -0,0 +1,267 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_disk_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout: magic, format version, number of buffers, (offset, size) of each buffer, padding, buffer data.
+// Each buffer starts at a multiple of kBufferAlignment from the start of the file.
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', 'C', '1'};
+constexpr uint64_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint64_t);
+constexpr uint64_t kMaxBuffers = 64;
+constexpr uint64_t kBufferAlignment = 64;
+
+uint64_t AlignUp(uint64_t value) {
+  return (value + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+// Accumulates the 128-bit hashes of the pieces of a key. Hashing each piece separately, rather than chaining a
+// 32-bit seed, keeps the full strength of the hash for the contents of large weights.
+class KeyHasher {
+ public:
+  void Add(const void* data, size_t length) {
+    // MurmurHash3 takes an int length
+    constexpr size_t kMaxChunk = size_t{1} << 30;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    do {
+      const size_t chunk = std::min(length, kMaxChunk);
+      uint32_t hash[4] = {0, 0, 0, 0};
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk), static_cast<uint32_t>(digest_.size()), hash);
+      digest_.append(reinterpret_cast<const char*>(hash), sizeof(hash));
+      bytes += chunk;
+      length -= chunk;
+    } while (length > 0);
+  }
+
+  void Add(const std::string& value) {
+    Add(value.size());
+    Add(value.data(), value.size());
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic_v<T>> Add(T value) {
+    Add(&value, sizeof(value));
+  }
+
+  std::string Finish() const {
+    uint32_t hash[4] = {0, 0, 0, 0};
+    MurmurHash3::x86_128(digest_.data(), static_cast<int>(digest_.size()), 0, hash);
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (auto h : hash) {
+      ss << std::setw(8) << h;
+    }
+    return ss.str();
+  }
+
+ private:
+  std::string digest_;
+};
+
+std::string CpuFeatures() {
+  const auto& cpuid = CPUIDInfo::GetCPUIDInfo();
+  std::string features;
+  // every feature that selects a different MLAS packing, e.g. the int8 kernels of SQNBitGemm pack B differently
+  // for AVX512-VNNI and AMX.
+  for (bool feature : {cpuid.HasSSE3(), cpuid.HasSSE4_1(), cpuid.HasAVX(), cpuid.HasAVX2(), cpuid.HasAVX_VNNI(),
+                       cpuid.HasAVX512f(), cpuid.HasAVX512Skylake(), cpuid.HasAVX512_VNNI(), cpuid.HasAVX512_BF16(),
+                       cpuid.HasAMX_BF16(), cpuid.HasAMX_INT8(), cpuid.HasF16C(),
+                       cpuid.HasArmNeonDot(), cpuid.HasArmNeon_I8MM(), cpuid.HasArmSVE_I8MM(),
+                       cpuid.HasArmNeon_BF16(), cpuid.HasFp16VectorAcceleration()}) {
+    features.push_back(feature ? '1' : '0');
+  }
+#if defined(MLAS_TARGET_AMD64_IX86)
+  // the AMX kernels also need the OS to grant the use of the tiles, the same CPU may use them or not.
+  features.push_back(MlasAMXKernelsSelected() ? '1' : '0');
+#endif
+  return features;
+}
+
+}  // namespace
+
+std::string PrePackedWeightsDiskCache::GenerateNodeKey(const Node& node,
+                                                       gsl::span<const Tensor* const> constant_inputs) {
+  if (node.ContainsSubgraph()) {
+    return {};
+  }
+
+  KeyHasher hasher;
+  hasher.Add(std::string(ORT_VERSION));
+  hasher.Add(kFormatVersion);
+  hasher.Add(sizeof(void*));
+  static const std::string cpu_features = CpuFeatures();
+  hasher.Add(cpu_features);
+
+  hasher.Add(node.OpType());
+  hasher.Add(node.Domain());
+  hasher.Add(node.SinceVersion());
+  hasher.Add(node.GetExecutionProviderType());
+
+  const auto& attributes = node.GetAttributes();
+  std::vector<const std::string*> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(&attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end(),
+            [](const std::string* a, const std::string* b) { return *a < *b; });
+  for (const auto* name : attribute_names) {
+    hasher.Add(*name);
+    hasher.Add(attributes.at(*name).SerializeAsString());
+  }
+
+  hasher.Add(constant_inputs.size());
+  for (const Tensor* tensor : constant_inputs) {
+    if (tensor == nullptr) {
+      hasher.Add(0);
+      continue;
+    }
+
+    if (tensor->IsDataTypeString()) {
+      return {};
+    }
+
+    hasher.Add(1);
+    hasher.Add(tensor->GetElementType());
+    const auto dims = tensor->Shape().GetDims();
+    hasher.Add(dims.size());
+    hasher.Add(dims.data(), dims.size_bytes());
+    hasher.Add(tensor->DataRaw(), tensor->SizeInBytes());
+  }
+
+  return hasher.Finish();
+}
+
+PathString PrePackedWeightsDiskCache::GetPath(const std::string& key) const {
+  return (std::filesystem::path(cache_dir_) / std::filesystem::path(ToPathString(key + ".ortpw"))).native();
+}
+
+bool PrePackedWeightsDiskCache::Load(const std::string& key, std::vector<BufferUniquePtr>& buffers,
+                                     std::vector<size_t>& buffer_sizes) {
+  buffers.clear();
+  buffer_sizes.clear();
+
+  const auto& env = Env::Default();
+  const PathString path = GetPath(key);
+
+  size_t file_length = 0;
+  if (!env.GetFileLength(path.c_str(), file_length).IsOK() || file_length < kHeaderSize) {
+    return false;
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  if (!env.MapFileIntoMemory(path.c_str(), 0, file_length, mapped_file).IsOK()) {
+    return false;
+  }
+
+  const char* data = mapped_file.get();
+  uint64_t format_version = 0;
+  uint64_t num_buffers = 0;
+  std::memcpy(&format_version, data + sizeof(kMagic), sizeof(format_version));
+  std::memcpy(&num_buffers, data + sizeof(kMagic) + sizeof(uint64_t), sizeof(num_buffers));
+  // the version is part of the key, a mismatch means the file was not written by this build for this key
+  if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0 || format_version != kFormatVersion ||
+      num_buffers > kMaxBuffers) {
+    return false;
+  }
+  const uint64_t header_size = kHeaderSize + num_buffers * 2 * sizeof(uint64_t);
+  if (header_size > file_length) {
+    return false;
+  }
+
+  const char* table = data + kHeaderSize;
+  for (uint64_t i = 0; i < num_buffers; ++i) {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    std::memcpy(&offset, table + (2 * i) * sizeof(uint64_t), sizeof(offset));
+    std::memcpy(&size, table + (2 * i + 1) * sizeof(uint64_t), sizeof(size));
+    if (offset < header_size || offset > file_length || size > file_length - offset) {
+      buffers.clear();
+      buffer_sizes.clear();
+      return false;
+    }
+
+    void* buffer = size == 0 ? nullptr : const_cast<char*>(data + offset);
+    buffers.emplace_back(buffer, BufferDeleter(nullptr));
+    buffer_sizes.push_back(static_cast<size_t>(size));
+  }
+
+  mapped_files_.push_back(std::move(mapped_file));
+  return true;
+}
+
+Status PrePackedWeightsDiskCache::Store(const std::string& key,
+                                        gsl::span<const gsl::span<const uint8_t>> buffers) const {
+  ORT_RETURN_IF(buffers.size() > kMaxBuffers, "Too many pre-packed buffers to persist: ", buffers.size());
+
+  const auto& env = Env::Default();
+  if (!env.FolderExists(cache_dir_)) {
+    ORT_RETURN_IF_ERROR(env.CreateFolder(cache_dir_));
+  }
+
+  const uint64_t num_buffers = buffers.size();
+  std::vector<uint64_t> table;
+  table.reserve(2 * buffers.size());
+  uint64_t offset = AlignUp(kHeaderSize + num_buffers * 2 * sizeof(uint64_t));
+  for (const auto& buffer : buffers) {
+    table.push_back(offset);
+    table.push_back(buffer.size());
+    offset = AlignUp(offset + buffer.size());
+  }
+
+  const PathString path = GetPath(key);
+  const PathString temp_path = path + ToPathString(".tmp" + std::to_string(env.GetSelfPid()));
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF(!file, "Failed to create ", PathToUTF8String(temp_path));
+
+    const char padding[kBufferAlignment] = {};
+    const uint64_t format_version = kFormatVersion;
+    file.write(kMagic, sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&format_version), sizeof(format_version));
+    file.write(reinterpret_cast<const char*>(&num_buffers), sizeof(num_buffers));
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(uint64_t));
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      const auto position = static_cast<uint64_t>(file.tellp());
+      file.write(padding, static_cast<std::streamsize>(table[2 * i] - position));
+      file.write(reinterpret_cast<const char*>(buffers[i].data()), static_cast<std::streamsize>(buffers[i].size()));
+    }
+
+    file.flush();
+    if (!file) {
+      file.close();
+      std::error_code ec;
+      std::filesystem::remove(temp_path, ec);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", PathToUTF8String(temp_path));
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, path, ec);
+  if (ec) {
+    std::filesystem::remove(temp_path, ec);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", PathToUTF8String(temp_path), " to ",
+                           PathToUTF8String(path), ": ", ec.message());
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
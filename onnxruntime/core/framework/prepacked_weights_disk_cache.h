@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+/**
+Directory of files holding the pre-packed buffers of the constant inputs of kernels, so that later sessions on the
+same machine can memory-map them instead of pre-packing the weights again.
+
+Each file holds the buffers of one input of one node. It is named after a 128-bit hash of everything the pre-packed
+state may depend on: the onnxruntime version, the format version, the CPU features, the operator and its attributes,
+the execution provider, and the type, shape and contents of all the constant inputs of the node. Files are written
+to a temporary name and renamed, so concurrent sessions never see a partial file.
+*/
+class PrePackedWeightsDiskCache {
+ public:
+  // Version of the pre-packed layouts of the kernels that persist their buffers. It must be incremented whenever
+  // one of those layouts changes, as builds with the same onnxruntime version would otherwise load each other's
+  // files. Files written with another version are not loaded.
+  static constexpr uint64_t kFormatVersion = 2;
+
+  explicit PrePackedWeightsDiskCache(PathString cache_dir) : cache_dir_(std::move(cache_dir)) {}
+
+  // Returns the key prefix shared by the inputs of `node`, or an empty string if the node cannot be cached.
+  // `constant_inputs` holds the constant initializer of each input of the node, nullptr for the other inputs.
+  // It must be called before any input of the node is pre-packed, as pre-packing may release the initializers.
+  static std::string GenerateNodeKey(const Node& node, gsl::span<const Tensor* const> constant_inputs);
+
+  static std::string GenerateKey(const std::string& node_key, int input_idx) {
+    return node_key + "_" + std::to_string(input_idx);
+  }
+
+  // Maps the buffers stored for `key` into memory. The buffers have a NULL deleter and remain valid for the lifetime
+  // of this instance. Returns false if there is no valid entry for the key.
+  bool Load(const std::string& key, std::vector<BufferUniquePtr>& buffers, std::vector<size_t>& buffer_sizes);
+
+  Status Store(const std::string& key, gsl::span<const gsl::span<const uint8_t>> buffers) const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrePackedWeightsDiskCache);
+
+ private:
+  PathString GetPath(const std::string& key) const;
+
+  const PathString cache_dir_;
+  std::vector<Env::MappedMemoryPtr> mapped_files_;
+};
+
+}  // namespace onnxruntime
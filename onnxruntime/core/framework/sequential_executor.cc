@@ -10,6 +10,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/critical_path_scheduler.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
@@ -578,16 +579,24 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  const auto* critical_path_schedule = session_state.GetCriticalPathSchedule();
+  if (critical_path_schedule && tp && !only_execute_path_to_fetches) {
+    ExecuteCriticalPathSchedule(*critical_path_schedule, ctx, session_scope, tp, terminate_flag);
+    // the schedule replaces the single valid stream
+    ctx.CompleteTask();
+  } else {
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [tp, i, &ctx, &terminate_flag, &session_scope]() {
+          concurrency::ThreadPool::InterOpTaskScope task_scope(tp);
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
   }
 
@@ -650,7 +659,8 @@ onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl
 
   for (size_t i = 0; i < plan->execution_plan.size(); ++i) {
     if (!plan->execution_plan[i]->steps_.empty()) {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+      concurrency::ThreadPool::Schedule(tp, [tp, i, &ctx, &terminate_flag, &session_scope]() {
+        concurrency::ThreadPool::InterOpTaskScope task_scope(tp);
         auto* range = ctx.GetCurrentRange();
         size_t start = !range ? 0 : range->stream_pc_range[i].first;
         RunSince(i, ctx, session_scope, terminate_flag, start);
@@ -3,10 +3,13 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -14,6 +17,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/static_mem_pattern_planner.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -61,6 +66,32 @@ class StreamCommandHandleRegistryImpl : public IStreamCommandHandleRegistry {
 };
 #endif
 
+static MemoryPatternCache CreateMemoryPatternCache(const SessionOptions& sess_options,
+                                                   const logging::Logger& logger) {
+  const auto& config_options = sess_options.config_options;
+  MemoryPatternBucketPolicy policy;
+  ORT_THROW_IF_ERROR(MemoryPatternBucketPolicy::Parse(
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternBuckets, ""), policy));
+#ifdef ENABLE_TRAINING
+  // the shapes inferred along with a memory pattern are only valid for the exact input shapes they were resolved for
+  if (policy.IsBucketed()) {
+    LOGS(logger, WARNING) << kOrtSessionOptionsConfigMemoryPatternBuckets
+                          << " is not supported in training builds. Memory patterns will use the exact input shapes.";
+    policy = MemoryPatternBucketPolicy{};
+  }
+#else
+  ORT_UNUSED_PARAMETER(logger);
+#endif
+
+  size_t max_bytes = 0;
+  const std::string max_bytes_str =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheMaxBytes, "0");
+  ORT_ENFORCE(TryParseStringWithClassicLocale(max_bytes_str, max_bytes),
+              "Invalid value for ", kOrtSessionOptionsConfigMemoryPatternCacheMaxBytes, ": ", max_bytes_str);
+
+  return MemoryPatternCache(std::move(policy), max_bytes);
+}
+
 SessionState::SessionState(Graph& graph,
                            const ExecutionProviders& execution_providers,
                            concurrency::ThreadPool* thread_pool,
@@ -76,6 +107,7 @@ SessionState::SessionState(Graph& graph,
       execution_providers_(execution_providers),
       logger_(logger),
       profiler_(profiler),
+      mem_patterns_(CreateMemoryPatternCache(sess_options, logger)),
       thread_pool_(thread_pool),
       inter_op_thread_pool_(inter_op_thread_pool),
       data_transfer_mgr_(data_transfer_mgr),
@@ -414,10 +446,50 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  const std::string prepacked_weights_cache_dir =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrePackedWeightsCacheDir, "");
+  if (!prepacked_weights_cache_dir.empty() && !prepacked_weights_disk_cache_) {
+    prepacked_weights_disk_cache_ = std::make_unique<PrePackedWeightsDiskCache>(ToPathString(prepacked_weights_cache_dir));
+  }
+
+  // returns the constant initialized tensor of `input_name` from this graph or the outer scope, or nullptr
+  auto find_constant_initializer = [this](const std::string& input_name) -> const Tensor* {
+    for (SessionState* st = this; st != nullptr; st = st->Parent()) {
+      int ort_value_idx;
+      if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+        auto it = st->constant_initialized_tensors_.find(ort_value_idx);
+        if (it != st->constant_initialized_tensors_.end()) {
+          return &it->second.Get<Tensor>();
+        }
+        if (st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+          break;
+        }
+      }
+    }
+    return nullptr;
+  };
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     &find_constant_initializer](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
+
+      // The key of the node in the on-disk cache covers the contents of all its constant inputs, so it has to be
+      // computed before pre-packing releases any of them.
+      std::string disk_cache_node_key;
+      InlinedVector<std::pair<int, std::string>> inputs_to_persist;
+      if (prepacked_weights_disk_cache_ && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        InlinedVector<const Tensor*> constant_inputs;
+        constant_inputs.reserve(node.InputDefs().size());
+        for (const auto* input_def : node.InputDefs()) {
+          constant_inputs.push_back(input_def->Exists() ? find_constant_initializer(input_def->Name()) : nullptr);
+        }
+        if (std::any_of(constant_inputs.begin(), constant_inputs.end(), [](const Tensor* t) { return t != nullptr; })) {
+          disk_cache_node_key = PrePackedWeightsDiskCache::GenerateNodeKey(node, constant_inputs);
+        }
+      }
+
       int input_idx = 0;
       for (auto& input_def : node.InputDefs()) {
         if (input_def->Exists()) {
@@ -495,12 +567,34 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                   }
 
                 } else {  // caching of pre-packed weights' turned OFF
-                  AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
-                                                      session_cpu_alloc,  // use allocator tied to this session
-                                                      is_packed,
-                                                      nullptr  // no caching required
-                                                      ));
+                  std::string disk_cache_key;
+                  if (!disk_cache_node_key.empty()) {
+                    disk_cache_key = PrePackedWeightsDiskCache::GenerateKey(disk_cache_node_key, input_idx);
+                    std::vector<BufferUniquePtr> persisted_buffers;
+                    std::vector<size_t> persisted_buffer_sizes;
+                    if (prepacked_weights_disk_cache_->Load(disk_cache_key, persisted_buffers, persisted_buffer_sizes)) {
+                      ORT_RETURN_IF_ERROR(kernel->UsePersistedPrePackedBuffers(persisted_buffers, persisted_buffer_sizes,
+                                                                               const_initialized_tensor, input_idx,
+                                                                               is_packed));
+                      if (is_packed) {
+                        LOGS(logger_, VERBOSE) << "Using persisted pre-packed weight for constant initializer: "
+                                               << input_name << " used in the node: " << node.Name();
+                        ++used_persisted_pre_packed_weights_counter_;
+                      }
+                    }
+                  }
+
+                  if (!is_packed) {
+                    AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
+                                                        session_cpu_alloc,  // use allocator tied to this session
+                                                        is_packed,
+                                                        nullptr  // no caching required
+                                                        ));
+                    if (is_packed && !disk_cache_key.empty()) {
+                      inputs_to_persist.emplace_back(input_idx, std::move(disk_cache_key));
+                    }
+                  }
                 }
                 if (is_packed) {
                   ++number_of_prepacks_counter_;
@@ -524,6 +618,19 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
         }
         input_idx++;
       }
+
+      // the pre-packed state of an input may include other inputs, so it is only complete once the whole node is done
+      for (const auto& [persisted_input_idx, disk_cache_key] : inputs_to_persist) {
+        std::vector<gsl::span<const uint8_t>> buffers;
+        ORT_RETURN_IF_ERROR(kernel->GetPrePackedBuffersToPersist(persisted_input_idx, buffers));
+        if (!buffers.empty()) {
+          auto status = prepacked_weights_disk_cache_->Store(disk_cache_key, buffers);
+          if (!status.IsOK()) {
+            LOGS(logger_, WARNING) << "Failed to persist the pre-packed weight of input " << persisted_input_idx
+                                   << " of the node: " << node.Name() << ". " << status.ErrorMessage();
+          }
+        }
+      }
     }
 
     return Status::OK();
@@ -541,14 +648,6 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -784,23 +883,36 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 #endif
 
 // MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// and is not updated if already present, unless memory pattern bucketing is enabled.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
     const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  if (static_mem_patterns_) {
+    bool matches_static_shapes = feed_mlvalue_idxs.size() == static_mem_patterns_input_shapes_.size();
+    for (size_t i = 0, end = feed_mlvalue_idxs.size(); matches_static_shapes && i < end; ++i) {
+      auto it = static_mem_patterns_input_shapes_.find(feed_mlvalue_idxs[i]);
+      matches_static_shapes = it != static_mem_patterns_input_shapes_.end() &&
+                              it->second == tensor_inputs[i].Get<Tensor>().Shape();
+    }
+
+    if (matches_static_shapes) {
+      return static_mem_patterns_;
+    }
+  }
+
+  const auto key = mem_patterns_.CalculateKey(tensor_inputs);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  auto mem_patterns = mem_patterns_.Find(key, tensor_inputs);
+  if (!mem_patterns) {
 #ifdef ENABLE_TRAINING
-    MemoryPatternGroup mem_patterns;
+    MemoryPatternGroup generated_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
+    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, generated_patterns, inferred_shapes).IsOK()) {
+      auto ptr = mem_patterns_.Insert(key, tensor_inputs, std::move(generated_patterns));
+      // the inferred shapes are not replaced if present as a pointer to them may be held by an execution frame.
+      auto shape_insert = shape_patterns_.try_emplace(key, std::move(inferred_shapes));
       out_inferred_shapes = &shape_insert.first->second;
       return ptr;
     }
@@ -814,7 +926,7 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
   if (patt_hit != shape_patterns_.cend()) {
     out_inferred_shapes = &patt_hit->second;
   }
-  return &it->second;
+  return mem_patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -865,11 +977,158 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  const auto key = mem_patterns_.CalculateKey(tensor_inputs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  mem_patterns_.Insert(key, tensor_inputs, std::move(mem_patterns));
+  return Status::OK();
+}
+
+Status SessionState::PlanStaticMemoryPatterns() {
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStaticMemoryPlan, "0") != "1" ||
+      !enable_mem_pattern_ || graph_viewer_->ParentNode() != nullptr) {
+    return Status::OK();
+  }
+
+  const auto* exe_plan = GetExecutionPlan();
+  ORT_RETURN_IF_NOT(exe_plan, "Execution plan must be created before planning static memory patterns.");
+
+  // the execution order, and with it the lifetime of each buffer, is only fixed if there is a single stream.
+  const SequentialExecutionPlan::LogicStream* stream = nullptr;
+  for (const auto& logic_stream : exe_plan->execution_plan) {
+    if (logic_stream->steps_.empty()) {
+      continue;
+    }
+    if (stream != nullptr) {
+      LOGS(logger_, INFO) << "[Static memory planning] Skipped as the execution plan has multiple streams.";
+      return Status::OK();
+    }
+    stream = logic_stream.get();
+  }
+
+  if (stream == nullptr) {
+    return Status::OK();
+  }
+
+  auto get_static_shape = [](const NodeArg& arg, TensorShape& shape) {
+    const auto* shape_proto = arg.Shape();
+    if (!shape_proto) {
+      return false;
+    }
+    TensorShapeVector dims;
+    dims.reserve(shape_proto->dim_size());
+    for (const auto& dim : shape_proto->dim()) {
+      if (!dim.has_dim_value() || dim.dim_value() < 0) {
+        return false;
+      }
+      dims.push_back(dim.dim_value());
+    }
+    shape = TensorShape(dims);
+    return true;
+  };
+
+  InlinedHashMap<int, TensorShape> input_shapes;
+  input_shapes.reserve(graph_viewer_->GetInputs().size());
+  for (const auto* input : graph_viewer_->GetInputs()) {
+    int idx = 0;
+    TensorShape shape;
+    if (!ort_value_name_idx_map_.GetIdx(input->Name(), idx).IsOK()) {
+      continue;
+    }
+    if (!get_static_shape(*input, shape)) {
+      LOGS(logger_, INFO) << "[Static memory planning] Skipped as the shape of graph input " << input->Name()
+                          << " is not static.";
+      return Status::OK();
+    }
+    input_shapes.emplace(idx, std::move(shape));
+  }
+
+  // replay the execution order to find the step each buffer is allocated and released at.
+  // a value is released after the node that drops its reference count to zero, the same way the executor does it.
+  struct Lifetime {
+    size_t size{0};
+    size_t start{0};
+    size_t end{std::numeric_limits<size_t>::max()};
+  };
+  InlinedHashMap<int, Lifetime> lifetimes;
+  InlinedVector<size_t> release_counts(exe_plan->release_actions.size(), 0);
+  InlinedHashSet<NodeIndex> visited_nodes;
+  size_t step = 0;
+
+  for (const auto& execution_step : stream->steps_) {
+    const NodeIndex node_index = execution_step->GetNodeIndex();
+    const Node* node = graph_viewer_->GetNode(node_index);
+    if (node == nullptr || !visited_nodes.insert(node_index).second) {
+      continue;
+    }
+
+    for (const auto* output : node->OutputDefs()) {
+      int idx = 0;
+      if (!output->Exists() || !ort_value_name_idx_map_.GetIdx(output->Name(), idx).IsOK()) {
+        continue;
+      }
+
+      const auto& alloc_plan = exe_plan->allocation_plan[idx];
+      if (alloc_plan.alloc_kind != AllocKind::kAllocate || !alloc_plan.value_type ||
+          !alloc_plan.value_type->IsTensorType()) {
+        continue;
+      }
+
+      const auto* element_type = static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType();
+      // string tensors are never placed in a memory pattern buffer
+      if (utils::IsDataTypeString(element_type)) {
+        continue;
+      }
+
+      TensorShape shape;
+      if (!get_static_shape(*output, shape)) {
+        LOGS(logger_, INFO) << "[Static memory planning] Skipped as the shape of " << output->Name()
+                            << " is not static.";
+        return Status::OK();
+      }
+
+      Lifetime lifetime;
+      ORT_RETURN_IF_ERROR(Tensor::CalculateTensorStorageSize(element_type, shape, kAllocAlignment, lifetime.size));
+      lifetime.start = step;
+      lifetimes.insert_or_assign(idx, lifetime);
+    }
+
+    if (node_index < exe_plan->node_release_list.size()) {
+      for (auto release_action_idx : exe_plan->node_release_list[node_index]) {
+        const auto& action = exe_plan->release_actions[release_action_idx];
+        if (++release_counts[release_action_idx] != action.ref_count) {
+          continue;
+        }
+        auto it = lifetimes.find(static_cast<int>(action.value_index));
+        if (it != lifetimes.end()) {
+          it->second.end = step;
+        }
+      }
+    }
+
+    ++step;
+  }
+
+  // values that are never released stay alive until the end of the run
+  NodeHashMap<OrtDevice, StaticMemPatternPlanner> planners;
+  for (const auto& [idx, lifetime] : lifetimes) {
+    planners[exe_plan->GetLocation(idx)].AddBuffer(idx, lifetime.size, lifetime.start,
+                                                   std::min(lifetime.end, step));
+  }
+
+  MemoryPatternGroup mem_patterns;
+  mem_patterns.locations.reserve(planners.size());
+  mem_patterns.patterns.reserve(planners.size());
+  for (const auto& [location, planner] : planners) {
+    mem_patterns.locations.push_back(location);
+    mem_patterns.patterns.push_back(planner.GenerateMemPattern());
+    LOGS(logger_, INFO) << "[Static memory planning] Planned " << planner.NumBuffers() << " buffers on "
+                        << location.ToString() << " with a peak size of " << mem_patterns.patterns.back().PeakSize()
+                        << " bytes.";
+  }
+
+  static_mem_patterns_ = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+  static_mem_patterns_input_shapes_ = std::move(input_shapes);
   return Status::OK();
 }
 
@@ -1109,6 +1368,27 @@ static void ComputeConstantInitializerUseCount(const Graph& graph, InlinedHashMa
   }
 }
 
+// Names and data sizes of the initializers of the graph that are stored in external files.
+static InlinedVector<std::pair<std::string, size_t>> GetExternalFileInitializers(
+    const GraphViewer& graph_viewer, const std::basic_string<PATH_CHAR_TYPE>& graph_location) {
+  InlinedVector<std::pair<std::string, size_t>> initializers;
+  for (const auto& entry : graph_viewer.GetAllInitializedTensors()) {
+    if (!utils::HasExternalData(*entry.second)) {
+      continue;
+    }
+
+    std::basic_string<ORTCHAR_T> file_path;
+    FileOffsetType offset = 0;
+    size_t length = 0;
+    // fails for data kept in memory, which is not loaded from a file.
+    if (utils::GetExtDataFileLocationFromTensorProto(graph_location, *entry.second, file_path, offset, length)
+            .IsOK()) {
+      initializers.emplace_back(entry.first, length);
+    }
+  }
+  return initializers;
+}
+
 using NodePlacementMap = std::unordered_map<std::string, std::vector<std::string>>;
 using NodePlacementSet = std::unordered_set<std::string>;
 
@@ -1394,9 +1674,15 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  // only the main graph is scheduled by critical path, see below
+  const bool critical_path_scheduling =
+      parent_node == nullptr && session_options.execution_mode == ExecutionMode::ORT_PARALLEL &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCriticalPathScheduling, "0") == "1";
+
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   critical_path_scheduling);
 
 #ifdef _WIN32
 
@@ -1425,6 +1711,19 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+  if (critical_path_scheduling) {
+    critical_path_schedule_ = CriticalPathSchedule::Create(*graph_viewer_, *p_seq_exec_plan_);
+    if (!critical_path_schedule_) {
+      LOGS(logger_, INFO) << kOrtSessionOptionsConfigCriticalPathScheduling
+                          << " is ignored as the execution plan does not consist of a single CPU stream.";
+    } else if (enable_mem_pattern_) {
+      // memory patterns, including the static one, place buffers assuming the nodes run one after the other in
+      // the order of the plan. the scheduled nodes run out of order and concurrently.
+      LOGS(logger_, INFO) << "Memory pattern optimization is disabled as the nodes are scheduled by critical path.";
+      enable_mem_pattern_ = false;
+    }
+  }
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1491,6 +1790,16 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  // The initializers stored in files are read or memory-mapped when they are saved. Only this step is timed, creating
+  // the kernels and prepacking the weights would add their own CPU time to it. The initializers are listed first as
+  // the graph may drop them while they are saved.
+  const auto external_initializers = GetExternalFileInitializers(*graph_viewer_, graph_location);
+  const auto load_start_time = std::chrono::steady_clock::now();
+  TimePoint load_tp;
+  if (!external_initializers.empty() && profiler_.IsEnabled()) {
+    load_tp = profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1507,6 +1816,43 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
           logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, session_options,
           memory_profile_func, name_to_buffered_tensor_));
 
+  if (!external_initializers.empty()) {
+    const double load_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start_time).count();
+
+    // The data copied to a device was read above. The data of initializers kept on CPU is only memory-mapped, its
+    // pages are read when the kernels use them, so it is left out of the throughput.
+    size_t read_bytes = 0;
+    size_t mapped_bytes = 0;
+    for (const auto& [name, length] : external_initializers) {
+      int idx;
+      if (!ort_value_name_idx_map_.GetIdx(name, idx).IsOK()) {
+        continue;
+      }
+      auto it = initialized_tensors_.find(idx);
+      if (it == initialized_tensors_.end() || !it->second.IsTensor()) {
+        continue;
+      }
+      if (it->second.Get<Tensor>().Location().device.Type() == OrtDevice::CPU) {
+        mapped_bytes += length;
+      } else {
+        read_bytes += length;
+      }
+    }
+
+    const double read_mb = read_bytes / (1024.0 * 1024.0);
+    const double read_mb_per_s = load_ms > 0 ? read_mb / (load_ms / 1000.0) : 0.0;
+    LOGS(logger_, INFO) << "Loaded external initializer data in " << load_ms << " ms: read " << read_mb << " MB ("
+                        << read_mb_per_s << " MB/s), memory-mapped " << mapped_bytes / (1024.0 * 1024.0) << " MB.";
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "external_initializers_load", load_tp,
+                                      {{"read_bytes", std::to_string(read_bytes)},
+                                       {"mapped_bytes", std::to_string(mapped_bytes)},
+                                       {"load_ms", std::to_string(load_ms)},
+                                       {"read_mb_per_s", std::to_string(read_mb_per_s)}});
+    }
+  }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
   GetMemoryProfiler()->GetMemoryInfo().RecordInitializerAllocInfo(GetInitializedTensors());
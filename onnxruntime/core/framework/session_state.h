@@ -19,6 +19,7 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
+#include "core/framework/critical_path_scheduler.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/external_data_loader_manager.h"
 #include "core/framework/execution_providers.h"
@@ -26,9 +27,11 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_disk_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -224,8 +227,10 @@ class SessionState {
   made under mutex being held. In inference scenarios,
   it is not mutable, we do not obtain a lock and simply get a pointer
   w/o copying a hashtable
+  The returned pattern is shared so it stays valid if the cache evicts or replaces it
+  while the caller is still using it.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
@@ -245,6 +250,12 @@ class SessionState {
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Whether cached memory patterns are shared by all input shapes that fall into the same bucket.
+  In that case a tensor may be placed in a pattern block that is larger than it needs.
+  */
+  bool IsMemoryPatternBucketingEnabled() const { return mem_patterns_.IsBucketed(); }
+
   /**
   Get enable memory re-use flag.
   */
@@ -257,6 +268,14 @@ class SessionState {
   */
   void ResolveMemoryPatternFlag();
 
+  /**
+  Plan the activation memory of the graph ahead of time if kOrtSessionOptionsConfigStaticMemoryPlan is enabled
+  and the shapes of the graph inputs and all planned activations are static.
+  The planned pattern is used by GetMemoryPatternGroup for feeds that match the static input shapes.
+  Must be called after ResolveMemoryPatternFlag. Does nothing if the graph does not qualify.
+  */
+  Status PlanStaticMemoryPatterns();
+
   struct NodeInfo {
     /**
      *
@@ -295,6 +314,12 @@ class SessionState {
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
+  /**
+  Get the schedule used to run the nodes out of order in parallel execution mode.
+  nullptr if kOrtSessionOptionsConfigCriticalPathScheduling is not enabled or the execution plan is not supported.
+  */
+  const CriticalPathSchedule* GetCriticalPathSchedule() const noexcept { return critical_path_schedule_.get(); }
+
   const FuncManager& GetFuncMgr() const noexcept { return fused_funcs_mgr_; }
   FuncManager& GetMutableFuncMgr() noexcept { return fused_funcs_mgr_; }
 
@@ -335,6 +360,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedPersistedPrePackedWeightCounter() const {
+    return used_persisted_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -485,6 +514,8 @@ class SessionState {
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
 
+  std::unique_ptr<CriticalPathSchedule> critical_path_schedule_;
+
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
 
@@ -497,17 +528,22 @@ class SessionState {
 
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
+  // cache for the generated mem_patterns. key is calculated based on (optionally bucketed) input shapes.
+  mutable MemoryPatternCache mem_patterns_;
   // This is mutable under mutex in training scenarios so execution frame would make a copy
   // of the value when created.
+  // must be a node based container as a pointer is cached.
 #ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
+  mutable NodeHashMap<MemoryPatternCache::Key, InlinedHashMap<int, TensorShape>> shape_patterns_;
 #else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
+  NodeHashMap<MemoryPatternCache::Key, InlinedHashMap<int, TensorShape>> shape_patterns_;
 #endif
 
+  // memory pattern planned ahead of time by PlanStaticMemoryPatterns and the graph input shapes it was planned for.
+  // immutable once the session is initialized.
+  std::shared_ptr<const MemoryPatternGroup> static_mem_patterns_;
+  InlinedHashMap<int, TensorShape> static_mem_patterns_input_shapes_;
+
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
 
@@ -531,6 +567,10 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // On-disk cache of the pre-packed weights of the CPU kernels. Created during pre-packing if
+  // kOrtSessionOptionsConfigPrePackedWeightsCacheDir is set, and kept alive as kernels may use the mapped buffers.
+  std::unique_ptr<PrePackedWeightsDiskCache> prepacked_weights_disk_cache_;
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -561,6 +601,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times the pre-packed weight of a constant initialized weight was restored from the
+  // on-disk cache instead of being pre-packed
+  size_t used_persisted_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_mem_pattern_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+void StaticMemPatternPlanner::AddBuffer(int ml_value_idx, size_t size, size_t start, size_t end) {
+  ORT_ENFORCE(start <= end, "Invalid lifetime for OrtValue ", ml_value_idx, ": [", start, ", ", end, "]");
+  buffers_.push_back({ml_value_idx, size, start, end});
+}
+
+MemoryPattern StaticMemPatternPlanner::GenerateMemPattern() const {
+  // place the largest buffers first. ties are broken by start step and then index so the result is deterministic.
+  std::vector<size_t> order(buffers_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+
+  std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+    const auto& a = buffers_[lhs];
+    const auto& b = buffers_[rhs];
+    if (a.size != b.size) return a.size > b.size;
+    if (a.start != b.start) return a.start < b.start;
+    return a.index < b.index;
+  });
+
+  MemoryPattern pattern;
+  pattern.patterns_.reserve(buffers_.size());
+
+  std::vector<size_t> placed;
+  placed.reserve(buffers_.size());
+  std::vector<MemoryBlock> live_blocks;
+
+  for (auto buffer_idx : order) {
+    const auto& buffer = buffers_[buffer_idx];
+    if (buffer.size == 0) {
+      pattern.patterns_.insert_or_assign(buffer.index, MemoryBlock(0, 0));
+      continue;
+    }
+
+    // blocks of the already placed buffers that are live at the same time as this one
+    live_blocks.clear();
+    for (auto placed_idx : placed) {
+      const auto& other = buffers_[placed_idx];
+      if (other.start <= buffer.end && buffer.start <= other.end) {
+        live_blocks.push_back(pattern.patterns_[other.index]);
+      }
+    }
+    std::sort(live_blocks.begin(), live_blocks.end());
+
+    size_t current = 0;
+    size_t waste_bytes = std::numeric_limits<size_t>::max();
+    size_t best_offset = 0;
+    bool best_offset_found = false;
+    for (const auto& block : live_blocks) {
+      if (block.offset_ > current) {
+        auto gap = block.offset_ - current;
+        if (gap >= buffer.size && (gap - buffer.size) < waste_bytes) {
+          waste_bytes = gap - buffer.size;
+          best_offset = current;
+          best_offset_found = true;
+        }
+      }
+      current = std::max(current, block.offset_ + block.size_);
+    }
+
+    if (!best_offset_found) {
+      best_offset = current;
+    }
+
+    const size_t end_offset = SafeInt<size_t>(best_offset) + buffer.size;
+    pattern.peak_size_ = std::max(pattern.peak_size_, end_offset);
+    pattern.patterns_.insert_or_assign(buffer.index, MemoryBlock(best_offset, buffer.size));
+    placed.push_back(buffer_idx);
+  }
+
+  return pattern;
+}
+
+}  // namespace onnxruntime
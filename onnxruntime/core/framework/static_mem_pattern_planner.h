@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+
+namespace onnxruntime {
+
+// StaticMemPatternPlanner computes a memory pattern ahead of time from buffer lifetimes that are fully known
+// before execution, instead of tracing the allocations and frees of a run like MemPatternPlanner does.
+//
+// Buffers are placed in decreasing order of size. Each buffer goes into the smallest gap between the already placed
+// buffers whose lifetimes overlap with its own, or above all of them if no gap is large enough.
+// Not thread-safe.
+class StaticMemPatternPlanner {
+ public:
+  StaticMemPatternPlanner() = default;
+
+  // Add a buffer that is live from execution step `start` to execution step `end`, both inclusive.
+  void AddBuffer(int ml_value_idx, size_t size, size_t start, size_t end);
+
+  size_t NumBuffers() const noexcept { return buffers_.size(); }
+
+  MemoryPattern GenerateMemPattern() const;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StaticMemPatternPlanner);
+
+ private:
+  struct Buffer {
+    int index;
+    size_t size;
+    size_t start;
+    size_t end;
+  };
+
+  std::vector<Buffer> buffers_;
+};
+
+}  // namespace onnxruntime
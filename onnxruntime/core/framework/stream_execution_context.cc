@@ -254,7 +254,8 @@ void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single
     for (auto downstream : it->second) {
       // increase the task count before schedule down-stream
       ctx.AddTask();
-      concurrency::ThreadPool::Schedule(tp, [&ctx, downstream, &terminate_flag, &session_scope]() {
+      concurrency::ThreadPool::Schedule(tp, [tp, &ctx, downstream, &terminate_flag, &session_scope]() {
+        concurrency::ThreadPool::InterOpTaskScope task_scope(tp);
         RunSince(downstream.first, ctx, session_scope, terminate_flag, downstream.second);
       });
     }
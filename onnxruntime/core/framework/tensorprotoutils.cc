@@ -1048,6 +1048,24 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
   return Status::OK();
 }
 
+Status GetExtDataFileLocationFromTensorProto(const std::filesystem::path& model_path,
+                                             const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                             std::basic_string<ORTCHAR_T>& external_file_path,
+                                             FileOffsetType& file_offset, size_t& length) {
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (!model_path.empty()) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_path, tensor_proto_dir));
+  }
+  SafeInt<size_t> raw_data_safe_len = 0;
+  ORT_RETURN_IF_ERROR(
+      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset, raw_data_safe_len));
+  ORT_RETURN_IF(external_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag,
+                "External initializer: ", tensor_proto.name(), " is in memory and not in a file.");
+  ORT_RETURN_IF(file_offset < 0, "External initializer: ", tensor_proto.name(), " has a negative offset.");
+  length = raw_data_safe_len;
+  return Status::OK();
+}
+
 Status LoadExtDataToTensorFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                           const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                           const IExternalDataLoader& ext_data_loader,
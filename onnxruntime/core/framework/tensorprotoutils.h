@@ -160,6 +160,14 @@ common::Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::
                                          OrtCallback& ext_data_deleter,
                                          Tensor* buffered_tensor = nullptr);
 
+// Given a tensor proto with external data in a file obtain the path of the file, resolved relative to the directory
+// of model_path, and the offset and length of the data in the file.
+// Fails if the external data location is kTensorProtoMemoryAddressTag.
+common::Status GetExtDataFileLocationFromTensorProto(const std::filesystem::path& model_path,
+                                                     const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                     std::basic_string<ORTCHAR_T>& external_file_path,
+                                                     FileOffsetType& file_offset, size_t& length);
+
 // Given a tensor proto with external data obtain a tensor using the specified custom external data loader.
 common::Status LoadExtDataToTensorFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                                   const ONNX_NAMESPACE::TensorProto& tensor_proto,
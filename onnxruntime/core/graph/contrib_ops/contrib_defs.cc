@@ -3495,6 +3495,48 @@ Input zero_points is stored as uint8_t or same as type(A). It has the same packi
         }
       });
 
+  static const char* MatMulNBitsSiluMul_ver1_doc = R"DOC(
+MatMulNBitsSiluMul computes the gated MLP activation of a Llama-style feed forward block in one op:
+  Y = SiLU(A * gate^T) * (A * up^T), where SiLU(x) = x * Sigmoid(x).
+Input B holds the gate and up projection weights concatenated along N, so the first N/2 output features of the
+matrix multiplication are the gate values and the last N/2 are the up values. The quantized inputs B, scales,
+zero_points and the optional bias use the same layout as MatMulNBits, and the bias is added before the activation.
+The output has N/2 features. This op is produced by graph optimizations from two MatMulNBits nodes sharing input A.
+)DOC";
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBitsSiluMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(MatMulNBitsSiluMul_ver1_doc)
+      .Attr("K", "size of each input feature", AttributeProto::INT)
+      .Attr("N", "size of the concatenated gate and up output features. It must be even.", AttributeProto::INT)
+      .Attr("bits", "number of bits used for weight quantization (default 4)", AttributeProto::INT)
+      .Attr("block_size", "number of groupsize used for weight quantization,(default 128). It needs to be a power of 2 and not smaller than 16.", AttributeProto::INT)
+      .Attr("accuracy_level",
+            "The minimum accuracy level of input A, can be: 0(unset), 1(fp32), 2(fp16), 3(bf16), or 4(int8) "
+            "(default unset). See MatMulNBits.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "A", "The input tensor, not quantized", "T1")
+      .Input(1, "B", "1 or 2 dimensional data blob of the concatenated gate and up weights", "T2")
+      .Input(2, "scales", "quantization scale", "T1")
+      .Input(3, "zero_points", "quantization zero points", "T3", OpSchema::Optional)
+      .Input(4, "g_idx", "group_idx", "T4", OpSchema::Optional)
+      .Input(5, "bias", "Bias to add to the matrix multiplication result. It should have shape [N].", "T1", OpSchema::Optional)
+      .Output(0, "Y", "tensor. The output tensor has the same rank as the input, with N/2 output features. ", "T1")
+      .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float/half_float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)", "tensor(int32)"}, "Constrain quantized weight types to uint8/int32.")
+      .TypeConstraint("T3", {"tensor(uint8)", "tensor(int32)", "tensor(float16)", "tensor(float)"}, "Constrain quantized zero point types to uint8/int32/float16/float.")
+      .TypeConstraint("T4", {"tensor(int32)"}, "the index tensor.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        int64_t in_features = getAttribute(ctx, "K", -1);
+        int64_t out_features = getAttribute(ctx, "N", -1);
+        if (out_features % 2 != 0) {
+          fail_shape_inference("N must be even, got ", out_features);
+        }
+        MatmulWithQuantWeightShapeInference(ctx, in_features, out_features / 2, true);
+      });
+
   static const char* MatMulBnb4_ver1_doc = R"DOC(
 MatMulBnb4 is a MatMul with weight quantized with 4 bits using either FP4 or NF4 data type (https://arxiv.org/pdf/2305.14314.pdf). It does Matrix Multiplication like MatMul (https://github.com/onnx/onnx/blob/main/docs/Operators.md#matmul) with differences:
   1. Input B is a 2D constant Matrix. Its input feature count and output feature count are specified by attribute 'K' and 'N'.
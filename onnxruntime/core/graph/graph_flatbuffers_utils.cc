@@ -58,6 +58,9 @@ Status SaveInitializerOrtFormat(flatbuffers::FlatBufferBuilder& builder,
       ORT_RETURN_IF_ERROR(external_writer(src_type, unpacked_tensor, offset));
       external_data_offset = onnxruntime::narrow<int64_t>(offset);  // offset in fb is int64_t so -1 can mark not in use
     } else {
+      if (unpacked_tensor.size() >= kMinimumSizeForInPlaceRawData) {
+        builder.ForceVectorAlignment(unpacked_tensor.size(), sizeof(uint8_t), kInPlaceRawDataAlignment);
+      }
       raw_data = builder.CreateVector(unpacked_tensor.data(), unpacked_tensor.size());
     }
   }
@@ -274,6 +277,19 @@ size_t GetSizeInBytesFromFbsTensor(const fbs::Tensor& tensor) {
   return num_elements * byte_size_of_one_element;
 }
 
+// Models saved by older versions do not align the raw data of initializers beyond the 4 bytes of the flatbuffer
+// vector length, so only use the data in place if it is aligned for the element type. The element size is derived
+// from the data size, which also covers the packed 4-bit types.
+static bool IsRawDataAlignedForInPlaceUse(const fbs::Tensor& fbs_tensor,
+                                          const flatbuffers::Vector<uint8_t>& fbs_raw_data) {
+  const auto* fbs_dims = fbs_tensor.dims();
+  const size_t num_elements = std::accumulate(fbs_dims->cbegin(), fbs_dims->cend(), SafeInt<size_t>(1),
+                                              std::multiplies<>());
+  const size_t element_size = num_elements > 0 ? std::max<size_t>(fbs_raw_data.size() / num_elements, 1) : 1;
+  const size_t alignment = std::min<size_t>(element_size, alignof(std::max_align_t));
+  return reinterpret_cast<uintptr_t>(fbs_raw_data.Data()) % alignment == 0;
+}
+
 Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& initializer,
                                 const OrtFormatLoadOptions& load_options,
                                 const ExternalDataReader& external_data_reader) {
@@ -299,7 +315,8 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
   } else {
     const auto* fbs_raw_data = fbs_tensor.raw_data();
     if (fbs_raw_data) {
-      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127) {
+      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() >= kMinimumSizeForInPlaceRawData &&
+          IsRawDataAlignedForInPlaceUse(fbs_tensor, *fbs_raw_data)) {
         initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
 
         static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
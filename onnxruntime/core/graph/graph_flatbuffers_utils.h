@@ -61,6 +61,19 @@ using ExternalDataReader = std::function<Status(uint64_t offset, gsl::span<uint8
 /// </remarks>
 constexpr uint32_t kMinimumSizeForExternalData = 64;
 
+/// <summary>
+/// Minimum number of bytes for the raw data of an initializer to be used in place when loading with
+/// OrtFormatLoadOptions::can_use_flatbuffer_for_initializers.
+/// </summary>
+constexpr uint32_t kMinimumSizeForInPlaceRawData = 128;
+
+/// <summary>
+/// Alignment, relative to the start of the flatbuffer, of the raw data of initializers that can be used in place.
+/// The data of a memory-mapped ORT format model is then suitably aligned for any tensor element type and for
+/// vectorized kernels.
+/// </summary>
+constexpr uint32_t kInPlaceRawDataAlignment = 64;
+
 /// <summary>
 /// Save an initializer to an ORT format flatbuffer.
 /// </summary>
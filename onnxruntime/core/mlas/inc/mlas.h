@@ -95,6 +95,19 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Bfloat16 precision GEMM (SBGEMM) is implemented with the BF16 extension on
+// ARM64 and with AVX512-BF16 and AMX-BF16 on x64. The x64 kernels require a
+// compiler that supports the AVX512-BF16 intrinsics.
+//
+
+#if defined(__linux__)
+#if defined(MLAS_TARGET_ARM64) || \
+    (defined(MLAS_TARGET_AMD64) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 10))))
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -147,6 +160,17 @@ MlasPlatformU8S8Overflow(
     void
     );
 
+/**
+ * @brief Return whether the AMX kernels were selected. They pack weights in
+ *        their own layout and are only selected when the OS grants the
+ *        process the use of the AMX tiles, which the CPUID bits do not tell.
+*/
+bool
+MLASCALL
+MlasAMXKernelsSelected(
+    void
+    );
+
 #endif
 
 
@@ -978,6 +1002,44 @@ MlasMaximumPool(
     size_t KernelSize
     );
 
+//
+// Reduction routines.
+//
+
+enum MLAS_REDUCTION_KIND {
+    MlasSumReduction,
+    MlasMeanReduction,
+    MlasMaximumReduction,
+    MlasMinimumReduction,
+    MlasLogSumExpReduction,
+    MlasReductionKindCount,
+};
+
+/**
+ * @brief Reduce the middle axis of a tensor viewed as [OuterCount, ReduceCount, InnerCount].
+ *        The output has shape [OuterCount, InnerCount]. When InnerCount is 1 the
+ *        reduced elements are contiguous, otherwise they are InnerCount elements apart.
+ *
+ * @param ReductionKind  Reduction to compute
+ * @param Input          Input tensor
+ * @param Output         Output tensor, must not overlap Input
+ * @param OuterCount     Number of independent reductions of ReduceCount x InnerCount elements
+ * @param ReduceCount    Number of elements to reduce, must not be zero
+ * @param InnerCount     Number of adjacent columns reduced together
+ * @param ThreadPool     Optional thread pool
+*/
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCTION_KIND ReductionKind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -1435,12 +1497,57 @@ MLAS_FP16* Destination,
 size_t Count
 );
 
+/**
+ * @brief Normalizes one row of LayerNormalization or SimplifiedLayerNormalization
+ *        (RMSNorm), optionally fused with the residual add of SkipLayerNormalization:
+ *            Output = (Input + Skip + SkipBias - Mean) * InvStdDev * Scale + Bias
+ *        Half precision rows are converted to single precision internally.
+ *
+ * @param Input       Row of NormSize elements
+ * @param Skip        Optional row added to Input
+ * @param SkipBias    Optional bias added to Input
+ * @param Scale       Scale (gamma) of NormSize elements
+ * @param Bias        Optional bias (beta), ignored when Simplified is set
+ * @param Output      Normalized row
+ * @param SkipOutput  Optional row receiving Input + Skip + SkipBias
+ * @param NormSize    Number of elements of the row
+ * @param Epsilon     Value added to the variance
+ * @param Simplified  Whether to compute the RMS normalization, which does not subtract the mean
+ * @param Mean        Optional, receives the mean of the row
+ * @param InvStdDev   Optional, receives the inverse standard deviation of the row
+*/
+template <typename T>
+void
+MLASCALL
+MlasLayerNormalization(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t NormSize,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
     /**
  * @brief Whether current CPU supports FP16 acceleration.
 */
 bool MLASCALL
 MlasFp16AccelerationSupported();
 
+/**
+ * @brief Whether MlasHalfGemmBatch has a vectorized kernel on the current CPU.
+ *        Besides the ARM64 fp16 vector intrinsics, this is true on x64 when
+ *        F16C or AVX512-FP16 is available.
+*/
+bool MLASCALL
+MlasHalfGemmSupported();
+
 /**
  * @brief Interface for half gemm post processors.
  *
@@ -1643,7 +1750,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1838,19 +1945,33 @@ MlasNhwcAvgPool(
 
 #endif
 
+//
+// Arguments of the fp32 Flash Attention. The query has shape
+// (batch_size, num_heads, q_sequence_length, qk_head_size) with batches
+// query_batch_stride elements apart, the key and value have shape
+// (batch_size, kv_num_heads, kv_sequence_length, head_size) and the output has
+// shape (batch_size, q_sequence_length, num_heads, v_head_size). Query heads
+// are grouped over the key and value heads as in grouped query attention.
+//
 struct MlasFlashAttentionThreadedArgs {
     int batch_size;
     int num_heads;
+    int kv_num_heads;                   // num_heads must be a multiple of kv_num_heads
     int q_sequence_length;
-    int kv_sequence_length;
+    int kv_sequence_length;             // sequence length of the K and V buffers
     int qk_head_size;
     int v_head_size;
     int q_block_size;
     int kv_block_size;
     float scale;
+    float softcap;                      // 0 to disable
+    bool is_causal;                     // query i attends to key positions <= i + (kv_length - q_sequence_length)
+    int local_window_size;              // -1 to disable, only used when is_causal is set
     int thread_count;
     float* buffer;
     size_t buffer_size_per_thread;
+    size_t query_batch_stride;          // number of elements between batches of the query
+    const int* kv_sequence_lengths;     // optional valid K and V length of each batch
     const float* query;
     const float* key;
     const float* value;
@@ -0,0 +1,249 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convsym_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the symmetric quantized integer convolution kernel
+    for AMX-INT8.
+
+    The filter packed by MlasConvSymPackW interleaves 4 input channels of 16
+    output channels, which is the VNNI layout of the B tile consumed by
+    TDPBUSD: 64 input channels of a block of 16 output channels form one
+    16x64 tile. Up to 16 output pixels are gathered into a tile of A one
+    kernel position and 64 input channels at a time, and up to 64 output
+    channels are accumulated in four tiles of C.
+
+--*/
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "mlasi.h"
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 64
+
+//
+// Maximum number of blocks of TILE_N output channels computed by one call.
+//
+constexpr size_t MLAS_CONV_SYM_AMX_CHANNEL_BLOCKS = 4;
+
+/*
+    This routine returns the tile of the packed filter for CountK input
+    channels. A partial tile is copied to a zero padded tile buffer so that
+    the tile load stays inside the packed filter.
+*/
+MLAS_FORCEINLINE
+const int8_t*
+MlasConvSymAmxFilterTile(
+    const int8_t* Filter, size_t CountK, int8_t* BTile
+)
+{
+    if (CountK == TILE_K) {
+        return Filter;
+    }
+
+    std::memcpy(BTile, Filter, CountK * TILE_N);
+    std::memset(BTile + CountK * TILE_N, 0, (TILE_K - CountK) * TILE_N);
+    return BTile;
+}
+
+/*
+    This routine applies the bias and requantizes one row of 16 accumulators,
+    matching MlasConvSymPostProcessAvx512Core.
+*/
+MLAS_FORCEINLINE
+void
+MlasConvSymAmxPostProcessRow(
+    const int32_t* Accumulators,
+    const int32_t* Bias,
+    const float* Scale,
+    bool PerChannelScale,
+    const MLAS_CONV_SYM_POST_PROCESS_PARAMS* PostProcessParams,
+    uint8_t* Output,
+    __mmask16 Mask
+)
+{
+    const __m512 ScaleVector = PerChannelScale ? _mm512_maskz_loadu_ps(Mask, Scale) : _mm512_set1_ps(*Scale);
+
+    __m512i Value = _mm512_add_epi32(_mm512_load_si512(Accumulators), _mm512_maskz_loadu_epi32(Mask, Bias));
+    __m512 FloatValue = _mm512_mul_ps(_mm512_cvtepi32_ps(Value), ScaleVector);
+
+    FloatValue = _mm512_max_ps(FloatValue, _mm512_set1_ps(PostProcessParams->MinimumValue));
+    FloatValue = _mm512_min_ps(FloatValue, _mm512_set1_ps(PostProcessParams->MaximumValue));
+
+    Value = _mm512_add_epi32(_mm512_cvtps_epi32(FloatValue), _mm512_set1_epi32(PostProcessParams->OutputZeroPoint));
+    _mm512_mask_cvtusepi32_storeu_epi8(Output, Mask, Value);
+}
+
+extern "C"
+void
+MLASCALL
+MlasConvSymKernelAmx(
+    const void* Input,
+    const void* Filter,
+    void* Output,
+    size_t KernelSize,
+    size_t InputChannels,
+    size_t OutputChannels,
+    unsigned ChannelCount,
+    unsigned OutputCount,
+    const MLAS_CONV_SYM_POST_PROCESS_PARAMS* PostProcessParams,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine computes up to TILE_M output pixels for up to 64 output
+    channels of the symmetric quantized convolution.
+
+Arguments:
+
+    Input - Supplies the address of the input indirection buffer, or the
+        address of the input pixels if MLAS_CONV_SYM_FLAG_INPUT_DIRECT is set.
+
+    Filter - Supplies the address of the packed filter.
+
+    Output - Supplies the address of the output buffer.
+
+    KernelSize - Supplies the number of kernel positions.
+
+    InputChannels - Supplies the number of input channels, a multiple of 4.
+
+    OutputChannels - Supplies the number of output channels, the stride of
+        the output pixels.
+
+    ChannelCount - Supplies the number of output channels to compute.
+
+    OutputCount - Supplies the number of output pixels to compute.
+
+    PostProcessParams - Supplies the address of the post process parameter block.
+
+    KernelFlags - Supplies additional flags controlling the operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(uint8_t ATile[TILE_M * TILE_K], 64);
+    MLAS_DECLSPEC_ALIGN(int8_t BTile[TILE_K * TILE_N], 64);
+    MLAS_DECLSPEC_ALIGN(int32_t CTile[MLAS_CONV_SYM_AMX_CHANNEL_BLOCKS][TILE_M * TILE_N], 64);
+
+    const bool InputDirect = (KernelFlags & MLAS_CONV_SYM_FLAG_INPUT_DIRECT) != 0;
+    const size_t ChannelBlocks = (ChannelCount + TILE_N - 1) / TILE_N;
+    const size_t FilterBlockStride = KernelSize * InputChannels * TILE_N;
+
+    MlasAmxTileConfigInit();
+
+    tile_zero(TMM0);
+    tile_zero(TMM1);
+    tile_zero(TMM2);
+    tile_zero(TMM3);
+
+    //
+    // Rows of A past OutputCount stay zero.
+    //
+    if (OutputCount < TILE_M) {
+        std::memset(ATile, 0, sizeof(ATile));
+    }
+
+    const int8_t* filter = static_cast<const int8_t*>(Filter);
+
+    for (size_t k = 0; k < KernelSize; k++) {
+
+        for (size_t ic = 0; ic < InputChannels; ic += TILE_K) {
+
+            const size_t CountK = std::min(InputChannels - ic, size_t{TILE_K});
+            const __mmask64 Mask = (CountK == TILE_K) ? ~__mmask64(0) : ((__mmask64(1) << CountK) - 1);
+
+            for (size_t m = 0; m < OutputCount; m++) {
+                const uint8_t* input = InputDirect
+                    ? static_cast<const uint8_t*>(Input) + m * InputChannels
+                    : static_cast<const uint8_t* const*>(Input)[m * KernelSize + k];
+                _mm512_store_si512(ATile + m * TILE_K, _mm512_maskz_loadu_epi8(Mask, input + ic));
+            }
+
+            tile_loadd(TMM4, ATile, TILE_K);
+
+            const int8_t* b = filter + (k * InputChannels + ic) * TILE_N;
+
+            tile_loadd(TMM5, MlasConvSymAmxFilterTile(b, CountK, BTile), TILE_N * 4);
+            tile_dpbusd(TMM0, TMM4, TMM5);
+
+            if (ChannelBlocks > 1) {
+                tile_loadd(TMM5, MlasConvSymAmxFilterTile(b + FilterBlockStride, CountK, BTile), TILE_N * 4);
+                tile_dpbusd(TMM1, TMM4, TMM5);
+            }
+
+            if (ChannelBlocks > 2) {
+                tile_loadd(TMM5, MlasConvSymAmxFilterTile(b + 2 * FilterBlockStride, CountK, BTile), TILE_N * 4);
+                tile_dpbusd(TMM2, TMM4, TMM5);
+            }
+
+            if (ChannelBlocks > 3) {
+                tile_loadd(TMM5, MlasConvSymAmxFilterTile(b + 3 * FilterBlockStride, CountK, BTile), TILE_N * 4);
+                tile_dpbusd(TMM3, TMM4, TMM5);
+            }
+        }
+    }
+
+    const int StrideC = TILE_N * sizeof(int32_t);
+
+    tile_stored(TMM0, CTile[0], StrideC);
+
+    if (ChannelBlocks > 1) {
+        tile_stored(TMM1, CTile[1], StrideC);
+    }
+
+    if (ChannelBlocks > 2) {
+        tile_stored(TMM2, CTile[2], StrideC);
+    }
+
+    if (ChannelBlocks > 3) {
+        tile_stored(TMM3, CTile[3], StrideC);
+    }
+
+    //
+    // Apply the bias, requantize and store the output pixels.
+    //
+
+    const bool PerChannelScale = (KernelFlags & MLAS_CONV_SYM_FLAG_PER_CHANNEL_SCALE) != 0;
+
+    for (size_t n = 0; n < ChannelBlocks; n++) {
+
+        const size_t CountN = std::min(size_t(ChannelCount) - n * TILE_N, size_t{TILE_N});
+        const __mmask16 Mask = __mmask16((1u << CountN) - 1);
+
+        const int32_t* bias = PostProcessParams->Bias + n * TILE_N;
+        const float* scale = PostProcessParams->Scale + (PerChannelScale ? n * TILE_N : 0);
+        uint8_t* output = static_cast<uint8_t*>(Output) + n * TILE_N;
+
+        for (size_t m = 0; m < OutputCount; m++) {
+            MlasConvSymAmxPostProcessRow(
+                CTile[n] + m * TILE_N, bias, scale, PerChannelScale, PostProcessParams,
+                output + m * OutputChannels, Mask
+            );
+        }
+    }
+}
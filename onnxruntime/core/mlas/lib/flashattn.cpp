@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <numeric>
 
 #include "mlasi.h"
@@ -13,6 +14,7 @@ MlasFlashAttentionThreaded(
     ptrdiff_t kv_block_size = static_cast<ptrdiff_t>(args->kv_block_size);
     ptrdiff_t batch_size = static_cast<ptrdiff_t>(args->batch_size);
     ptrdiff_t num_heads = static_cast<ptrdiff_t>(args->num_heads);
+    ptrdiff_t kv_num_heads = static_cast<ptrdiff_t>(args->kv_num_heads);
     ptrdiff_t q_sequence_length = static_cast<ptrdiff_t>(args->q_sequence_length);
     ptrdiff_t kv_sequence_length = static_cast<ptrdiff_t>(args->kv_sequence_length);
     ptrdiff_t qk_head_size = static_cast<ptrdiff_t>(args->qk_head_size);
@@ -20,6 +22,10 @@ MlasFlashAttentionThreaded(
     float* buffer = args->buffer;
     ptrdiff_t buffer_size_per_thread = static_cast<ptrdiff_t>(args->buffer_size_per_thread);
     ptrdiff_t thread_count = static_cast<ptrdiff_t>(args->thread_count);
+    ptrdiff_t query_batch_stride = static_cast<ptrdiff_t>(args->query_batch_stride);
+    const float softcap = args->softcap;
+    const bool is_causal = args->is_causal;
+    ptrdiff_t local_window_size = static_cast<ptrdiff_t>(args->local_window_size);
     const float* query = args->query;
     const float* key = args->key;
     const float* value = args->value;
@@ -29,11 +35,18 @@ MlasFlashAttentionThreaded(
     auto&& mlas_platform = GetMlasPlatform();
 #endif
 
-    ptrdiff_t q_chunk_count = (q_sequence_length + (q_block_size - 1)) / q_block_size;
+    //
+    // The query heads sharing a key and value head are adjacent, so the rows
+    // of a group are processed together and each block of K and V is loaded
+    // once for all of them.
+    //
+    ptrdiff_t group_size = num_heads / kv_num_heads;
+    ptrdiff_t q_group_rows = group_size * q_sequence_length;
+    ptrdiff_t q_chunk_count = (q_group_rows + (q_block_size - 1)) / q_block_size;
 
     ptrdiff_t task_start = 0;
     ptrdiff_t task_end = 0;
-    ptrdiff_t total_task_count = batch_size * num_heads * q_chunk_count;
+    ptrdiff_t total_task_count = batch_size * kv_num_heads * q_chunk_count;
     ptrdiff_t quotient = total_task_count / thread_count;
     ptrdiff_t remainder = total_task_count % thread_count;
     if (thread_id < remainder) {
@@ -48,8 +61,8 @@ MlasFlashAttentionThreaded(
         ptrdiff_t batch_idx = task_index;
         ptrdiff_t q_idx = (batch_idx % q_chunk_count) * q_block_size;
         batch_idx /= q_chunk_count;
-        ptrdiff_t head_idx = batch_idx % num_heads;
-        batch_idx /= num_heads;
+        ptrdiff_t kv_head_idx = batch_idx % kv_num_heads;
+        batch_idx /= kv_num_heads;
 
         char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
         float* l = reinterpret_cast<float*>(buffer_current_thread);
@@ -61,23 +74,59 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_group_rows - q_idx);
+
+        ptrdiff_t kv_length = kv_sequence_length;
+        if (args->kv_sequence_lengths != nullptr) {
+            kv_length = std::min(static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx]), kv_sequence_length);
+        }
+
+        //
+        // The causal mask is aligned to the end of the key sequence. Compute
+        // the range of key positions seen by the rows of this block so that
+        // blocks of K and V that are masked out entirely are skipped.
+        //
+        ptrdiff_t causal_offset = std::max(kv_length - q_sequence_length, ptrdiff_t{0});
+        auto row_kv_range = [&](ptrdiff_t irow, ptrdiff_t& kv_lo, ptrdiff_t& kv_hi) {
+            kv_lo = 0;
+            kv_hi = kv_length;
+            if (is_causal) {
+                ptrdiff_t position = causal_offset + (q_idx + irow) % q_sequence_length;
+                kv_hi = std::min(position + 1, kv_length);
+                if (local_window_size >= 0) {
+                    kv_lo = std::max(position - local_window_size, ptrdiff_t{0});
+                }
+            }
+        };
+
+        ptrdiff_t kv_begin = kv_length;
+        ptrdiff_t kv_end = 0;
+        for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            ptrdiff_t kv_lo, kv_hi;
+            row_kv_range(irow, kv_lo, kv_hi);
+            kv_begin = std::min(kv_begin, kv_lo);
+            kv_end = std::max(kv_end, kv_hi);
+        }
+
+        const float* inputQ = query + batch_idx * query_batch_stride + (kv_head_idx * q_group_rows + q_idx) * qk_head_size;
+        ptrdiff_t h = batch_idx * kv_num_heads + kv_head_idx;
+
+        for (ptrdiff_t ir = kv_begin; ir < kv_end; ir += kv_block_size) {
             /*
-                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
+                S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
                 m = max(m, rowmax(S))
                 diff = old_m - m
                 S = exp(S - m)
                 l = exp(diff) * l + rowsum(S)
-                O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
+                O = diag(exp(diff)) * O + S * V[batch_idx, kv_head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
             const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
             const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const bool first_block = (ir == kv_begin);
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -96,10 +145,38 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                //
+                // Zero the masked columns so that they do not contribute to
+                // S * V, and update the statistics from the remaining ones.
+                //
+                ptrdiff_t kv_lo, kv_hi;
+                row_kv_range(irow, kv_lo, kv_hi);
+                size_t col_begin = static_cast<size_t>(std::clamp(kv_lo - ir, ptrdiff_t{0}, static_cast<ptrdiff_t>(row_size_kv_capped)));
+                size_t col_end = static_cast<size_t>(std::clamp(kv_hi - ir, ptrdiff_t{0}, static_cast<ptrdiff_t>(row_size_kv_capped)));
+
+                if (col_begin >= col_end) {
+                    std::fill_n(p, row_size_kv_capped, 0.0f);
+                    if (first_block) {
+                        l[irow] = 0.0f;
+                    }
+                    continue;
+                }
+
+                std::fill_n(p, col_begin, 0.0f);
+                std::fill_n(p + col_end, row_size_kv_capped - col_end, 0.0f);
+                p += col_begin;
+                size_t col_count = col_end - col_begin;
+
+                if (softcap > 0.0f) {
+                    for (size_t icol = 0; icol < col_count; ++icol) {
+                        p[icol] = softcap * std::tanh(p[icol] / softcap);
+                    }
+                }
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, col_count);
 #else
-                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = MlasReduceMaximumF32Kernel(p, col_count);
 #endif
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
@@ -107,13 +184,13 @@ MlasFlashAttentionThreaded(
                 m_diff -= m[irow];  // old - new (less than 0)
 
 #if defined(MLAS_TARGET_AMD64)
-                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, col_count, &negmax);
 #else
-                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = MlasComputeSumExpF32Kernel(p, p, col_count, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block, there is actually no need to calculate exp_diff
+                if (!first_block) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
@@ -122,7 +199,7 @@ MlasFlashAttentionThreaded(
                     }
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
+                    // For the first block, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,19 +212,24 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     first_block ? 0.0f : 1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
-        float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            ptrdiff_t head_idx = kv_head_idx * group_size + (q_idx + irow) / q_sequence_length;
+            ptrdiff_t seq_idx = (q_idx + irow) % q_sequence_length;
+            float* output_row = output + ((batch_idx * q_sequence_length + seq_idx) * num_heads + head_idx) * v_head_size;
+            if (kv_begin >= kv_end) {
+                // Nothing to attend to, e.g. an empty key sequence.
+                std::fill_n(output_row, v_head_size, 0.0f);
+                continue;
+            }
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
                 output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
             }
-            output_row += num_heads * v_head_size;
         }
     }
 }
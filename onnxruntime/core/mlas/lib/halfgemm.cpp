@@ -32,6 +32,18 @@ MlasFp16AccelerationSupported()
 #endif
 }
 
+bool MLASCALL
+MlasHalfGemmSupported()
+{
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+    return MLAS_CPUIDINFO::GetCPUIDInfo().HasFp16VectorAcceleration();
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().HalfGemmDispatch != nullptr;
+#else
+    return false;
+#endif
+}
+
 
 void
 MLASCALL
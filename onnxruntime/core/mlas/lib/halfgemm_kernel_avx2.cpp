@@ -0,0 +1,303 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for processors
+    supporting F16C and FMA3.
+
+    The processor has no half precision arithmetic, so matrix elements are
+    converted to single precision as they are loaded and the dot products
+    are accumulated in single precision. Results are rounded to half
+    precision only when stored to matrix C.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#include <cstring>
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of columns of matrix C produced by one pass of the kernel.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX2_STRIDEN = 16;
+
+//
+// Number of K elements of matrix A converted to single precision at a time.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX2_STRIDEK = 8;
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= 8) {
+        const __m128i Half = _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), Half);
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    while (len > 0) {
+        const __m128i Half = _mm_cvtps_ph(_mm_set_ss(*src), _MM_FROUND_TO_NEAREST_INT);
+        *dest = static_cast<_mlas_fp16_>(_mm_extract_epi16(Half, 0));
+        src += 1;
+        dest += 1;
+        len -= 1;
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        const size_t len = CntRow * CntCol;
+        CvtFloat2Half(dest, src, len);
+        return;
+    }
+    while (CntRow > 0) {
+        CvtFloat2Half(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+/**
+ * @brief Load up to 16 fp16 values and convert them to two vectors of fp32,
+ *        filling the lanes beyond CountN with zeros.
+*/
+MLAS_FORCEINLINE
+void
+MlasHalfGemmLoadAvx2(
+    const _mlas_fp16_* src,
+    size_t CountN,
+    __m256& Low,
+    __m256& High
+    )
+{
+    if (CountN >= MLAS_HALF_GEMM_AVX2_STRIDEN) {
+        Low = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        High = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8)));
+    } else {
+        MLAS_DECLSPEC_ALIGN(_mlas_fp16_ Buffer[MLAS_HALF_GEMM_AVX2_STRIDEN], 32) = {};
+        std::memcpy(Buffer, src, CountN * sizeof(_mlas_fp16_));
+        Low = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(Buffer)));
+        High = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(Buffer + 8)));
+    }
+}
+
+/**
+ * @brief Round two vectors of fp32 to fp16 and store the first CountN values.
+*/
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreAvx2(
+    _mlas_fp16_* dest,
+    size_t CountN,
+    __m256 Low,
+    __m256 High
+    )
+{
+    const __m128i HalfLow = _mm256_cvtps_ph(Low, _MM_FROUND_TO_NEAREST_INT);
+    const __m128i HalfHigh = _mm256_cvtps_ph(High, _MM_FROUND_TO_NEAREST_INT);
+
+    if (CountN >= MLAS_HALF_GEMM_AVX2_STRIDEN) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), HalfLow);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), HalfHigh);
+    } else {
+        MLAS_DECLSPEC_ALIGN(_mlas_fp16_ Buffer[MLAS_HALF_GEMM_AVX2_STRIDEN], 32);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Buffer), HalfLow);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Buffer + 8), HalfHigh);
+        std::memcpy(dest, Buffer, CountN * sizeof(_mlas_fp16_));
+    }
+}
+
+/**
+ * @brief Compute RowCount rows of matrix C, 16 columns at a time.
+ *
+ * A is converted to fp32 eight K elements at a time into a local buffer so
+ * that each element can be broadcast straight from memory.
+*/
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float ABuffer[RowCount][MLAS_HALF_GEMM_AVX2_STRIDEK], 32);
+
+    for (size_t n = 0; n < CountN; n += MLAS_HALF_GEMM_AVX2_STRIDEN) {
+        const size_t CountNThisPass = CountN - n;
+
+        __m256 Accumulators[RowCount][2];
+
+        if (ZeroMode) {
+            __m256 BiasLow = _mm256_setzero_ps();
+            __m256 BiasHigh = _mm256_setzero_ps();
+            if (Bias != nullptr) {
+                MlasHalfGemmLoadAvx2(Bias + n, CountNThisPass, BiasLow, BiasHigh);
+            }
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r][0] = BiasLow;
+                Accumulators[r][1] = BiasHigh;
+            }
+        } else {
+            for (size_t r = 0; r < RowCount; r++) {
+                MlasHalfGemmLoadAvx2(C + r * ldc + n, CountNThisPass, Accumulators[r][0], Accumulators[r][1]);
+            }
+        }
+
+        const _mlas_fp16_* b = B + n;
+
+        for (size_t k = 0; k < CountK; k += MLAS_HALF_GEMM_AVX2_STRIDEK) {
+            const size_t CountKThisPass = std::min(CountK - k, MLAS_HALF_GEMM_AVX2_STRIDEK);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const _mlas_fp16_* a = A + r * lda + k;
+                if (CountKThisPass == MLAS_HALF_GEMM_AVX2_STRIDEK) {
+                    _mm256_store_ps(ABuffer[r], _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a))));
+                } else {
+                    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ Buffer[MLAS_HALF_GEMM_AVX2_STRIDEK], 16) = {};
+                    std::memcpy(Buffer, a, CountKThisPass * sizeof(_mlas_fp16_));
+                    _mm256_store_ps(ABuffer[r], _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(Buffer))));
+                }
+            }
+
+            for (size_t kk = 0; kk < CountKThisPass; kk++) {
+                __m256 BLow;
+                __m256 BHigh;
+                MlasHalfGemmLoadAvx2(b, CountNThisPass, BLow, BHigh);
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m256 ABroadcast = _mm256_broadcast_ss(&ABuffer[r][kk]);
+                    Accumulators[r][0] = _mm256_fmadd_ps(ABroadcast, BLow, Accumulators[r][0]);
+                    Accumulators[r][1] = _mm256_fmadd_ps(ABroadcast, BHigh, Accumulators[r][1]);
+                }
+
+                b += ldb;
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasHalfGemmStoreAvx2(C + r * ldc + n, CountNThisPass, Accumulators[r][0], Accumulators[r][1]);
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx2Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx2Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx2Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx2Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx2Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx2Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0  // kernel does not read beyond the buffer end
+};
@@ -0,0 +1,241 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements the half precision GEMM kernel for processors
+    supporting AVX512-FP16.
+
+    Like the NEON kernel, the dot products are computed with native half
+    precision fused multiply adds.
+
+--*/
+
+#include <immintrin.h>
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#if defined(MLAS_HALFGEMM_AVX512FP16_SUPPORTED)
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of columns of matrix C produced by one pass of the kernel.
+//
+constexpr size_t MLAS_HALF_GEMM_AVX512FP16_STRIDEN = 64;
+
+MLAS_FORCEINLINE
+__mmask32
+MlasHalfGemmMaskAvx512Fp16(
+    size_t Count
+    )
+{
+    return (Count >= 32) ? __mmask32(0xFFFFFFFF) : __mmask32((1u << Count) - 1);
+}
+
+MLAS_FORCEINLINE
+__m512h
+MlasHalfGemmLoadAvx512Fp16(
+    const _mlas_fp16_* src,
+    __mmask32 Mask
+    )
+{
+    return _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Mask, src));
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreAvx512Fp16(
+    _mlas_fp16_* dest,
+    __mmask32 Mask,
+    __m512h Value
+    )
+{
+    _mm512_mask_storeu_epi16(dest, Mask, _mm512_castph_si512(Value));
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+CvtFloat2Half2D(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    while (CntRow > 0) {
+        for (size_t n = 0; n < CntCol; n += 16) {
+            const size_t Remaining = CntCol - n;
+            const __mmask16 Mask = (Remaining >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+            const __m256i Half = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(Mask, src + n), _MM_FROUND_TO_NEAREST_INT);
+            _mm256_mask_storeu_epi16(dest + n, Mask, Half);
+        }
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+/**
+ * @brief Compute RowCount rows of matrix C, 64 columns at a time.
+*/
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    bool ZeroMode
+    )
+{
+    for (size_t n = 0; n < CountN; n += MLAS_HALF_GEMM_AVX512FP16_STRIDEN) {
+        const size_t CountNThisPass = CountN - n;
+        const __mmask32 Mask0 = MlasHalfGemmMaskAvx512Fp16(CountNThisPass);
+        const __mmask32 Mask1 = (CountNThisPass > 32) ? MlasHalfGemmMaskAvx512Fp16(CountNThisPass - 32) : __mmask32(0);
+
+        __m512h Accumulators[RowCount][2];
+
+        if (ZeroMode) {
+            __m512h Bias0 = _mm512_setzero_ph();
+            __m512h Bias1 = _mm512_setzero_ph();
+            if (Bias != nullptr) {
+                Bias0 = MlasHalfGemmLoadAvx512Fp16(Bias + n, Mask0);
+                Bias1 = MlasHalfGemmLoadAvx512Fp16(Bias + n + 32, Mask1);
+            }
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r][0] = Bias0;
+                Accumulators[r][1] = Bias1;
+            }
+        } else {
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r][0] = MlasHalfGemmLoadAvx512Fp16(C + r * ldc + n, Mask0);
+                Accumulators[r][1] = MlasHalfGemmLoadAvx512Fp16(C + r * ldc + n + 32, Mask1);
+            }
+        }
+
+        const _mlas_fp16_* a = A;
+        const _mlas_fp16_* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            const __m512h B0 = MlasHalfGemmLoadAvx512Fp16(b, Mask0);
+            const __m512h B1 = MlasHalfGemmLoadAvx512Fp16(b + 32, Mask1);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m512h ABroadcast = _mm512_castsi512_ph(_mm512_set1_epi16(static_cast<short>(a[r * lda])));
+                Accumulators[r][0] = _mm512_fmadd_ph(ABroadcast, B0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm512_fmadd_ph(ABroadcast, B1, Accumulators[r][1]);
+            }
+
+            a += 1;
+            b += ldb;
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasHalfGemmStoreAvx512Fp16(C + r * ldc + n, Mask0, Accumulators[r][0]);
+            MlasHalfGemmStoreAvx512Fp16(C + r * ldc + n + 32, Mask1, Accumulators[r][1]);
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    CvtFloat2Half2D(D, B, ldb, CountK, CountN);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx512Fp16Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx512Fp16Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx512Fp16Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx512Fp16Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx512Fp16Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx512Fp16Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0  // kernel does not read beyond the buffer end
+};
+
+#endif  // defined(MLAS_HALFGEMM_AVX512FP16_SUPPORTED)
@@ -0,0 +1,331 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements the layer normalization routines, optionally
+    fused with the residual add of skip layer normalization.
+
+    Half precision rows are converted to single precision in small chunks
+    that stay in the L1 cache, so the inputs are read directly from the
+    tensors without converting them to temporary buffers up front.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cstring>
+#include <type_traits>
+
+//
+// Number of elements of a row converted to single precision at a time.
+//
+constexpr size_t MLAS_LAYERNORM_CHUNK_SIZE = 256;
+
+template<typename T>
+MLAS_FORCEINLINE
+const float*
+MlasLayerNormLoadChunk(
+    const T* Source,
+    float* Buffer,
+    size_t Count
+    )
+{
+    if constexpr (std::is_same_v<T, float>) {
+        MLAS_UNREFERENCED_PARAMETER(Buffer);
+        MLAS_UNREFERENCED_PARAMETER(Count);
+        return Source;
+    } else {
+        MlasConvertHalfToFloatBuffer(Source, Buffer, Count);
+        return Buffer;
+    }
+}
+
+template<typename T>
+MLAS_FORCEINLINE
+void
+MlasLayerNormStoreChunk(
+    T* Destination,
+    const float* Source,
+    size_t Count
+    )
+{
+    if constexpr (std::is_same_v<T, float>) {
+        if (Destination != Source) {
+            std::memcpy(Destination, Source, Count * sizeof(float));
+        }
+    } else {
+        MlasConvertFloatToHalfBuffer(Source, Destination, Count);
+    }
+}
+
+/**
+ * @brief Compute Input + Skip + SkipBias for a chunk of a row.
+ *
+ * @return The address of the single precision sums, which is Input itself
+ *         when there is nothing to add to a single precision row.
+*/
+template<typename T>
+MLAS_FORCEINLINE
+const float*
+MlasLayerNormSumChunk(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    float* Buffer,
+    float* SkipBuffer,
+    size_t Count
+    )
+{
+    const float* x = MlasLayerNormLoadChunk(Input, Buffer, Count);
+
+    if (Skip == nullptr && SkipBias == nullptr) {
+        return x;
+    }
+
+    const float* s = (Skip != nullptr) ? MlasLayerNormLoadChunk(Skip, SkipBuffer, Count) : nullptr;
+
+    size_t n = 0;
+
+    for (; n + 4 <= Count; n += 4) {
+        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(x + n);
+        if (s != nullptr) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(s + n));
+        }
+        if (SkipBias != nullptr) {
+            Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(SkipBias + n));
+        }
+        MlasStoreFloat32x4(Buffer + n, Value);
+    }
+
+    for (; n < Count; n++) {
+        float Value = x[n];
+        if (s != nullptr) {
+            Value += s[n];
+        }
+        if (SkipBias != nullptr) {
+            Value += SkipBias[n];
+        }
+        Buffer[n] = Value;
+    }
+
+    return Buffer;
+}
+
+template<typename T>
+void
+MLASCALL
+MlasLayerNormalization(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t NormSize,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes one row of a (skip) layer normalization.
+
+    The row is read twice: the first pass accumulates the sum and the sum of
+    squares of Input + Skip + SkipBias and optionally stores it to SkipOutput,
+    the second pass recomputes the same values and normalizes them. This
+    avoids rounding the intermediate values to the output type.
+
+Arguments:
+
+    Input - Supplies the row to normalize.
+
+    Skip - Optionally supplies a row to add to Input.
+
+    SkipBias - Optionally supplies a bias to add to Input.
+
+    Scale - Supplies the scale (gamma).
+
+    Bias - Optionally supplies the bias (beta). Ignored when Simplified is
+        set.
+
+    Output - Supplies the row to store the normalized values.
+
+    SkipOutput - Optionally supplies the row to store Input + Skip + SkipBias.
+
+    NormSize - Supplies the number of elements of the row.
+
+    Epsilon - Supplies the value added to the variance.
+
+    Simplified - Supplies true to compute the RMS normalization, which does
+        not subtract the mean.
+
+    Mean - Optionally receives the mean of the row.
+
+    InvStdDev - Optionally receives the inverse standard deviation of the
+        row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[MLAS_LAYERNORM_CHUNK_SIZE], 16);
+    MLAS_DECLSPEC_ALIGN(float SkipBuffer[MLAS_LAYERNORM_CHUNK_SIZE], 16);
+
+    //
+    // Accumulate the sum and the sum of squares of the row.
+    //
+
+    MLAS_FLOAT32X4 SumVector = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquareVector = MlasZeroFloat32x4();
+    float Sum = 0.0f;
+    float SumSquare = 0.0f;
+
+    for (size_t i = 0; i < NormSize; i += MLAS_LAYERNORM_CHUNK_SIZE) {
+
+        const size_t Count = std::min(NormSize - i, MLAS_LAYERNORM_CHUNK_SIZE);
+        const float* Value = MlasLayerNormSumChunk(Input + i, (Skip != nullptr) ? Skip + i : nullptr,
+                                                   (SkipBias != nullptr) ? SkipBias + i : nullptr,
+                                                   Buffer, SkipBuffer, Count);
+
+        size_t n = 0;
+
+        for (; n + 4 <= Count; n += 4) {
+            MLAS_FLOAT32X4 v = MlasLoadFloat32x4(Value + n);
+            SumVector = MlasAddFloat32x4(SumVector, v);
+            SumSquareVector = MlasMultiplyAddFloat32x4(v, v, SumSquareVector);
+        }
+
+        for (; n < Count; n++) {
+            Sum += Value[n];
+            SumSquare += Value[n] * Value[n];
+        }
+
+        if (SkipOutput != nullptr) {
+            MlasLayerNormStoreChunk(SkipOutput + i, Value, Count);
+        }
+    }
+
+    Sum += MlasReduceAddFloat32x4(SumVector);
+    SumSquare += MlasReduceAddFloat32x4(SumSquareVector);
+
+    const float MeanValue = Sum / NormSize;
+    float StdDev;
+    if (Simplified) {
+        StdDev = std::sqrt(SumSquare / NormSize + Epsilon);
+    } else {
+        StdDev = std::sqrt(SumSquare / NormSize - MeanValue * MeanValue + Epsilon);
+    }
+    const float InvStdDevValue = 1.0f / StdDev;
+
+    if (Mean != nullptr) {
+        *Mean = MeanValue;
+    }
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvStdDevValue;
+    }
+
+    //
+    // Normalize the row: Output = (Value - Mean) * InvStdDev * Scale + Bias.
+    //
+
+    const float Shift = Simplified ? 0.0f : MeanValue;
+    const MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+    const MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDevValue);
+    const float* Beta = Simplified ? nullptr : Bias;
+
+    for (size_t i = 0; i < NormSize; i += MLAS_LAYERNORM_CHUNK_SIZE) {
+
+        const size_t Count = std::min(NormSize - i, MLAS_LAYERNORM_CHUNK_SIZE);
+        const float* Value = MlasLayerNormSumChunk(Input + i, (Skip != nullptr) ? Skip + i : nullptr,
+                                                   (SkipBias != nullptr) ? SkipBias + i : nullptr,
+                                                   Buffer, SkipBuffer, Count);
+
+        //
+        // A single precision output is written in place, otherwise the
+        // results are stored to the chunk buffer and then converted.
+        //
+
+        float* Result;
+        if constexpr (std::is_same_v<T, float>) {
+            Result = Output + i;
+        } else {
+            Result = Buffer;
+        }
+
+        const float* gamma = Scale + i;
+        const float* beta = (Beta != nullptr) ? Beta + i : nullptr;
+
+        size_t n = 0;
+
+        for (; n + 4 <= Count; n += 4) {
+            MLAS_FLOAT32X4 v = MlasSubtractFloat32x4(MlasLoadFloat32x4(Value + n), ShiftVector);
+            v = MlasMultiplyFloat32x4(v, InvStdDevVector);
+            if (beta != nullptr) {
+                v = MlasMultiplyAddFloat32x4(v, MlasLoadFloat32x4(gamma + n), MlasLoadFloat32x4(beta + n));
+            } else {
+                v = MlasMultiplyFloat32x4(v, MlasLoadFloat32x4(gamma + n));
+            }
+            MlasStoreFloat32x4(Result + n, v);
+        }
+
+        for (; n < Count; n++) {
+            float v = (Value[n] - Shift) * InvStdDevValue * gamma[n];
+            if (beta != nullptr) {
+                v += beta[n];
+            }
+            Result[n] = v;
+        }
+
+        MlasLayerNormStoreChunk(Output + i, Result, Count);
+    }
+}
+
+template
+void
+MLASCALL
+MlasLayerNormalization<float>(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t NormSize,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+template
+void
+MLASCALL
+MlasLayerNormalization<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t NormSize,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
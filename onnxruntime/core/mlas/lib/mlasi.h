@@ -925,7 +925,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -992,6 +992,7 @@ extern const MLAS_CONV_SYM_DISPATCH MlasConvSymDispatchAvx2;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymDispatchAvxVnni;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymDispatchAvx512Core;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymDispatchAvx512Vnni;
+extern const MLAS_CONV_SYM_DISPATCH MlasConvSymDispatchAmx;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchDot;
@@ -1029,6 +1030,40 @@ extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAmx;
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx;
+#endif
+
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+// The AVX512-FP16 kernel requires a compiler that supports the AVX512-FP16
+// intrinsics, keep in sync with onnxruntime_mlas.cmake.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+
+#if !defined(_MSC_VER) && !defined(__APPLE__) && \
+    ((defined(__clang__) && (__clang_major__ >= 14)) || (!defined(__clang__) && defined(__GNUC__) && (__GNUC__ >= 12)))
+#define MLAS_HALFGEMM_AVX512FP16_SUPPORTED
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+#endif
+#endif
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1186,6 +1221,14 @@ struct MLAS_PLATFORM {
 
     const MLAS_SQNBIT_GEMM_DISPATCH* SQNBitGemmDispatch{nullptr};
 
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+#endif
+
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+#endif
+
     MLAS_CAST_F16_TO_F32_KERNEL* CastF16ToF32Kernel;
     MLAS_CAST_F32_TO_F16_KERNEL* CastF32ToF16Kernel;
 };
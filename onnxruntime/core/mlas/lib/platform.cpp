@@ -390,6 +390,7 @@ Return Value:
                 this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
                 this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelAvx2;
                 this->CastF32ToF16Kernel = &MlasCastF32ToF16KernelAvx2;
+                this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
 
 
                 //
@@ -473,6 +474,26 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
+#endif
+
+#if defined(MLAS_HALFGEMM_AVX512FP16_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif
                     }
                 }
 
@@ -500,7 +521,9 @@ Return Value:
 
                 //
                 // Check if the processor supports AMX-TILE and AMX-INT8
-                // features.
+                // features. The SQNBitGemm and symmetric convolution AMX
+                // kernels compute left over rows and the depthwise
+                // convolution with AVX512-VNNI.
                 //
                 if ((Cpuid7[3] & 0b1 << 24) != 0 &&
                     (Cpuid7[3] & 0b1 << 25) != 0 &&
@@ -508,8 +531,30 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+                        if (this->SQNBitGemmDispatch == &MlasSQNBitGemmDispatchAvx512vnni) {
+                            this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAmx;
+                        }
+                        if (this->ConvSymU8S8Dispatch == &MlasConvSymDispatchAvx512Vnni) {
+                            this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAmx;
+                        }
+                    }
+                }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+                //
+                // Check if the processor supports AMX-TILE and AMX-BF16
+                // features. The AMX kernel hands rows left over from its
+                // tiles to the AVX512_BF16 kernel.
+                //
+                if (this->SBGemmDispatch != nullptr &&
+                    (Cpuid7[3] & 0b1 << 24) != 0 &&
+                    (Cpuid7[3] & 0b1 << 22) != 0 &&
+                    (xcr0 & XFEATURE_MASK_XTILE) == XFEATURE_MASK_XTILE) {
+                    if (MlasInitAMX()) {
+                        this->SBGemmDispatch = &MlasSBGemmDispatchAmx;
                     }
                 }
+#endif
 #endif // __APPLE__
 
 #endif // ORT_MINIMAL_BUILD
@@ -723,6 +768,24 @@ MlasPlatformU8S8Overflow(
     return p.GemmU8U8Dispatch != p.GemmU8S8Dispatch;
 }
 
+bool
+MLASCALL
+MlasAMXKernelsSelected(
+    void
+    )
+{
+#if defined(MLAS_TARGET_AMD64) && !defined(ORT_MINIMAL_BUILD) && !defined(__APPLE__)
+    const auto& p = GetMlasPlatform();
+    bool selected = p.GemmU8S8Dispatch == &MlasGemmU8S8DispatchAmx;
+#if defined(MLAS_SBGEMM_SUPPORTED)
+    selected = selected || p.SBGemmDispatch == &MlasSBGemmDispatchAmx;
+#endif
+    return selected;
+#else
+    return false;
+#endif
+}
+
 #endif
 thread_local size_t ThreadedBufSize = 0;
 #ifdef _MSC_VER
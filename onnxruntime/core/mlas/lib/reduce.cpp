@@ -0,0 +1,728 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements the reduction of the middle axis of a tensor
+    viewed as [OuterCount, ReduceCount, InnerCount].
+
+    When InnerCount is one, every output is the reduction of a contiguous
+    row. Otherwise the reduced elements are strided and a block of adjacent
+    columns is reduced together with vector operations, so each row of the
+    input is read sequentially.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Number of adjacent columns reduced together when the reduced elements are
+// strided. The partial results stay in the L1 cache.
+//
+constexpr size_t MLAS_REDUCE_COLUMN_BLOCK_SIZE = 256;
+
+//
+// Minimum number of input elements processed per thread.
+//
+constexpr size_t MLAS_REDUCE_MINIMUM_ELEMENTS_PER_THREAD = 16384;
+
+struct MLAS_REDUCE_WORK_BLOCK {
+    MLAS_REDUCTION_KIND ReductionKind;
+    const float* Input;
+    float* Output;
+    size_t OuterCount;
+    size_t ReduceCount;
+    size_t InnerCount;
+    size_t ColumnBlockCount;
+    ptrdiff_t ThreadCount;
+};
+
+MLAS_FORCEINLINE
+bool
+MlasReduceIsFinite(
+    float Value
+    )
+{
+    return std::isfinite(Value);
+}
+
+float
+MlasReduceLogSumExpNonFinite(
+    const float* Input,
+    size_t N,
+    size_t Stride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the LogSumExp of a vector whose maximum is not
+    finite. The exponential kernels clamp their inputs, so these vectors
+    cannot be shifted by their maximum and summed like the others.
+
+Arguments:
+
+    Input - Supplies the input vector.
+
+    N - Supplies the number of elements of the vector.
+
+    Stride - Supplies the distance between two elements of the vector.
+
+Return Value:
+
+    NaN if an element is NaN, else positive infinity if an element is
+    positive infinity, else negative infinity.
+
+--*/
+{
+    float Value = -std::numeric_limits<float>::infinity();
+
+    for (size_t n = 0; n < N; n++) {
+        const float Element = Input[n * Stride];
+        if (std::isnan(Element)) {
+            return Element;
+        }
+        if (Element == std::numeric_limits<float>::infinity()) {
+            Value = Element;
+        }
+    }
+
+    return Value;
+}
+
+float
+MlasReduceSumRow(
+    const float* Input,
+    size_t N
+    )
+{
+    MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator2 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 Accumulator3 = MlasZeroFloat32x4();
+
+    while (N >= 16) {
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(Input));
+        Accumulator1 = MlasAddFloat32x4(Accumulator1, MlasLoadFloat32x4(Input + 4));
+        Accumulator2 = MlasAddFloat32x4(Accumulator2, MlasLoadFloat32x4(Input + 8));
+        Accumulator3 = MlasAddFloat32x4(Accumulator3, MlasLoadFloat32x4(Input + 12));
+        Input += 16;
+        N -= 16;
+    }
+
+    while (N >= 4) {
+        Accumulator0 = MlasAddFloat32x4(Accumulator0, MlasLoadFloat32x4(Input));
+        Input += 4;
+        N -= 4;
+    }
+
+    Accumulator0 = MlasAddFloat32x4(Accumulator0, Accumulator1);
+    Accumulator2 = MlasAddFloat32x4(Accumulator2, Accumulator3);
+    Accumulator0 = MlasAddFloat32x4(Accumulator0, Accumulator2);
+
+    float Sum = MlasReduceAddFloat32x4(Accumulator0);
+
+    while (N > 0) {
+        Sum += *Input++;
+        N--;
+    }
+
+    return Sum;
+}
+
+float
+MlasReduceMinimumRow(
+    const float* Input,
+    size_t N
+    )
+{
+    float Minimum = std::numeric_limits<float>::infinity();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 Minimum0 = MlasBroadcastFloat32x4(Minimum);
+        MLAS_FLOAT32X4 Minimum1 = Minimum0;
+        MLAS_FLOAT32X4 Minimum2 = Minimum0;
+        MLAS_FLOAT32X4 Minimum3 = Minimum0;
+
+        while (N >= 16) {
+            Minimum0 = MlasMinimumFloat32x4(Minimum0, MlasLoadFloat32x4(Input));
+            Minimum1 = MlasMinimumFloat32x4(Minimum1, MlasLoadFloat32x4(Input + 4));
+            Minimum2 = MlasMinimumFloat32x4(Minimum2, MlasLoadFloat32x4(Input + 8));
+            Minimum3 = MlasMinimumFloat32x4(Minimum3, MlasLoadFloat32x4(Input + 12));
+            Input += 16;
+            N -= 16;
+        }
+
+        while (N >= 4) {
+            Minimum0 = MlasMinimumFloat32x4(Minimum0, MlasLoadFloat32x4(Input));
+            Input += 4;
+            N -= 4;
+        }
+
+        Minimum0 = MlasMinimumFloat32x4(Minimum0, Minimum1);
+        Minimum2 = MlasMinimumFloat32x4(Minimum2, Minimum3);
+        Minimum0 = MlasMinimumFloat32x4(Minimum0, Minimum2);
+
+        Minimum = MlasReduceMinimumFloat32x4(Minimum0);
+    }
+
+    while (N > 0) {
+        Minimum = std::min(Minimum, *Input++);
+        N--;
+    }
+
+    return Minimum;
+}
+
+float
+MlasReduceMaximumRow(
+    const float* Input,
+    size_t N
+    )
+{
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+    float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Input, N);
+#else
+    float Maximum = MlasReduceMaximumF32Kernel(Input, N);
+#endif
+
+    //
+    // The kernels start from the lowest finite value, so check whether the
+    // row is made of negative infinities.
+    //
+
+    if (Maximum == std::numeric_limits<float>::lowest()) {
+        Maximum = -std::numeric_limits<float>::infinity();
+        for (size_t n = 0; n < N; n++) {
+            Maximum = std::max(Maximum, Input[n]);
+        }
+    }
+
+    return Maximum;
+}
+
+float
+MlasReduceLogSumExpRow(
+    const float* Input,
+    size_t N
+    )
+{
+    float Maximum = MlasReduceMaximumRow(Input, N);
+
+    if (!MlasReduceIsFinite(Maximum)) {
+        return MlasReduceLogSumExpNonFinite(Input, N, 1);
+    }
+
+    float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+    float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#else
+    float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, N, &NegativeMaximum);
+#endif
+
+    return std::log(Accumulation) + Maximum;
+}
+
+void
+MlasReduceRows(
+    MLAS_REDUCTION_KIND ReductionKind,
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t ReduceCount
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a set of contiguous rows.
+
+Arguments:
+
+    ReductionKind - Supplies the reduction to compute.
+
+    Input - Supplies the rows to reduce.
+
+    Output - Supplies the buffer receiving one value per row.
+
+    RowCount - Supplies the number of rows.
+
+    ReduceCount - Supplies the number of elements of each row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Scale = 1.0f / float(ReduceCount);
+
+    for (size_t row = 0; row < RowCount; row++) {
+
+        float Value;
+
+        switch (ReductionKind) {
+            case MlasSumReduction:
+                Value = MlasReduceSumRow(Input, ReduceCount);
+                break;
+
+            case MlasMeanReduction:
+                Value = MlasReduceSumRow(Input, ReduceCount) * Scale;
+                break;
+
+            case MlasMaximumReduction:
+                Value = MlasReduceMaximumRow(Input, ReduceCount);
+                break;
+
+            case MlasMinimumReduction:
+                Value = MlasReduceMinimumRow(Input, ReduceCount);
+                break;
+
+            default:
+                Value = MlasReduceLogSumExpRow(Input, ReduceCount);
+                break;
+        }
+
+        Output[row] = Value;
+        Input += ReduceCount;
+    }
+}
+
+//
+// Operations combining the partial results of strided reductions.
+//
+
+struct MLAS_REDUCE_OPERATION_ADD {
+    static MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasAddFloat32x4(a, b); }
+    static float Scalar(float a, float b) { return a + b; }
+};
+
+struct MLAS_REDUCE_OPERATION_MAXIMUM {
+    static MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasMaximumFloat32x4(a, b); }
+    static float Scalar(float a, float b) { return std::max(a, b); }
+};
+
+struct MLAS_REDUCE_OPERATION_MINIMUM {
+    static MLAS_FLOAT32X4 Vector(MLAS_FLOAT32X4 a, MLAS_FLOAT32X4 b) { return MlasMinimumFloat32x4(a, b); }
+    static float Scalar(float a, float b) { return std::min(a, b); }
+};
+
+template<typename Operation>
+void
+MlasReduceColumnsBinary(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t ColumnCount
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a block of strided columns with a binary operation.
+
+    Four input rows are combined per pass over the output block to reduce the
+    number of loads and stores of the partial results.
+
+Arguments:
+
+    Input - Supplies the address of the first column of the block in the
+        first row to reduce.
+
+    Output - Supplies the address of the first column of the block in the
+        output row.
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    InnerCount - Supplies the distance between two rows.
+
+    ColumnCount - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    std::copy_n(Input, ColumnCount, Output);
+
+    size_t row = 1;
+
+    for (; row + 4 <= ReduceCount; row += 4) {
+
+        const float* Row0 = Input + row * InnerCount;
+        const float* Row1 = Row0 + InnerCount;
+        const float* Row2 = Row1 + InnerCount;
+        const float* Row3 = Row2 + InnerCount;
+
+        size_t n = 0;
+
+        for (; n + 4 <= ColumnCount; n += 4) {
+            MLAS_FLOAT32X4 Value01 = Operation::Vector(MlasLoadFloat32x4(Row0 + n), MlasLoadFloat32x4(Row1 + n));
+            MLAS_FLOAT32X4 Value23 = Operation::Vector(MlasLoadFloat32x4(Row2 + n), MlasLoadFloat32x4(Row3 + n));
+            MLAS_FLOAT32X4 Value = Operation::Vector(Value01, Value23);
+            MlasStoreFloat32x4(Output + n, Operation::Vector(MlasLoadFloat32x4(Output + n), Value));
+        }
+
+        for (; n < ColumnCount; n++) {
+            float Value = Operation::Scalar(Operation::Scalar(Row0[n], Row1[n]), Operation::Scalar(Row2[n], Row3[n]));
+            Output[n] = Operation::Scalar(Output[n], Value);
+        }
+    }
+
+    for (; row < ReduceCount; row++) {
+
+        const float* Row0 = Input + row * InnerCount;
+
+        size_t n = 0;
+
+        for (; n + 4 <= ColumnCount; n += 4) {
+            MlasStoreFloat32x4(Output + n, Operation::Vector(MlasLoadFloat32x4(Output + n), MlasLoadFloat32x4(Row0 + n)));
+        }
+
+        for (; n < ColumnCount; n++) {
+            Output[n] = Operation::Scalar(Output[n], Row0[n]);
+        }
+    }
+}
+
+void
+MlasReduceColumnsLogSumExp(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t ColumnCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the LogSumExp of a block of strided columns.
+
+    The first pass finds the maximum of each column. The second pass
+    subtracts it from a row of the block, computes the exponential of the
+    row in place in a temporary buffer and accumulates it.
+
+Arguments:
+
+    Input - Supplies the address of the first column of the block in the
+        first row to reduce.
+
+    Output - Supplies the address of the first column of the block in the
+        output row.
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    InnerCount - Supplies the distance between two rows.
+
+    ColumnCount - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Maximum[MLAS_REDUCE_COLUMN_BLOCK_SIZE], 16);
+    MLAS_DECLSPEC_ALIGN(float Accumulation[MLAS_REDUCE_COLUMN_BLOCK_SIZE], 16);
+    MLAS_DECLSPEC_ALIGN(float Temp[MLAS_REDUCE_COLUMN_BLOCK_SIZE], 16);
+
+    MlasReduceColumnsBinary<MLAS_REDUCE_OPERATION_MAXIMUM>(Input, Maximum, ReduceCount, InnerCount, ColumnCount);
+
+    //
+    // The output of the columns whose maximum is not finite is computed
+    // separately and these columns are shifted by zero in the loop below.
+    // The other columns keep their finite maximum in the output.
+    //
+
+    for (size_t n = 0; n < ColumnCount; n++) {
+        if (MlasReduceIsFinite(Maximum[n])) {
+            Output[n] = Maximum[n];
+        } else {
+            Output[n] = MlasReduceLogSumExpNonFinite(Input + n, ReduceCount, InnerCount);
+            Maximum[n] = 0.0f;
+        }
+    }
+
+    std::fill_n(Accumulation, ColumnCount, 0.0f);
+
+    for (size_t row = 0; row < ReduceCount; row++) {
+
+        const float* Row = Input + row * InnerCount;
+
+        size_t n = 0;
+
+        for (; n + 4 <= ColumnCount; n += 4) {
+            MLAS_FLOAT32X4 Value = MlasSubtractFloat32x4(MlasLoadFloat32x4(Row + n), MlasLoadFloat32x4(Maximum + n));
+            MlasStoreFloat32x4(Temp + n, Value);
+        }
+
+        for (; n < ColumnCount; n++) {
+            Temp[n] = Row[n] - Maximum[n];
+        }
+
+        MlasComputeExp(Temp, Temp, ColumnCount);
+
+        n = 0;
+
+        for (; n + 4 <= ColumnCount; n += 4) {
+            MLAS_FLOAT32X4 Value = MlasAddFloat32x4(MlasLoadFloat32x4(Accumulation + n), MlasLoadFloat32x4(Temp + n));
+            MlasStoreFloat32x4(Accumulation + n, Value);
+        }
+
+        for (; n < ColumnCount; n++) {
+            Accumulation[n] += Temp[n];
+        }
+    }
+
+    for (size_t n = 0; n < ColumnCount; n++) {
+        if (MlasReduceIsFinite(Output[n])) {
+            Output[n] = std::log(Accumulation[n]) + Maximum[n];
+        }
+    }
+}
+
+void
+MlasReduceColumns(
+    MLAS_REDUCTION_KIND ReductionKind,
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t ColumnCount
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces a block of strided columns.
+
+Arguments:
+
+    ReductionKind - Supplies the reduction to compute.
+
+    Input - Supplies the address of the first column of the block in the
+        first row to reduce.
+
+    Output - Supplies the address of the first column of the block in the
+        output row.
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    InnerCount - Supplies the distance between two rows.
+
+    ColumnCount - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (ReductionKind) {
+        case MlasSumReduction:
+        case MlasMeanReduction:
+        {
+            MlasReduceColumnsBinary<MLAS_REDUCE_OPERATION_ADD>(Input, Output, ReduceCount, InnerCount, ColumnCount);
+
+            if (ReductionKind == MlasMeanReduction) {
+
+                const float Scale = 1.0f / float(ReduceCount);
+                const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+                size_t n = 0;
+
+                for (; n + 4 <= ColumnCount; n += 4) {
+                    MlasStoreFloat32x4(Output + n, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output + n), ScaleVector));
+                }
+
+                for (; n < ColumnCount; n++) {
+                    Output[n] *= Scale;
+                }
+            }
+            break;
+        }
+
+        case MlasMaximumReduction:
+        {
+            MlasReduceColumnsBinary<MLAS_REDUCE_OPERATION_MAXIMUM>(Input, Output, ReduceCount, InnerCount, ColumnCount);
+            break;
+        }
+
+        case MlasMinimumReduction:
+        {
+            MlasReduceColumnsBinary<MLAS_REDUCE_OPERATION_MINIMUM>(Input, Output, ReduceCount, InnerCount, ColumnCount);
+            break;
+        }
+
+        default:
+        {
+            MlasReduceColumnsLogSumExp(Input, Output, ReduceCount, InnerCount, ColumnCount);
+            break;
+        }
+    }
+}
+
+void
+MlasReduceThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    reduction operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_REDUCE_WORK_BLOCK*)Context;
+
+    const size_t ReduceCount = WorkBlock->ReduceCount;
+    const size_t InnerCount = WorkBlock->InnerCount;
+
+    //
+    // Rows are reduced independently when the reduced elements are
+    // contiguous, otherwise a work item is a block of columns of one of the
+    // outer slices.
+    //
+
+    const size_t TotalWork = (InnerCount == 1) ? WorkBlock->OuterCount :
+        WorkBlock->OuterCount * WorkBlock->ColumnBlockCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+    if (InnerCount == 1) {
+        MlasReduceRows(WorkBlock->ReductionKind, WorkBlock->Input + WorkIndex * ReduceCount,
+                       WorkBlock->Output + WorkIndex, WorkRemaining, ReduceCount);
+        return;
+    }
+
+    while (WorkRemaining > 0) {
+
+        const size_t Outer = WorkIndex / WorkBlock->ColumnBlockCount;
+        const size_t Column = (WorkIndex % WorkBlock->ColumnBlockCount) * MLAS_REDUCE_COLUMN_BLOCK_SIZE;
+        const size_t ColumnCount = std::min(InnerCount - Column, MLAS_REDUCE_COLUMN_BLOCK_SIZE);
+
+        MlasReduceColumns(WorkBlock->ReductionKind,
+                          WorkBlock->Input + Outer * ReduceCount * InnerCount + Column,
+                          WorkBlock->Output + Outer * InnerCount + Column,
+                          ReduceCount, InnerCount, ColumnCount);
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCTION_KIND ReductionKind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the middle axis of a tensor viewed as
+    [OuterCount, ReduceCount, InnerCount].
+
+    Maximum and Minimum follow the semantics of the vector minimum and
+    maximum instructions for NaNs. LogSumExp is positive infinity when an
+    element is positive infinity and negative infinity when all the elements
+    are negative infinity. When the maximum of the elements is NaN or
+    infinite, LogSumExp is NaN if an element is NaN.
+
+Arguments:
+
+    ReductionKind - Supplies the reduction to compute.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor of [OuterCount, InnerCount].
+
+    OuterCount - Supplies the number of independent reductions.
+
+    ReduceCount - Supplies the number of elements to reduce. Must not be zero.
+
+    InnerCount - Supplies the number of adjacent columns reduced together.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OuterCount == 0 || InnerCount == 0) {
+        return;
+    }
+
+    MLAS_REDUCE_WORK_BLOCK WorkBlock;
+
+    WorkBlock.ReductionKind = ReductionKind;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.OuterCount = OuterCount;
+    WorkBlock.ReduceCount = ReduceCount;
+    WorkBlock.InnerCount = InnerCount;
+    WorkBlock.ColumnBlockCount = (InnerCount + MLAS_REDUCE_COLUMN_BLOCK_SIZE - 1) / MLAS_REDUCE_COLUMN_BLOCK_SIZE;
+
+    //
+    // Compute the number of target threads given the amount of input to
+    // reduce. Limit the number of threads to the number of work items and
+    // keep each thread processing a minimum number of elements.
+    //
+
+    const size_t TotalWork = (InnerCount == 1) ? OuterCount : OuterCount * WorkBlock.ColumnBlockCount;
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalWork) {
+        ThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    const size_t BlockCount = ((OuterCount * ReduceCount * InnerCount) / MLAS_REDUCE_MINIMUM_ELEMENTS_PER_THREAD) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasReduceThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
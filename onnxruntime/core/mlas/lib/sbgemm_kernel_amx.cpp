@@ -0,0 +1,274 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the bfloat16 precision GEMM kernel for AMX-BF16.
+
+    Matrix B uses the packed layout of the AVX512-BF16 kernel with K padded
+    to the 32 elements consumed by one TDPBF16PS, so each 16x32 block of B is
+    a contiguous tile. Blocks of 16 rows of A are converted to bfloat16 into
+    a local tile buffer. Rows left over after the last full block of 16 are
+    computed by the AVX512-BF16 kernel, which reads the same packed B.
+
+--*/
+
+#include <immintrin.h>
+
+#include "sbgemm.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 32
+
+struct MLAS_SBGEMM_KERNEL_AMX {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = TILE_M;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = TILE_K;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+//
+// Number of K elements of A converted to bfloat16 at a time.
+//
+constexpr size_t MLAS_SBGEMM_AMX_KCHUNK = 256;
+
+/*
+    This routine converts TILE_M rows of CountK elements of A to bf16, padding
+    each row with zeros up to the next multiple of TILE_K.
+*/
+static
+void
+MlasSBGemmConvertTileA(
+    uint16_t* D, const float* A, size_t lda, size_t CountK
+)
+{
+    for (size_t m = 0; m < TILE_M; m++) {
+        uint16_t* d = D + m * MLAS_SBGEMM_AMX_KCHUNK;
+        const float* a = A + m * lda;
+
+        for (size_t k = 0; k < CountK; k += TILE_K) {
+            const size_t Remaining = CountK - k;
+            const __mmask16 Mask0 = Remaining >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+            const __mmask16 Mask1 = Remaining >= 32 ? __mmask16(0xFFFF)
+                                                    : (Remaining > 16 ? __mmask16((1u << (Remaining - 16)) - 1) : __mmask16(0));
+
+            const __m512 Low = _mm512_maskz_loadu_ps(Mask0, a + k);
+            const __m512 High = _mm512_maskz_loadu_ps(Mask1, a + k + 16);
+            _mm512_storeu_si512(d + k, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+        }
+    }
+}
+
+/*
+    This routine fills a 16x16 tile buffer with the initial value of a block
+    of C: the bias broadcast to every row, or the current contents of C.
+*/
+static
+void
+MlasSBGemmInitTileC(
+    float* Tile, const float* C, size_t ldc, __mmask16 Mask, const float* Bias, bool ZeroMode
+)
+{
+    const __m512 BiasVector = (ZeroMode && Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask, Bias) : _mm512_setzero_ps();
+
+    for (size_t m = 0; m < TILE_M; m++) {
+        const __m512 Value = ZeroMode ? BiasVector : _mm512_maskz_loadu_ps(Mask, C + m * ldc);
+        _mm512_store_ps(Tile + m * TILE_N, Value);
+    }
+}
+
+static
+void
+MlasSBGemmStoreTileC(
+    const float* Tile, float* C, size_t ldc, __mmask16 Mask
+)
+{
+    for (size_t m = 0; m < TILE_M; m++) {
+        _mm512_mask_storeu_ps(C + m * ldc, Mask, _mm512_load_ps(Tile + m * TILE_N));
+    }
+}
+
+/*
+    This routine computes TILE_M rows of C for the K range of the converted
+    tile buffer of A, one or two blocks of TILE_N columns at a time.
+*/
+static
+void
+MlasSBGemmKernelTile(
+    const uint16_t* ATile,
+    size_t CountN,
+    size_t CountK,
+    size_t PackedCountK,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    MLAS_DECLSPEC_ALIGN(float CTile[2][TILE_M * TILE_N], 64);
+
+    const int StrideA = static_cast<int>(MLAS_SBGEMM_AMX_KCHUNK * sizeof(uint16_t));
+    const int StrideB = static_cast<int>(TILE_N * 2 * sizeof(bfloat16_t));
+    const int StrideC = static_cast<int>(ldc * sizeof(float));
+    const int StrideTile = static_cast<int>(TILE_N * sizeof(float));
+
+    for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+        const size_t Remaining = CountN - n;
+        const bool TwoBlocks = Remaining > TILE_N;
+        const bool Full0 = Remaining >= TILE_N;
+        const bool Full1 = Remaining >= 2 * TILE_N;
+        const __mmask16 Mask0 = Full0 ? __mmask16(0xFFFF) : __mmask16((1u << Remaining) - 1);
+        const __mmask16 Mask1 = Full1 ? __mmask16(0xFFFF)
+                                      : (TwoBlocks ? __mmask16((1u << (Remaining - TILE_N)) - 1) : __mmask16(0));
+
+        float* c0 = C + n;
+        float* c1 = c0 + TILE_N;
+        const float* bias = (Bias != nullptr) ? Bias + n : nullptr;
+
+        //
+        // Load the accumulators. Full blocks are loaded straight from C.
+        //
+        if (ZeroMode && bias == nullptr) {
+            tile_zero(TMM0);
+        } else if (!ZeroMode && Full0) {
+            tile_loadd(TMM0, c0, StrideC);
+        } else {
+            MlasSBGemmInitTileC(CTile[0], c0, ldc, Mask0, bias, ZeroMode);
+            tile_loadd(TMM0, CTile[0], StrideTile);
+        }
+
+        if (TwoBlocks) {
+            if (ZeroMode && bias == nullptr) {
+                tile_zero(TMM1);
+            } else if (!ZeroMode && Full1) {
+                tile_loadd(TMM1, c1, StrideC);
+            } else {
+                MlasSBGemmInitTileC(CTile[1], c1, ldc, Mask1, (bias != nullptr) ? bias + TILE_N : nullptr, ZeroMode);
+                tile_loadd(TMM1, CTile[1], StrideTile);
+            }
+        }
+
+        const bfloat16_t* b0 = B + n * PackedCountK;
+        const bfloat16_t* b1 = b0 + TILE_N * PackedCountK;
+
+        for (size_t k = 0; k < CountK; k += TILE_K) {
+            tile_loadd(TMM2, ATile + k, StrideA);
+            tile_loadd(TMM3, b0 + k * TILE_N, StrideB);
+            tile_dpbf16ps(TMM0, TMM2, TMM3);
+            if (TwoBlocks) {
+                tile_loadd(TMM4, b1 + k * TILE_N, StrideB);
+                tile_dpbf16ps(TMM1, TMM2, TMM4);
+            }
+        }
+
+        if (Full0) {
+            tile_stored(TMM0, c0, StrideC);
+        } else {
+            tile_stored(TMM0, CTile[0], StrideTile);
+            MlasSBGemmStoreTileC(CTile[0], c0, ldc, Mask0);
+        }
+
+        if (TwoBlocks) {
+            if (Full1) {
+                tile_stored(TMM1, c1, StrideC);
+            } else {
+                tile_stored(TMM1, CTile[1], StrideTile);
+                MlasSBGemmStoreTileC(CTile[1], c1, ldc, Mask1);
+            }
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AMX>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B, ldb, CountN, CountK, MLAS_SBGEMM_KERNEL_AMX::PackedK);
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AMX>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    const size_t PackedCountK = (CountK + TILE_K - 1) & ~size_t(TILE_K - 1);
+
+    MLAS_DECLSPEC_ALIGN(uint16_t ATile[TILE_M * MLAS_SBGEMM_AMX_KCHUNK], 64);
+
+    if (CountM >= TILE_M) {
+        MlasAmxTileConfigInit();
+    }
+
+    while (CountM >= TILE_M) {
+        for (size_t k = 0; k < CountK; k += MLAS_SBGEMM_AMX_KCHUNK) {
+            const size_t ChunkK = std::min(CountK - k, MLAS_SBGEMM_AMX_KCHUNK);
+
+            MlasSBGemmConvertTileA(ATile, A + k, lda, ChunkK);
+            MlasSBGemmKernelTile(ATile, CountN, ChunkK, PackedCountK, B + k * TILE_N, C, ldc, Bias, ZeroMode && (k == 0));
+        }
+
+        C += ldc * TILE_M;
+        A += lda * TILE_M;
+        CountM -= TILE_M;
+    }
+
+    if (CountM > 0) {
+        MlasSBGemmKernelAvx512Bf16(CountM, CountN, CountK, PackedCountK, A, lda, B, C, ldc, Bias, ZeroMode);
+    }
+}
+
+/*
+    This routine packs the whole of matrix B one slice of Strides.K rows at a
+    time, as expected by MlasSBGemmPackedOperation.
+*/
+static void
+MlasSBGemmConvertPackBAmx(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AMX::PackedN;
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AMX::PackedK;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AMX::Strides;
+
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    size_t K_block_size;
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B + k * ldb, ldb, CountN, K_block_size, PackedK);
+        PackedB += AlignedN * ((K_block_size + PackedK - 1) & ~(PackedK - 1));
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAmx = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AMX>,
+    MlasSBGemmConvertPackBAmx,
+    MLAS_SBGEMM_KERNEL_AMX::PackedK,
+    MLAS_SBGEMM_KERNEL_AMX::PackedN,
+    MLAS_SBGEMM_KERNEL_AMX::KernelMaxM,
+    0  // kernel does not read beyond the packed buffer
+};
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
@@ -0,0 +1,298 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the bfloat16 precision GEMM kernel for AVX512-BF16.
+
+    Matrix A is converted to bfloat16 a panel of rows at a time. Matrix B is
+    packed in blocks of 16 columns where each 64 byte row of a block holds
+    two rows of B interleaved, so VDPBF16PS accumulates two rows of K into 16
+    columns of C with a single instruction.
+
+--*/
+
+#include <immintrin.h>
+
+#include "sbgemm.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 4;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+static_assert(MLAS_SGEMM_STRIDEN_THREAD_ALIGN == 16, "packed B blocks are one 512-bit vector wide");
+
+//
+// Number of K elements of A converted to bfloat16 at a time.
+//
+constexpr size_t MLAS_SBGEMM_AVX512BF16_KCHUNK = 512;
+
+MLAS_FORCEINLINE
+__m512bh
+MlasCastToBf16x32(__m512i Vector)
+{
+    return (__m512bh)Vector;
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmColumnMask(size_t CountN)
+{
+    return CountN >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+}
+
+/*
+    This routine converts fp32 to bf16 and copies elements from the source
+    matrix to the destination packed buffer.
+
+    Each block of 16 columns is stored as CountK rows rounded up to PackedK,
+    two rows of the source interleaved per 64 byte row of the block. The
+    remaining columns and rows are padded with zeros.
+*/
+void
+MlasSBGemmConvertCopyPackBAvx512Bf16(
+    bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK, size_t PackedK
+)
+{
+    const size_t AlignedCountK = (CountK + PackedK - 1) & ~(PackedK - 1);
+
+    //
+    // Interleave the low and high halves of the converted vector so that the
+    // elements of a column in both rows are adjacent.
+    //
+    const __m512i Interleave = _mm512_set_epi16(
+        31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9, 24, 8,
+        23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0
+    );
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const __mmask16 Mask = MlasSBGemmColumnMask(CountN - n);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < AlignedCountK; k += 2) {
+            const __m512 Row0 = (k < CountK) ? _mm512_maskz_loadu_ps(Mask, b + k * ldb) : _mm512_setzero_ps();
+            const __m512 Row1 = (k + 1 < CountK) ? _mm512_maskz_loadu_ps(Mask, b + (k + 1) * ldb) : _mm512_setzero_ps();
+
+            const __m512i Converted = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(Interleave, Converted));
+            D += 32;
+        }
+    }
+}
+
+/*
+    This routine converts CountK elements of CountM rows of A to bf16. Each
+    row of the destination holds RowPairs 32-bit pairs, the pairs past CountK
+    up to the next multiple of 32 elements are zero.
+*/
+static
+void
+MlasSBGemmConvertA(
+    uint32_t* D, size_t RowPairs, const float* A, size_t lda, size_t CountM, size_t CountK
+)
+{
+    for (size_t m = 0; m < CountM; m++) {
+        uint32_t* d = D + m * RowPairs;
+        const float* a = A + m * lda;
+
+        for (size_t k = 0; k < CountK; k += 32) {
+            const __mmask16 Mask0 = MlasSBGemmColumnMask(CountK - k);
+            const __mmask16 Mask1 = (k + 16 < CountK) ? MlasSBGemmColumnMask(CountK - k - 16) : __mmask16(0);
+
+            const __m512 Low = _mm512_maskz_loadu_ps(Mask0, a + k);
+            const __m512 High = _mm512_maskz_loadu_ps(Mask1, a + k + 16);
+            _mm512_storeu_si512(d + k / 2, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+        }
+    }
+}
+
+/*
+    This routine computes up to KernelMaxM rows of C for the K range of the
+    converted panel of A, 32 columns at a time.
+*/
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasSBGemmKernelRows(
+    const uint32_t* A,
+    size_t RowPairs,
+    size_t CountN,
+    size_t CountPairs,
+    size_t PackedCountK,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    for (size_t n = 0; n < CountN; n += 32) {
+        const bool TwoBlocks = CountN - n > 16;
+        const __mmask16 Mask0 = MlasSBGemmColumnMask(CountN - n);
+        const __mmask16 Mask1 = TwoBlocks ? MlasSBGemmColumnMask(CountN - n - 16) : __mmask16(0);
+
+        __m512 Accumulators[RowCount][2];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            if (ZeroMode) {
+                Accumulators[r][0] = Bias != nullptr ? _mm512_maskz_loadu_ps(Mask0, Bias + n) : _mm512_setzero_ps();
+                Accumulators[r][1] = Bias != nullptr ? _mm512_maskz_loadu_ps(Mask1, Bias + n + 16) : _mm512_setzero_ps();
+            } else {
+                Accumulators[r][0] = _mm512_maskz_loadu_ps(Mask0, C + r * ldc + n);
+                Accumulators[r][1] = _mm512_maskz_loadu_ps(Mask1, C + r * ldc + n + 16);
+            }
+        }
+
+        const bfloat16_t* b0 = B + n * PackedCountK;
+        const bfloat16_t* b1 = b0 + 16 * PackedCountK;
+
+        if (TwoBlocks) {
+            for (size_t p = 0; p < CountPairs; p++) {
+                const __m512bh BElements0 = MlasCastToBf16x32(_mm512_loadu_si512(b0 + p * 32));
+                const __m512bh BElements1 = MlasCastToBf16x32(_mm512_loadu_si512(b1 + p * 32));
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m512bh AElements = MlasCastToBf16x32(_mm512_set1_epi32(int(A[r * RowPairs + p])));
+                    Accumulators[r][0] = _mm512_dpbf16_ps(Accumulators[r][0], AElements, BElements0);
+                    Accumulators[r][1] = _mm512_dpbf16_ps(Accumulators[r][1], AElements, BElements1);
+                }
+            }
+        } else {
+            for (size_t p = 0; p < CountPairs; p++) {
+                const __m512bh BElements0 = MlasCastToBf16x32(_mm512_loadu_si512(b0 + p * 32));
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m512bh AElements = MlasCastToBf16x32(_mm512_set1_epi32(int(A[r * RowPairs + p])));
+                    Accumulators[r][0] = _mm512_dpbf16_ps(Accumulators[r][0], AElements, BElements0);
+                }
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            _mm512_mask_storeu_ps(C + r * ldc + n, Mask0, Accumulators[r][0]);
+            if (TwoBlocks) {
+                _mm512_mask_storeu_ps(C + r * ldc + n + 16, Mask1, Accumulators[r][1]);
+            }
+        }
+    }
+}
+
+void
+MlasSBGemmKernelAvx512Bf16(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t PackedCountK,
+    const float* A,
+    size_t lda,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t RowPairs = MLAS_SBGEMM_AVX512BF16_KCHUNK / 2;
+
+    MLAS_DECLSPEC_ALIGN(uint32_t PanelA[KernelMaxM * RowPairs], 64);
+
+    while (CountM > 0) {
+        const size_t RowsHandled = std::min(CountM, KernelMaxM);
+
+        for (size_t k = 0; k < CountK; k += MLAS_SBGEMM_AVX512BF16_KCHUNK) {
+            const size_t ChunkK = std::min(CountK - k, MLAS_SBGEMM_AVX512BF16_KCHUNK);
+            const size_t ChunkPairs = (ChunkK + 1) / 2;
+            const bool ChunkZeroMode = ZeroMode && (k == 0);
+            const bfloat16_t* b = B + k * 16;
+
+            MlasSBGemmConvertA(PanelA, RowPairs, A + k, lda, RowsHandled, ChunkK);
+
+            switch (RowsHandled) {
+                case 4:
+                    MlasSBGemmKernelRows<4>(PanelA, RowPairs, CountN, ChunkPairs, PackedCountK, b, C, ldc, Bias, ChunkZeroMode);
+                    break;
+                case 3:
+                    MlasSBGemmKernelRows<3>(PanelA, RowPairs, CountN, ChunkPairs, PackedCountK, b, C, ldc, Bias, ChunkZeroMode);
+                    break;
+                case 2:
+                    MlasSBGemmKernelRows<2>(PanelA, RowPairs, CountN, ChunkPairs, PackedCountK, b, C, ldc, Bias, ChunkZeroMode);
+                    break;
+                default:
+                    MlasSBGemmKernelRows<1>(PanelA, RowPairs, CountN, ChunkPairs, PackedCountK, b, C, ldc, Bias, ChunkZeroMode);
+                    break;
+            }
+        }
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B, ldb, CountN, CountK, MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK);
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    const size_t PackedCountK = (CountK + PackedK - 1) & ~(PackedK - 1);
+
+    MlasSBGemmKernelAvx512Bf16(CountM, CountN, CountK, PackedCountK, A, lda, B, C, ldc, Bias, ZeroMode);
+}
+
+/*
+    This routine packs the whole of matrix B one slice of Strides.K rows at a
+    time, as expected by MlasSBGemmPackedOperation.
+*/
+static void
+MlasSBGemmConvertPackBAvx512Bf16(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN;
+    constexpr size_t PackedK = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    size_t K_block_size;
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B + k * ldb, ldb, CountN, K_block_size, PackedK);
+        PackedB += AlignedN * ((K_block_size + PackedK - 1) & ~(PackedK - 1));
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackBAvx512Bf16,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0  // kernel does not read beyond the packed buffer
+};
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
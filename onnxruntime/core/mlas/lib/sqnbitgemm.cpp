@@ -30,6 +30,10 @@ enum SQNBitGemmVariant {
 
     SQNBitGemmVariant_BitWidth4_CompFp32 = 0,
     SQNBitGemmVariant_BitWidth4_CompInt8,
+    SQNBitGemmVariant_BitWidth2_CompFp32,
+    SQNBitGemmVariant_BitWidth2_CompInt8,
+    SQNBitGemmVariant_BitWidth3_CompFp32,
+    SQNBitGemmVariant_BitWidth3_CompInt8,
 
     // End of valid variants
 
@@ -55,6 +59,18 @@ GetSQNBitGemmVariant(
         }
     }
 
+    // 2-bit and 3-bit B data is packed in sub-blocks of MlasQNBitLowBitSubBlkLen values
+    if (MlasQNBitIsLowBitWidth(BlkBitWidth) &&
+        (BlkLen == 32 || BlkLen == 64 || BlkLen == 128)) {
+        const bool Is2Bit = BlkBitWidth == 2;
+        if (ComputeType == CompFp32 ||
+            ComputeType == CompUndef) {  // treat CompUndef (undefined) as CompFp32
+            return Is2Bit ? SQNBitGemmVariant_BitWidth2_CompFp32 : SQNBitGemmVariant_BitWidth3_CompFp32;
+        } else if (ComputeType == CompInt8) {
+            return Is2Bit ? SQNBitGemmVariant_BitWidth2_CompInt8 : SQNBitGemmVariant_BitWidth3_CompInt8;
+        }
+    }
+
     return SQNBitGemmVariantInvalid;
 }
 
@@ -84,6 +100,17 @@ MlasIsSQNBitGemmAvailable(
               (Dispatch->SQ4BitGemmKernel_CompInt8 != nullptr && Dispatch->QuantizeARow_CompInt8 != nullptr) ||
               (Dispatch->SQ4BitGemmKernel_BlkSum_CompInt8 != nullptr && Dispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr);
         }
+        case SQNBitGemmVariant_BitWidth2_CompFp32:
+        case SQNBitGemmVariant_BitWidth3_CompFp32: {
+            return Dispatch->SQLowBitGemmM1Kernel_CompFp32 != nullptr &&
+                   Dispatch->QLowBitBlkDequantBForSgemm_CompFp32 != nullptr;
+        }
+        case SQNBitGemmVariant_BitWidth2_CompInt8:
+        case SQNBitGemmVariant_BitWidth3_CompInt8: {
+            return Dispatch->SQLowBitGemmKernel_CompInt8 != nullptr &&
+                   (Dispatch->QuantizeARow_CompInt8 != nullptr ||
+                    Dispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr);
+        }
         default: {
             return false;
         }
@@ -108,7 +135,9 @@ SQNBitGemmPerGemmWorkspaceSize(
         return 0;
     }
 
-    if (BlkBitWidth == 4 && Dispatch->SQ4BitGemmPerGemmWorkspaceSize != nullptr) {
+    // the workspace holds the quantized A, which does not depend on the bit width of B
+    if ((BlkBitWidth == 4 || MlasQNBitIsLowBitWidth(BlkBitWidth)) &&
+        Dispatch->SQ4BitGemmPerGemmWorkspaceSize != nullptr) {
         return Dispatch->SQ4BitGemmPerGemmWorkspaceSize(M, N, K, BlkLen, ComputeType);
     }
 
@@ -127,7 +156,8 @@ SQNBitGemmPerGemmWorkspaceAlignment(
         return 1;
     }
 
-    if (BlkBitWidth == 4 && Dispatch->SQ4BitGemmPerGemmWorkspaceAlignment != nullptr) {
+    if ((BlkBitWidth == 4 || MlasQNBitIsLowBitWidth(BlkBitWidth)) &&
+        Dispatch->SQ4BitGemmPerGemmWorkspaceAlignment != nullptr) {
         return Dispatch->SQ4BitGemmPerGemmWorkspaceAlignment(BlkLen, ComputeType);
     }
 
@@ -194,9 +224,92 @@ MlasSQNBitGemmPackQuantBDataSize(
         );
     }
 
+    if (MlasQNBitIsLowBitWidth(BlkBitWidth) &&
+        GetSQNBitGemmVariant(BlkBitWidth, BlkLen, ComputeType) != SQNBitGemmVariantInvalid) {
+        // the low bit packed layout has the same size as the input
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        return N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    }
+
     return 0;
 }
 
+namespace
+{
+
+void
+SQLowBitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    constexpr size_t SubBlkLen = MlasQNBitLowBitSubBlkLen;
+
+    assert(BlkLen % SubBlkLen == 0);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, SubBlkLen);
+    const size_t SubBlkCountPerBlk = BlkLen / SubBlkLen;
+    const uint32_t ValueMask = (1u << BlkBitWidth) - 1;
+
+    //
+    // Repack each sub-block of 32 values from a little-endian bit stream to the low bit and high bit planes
+    // described at MlasQNBitLowBitSubBlkLen.
+    //
+
+    const size_t Iterations = N * BlockCountK;  // one iteration per block
+
+    MlasTrySimpleParallel(
+        ThreadPool, Iterations,
+        [&](ptrdiff_t tid) {
+            const size_t data_offset = static_cast<size_t>(tid) * BlkDataSize;
+            const std::byte* QuantBData = QuantBDataBegin + data_offset;
+            std::byte* PackedQuantBData = PackedQuantBDataBegin + data_offset;
+
+            for (size_t subblk = 0; subblk < SubBlkCountPerBlk; ++subblk) {
+                uint8_t values[SubBlkLen];
+                for (size_t i = 0; i < SubBlkLen; ++i) {
+                    const size_t bit_offset = i * BlkBitWidth;
+                    uint32_t bits = std::to_integer<uint32_t>(QuantBData[bit_offset / 8]);
+                    if (bit_offset % 8 + BlkBitWidth > 8) {
+                        bits |= std::to_integer<uint32_t>(QuantBData[bit_offset / 8 + 1]) << 8;
+                    }
+                    values[i] = static_cast<uint8_t>((bits >> (bit_offset % 8)) & ValueMask);
+                }
+
+                for (size_t j = 0; j < 8; ++j) {
+                    const uint32_t low_bits = (values[j] & 0x3) |
+                                              ((values[j + 8] & 0x3) << 2) |
+                                              ((values[j + 16] & 0x3) << 4) |
+                                              ((values[j + 24] & 0x3) << 6);
+                    PackedQuantBData[j] = static_cast<std::byte>(low_bits);
+                }
+
+                if (BlkBitWidth == 3) {
+                    for (size_t j = 0; j < 4; ++j) {
+                        uint32_t high_bits = 0;
+                        for (size_t b = 0; b < 8; ++b) {
+                            high_bits |= ((values[j * 8 + b] >> 2) & 0x1) << b;
+                        }
+                        PackedQuantBData[8 + j] = static_cast<std::byte>(high_bits);
+                    }
+                }
+
+                QuantBData += SubBlkDataSize;
+                PackedQuantBData += SubBlkDataSize;
+            }
+        }
+    );
+}
+
+}  // namespace
+
 struct PerGemmQuantAWorkspace {
     PerGemmQuantAWorkspace(void* PerGemmWorkspace, size_t M, size_t BlockCountK, size_t BlkLen)
         : PerGemmWorkspace_(PerGemmWorkspace), M_(M), BlockCountK_(BlockCountK), BlkLen_(BlkLen)
@@ -232,6 +345,20 @@ MlasSQNBitGemmPackQuantBData(
         return;
     }
 
+    if (MlasQNBitIsLowBitWidth(BlkBitWidth)) {
+        // only the B data is packed, calls with just the scales or zero points have nothing to do
+        if (QuantBData != nullptr &&
+            GetSQNBitGemmVariant(BlkBitWidth, BlkLen, ComputeType) != SQNBitGemmVariantInvalid) {
+            SQLowBitGemmPackQuantBData(
+                N, K, BlkBitWidth, BlkLen,
+                static_cast<const std::byte*>(QuantBData),
+                static_cast<std::byte*>(PackedQuantBDataAndOrBlkSumWorkspace),
+                ThreadPool
+            );
+        }
+        return;
+    }
+
     if (BlkBitWidth == 4) {
         if (ComputeType == CompInt8 && Dispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
             const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
@@ -306,8 +433,9 @@ typedef void(SQNBitGemmFn)(
     size_t RangeCountN
 );
 
+template <size_t BlkBitWidth>
 void
-SQ4BitGemm_CompFp32(
+SQNBitGemm_CompFp32(
     const size_t BlkLen,
     const size_t K,
     const MLAS_SQNBIT_GEMM_DATA_PARAMS* const DataParams,
@@ -318,7 +446,7 @@ SQ4BitGemm_CompFp32(
     const size_t RangeCountN
 )
 {
-    constexpr size_t BlkBitWidth = 4;
+    static_assert(BlkBitWidth == 4 || MlasQNBitIsLowBitWidth(BlkBitWidth));
 
     MLAS_UNREFERENCED_PARAMETER(PerGemmWorkspace);
 
@@ -355,10 +483,17 @@ SQ4BitGemm_CompFp32(
             float* c_blk = C + n;
             const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-            GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompFp32(
-                BlkLen,
-                a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
-            );
+            if constexpr (BlkBitWidth == 4) {
+                GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompFp32(
+                    BlkLen,
+                    a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
+                );
+            } else {
+                GetMlasPlatform().SQNBitGemmDispatch->SQLowBitGemmM1Kernel_CompFp32(
+                    BlkBitWidth, BlkLen,
+                    a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
+                );
+            }
 
             if (DataParams->PostProcessor != nullptr) {
                 DataParams->PostProcessor->Process(
@@ -393,10 +528,17 @@ SQ4BitGemm_CompFp32(
         float* c_blk = C + n;
         const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-        GetMlasPlatform().SQNBitGemmDispatch->Q4BitBlkDequantBForSgemm_CompFp32(
-            BlkLen,
-            dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
-        );
+        if constexpr (BlkBitWidth == 4) {
+            GetMlasPlatform().SQNBitGemmDispatch->Q4BitBlkDequantBForSgemm_CompFp32(
+                BlkLen,
+                dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
+            );
+        } else {
+            GetMlasPlatform().SQNBitGemmDispatch->QLowBitBlkDequantBForSgemm_CompFp32(
+                BlkBitWidth, BlkLen,
+                dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
+            );
+        }
 
         size_t RowsRemaining = RangeCountM;
         while (RowsRemaining > 0) {
@@ -554,6 +696,97 @@ SQ4BitGemm_CompInt8(
     }
 }
 
+template <size_t BlkBitWidth>
+void
+SQLowBitGemm_CompInt8(
+    const size_t BlkLen,
+    const size_t K,
+    const MLAS_SQNBIT_GEMM_DATA_PARAMS* const DataParams,
+    void* const PerGemmWorkspace,
+    const size_t RangeStartM,
+    const size_t RangeCountM,
+    const size_t RangeStartN,
+    const size_t RangeCountN
+)
+{
+    static_assert(MlasQNBitIsLowBitWidth(BlkBitWidth));
+
+    const size_t k_blks = MlasDivRoundup(K, BlkLen);
+
+    const size_t ldc = DataParams->ldc;
+    const size_t ldb = k_blks * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t k_blks_zp_bytes = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(k_blks);
+
+#ifdef MLAS_TARGET_AMD64_IX86
+    // A is quantized by QuantizeARowComputeBlkSum_CompInt8
+    PerGemmQuantAWorkspace* const per_gemm_quant_a_workspace = static_cast<PerGemmQuantAWorkspace*>(PerGemmWorkspace);
+
+    const size_t lda = k_blks * BlkLen;
+    const std::byte* QuantA = per_gemm_quant_a_workspace->QuantData + RangeStartM * lda;
+    const float* QuantAScale = per_gemm_quant_a_workspace->QuantScale + RangeStartM * k_blks;
+    const float* ABlockSum = per_gemm_quant_a_workspace->BlockSum + RangeStartM * k_blks;
+    const size_t lda_scale = k_blks;
+#else
+    // A is quantized by QuantizeARow_CompInt8, the scales are embedded in QuantA
+    const size_t lda = k_blks * Q8BlkSize(BlkLen);
+    const std::byte* QuantA = static_cast<const std::byte*>(PerGemmWorkspace) + RangeStartM * lda;
+    const float* QuantAScale = nullptr;
+    const float* ABlockSum = nullptr;
+    const size_t lda_scale = 0;
+#endif
+
+    const std::byte* QuantBData = static_cast<const std::byte*>(DataParams->PackedQuantBData) + RangeStartN * ldb;
+    const float* QuantBScale = DataParams->QuantBScale + RangeStartN * k_blks;
+    const std::byte* QuantBZeroPoint =
+        (DataParams->QuantBZeroPoint == nullptr)
+            ? nullptr
+            : static_cast<const std::byte*>(DataParams->QuantBZeroPoint) + RangeStartN * k_blks_zp_bytes;
+
+    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+
+    const float* Bias = (DataParams->Bias == nullptr) ? nullptr : DataParams->Bias + RangeStartN;
+
+    size_t CountN;
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+        CountN = std::min(RangeCountN - n, size_t{128});
+
+        const std::byte* a_row = QuantA;
+        const float* a_row_scale = QuantAScale;
+        const float* a_row_blk_sum = ABlockSum;
+        const std::byte* b_col = QuantBData + n * ldb;
+        const float* b_col_scale = QuantBScale + n * k_blks;
+        const std::byte* b_col_zp =
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * k_blks_zp_bytes;
+        float* c_blk = C + n;
+        const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
+
+        size_t RowsRemaining = RangeCountM;
+        while (RowsRemaining > 0) {
+            const auto RowsHandled = GetMlasPlatform().SQNBitGemmDispatch->SQLowBitGemmKernel_CompInt8(
+                BlkBitWidth, BlkLen,
+                a_row, a_row_scale, a_row_blk_sum, b_col, b_col_scale, b_col_zp, c_blk,
+                RowsRemaining, CountN, K, k_blks, ldc, bias
+            );
+
+            if (DataParams->PostProcessor != nullptr) {
+                DataParams->PostProcessor->Process(
+                    DataParams->C, RangeStartM + RangeCountM - RowsRemaining, RangeStartN + n,
+                    RowsHandled, CountN, ldc
+                );
+            }
+
+            c_blk += RowsHandled * ldc;
+            a_row += RowsHandled * lda;
+            if (a_row_scale != nullptr) {
+                a_row_scale += RowsHandled * lda_scale;
+                a_row_blk_sum += RowsHandled * lda_scale;
+            }
+
+            RowsRemaining -= RowsHandled;
+        }
+    }
+}
+
 typedef void(InitializeWorkspaceFn)(
     size_t M,
     size_t N,
@@ -630,11 +863,19 @@ struct Operations {
 constexpr auto OperationMap = []() {
     std::array<Operations, SQNBitGemmVariantCount> ops;
 
-    ops[SQNBitGemmVariant_BitWidth4_CompFp32].SQNBitGemm = SQ4BitGemm_CompFp32;
+    ops[SQNBitGemmVariant_BitWidth4_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<4>;
 
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].InitializeWorkspace = InitializeWorkspace_CompInt8;
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].SQNBitGemm = SQ4BitGemm_CompInt8;
 
+    ops[SQNBitGemmVariant_BitWidth2_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<2>;
+    ops[SQNBitGemmVariant_BitWidth3_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<3>;
+
+    ops[SQNBitGemmVariant_BitWidth2_CompInt8].InitializeWorkspace = InitializeWorkspace_CompInt8;
+    ops[SQNBitGemmVariant_BitWidth2_CompInt8].SQNBitGemm = SQLowBitGemm_CompInt8<2>;
+    ops[SQNBitGemmVariant_BitWidth3_CompInt8].InitializeWorkspace = InitializeWorkspace_CompInt8;
+    ops[SQNBitGemmVariant_BitWidth3_CompInt8].SQNBitGemm = SQLowBitGemm_CompInt8<3>;
+
     return ops;
 }();
 }  // namespace
@@ -680,18 +921,29 @@ MlasSQNBitGemmBatch(
 
     const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
 
+    // x64 CompInt8 kernels take A quantized with its block sums, see PerGemmQuantAWorkspace
+    const bool UseQuantAWorkspace =
+        ComputeType == CompInt8 && GetMlasPlatform().SQNBitGemmDispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr;
+    // 4-bit B is packed together with its scales and block sums
+    const bool UsePackedQuantBWorkspace =
+        BlkBitWidth == 4 && ComputeType == CompInt8 &&
+        GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr;
+
     if (ThreadPool == nullptr) {
         for (size_t gemm_i = 0; gemm_i < BatchN; gemm_i++) {
             const auto* Data = &DataParams[gemm_i];
             void* PerGemmWorkspace =
                 reinterpret_cast<std::byte*>(Workspace) + gemm_i * PerGemmWorkspaceStride;
-            if (ComputeType == CompInt8 && GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
+            if (UsePackedQuantBWorkspace) {
                 PackedQuantBDataStruct packed_quant_b(const_cast<void*>(Data->QuantBDataWorkspace), N, BlockCountK, BlkLen);
                 const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->PackedQuantBData = packed_quant_b.PackedQuantBData;
                 const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->QuantBBlkSum = packed_quant_b.QuantBBlkSum;
                 const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->QuantBScale = packed_quant_b.PackedQuantBScale;
                 PerGemmQuantAWorkspace per_gemm_quant_a_workspace(PerGemmWorkspace, M, BlockCountK, BlkLen);
                 ComputeOperation(BlkLen, K, Data, &per_gemm_quant_a_workspace, 0, M, 0, N);
+            } else if (UseQuantAWorkspace) {
+                PerGemmQuantAWorkspace per_gemm_quant_a_workspace(PerGemmWorkspace, M, BlockCountK, BlkLen);
+                ComputeOperation(BlkLen, K, Data, &per_gemm_quant_a_workspace, 0, M, 0, N);
             } else {
                 ComputeOperation(BlkLen, K, Data, PerGemmWorkspace, 0, M, 0, N);
             }
@@ -756,12 +1008,15 @@ MlasSQNBitGemmBatch(
 
         void* PerGemmWorkspace =
             reinterpret_cast<std::byte*>(Workspace) + gemm_i * PerGemmWorkspaceStride;
-        if (ComputeType == CompInt8 && GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
+        if (UsePackedQuantBWorkspace) {
             PackedQuantBDataStruct packed_quant_b(const_cast<void*>(Data->QuantBDataWorkspace), N, BlockCountK, BlkLen);
             const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->PackedQuantBData = packed_quant_b.PackedQuantBData;
             const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->QuantBBlkSum = packed_quant_b.QuantBBlkSum;
             const_cast<MLAS_SQNBIT_GEMM_DATA_PARAMS*>(Data)->QuantBScale = packed_quant_b.PackedQuantBScale;
 
+            PerGemmQuantAWorkspace per_gemm_quant_a_workspace(PerGemmWorkspace, M, BlockCountK, BlkLen);
+            ComputeOperation(BlkLen, K, Data, &per_gemm_quant_a_workspace, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+        } else if (UseQuantAWorkspace) {
             PerGemmQuantAWorkspace per_gemm_quant_a_workspace(PerGemmWorkspace, M, BlockCountK, BlkLen);
             ComputeOperation(BlkLen, K, Data, &per_gemm_quant_a_workspace, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
         } else {
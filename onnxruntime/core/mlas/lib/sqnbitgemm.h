@@ -73,13 +73,58 @@ template <size_t BlkBitWidth>
 constexpr MLAS_FORCEINLINE size_t
 MlasQNBitZeroPointsForBlksSizeInBytes(size_t BlkCount)
 {
-    if constexpr (BlkBitWidth <= 4) {
+    if constexpr (BlkBitWidth == 4) {
         return MlasDivRoundup(BlkCount, 2);  // 2 blocks per byte
+    } else if constexpr (BlkBitWidth < 8) {
+        return MlasDivRoundup(BlkCount * BlkBitWidth, 8);  // bit packed, a zero point may span two bytes
     } else {
         return BlkCount;
     }
 }
 
+//
+// Low bit (2-bit and 3-bit) quantized B data.
+//
+// The quantized B data of MatMulNBits stores the values of a block as a little-endian bit stream. For 2-bit and 3-bit
+// values, MlasSQNBitGemmPackQuantBData() repacks each block into sub-blocks of 32 values, which can be expanded to
+// bytes with a few vector shifts:
+//
+//  - 8 bytes of low bits. Byte j holds bits 0-1 of the values j, j + 8, j + 16 and j + 24 in bits 0-1, 2-3, 4-5 and
+//    6-7 respectively.
+//  - 3-bit only: 4 bytes of high bits. Bit i of this little-endian 32-bit word is bit 2 of value i.
+//
+// The packed data has the same size as the unpacked data.
+//
+
+constexpr size_t MlasQNBitLowBitSubBlkLen = 32;
+
+constexpr MLAS_FORCEINLINE bool
+MlasQNBitIsLowBitWidth(size_t BlkBitWidth)
+{
+    return BlkBitWidth == 2 || BlkBitWidth == 3;
+}
+
+/**
+ * @brief Gets the zero point of a block from the bit packed zero points of one column of quantized B.
+ *        The default zero point 2^(BlkBitWidth - 1) is returned if no zero points are given.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE uint8_t
+MlasQNBitLowBitZeroPoint(const std::byte* QuantBZeroPointCol, size_t BlkIdx)
+{
+    if (QuantBZeroPointCol == nullptr) {
+        return static_cast<uint8_t>(1 << (BlkBitWidth - 1));
+    }
+
+    const size_t BitOffset = BlkIdx * BlkBitWidth;
+    const std::byte* ZeroPointBytes = QuantBZeroPointCol + BitOffset / 8;
+    uint32_t Bits = std::to_integer<uint32_t>(ZeroPointBytes[0]);
+    if (BitOffset % 8 + BlkBitWidth > 8) {
+        Bits |= std::to_integer<uint32_t>(ZeroPointBytes[1]) << 8;
+    }
+    return static_cast<uint8_t>((Bits >> (BitOffset % 8)) & ((1u << BlkBitWidth) - 1));
+}
+
 //
 // Kernel dispatch structure.
 //
@@ -337,4 +382,103 @@ struct MLAS_SQNBIT_GEMM_DISPATCH {
         float* AScaledGroupSum  // scale_k * Sum_blklen(a_i)
     );
     QuantizeARowComputeBlkSum_CompInt8_Fn* QuantizeARowComputeBlkSum_CompInt8 = nullptr;
+
+    //
+    // Low bit (2-bit and 3-bit) kernel function prototypes.
+    //
+    // The quantized B data is packed into sub-blocks by MlasSQNBitGemmPackQuantBData(), see
+    // MlasQNBitLowBitSubBlkLen. The zero points are bit packed per column as in the MatMulNBits input.
+    //
+
+    /**
+     * @brief Multiply float matrix A with quantized 2-bit or 3-bit integer matrix B.
+     *        B is block quantized and column major.
+     *        This kernel handles the special case where M, the number of rows of A and C, is 1.
+     *        See SQ4BitGemmM1Kernel_CompFp32 for the other parameters.
+     *
+     * @param       BlkBitWidth         Quantized value bit width, 2 or 3.
+     */
+    typedef void(SQLowBitGemmM1Kernel_CompFp32_Fn)(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        const float* A,
+        const std::byte* QuantBData,
+        const float* QuantBScale,
+        const std::byte* QuantBZeroPoint,
+        float* C,
+        size_t CountN,
+        size_t CountK,
+        size_t BlockStrideQuantB,
+        const float* Bias
+    );
+
+    SQLowBitGemmM1Kernel_CompFp32_Fn* SQLowBitGemmM1Kernel_CompFp32 = nullptr;
+
+    /**
+     * @brief Dequantize 2-bit or 3-bit B into the format expected by the Sgemm kernel.
+     *        Only the first CountK rows of each 16 column panel are written.
+     *        See Q4BitBlkDequantBForSgemm_CompFp32 for the other parameters.
+     *
+     * @param       BlkBitWidth         Quantized value bit width, 2 or 3.
+     */
+    typedef void(QLowBitBlkDequantBForSgemm_CompFp32_Fn)(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        float* FpData,
+        const std::byte* QuantBData,
+        const float* QuantBScale,
+        const std::byte* QuantBZeroPoint,
+        size_t CountN,
+        size_t CountK,
+        size_t BlockStrideQuantB
+    );
+
+    QLowBitBlkDequantBForSgemm_CompFp32_Fn* QLowBitBlkDequantBForSgemm_CompFp32 = nullptr;
+
+    /**
+     * @brief Multiply quantized 8-bit integer matrix A with quantized 2-bit or 3-bit integer matrix B.
+     *        A and B are block quantized and B is column major.
+     *
+     *        A is quantized by QuantizeARowComputeBlkSum_CompInt8 if it is set. QuantA then holds BlkLen int8 values
+     *        per block, and QuantAScale and ABlockSum hold the scale and the scaled sum of the values of each block.
+     *        Otherwise A is quantized by QuantizeARow_CompInt8, QuantA holds the blocks with their scales and
+     *        QuantAScale and ABlockSum are nullptr.
+     *
+     * @param       BlkBitWidth         Quantized value bit width, 2 or 3.
+     * @param       BlkLen              Number of values in a block.
+     * @param       QuantA              Supplies the quantized A matrix.
+     * @param       QuantAScale         Supplies the block scales of A. Optional.
+     * @param       ABlockSum           Supplies the block sums of A. Optional.
+     * @param       QuantBData          Supplies the quantized B matrix block data.
+     * @param       QuantBScale         Supplies the quantized B matrix block scale values.
+     * @param       QuantBZeroPoint     Supplies the quantized B matrix block zero point values. Optional.
+     * @param[out]  C                   Supplies the output C matrix.
+     * @param       CountM              Number of rows of A and C to process, an upper bound.
+     * @param       CountN              Number of columns of B and C to process.
+     * @param       CountK              Number of columns of A and rows of B.
+     * @param       BlockCountK         Number of blocks in one row of A and one column of B.
+     * @param       ldc                 Number of elements between adjacent rows of C.
+     * @param       Bias                Bias vector of length N.
+     *
+     * @return                          The number of rows of A and C that were processed, at most CountM.
+     */
+    typedef size_t(SQLowBitGemmKernel_CompInt8_Fn)(
+        size_t BlkBitWidth,
+        size_t BlkLen,
+        const std::byte* QuantA,
+        const float* QuantAScale,
+        const float* ABlockSum,
+        const std::byte* QuantBData,
+        const float* QuantBScale,
+        const std::byte* QuantBZeroPoint,
+        float* C,
+        size_t CountM,
+        size_t CountN,
+        size_t CountK,
+        size_t BlockCountK,
+        size_t ldc,
+        const float* Bias
+    );
+
+    SQLowBitGemmKernel_CompInt8_Fn* SQLowBitGemmKernel_CompInt8 = nullptr;
 };
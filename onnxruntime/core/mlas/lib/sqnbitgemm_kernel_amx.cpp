@@ -0,0 +1,331 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the CompInt8 kernel of the 4-bit SQNBitGemm for
+    AMX-INT8.
+
+    Matrix B is packed in groups of 16 columns. For each block of BlkLen
+    values along K, a group holds BlkLen/8 rows of 4 bytes per column. The
+    low and high nibbles of a byte are the values k and k+4 of a column, so
+    masking and shifting a row gives two rows of the VNNI layout consumed by
+    TDPBSUD. The scales of a group are stored block major and the block sums
+    of B use the layout of the AVX512 kernels.
+
+    Blocks of 16 rows of A are computed with AMX tiles. Rows left over after
+    the last full block of 16 are computed by AVX512-VNNI from the same
+    unpacked block of B.
+
+--*/
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "sqnbitgemm_kernel_amx.h"
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 64
+
+//
+// Largest block length supported by MlasIsSQNBitGemmAvailable().
+//
+constexpr size_t MLAS_SQNBIT_AMX_MAX_BLKLEN = 256;
+
+static void
+SQ4BitGemmPackQuantBDataAmx(
+    size_t N,
+    size_t BlockCountK,
+    size_t BlkLen,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ldb = BlockCountK * BlkDataSize;
+    const size_t GroupCount = MlasDivRoundup(N, TILE_N);
+
+    //
+    // For each group of 16 columns and each 8 values of a block, pack the
+    // values k to k+7 of the columns like this:
+    //
+    // src: | v0 v1 | v2 v3 | v4 v5 | v6 v7 |  (per column)
+    //   =>
+    // dst: | c0v0 c0v4 | c0v1 c0v5 | c0v2 c0v6 | c0v3 c0v7 | c1v0 c1v4 | ... | c15v3 c15v7 |
+    //
+
+    MlasTrySimpleParallel(
+        ThreadPool, GroupCount * BlockCountK,
+        [&](ptrdiff_t tid) {
+            const size_t n = (tid / BlockCountK) * TILE_N;
+            const size_t k_blk = tid % BlockCountK;
+            const size_t CountN = std::min(N - n, size_t{TILE_N});
+
+            const std::byte* QuantBData = QuantBDataBegin + n * ldb + k_blk * BlkDataSize;
+            std::byte* PackedQuantBData = PackedQuantBDataBegin + n * ldb + k_blk * CountN * BlkDataSize;
+
+            for (size_t k = 0; k < BlkLen; k += 8) {
+                for (size_t nn = 0; nn < CountN; nn++) {
+                    const std::byte* src = QuantBData + nn * ldb + k / 2;
+                    std::byte* dst = PackedQuantBData + nn * 4;
+
+                    for (size_t kk = 0; kk < 2; kk++) {
+                        const std::byte src0 = src[kk];
+                        const std::byte src1 = src[kk + 2];
+
+                        dst[2 * kk] = (src0 & std::byte{0x0F}) | ((src1 & std::byte{0x0F}) << 4);
+                        dst[2 * kk + 1] = (src0 >> 4) | ((src1 >> 4) << 4);
+                    }
+                }
+
+                PackedQuantBData += CountN * 4;
+            }
+        }
+    );
+}
+
+static void
+SQ4BitGemmPackQuantBScaleAndBlkSumAmx(
+    size_t N,
+    size_t BlockCountK,
+    float* QuantBScaleBegin,
+    const std::byte* QuantBZPBegin,
+    float* BlockSumBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    const std::vector<float> QuantBScaleCopy(QuantBScaleBegin, QuantBScaleBegin + N * BlockCountK);
+
+    MlasTrySimpleParallel(ThreadPool, N * BlockCountK, [&](ptrdiff_t tid) {
+        const size_t n = tid / BlockCountK;
+        const size_t k_blk = tid % BlockCountK;
+
+        const float QuantBScale = QuantBScaleCopy[n * BlockCountK + k_blk];
+        uint8_t zp = 8;
+        if (QuantBZPBegin != nullptr) {
+            const std::byte QuantBZP = QuantBZPBegin[n * MlasDivRoundup(BlockCountK, 2) + k_blk / 2];
+            zp = (k_blk % 2 == 0) ? uint8_t(QuantBZP & std::byte{0x0F}) : uint8_t(QuantBZP >> 4);
+        }
+
+        // BlockSum is a width 16 row major matrix
+        BlockSumBegin[((n / 16) * BlockCountK + k_blk) * 16 + n % 16] = -QuantBScale * zp;
+
+        // the scales of a group of columns are stored block major
+        const size_t GroupStartN = n / TILE_N * TILE_N;
+        const size_t GroupCountN = std::min(N - GroupStartN, size_t{TILE_N});
+        QuantBScaleBegin[GroupStartN * BlockCountK + k_blk * GroupCountN + (n - GroupStartN)] = QuantBScale;
+    });
+}
+
+void
+SQ4BitGemmPackQuantBDataAndBlkSumAmx(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    const float* QuantBScaleBegin,
+    bool has_zp_input,
+    const std::byte* QuantBZPBegin,
+    PackedQuantBDataStruct& packed_quant_b,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);
+
+    assert(ComputeType == CompInt8);
+    assert(BlkLen >= 16 && BlkLen % 16 == 0 && BlkLen <= MLAS_SQNBIT_AMX_MAX_BLKLEN);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+
+    if (QuantBDataBegin) {
+        SQ4BitGemmPackQuantBDataAmx(N, BlockCountK, BlkLen, QuantBDataBegin, packed_quant_b.PackedQuantBData, ThreadPool);
+    }
+
+    if (QuantBScaleBegin) {
+        std::copy(QuantBScaleBegin, QuantBScaleBegin + N * BlockCountK, packed_quant_b.PackedQuantBScale);
+    }
+
+    if ((QuantBScaleBegin && !has_zp_input) || QuantBZPBegin) {
+        SQ4BitGemmPackQuantBScaleAndBlkSumAmx(
+            N, BlockCountK, packed_quant_b.PackedQuantBScale, QuantBZPBegin, packed_quant_b.QuantBBlkSum, ThreadPool
+        );
+    }
+}
+
+/*
+    This routine loads the tile configuration of the kernel: the int32
+    accumulators of C, TILE_M rows of TileK values of A and TileK/4 rows of B
+    in the VNNI layout.
+*/
+static void
+SQ4BitGemmTileConfigAmx(size_t TileK)
+{
+    tileconfig_t tc;
+    tc.palette_id = 1;
+
+    tc.rows[TMM0] = TILE_M;
+    tc.colb[TMM0] = TILE_N * sizeof(int32_t);
+    tc.rows[TMM1] = TILE_M;
+    tc.colb[TMM1] = static_cast<uint16_t>(TileK);
+    tc.rows[TMM2] = static_cast<uint8_t>(TileK / 4);
+    tc.colb[TMM2] = TILE_N * 4;
+
+    tile_loadconfig(&tc);
+}
+
+/*
+    This routine unpacks a block of a group of columns of B to BlkLen/4 rows
+    of 64 bytes in the VNNI layout. Columns past CountN are zero.
+*/
+MLAS_FORCEINLINE void
+SQ4BitGemmUnpackBlkAmx(
+    const std::byte* QuantBData, uint8_t* BTile, size_t BlkLen, __mmask64 Mask, size_t CountN
+)
+{
+    const __m512i LowMask = _mm512_set1_epi8(0x0F);
+
+    for (size_t k = 0; k < BlkLen; k += 8) {
+        const __m512i Bytes = _mm512_maskz_loadu_epi8(Mask, QuantBData);
+
+        _mm512_store_si512(BTile, _mm512_and_si512(Bytes, LowMask));
+        _mm512_store_si512(BTile + 64, _mm512_and_si512(_mm512_srli_epi16(Bytes, 4), LowMask));
+
+        QuantBData += CountN * 4;
+        BTile += 128;
+    }
+}
+
+MLAS_FORCEINLINE void
+SQ4BitGemmAccumulateRowAmx(
+    __m512i Dot, __m512 ScaleB, float ScaleA, float* C, __mmask16 Mask
+)
+{
+    const __m512 Scale = _mm512_mul_ps(ScaleB, _mm512_set1_ps(ScaleA));
+    const __m512 Accumulator = _mm512_maskz_loadu_ps(Mask, C);
+    _mm512_mask_storeu_ps(C, Mask, _mm512_fmadd_ps(_mm512_cvtepi32_ps(Dot), Scale, Accumulator));
+}
+
+size_t
+SQ4BitGemmKernel_BlkSum_CompInt8_amx(
+    const size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* /*QuantBZeroPoint*/,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc,
+    const float* ABlockSum,
+    const float* QuantBBlkSum
+)
+{
+    assert(BlkLen <= MLAS_SQNBIT_AMX_MAX_BLKLEN);
+
+    MLAS_DECLSPEC_ALIGN(uint8_t BTile[MLAS_SQNBIT_AMX_MAX_BLKLEN / 4 * TILE_N * 4], 64);
+    MLAS_DECLSPEC_ALIGN(int32_t CTile[TILE_M * TILE_N], 64);
+
+    const size_t TileK = std::min(BlkLen, size_t{TILE_K});
+    const size_t lda = BlockCountK * BlkLen;
+    const size_t ldb = BlockCountK * BlkLen / 2;
+
+    if (CountM >= TILE_M) {
+        SQ4BitGemmTileConfigAmx(TileK);
+    }
+
+    for (size_t n = 0; n < CountN; n += TILE_N) {
+        const size_t nb = std::min(CountN - n, size_t{TILE_N});
+        const __mmask16 Mask = __mmask16((1u << nb) - 1);
+        const __mmask64 BMask = (nb == TILE_N) ? ~__mmask64(0) : ((__mmask64(1) << (nb * 4)) - 1);
+
+        const std::byte* b_col = QuantBData + n * ldb;
+        const float* b_col_scale = QuantBScale + n * BlockCountK;
+        float* c_blk = C + n;
+
+        const __m512 BiasVector = (Bias != nullptr) ? _mm512_maskz_loadu_ps(Mask, Bias + n) : _mm512_setzero_ps();
+        for (size_t m = 0; m < CountM; m++) {
+            _mm512_mask_storeu_ps(c_blk + m * ldc, Mask, BiasVector);
+        }
+
+        for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+            SQ4BitGemmUnpackBlkAmx(b_col + k_blk * nb * BlkLen / 2, BTile, BlkLen, BMask, nb);
+            const __m512 ScaleB = _mm512_maskz_loadu_ps(Mask, b_col_scale + k_blk * nb);
+
+            size_t m = 0;
+
+            for (; m + TILE_M <= CountM; m += TILE_M) {
+                const std::byte* a_blk = QuantA + m * lda + k_blk * BlkLen;
+
+                tile_zero(TMM0);
+                for (size_t k = 0; k < BlkLen; k += TileK) {
+                    tile_loadd(TMM1, a_blk + k, static_cast<int>(lda));
+                    tile_loadd(TMM2, BTile + k * TILE_N, TILE_N * 4);
+                    tile_dpbsud(TMM0, TMM1, TMM2);
+                }
+                tile_stored(TMM0, CTile, TILE_N * sizeof(int32_t));
+
+                for (size_t mm = 0; mm < TILE_M; mm++) {
+                    SQ4BitGemmAccumulateRowAmx(
+                        _mm512_load_si512(CTile + mm * TILE_N), ScaleB,
+                        QuantAScale[(m + mm) * BlockCountK + k_blk], c_blk + (m + mm) * ldc, Mask
+                    );
+                }
+            }
+
+            for (; m < CountM; m++) {
+                const std::byte* a_blk = QuantA + m * lda + k_blk * BlkLen;
+
+                __m512i Dot0 = _mm512_setzero_si512();
+                __m512i Dot1 = _mm512_setzero_si512();
+                for (size_t k = 0; k < BlkLen; k += 8) {
+                    const __m512i A0 = _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(a_blk + k));
+                    const __m512i A1 = _mm512_set1_epi32(*reinterpret_cast<const int32_t*>(a_blk + k + 4));
+                    Dot0 = _mm512_dpbusd_epi32(Dot0, _mm512_load_si512(BTile + k * TILE_N), A0);
+                    Dot1 = _mm512_dpbusd_epi32(Dot1, _mm512_load_si512(BTile + k * TILE_N + 64), A1);
+                }
+
+                SQ4BitGemmAccumulateRowAmx(
+                    _mm512_add_epi32(Dot0, Dot1), ScaleB, QuantAScale[m * BlockCountK + k_blk], c_blk + m * ldc, Mask
+                );
+            }
+        }
+    }
+
+    float* c_blk = C;
+    const float* b_blk_sum = QuantBBlkSum;
+
+    size_t RowsRemaining = CountM;
+    const float* a_blksum_row = ABlockSum;
+    while (RowsRemaining > 0) {
+        auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
+            a_blksum_row, b_blk_sum, c_blk, BlockCountK, RowsRemaining, CountN, BlockCountK, ldc, 1.f, false
+        );
+
+        c_blk += ldc * RowsHandled;
+        a_blksum_row += BlockCountK * RowsHandled;
+        RowsRemaining -= RowsHandled;
+    }
+    return CountM;
+}
@@ -0,0 +1,55 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_amx.h
+
+Abstract:
+
+    This module includes function declarations for the SQNBitGemm AMX-INT8
+    kernels. The AMX dispatch structure is defined with the AVX512-VNNI one,
+    whose kernels it shares for everything but the CompInt8 computation with
+    4-bit B.
+
+--*/
+
+#pragma once
+
+#include "sqnbitgemm.h"
+
+void
+SQ4BitGemmPackQuantBDataAndBlkSumAmx(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    const float* QuantBScaleBegin,
+    bool has_zp_input,
+    const std::byte* QuantBZPBegin,
+    PackedQuantBDataStruct& packed_quant_b,
+    MLAS_THREADPOOL* ThreadPool
+);
+
+size_t
+SQ4BitGemmKernel_BlkSum_CompInt8_amx(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc,
+    const float* ABlockSum,
+    const float* QuantBBlkSum
+);
@@ -25,6 +25,7 @@ Abstract:
 #include "sqnbitgemm_kernel_avx2_int8_blklen16.h"
 #include "sqnbitgemm_kernel_avx2_int8_blklen32.h"
 #include "sqnbitgemm_kernel_avx2_int8_blklen64.h"
+#include "sqnbitgemm_kernel_avx2_lowbit.h"
 
 #include "sqnbitgemm_m1_sym_kernel_avx2_int8_blklen32.h"
 #include "sqnbitgemm_m1_sym_kernel_avx2_int8_blklen64.h"
@@ -1346,6 +1347,10 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2 = []() {
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx2;
     d.QuantizeARowComputeBlkSum_CompInt8 = QuantizeARow_CompInt8_avx2;
 
+    d.SQLowBitGemmM1Kernel_CompFp32 = SQLowBitGemmM1Kernel_CompFp32_avx2;
+    d.QLowBitBlkDequantBForSgemm_CompFp32 = QLowBitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQLowBitGemmKernel_CompInt8 = SQLowBitGemmKernel_CompInt8_avx2<false>;
+
     return d;
 }();
 
@@ -1365,5 +1370,9 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2vnni = []() {
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx2vnni;
     d.QuantizeARowComputeBlkSum_CompInt8 = QuantizeARow_CompInt8_avx2;
 
+    d.SQLowBitGemmM1Kernel_CompFp32 = SQLowBitGemmM1Kernel_CompFp32_avx2;
+    d.QLowBitBlkDequantBForSgemm_CompFp32 = QLowBitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQLowBitGemmKernel_CompInt8 = SQLowBitGemmKernel_CompInt8_avx2<true>;
+
     return d;
 }();
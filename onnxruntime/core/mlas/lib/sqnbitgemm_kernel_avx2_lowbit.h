@@ -0,0 +1,602 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_avx2_lowbit.h
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for 2-bit and 3-bit quantized B on x64.
+
+    The kernels only require AVX2 and FMA, with optional AVX-VNNI or
+    AVX512-VNNI dot products, so they are shared by the AVX2 and AVX512
+    kernel dispatches.
+
+--*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_avx_common.h"
+
+namespace
+{
+
+constexpr size_t LowBitSubBlkLen32 = MlasQNBitLowBitSubBlkLen;
+
+//
+// Unpacks a sub-block of 32 2-bit or 3-bit values to 32 uint8 values in the order v0, v1, ..., v31.
+// See MlasQNBitLowBitSubBlkLen for the packed layout.
+//
+template <size_t BlkBitWidth>
+static MLAS_FORCEINLINE __m256i
+UnpackLowBitSubBlk_avx2(const std::byte* QuantBDataPtr)
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    // 64-bit lane i holds bits 2i and 2i + 1 of each byte of the low bits in bits 0 and 1 of its bytes
+    uint64_t low_bits;
+    std::memcpy(&low_bits, QuantBDataPtr, sizeof(low_bits));
+    const __m256i low_shift = _mm256_set_epi64x(6, 4, 2, 0);
+    __m256i bv = _mm256_srlv_epi64(_mm256_set1_epi64x(static_cast<long long>(low_bits)), low_shift);
+    bv = _mm256_and_si256(bv, _mm256_set1_epi8(0x03));
+
+    if constexpr (BlkBitWidth == 3) {
+        // broadcast byte i of the high bits to 64-bit lane i, then test bit j in byte j of each lane
+        int32_t high_bits;
+        std::memcpy(&high_bits, QuantBDataPtr + 8, sizeof(high_bits));
+        const __m256i byte_select = _mm256_set_epi64x(
+            0x0303030303030303LL, 0x0202020202020202LL, 0x0101010101010101LL, 0
+        );
+        const __m256i bit_select = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ULL));
+        __m256i hv = _mm256_shuffle_epi8(_mm256_set1_epi32(high_bits), byte_select);
+        hv = _mm256_cmpeq_epi8(_mm256_and_si256(hv, bit_select), bit_select);
+        bv = _mm256_or_si256(bv, _mm256_and_si256(hv, _mm256_set1_epi8(0x04)));
+    }
+
+    return bv;
+}
+
+//
+// Converts 8 int8 values starting at index 8 * Idx to float.
+//
+template <size_t Idx>
+static MLAS_FORCEINLINE __m256
+ConvertLowBitEpi8ToPs_avx2(const __m256i v_32_epi8)
+{
+    const __m128i v_16_epi8 = _mm256_extracti128_si256(v_32_epi8, Idx / 2);
+    const __m128i v_8_epi8 = (Idx % 2 == 0) ? v_16_epi8 : _mm_srli_si128(v_16_epi8, 8);
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(v_8_epi8));
+}
+
+static MLAS_FORCEINLINE __m256
+LoadLowBitFloatN_avx2(const float* src, size_t count)
+{
+    if (count >= 8) {
+        return _mm256_loadu_ps(src);
+    }
+    if (count == 0) {
+        return _mm256_setzero_ps();
+    }
+    const __m256i mask = _mm256_cmpgt_epi32(
+        _mm256_set1_epi32(static_cast<int>(count)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0)
+    );
+    return _mm256_maskload_ps(src, mask);
+}
+
+//
+// Multiplies 32 uint8 values of B with 32 int8 values of A and accumulates groups of 4 products to int32.
+//
+template <bool vnni>
+static MLAS_FORCEINLINE __m256i
+DotLowBitU8S8_avx2(const __m256i acc_8_epi32, const __m256i bv_32_epu8, const __m256i av_32_epi8)
+{
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    if constexpr (vnni) {
+        return _mm256_dpbusd_epi32(acc_8_epi32, bv_32_epu8, av_32_epi8);
+    }
+#elif defined(__AVXVNNI__)
+    if constexpr (vnni) {
+        return _mm256_dpbusd_avx_epi32(acc_8_epi32, bv_32_epu8, av_32_epi8);
+    }
+#endif
+    // B values are at most 7 so the 16-bit pair sums cannot saturate
+    const __m256i dot_16_epi16 = _mm256_maddubs_epi16(bv_32_epu8, av_32_epi8);
+    return _mm256_add_epi32(acc_8_epi32, _mm256_madd_epi16(_mm256_set1_epi16(1), dot_16_epi16));
+}
+
+static MLAS_FORCEINLINE void
+Transpose8x8_avx2(__m256 (&v)[8])
+{
+    const __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+    const __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+    const __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+    const __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+    const __m256 t4 = _mm256_unpacklo_ps(v[4], v[5]);
+    const __m256 t5 = _mm256_unpackhi_ps(v[4], v[5]);
+    const __m256 t6 = _mm256_unpacklo_ps(v[6], v[7]);
+    const __m256 t7 = _mm256_unpackhi_ps(v[6], v[7]);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    v[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    v[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    v[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    v[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    v[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    v[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    v[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    v[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+}
+
+//
+// CompFp32 kernels.
+//
+
+template <size_t BlkBitWidth, size_t NCols>
+static MLAS_FORCEINLINE void
+SQLowBitGemmM1Kernel_CompFp32_NCols_avx2(
+    const size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    const size_t CountK,
+    const size_t BlockCountK,
+    const float* BiasPtr
+)
+{
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, LowBitSubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    __m256 acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) { acc[i] = _mm256_setzero_ps(); });
+
+    for (size_t k_blk_idx = 0, k = 0; k_blk_idx < BlockCountK; ++k_blk_idx, k += BlkLen) {
+        __m256 scale[NCols];
+        __m256i zp[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            scale[i] = _mm256_set1_ps(QuantBScaleColPtr[i * BlockCountK + k_blk_idx]);
+            const std::byte* zp_col =
+                (QuantBZeroPointColPtr == nullptr) ? nullptr : QuantBZeroPointColPtr + i * StrideQuantBZeroPoint;
+            zp[i] = _mm256_set1_epi8(static_cast<char>(MlasQNBitLowBitZeroPoint<BlkBitWidth>(zp_col, k_blk_idx)));
+        });
+
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+        const std::byte* QuantBDataBlkPtr = QuantBDataColPtr + k_blk_idx * BlkDataSize;
+
+        for (size_t kk = 0; kk < k_blk_len; kk += LowBitSubBlkLen32) {
+            const size_t k_subblk_len = std::min(k_blk_len - kk, LowBitSubBlkLen32);
+
+            // A values past CountK are zero so the padding of the last B block does not contribute
+            __m256 av[4];
+            UnrolledLoop<4>([&](size_t j) {
+                av[j] = LoadLowBitFloatN_avx2(ARowPtr + k + kk + j * 8, k_subblk_len > j * 8 ? k_subblk_len - j * 8 : 0);
+            });
+
+            const std::byte* QuantBDataSubBlkPtr = QuantBDataBlkPtr + (kk / LowBitSubBlkLen32) * SubBlkDataSize;
+
+            UnrolledLoop<NCols>([&](size_t i) {
+                const __m256i bv = _mm256_sub_epi8(
+                    UnpackLowBitSubBlk_avx2<BlkBitWidth>(QuantBDataSubBlkPtr + i * StrideQuantBData), zp[i]
+                );
+
+                __m256 sum = _mm256_mul_ps(ConvertLowBitEpi8ToPs_avx2<0>(bv), av[0]);
+                sum = _mm256_fmadd_ps(ConvertLowBitEpi8ToPs_avx2<1>(bv), av[1], sum);
+                sum = _mm256_fmadd_ps(ConvertLowBitEpi8ToPs_avx2<2>(bv), av[2], sum);
+                sum = _mm256_fmadd_ps(ConvertLowBitEpi8ToPs_avx2<3>(bv), av[3], sum);
+                acc[i] = _mm256_fmadd_ps(sum, scale[i], acc[i]);
+            });
+        }
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 acc_x = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+        if (BiasPtr != nullptr) {
+            acc_x = _mm_add_ps(acc_x, _mm_loadu_ps(BiasPtr));
+        }
+        _mm_storeu_ps(SumPtr, acc_x);
+    } else {
+        UnrolledLoop<NCols>([&](size_t i) {
+            SumPtr[i] = hsum_float_8(acc[i]) + ((BiasPtr != nullptr) ? BiasPtr[i] : 0.0f);
+        });
+    }
+}
+
+template <size_t BlkBitWidth>
+static void
+SQLowBitGemmM1Kernel_CompFp32_Impl_avx2(
+    const size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK,
+    const float* Bias
+)
+{
+    constexpr size_t NCols4 = 4;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    size_t n = 0;
+    for (; n + NCols4 <= CountN; n += NCols4) {
+        SQLowBitGemmM1Kernel_CompFp32_NCols_avx2<BlkBitWidth, NCols4>(
+            BlkLen, A,
+            QuantBData + n * StrideQuantBData,
+            QuantBScale + n * BlockCountK,
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+            C + n, CountK, BlockCountK,
+            (Bias == nullptr) ? nullptr : Bias + n
+        );
+    }
+
+    for (; n < CountN; ++n) {
+        SQLowBitGemmM1Kernel_CompFp32_NCols_avx2<BlkBitWidth, 1>(
+            BlkLen, A,
+            QuantBData + n * StrideQuantBData,
+            QuantBScale + n * BlockCountK,
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+            C + n, CountK, BlockCountK,
+            (Bias == nullptr) ? nullptr : Bias + n
+        );
+    }
+}
+
+static void
+SQLowBitGemmM1Kernel_CompFp32_avx2(
+    const size_t BlkBitWidth,
+    const size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK,
+    const float* Bias
+)
+{
+    assert(BlkLen % LowBitSubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        SQLowBitGemmM1Kernel_CompFp32_Impl_avx2<2>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    } else {
+        assert(BlkBitWidth == 3);
+        SQLowBitGemmM1Kernel_CompFp32_Impl_avx2<3>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    }
+}
+
+template <size_t BlkBitWidth>
+static void
+QLowBitBlkDequantBForSgemm_CompFp32_Impl_avx2(
+    const size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK
+)
+{
+    constexpr size_t NCols8 = 8;                   // dequantize NCols8 columns of QuantB at a time
+    constexpr size_t GemmFloatKernelWidth16 = 16;  // mlas GemmFloatKernel requires B with width 16
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, LowBitSubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t col = 0; col < CountN; col += NCols8) {
+        const size_t cols = std::min(NCols8, CountN - col);
+
+        // columns [col, col + 8) are the first or second half of a 16 column tile
+        float* dst_tile_ptr = FpData + (col / GemmFloatKernelWidth16) * CountK * GemmFloatKernelWidth16 +
+                              (col % GemmFloatKernelWidth16);
+
+        for (size_t k_blk_idx = 0, k = 0; k_blk_idx < BlockCountK; ++k_blk_idx, k += BlkLen) {
+            __m256 scale[NCols8];
+            __m256i zp[NCols8];
+            UnrolledLoop<NCols8>([&](size_t i) {
+                if (i < cols) {
+                    scale[i] = _mm256_set1_ps(QuantBScale[(col + i) * BlockCountK + k_blk_idx]);
+                    const std::byte* zp_col = (QuantBZeroPoint == nullptr)
+                                                  ? nullptr
+                                                  : QuantBZeroPoint + (col + i) * StrideQuantBZeroPoint;
+                    zp[i] = _mm256_set1_epi8(static_cast<char>(MlasQNBitLowBitZeroPoint<BlkBitWidth>(zp_col, k_blk_idx)));
+                } else {
+                    scale[i] = _mm256_setzero_ps();
+                    zp[i] = _mm256_setzero_si256();
+                }
+            });
+
+            const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+            for (size_t kk = 0; kk < k_blk_len; kk += LowBitSubBlkLen32) {
+                const std::byte* QuantBDataSubBlkPtr = QuantBData + k_blk_idx * BlkDataSize +
+                                                       (kk / LowBitSubBlkLen32) * SubBlkDataSize;
+
+                __m256i bv[NCols8];
+                UnrolledLoop<NCols8>([&](size_t i) {
+                    bv[i] = (i < cols)
+                                ? _mm256_sub_epi8(
+                                      UnpackLowBitSubBlk_avx2<BlkBitWidth>(
+                                          QuantBDataSubBlkPtr + (col + i) * StrideQuantBData
+                                      ),
+                                      zp[i]
+                                  )
+                                : _mm256_setzero_si256();
+                });
+
+                // dequantize 8 rows of 8 columns at a time and store them as 8 rows of the tile
+                UnrolledLoop<4>([&](size_t j) {
+                    const size_t row = k + kk + j * 8;
+                    if (row >= CountK) {
+                        return;
+                    }
+
+                    __m256 w[NCols8];
+                    UnrolledLoop<NCols8>([&](size_t i) {
+                        __m256 v;
+                        if (j == 0) {
+                            v = ConvertLowBitEpi8ToPs_avx2<0>(bv[i]);
+                        } else if (j == 1) {
+                            v = ConvertLowBitEpi8ToPs_avx2<1>(bv[i]);
+                        } else if (j == 2) {
+                            v = ConvertLowBitEpi8ToPs_avx2<2>(bv[i]);
+                        } else {
+                            v = ConvertLowBitEpi8ToPs_avx2<3>(bv[i]);
+                        }
+                        w[i] = _mm256_mul_ps(v, scale[i]);
+                    });
+
+                    Transpose8x8_avx2(w);
+
+                    const size_t rows = std::min(CountK - row, size_t{8});
+                    for (size_t r = 0; r < rows; ++r) {
+                        _mm256_storeu_ps(dst_tile_ptr + (row + r) * GemmFloatKernelWidth16, w[r]);
+                    }
+                });
+            }
+        }
+    }
+}
+
+static void
+QLowBitBlkDequantBForSgemm_CompFp32_avx2(
+    const size_t BlkBitWidth,
+    const size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK
+)
+{
+    assert(BlkLen % LowBitSubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        QLowBitBlkDequantBForSgemm_CompFp32_Impl_avx2<2>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    } else {
+        assert(BlkBitWidth == 3);
+        QLowBitBlkDequantBForSgemm_CompFp32_Impl_avx2<3>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    }
+}
+
+//
+// CompInt8 kernels.
+//
+// A is quantized by QuantizeARowComputeBlkSum_CompInt8, so the zero point of a B block is applied once per block
+// with the scaled block sum of A: sum(a * (b - zp)) * scale_a * scale_b
+//   = sum(a * b) * scale_a * scale_b - zp * scale_b * (scale_a * sum(a)).
+//
+
+template <size_t BlkBitWidth, bool vnni, size_t NCols>
+static MLAS_FORCEINLINE void
+SQLowBitGemmKernel_CompInt8_NCols_avx2(
+    const size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const float* QuantAScaleRowPtr,
+    const float* ABlockSumRowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    const size_t BlockCountK,
+    const float* BiasPtr
+)
+{
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, LowBitSubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    __m256 acc[NCols];
+    float zp_acc[NCols];
+    UnrolledLoop<NCols>([&](size_t i) {
+        acc[i] = _mm256_setzero_ps();
+        zp_acc[i] = 0.0f;
+    });
+
+    const int8_t* QuantAPtr = reinterpret_cast<const int8_t*>(QuantARowPtr);
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        __m256i dot[NCols];
+        UnrolledLoop<NCols>([&](size_t i) { dot[i] = _mm256_setzero_si256(); });
+
+        const std::byte* QuantBDataBlkPtr = QuantBDataColPtr + k_blk_idx * BlkDataSize;
+
+        for (size_t kk = 0; kk < BlkLen; kk += LowBitSubBlkLen32) {
+            const __m256i av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(QuantAPtr + kk));
+            const std::byte* QuantBDataSubBlkPtr = QuantBDataBlkPtr + (kk / LowBitSubBlkLen32) * SubBlkDataSize;
+
+            UnrolledLoop<NCols>([&](size_t i) {
+                const __m256i bv = UnpackLowBitSubBlk_avx2<BlkBitWidth>(QuantBDataSubBlkPtr + i * StrideQuantBData);
+                dot[i] = DotLowBitU8S8_avx2<vnni>(dot[i], bv, av);
+            });
+        }
+
+        const float a_scale = QuantAScaleRowPtr[k_blk_idx];
+        const float a_blk_sum = ABlockSumRowPtr[k_blk_idx];
+        UnrolledLoop<NCols>([&](size_t i) {
+            const float b_scale = QuantBScaleColPtr[i * BlockCountK + k_blk_idx];
+            const std::byte* zp_col =
+                (QuantBZeroPointColPtr == nullptr) ? nullptr : QuantBZeroPointColPtr + i * StrideQuantBZeroPoint;
+            const float zp = static_cast<float>(MlasQNBitLowBitZeroPoint<BlkBitWidth>(zp_col, k_blk_idx));
+
+            acc[i] = _mm256_fmadd_ps(_mm256_cvtepi32_ps(dot[i]), _mm256_set1_ps(a_scale * b_scale), acc[i]);
+            zp_acc[i] += zp * b_scale * a_blk_sum;
+        });
+
+        QuantAPtr += BlkLen;
+    }
+
+    if constexpr (NCols == 4) {
+        __m128 acc_x = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+        acc_x = _mm_sub_ps(acc_x, _mm_loadu_ps(zp_acc));
+        if (BiasPtr != nullptr) {
+            acc_x = _mm_add_ps(acc_x, _mm_loadu_ps(BiasPtr));
+        }
+        _mm_storeu_ps(SumPtr, acc_x);
+    } else {
+        UnrolledLoop<NCols>([&](size_t i) {
+            SumPtr[i] = hsum_float_8(acc[i]) - zp_acc[i] + ((BiasPtr != nullptr) ? BiasPtr[i] : 0.0f);
+        });
+    }
+}
+
+template <size_t BlkBitWidth, bool vnni>
+static size_t
+SQLowBitGemmKernel_CompInt8_Impl_avx2(
+    const size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const float* ABlockSum,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    const size_t CountM,
+    const size_t CountN,
+    const size_t BlockCountK,
+    const size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t NCols4 = 4;
+
+    const size_t StrideQuantA = BlockCountK * BlkLen;
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t m = 0; m < CountM; ++m) {
+        const std::byte* QuantARowPtr = QuantA + m * StrideQuantA;
+        const float* QuantAScaleRowPtr = QuantAScale + m * BlockCountK;
+        const float* ABlockSumRowPtr = ABlockSum + m * BlockCountK;
+        float* SumRowPtr = C + m * ldc;
+
+        size_t n = 0;
+        for (; n + NCols4 <= CountN; n += NCols4) {
+            SQLowBitGemmKernel_CompInt8_NCols_avx2<BlkBitWidth, vnni, NCols4>(
+                BlkLen, QuantARowPtr, QuantAScaleRowPtr, ABlockSumRowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * BlockCountK,
+                (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+                SumRowPtr + n, BlockCountK,
+                (Bias == nullptr) ? nullptr : Bias + n
+            );
+        }
+
+        for (; n < CountN; ++n) {
+            SQLowBitGemmKernel_CompInt8_NCols_avx2<BlkBitWidth, vnni, 1>(
+                BlkLen, QuantARowPtr, QuantAScaleRowPtr, ABlockSumRowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * BlockCountK,
+                (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+                SumRowPtr + n, BlockCountK,
+                (Bias == nullptr) ? nullptr : Bias + n
+            );
+        }
+    }
+
+    return CountM;
+}
+
+template <bool vnni>
+static size_t
+SQLowBitGemmKernel_CompInt8_avx2(
+    const size_t BlkBitWidth,
+    const size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const float* ABlockSum,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    const size_t CountM,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK,
+    const size_t ldc,
+    const float* Bias
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(CountK);
+
+    // A must be quantized by QuantizeARowComputeBlkSum_CompInt8
+    assert(QuantAScale != nullptr && ABlockSum != nullptr);
+    assert(BlkLen % LowBitSubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        return SQLowBitGemmKernel_CompInt8_Impl_avx2<2, vnni>(
+            BlkLen, QuantA, QuantAScale, ABlockSum, QuantBData, QuantBScale, QuantBZeroPoint,
+            C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    }
+
+    assert(BlkBitWidth == 3);
+    return SQLowBitGemmKernel_CompInt8_Impl_avx2<3, vnni>(
+        BlkLen, QuantA, QuantAScale, ABlockSum, QuantBData, QuantBScale, QuantBZeroPoint,
+        C, CountM, CountN, BlockCountK, ldc, Bias
+    );
+}
+
+}  // namespace
@@ -26,6 +26,7 @@ Abstract:
 #include "sqnbitgemm_kernel_avx512_int8_blklen32.h"
 #include "sqnbitgemm_kernel_avx512_int8_blklen64.h"
 #include "sqnbitgemm_kernel_avx512_int8_blklen128.h"
+#include "sqnbitgemm_kernel_avx2_lowbit.h"
 
 //
 // CompFp32 kernel implementation.
@@ -368,5 +369,9 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512 = []() {
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx512;
     d.QuantizeARowComputeBlkSum_CompInt8 = QuantizeARow_CompInt8_avx512;
 
+    d.SQLowBitGemmM1Kernel_CompFp32 = SQLowBitGemmM1Kernel_CompFp32_avx2;
+    d.QLowBitBlkDequantBForSgemm_CompFp32 = QLowBitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQLowBitGemmKernel_CompInt8 = SQLowBitGemmKernel_CompInt8_avx2<false>;
+
     return d;
 }();
@@ -190,5 +190,9 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon = []() {
     d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8;
     d.QuantizeARow_CompInt8 = sqnbitgemm_neon::QuantizeARow_CompInt8;
 
+    d.SQLowBitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQLowBitGemmM1Kernel_CompFp32;
+    d.QLowBitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::QLowBitBlkDequantBForSgemm_CompFp32;
+    d.SQLowBitGemmKernel_CompInt8 = sqnbitgemm_neon::SQLowBitGemmKernel_CompInt8;
+
     return d;
 }();
@@ -90,6 +90,55 @@ SQ4BitGemmKernel_CompInt8(
     const float* Bias
 );
 
+// Low bit (2-bit and 3-bit) declarations
+
+void
+SQLowBitGemmM1Kernel_CompFp32(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+);
+
+void
+QLowBitBlkDequantBForSgemm_CompFp32(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+);
+
+size_t
+SQLowBitGemmKernel_CompInt8(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const float* /*QuantAScale*/,
+    const float* /*ABlockSum*/,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+);
+
 //
 // General helpers.
 //
@@ -0,0 +1,445 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_neon_lowbit.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for ARM NEON specific to 2-bit and 3-bit
+    quantized B, for MLAS_SQNBIT_GEMM_COMPUTE_TYPE CompFp32 and CompInt8.
+
+--*/
+
+#include <arm_neon.h>
+
+#include <cassert>
+#include <cstring>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_neon.h"
+#include "sqnbitgemm_q8_block.h"
+
+namespace sqnbitgemm_neon
+{
+
+namespace
+{
+
+constexpr size_t SubBlkLen32 = MlasQNBitLowBitSubBlkLen;
+
+//
+// Unpacks a sub-block of 32 2-bit or 3-bit values to uint8 values v0-v15 in bv[0] and v16-v31 in bv[1].
+// See MlasQNBitLowBitSubBlkLen for the packed layout.
+//
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+UnpackLowBitSubBlk(const std::byte* QuantBDataPtr, uint8x16_t (&bv)[2])
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    const uint8x8_t LowMask = vdup_n_u8(0x03);
+    const uint8x8_t low_bits = vld1_u8(reinterpret_cast<const uint8_t*>(QuantBDataPtr));
+
+    bv[0] = vcombine_u8(vand_u8(low_bits, LowMask), vand_u8(vshr_n_u8(low_bits, 2), LowMask));
+    bv[1] = vcombine_u8(vand_u8(vshr_n_u8(low_bits, 4), LowMask), vshr_n_u8(low_bits, 6));
+
+    if constexpr (BlkBitWidth == 3) {
+        // byte j of each half of the high bits selects bit j of a high bits byte
+        const uint8x16_t BitSelect = vreinterpretq_u8_u64(vdupq_n_u64(0x8040201008040201ULL));
+        const uint8x16_t HighBit = vdupq_n_u8(0x04);
+
+        const uint8_t* high_bits = reinterpret_cast<const uint8_t*>(QuantBDataPtr) + 8;
+        const uint8x16_t h0 = vcombine_u8(vdup_n_u8(high_bits[0]), vdup_n_u8(high_bits[1]));
+        const uint8x16_t h1 = vcombine_u8(vdup_n_u8(high_bits[2]), vdup_n_u8(high_bits[3]));
+
+        bv[0] = vorrq_u8(bv[0], vandq_u8(vtstq_u8(h0, BitSelect), HighBit));
+        bv[1] = vorrq_u8(bv[1], vandq_u8(vtstq_u8(h1, BitSelect), HighBit));
+    }
+}
+
+//
+// Converts 32 int8 values to float, scaled by `scale`.
+//
+MLAS_FORCEINLINE void
+ConvertLowBitS8ToF32(const int8x16_t (&bv)[2], float32x4_t scale, float32x4_t (&fv)[8])
+{
+    UnrolledLoop<2>([&](size_t i) {
+        const int16x8_t lo = vmovl_s8(vget_low_s8(bv[i]));
+        const int16x8_t hi = vmovl_s8(vget_high_s8(bv[i]));
+        fv[i * 4 + 0] = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), scale);
+        fv[i * 4 + 1] = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), scale);
+        fv[i * 4 + 2] = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), scale);
+        fv[i * 4 + 3] = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), scale);
+    });
+}
+
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+LoadLowBitSubBlkWithZeroPoint(const std::byte* QuantBDataPtr, uint8_t zp, int8x16_t (&bv)[2])
+{
+    uint8x16_t bv_u8[2];
+    UnpackLowBitSubBlk<BlkBitWidth>(QuantBDataPtr, bv_u8);
+
+    // values and zero points are at most 7, so the wrapped uint8 difference is the int8 difference
+    const uint8x16_t zp_v = vdupq_n_u8(zp);
+    bv[0] = vreinterpretq_s8_u8(vsubq_u8(bv_u8[0], zp_v));
+    bv[1] = vreinterpretq_s8_u8(vsubq_u8(bv_u8[1], zp_v));
+}
+
+MLAS_FORCEINLINE const std::byte*
+ZeroPointColPtr(const std::byte* QuantBZeroPoint, size_t n, size_t StrideQuantBZeroPoint)
+{
+    return (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint;
+}
+
+//
+// CompFp32 kernel implementation.
+//
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemmM1Kernel_CompFp32_Impl(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+)
+{
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, SubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t n = 0; n < CountN; ++n) {
+        const std::byte* QuantBDataColPtr = QuantBData + n * StrideQuantBData;
+        const std::byte* QuantBZeroPointColPtr = ZeroPointColPtr(QuantBZeroPoint, n, StrideQuantBZeroPoint);
+
+        float32x4_t acc[8]{};
+
+        for (size_t k_blk_idx = 0, k = 0; k_blk_idx < BlockCountK; ++k_blk_idx, k += BlkLen) {
+            const float32x4_t scale = vdupq_n_f32(QuantBScale[n * BlockCountK + k_blk_idx]);
+            const uint8_t zp = MlasQNBitLowBitZeroPoint<BlkBitWidth>(QuantBZeroPointColPtr, k_blk_idx);
+
+            const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+            for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen32) {
+                const size_t k_subblk_len = std::min(k_blk_len - kk, SubBlkLen32);
+
+                // A values past CountK are zero so the padding of the last B block does not contribute
+                float32x4_t av[8]{};
+                LoadFloatData<SubBlkLen32>(A + k + kk, k_subblk_len, av);
+
+                int8x16_t bv[2];
+                LoadLowBitSubBlkWithZeroPoint<BlkBitWidth>(
+                    QuantBDataColPtr + k_blk_idx * BlkDataSize + (kk / SubBlkLen32) * SubBlkDataSize, zp, bv
+                );
+
+                float32x4_t fv[8];
+                ConvertLowBitS8ToF32(bv, scale, fv);
+
+                UnrolledLoop<8>([&](size_t i) { acc[i] = vfmaq_f32(acc[i], av[i], fv[i]); });
+            }
+        }
+
+        UnrolledLoop<4>([&](size_t i) { acc[i] = vaddq_f32(acc[i], acc[i + 4]); });
+        acc[0] = vaddq_f32(vaddq_f32(acc[0], acc[1]), vaddq_f32(acc[2], acc[3]));
+
+        C[n] = vaddvq_f32(acc[0]) + ((Bias != nullptr) ? Bias[n] : 0.0f);
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+QLowBitBlkDequantBForSgemm_CompFp32_Impl(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    constexpr size_t GemmFloatKernelWidth16 = 16;  // mlas GemmFloatKernel requires B with width 16
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, SubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    const size_t PaddedCountN = MlasDivRoundup(CountN, GemmFloatKernelWidth16) * GemmFloatKernelWidth16;
+
+    for (size_t n = 0; n < PaddedCountN; ++n) {
+        float* dst_col_ptr = FpData + (n / GemmFloatKernelWidth16) * CountK * GemmFloatKernelWidth16 +
+                             (n % GemmFloatKernelWidth16);
+
+        if (n >= CountN) {
+            // zero the padding columns of the last tile
+            for (size_t k = 0; k < CountK; ++k) {
+                dst_col_ptr[k * GemmFloatKernelWidth16] = 0.0f;
+            }
+            continue;
+        }
+
+        const std::byte* QuantBDataColPtr = QuantBData + n * StrideQuantBData;
+        const std::byte* QuantBZeroPointColPtr = ZeroPointColPtr(QuantBZeroPoint, n, StrideQuantBZeroPoint);
+
+        for (size_t k_blk_idx = 0, k = 0; k_blk_idx < BlockCountK; ++k_blk_idx, k += BlkLen) {
+            const float32x4_t scale = vdupq_n_f32(QuantBScale[n * BlockCountK + k_blk_idx]);
+            const uint8_t zp = MlasQNBitLowBitZeroPoint<BlkBitWidth>(QuantBZeroPointColPtr, k_blk_idx);
+
+            const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+            for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen32) {
+                const size_t k_subblk_len = std::min(k_blk_len - kk, SubBlkLen32);
+
+                int8x16_t bv[2];
+                LoadLowBitSubBlkWithZeroPoint<BlkBitWidth>(
+                    QuantBDataColPtr + k_blk_idx * BlkDataSize + (kk / SubBlkLen32) * SubBlkDataSize, zp, bv
+                );
+
+                float32x4_t fv[8];
+                ConvertLowBitS8ToF32(bv, scale, fv);
+
+                float values[SubBlkLen32];
+                UnrolledLoop<8>([&](size_t i) { vst1q_f32(values + i * 4, fv[i]); });
+
+                float* dst_ptr = dst_col_ptr + (k + kk) * GemmFloatKernelWidth16;
+                for (size_t i = 0; i < k_subblk_len; ++i) {
+                    dst_ptr[i * GemmFloatKernelWidth16] = values[i];
+                }
+            }
+        }
+    }
+}
+
+//
+// CompInt8 kernel implementation.
+//
+// A is quantized by QuantizeARow_CompInt8 into blocks of [float scale][int8 values]. Values past CountK are zero.
+//
+
+template <size_t BlkBitWidth, size_t NCols>
+MLAS_FORCEINLINE void
+SQLowBitGemm_CompInt8_Compute1xNCols(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    const float* BiasPtr,
+    float* SumPtr,
+    size_t BlockCountK
+)
+{
+    constexpr size_t SubBlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, SubBlkLen32);
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBData = BlockCountK * BlkDataSize;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    float32x4_t acc[NCols]{};
+
+    const std::byte* QuantABlkPtr = QuantARowPtr;
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        const float a_scale = Q8BlkScale(QuantABlkPtr);
+        const int8_t* a_data = Q8BlkData(QuantABlkPtr);
+
+        uint8_t zp[NCols];
+        UnrolledLoop<NCols>([&](size_t i) {
+            zp[i] = MlasQNBitLowBitZeroPoint<BlkBitWidth>(
+                ZeroPointColPtr(QuantBZeroPointColPtr, i, StrideQuantBZeroPoint), k_blk_idx
+            );
+        });
+
+        int32x4_t dot[NCols]{};
+
+        for (size_t kk = 0; kk < BlkLen; kk += SubBlkLen32) {
+            const int8x16_t av0 = vld1q_s8(a_data + kk);
+            const int8x16_t av1 = vld1q_s8(a_data + kk + 16);
+
+            const std::byte* QuantBDataSubBlkPtr =
+                QuantBDataColPtr + k_blk_idx * BlkDataSize + (kk / SubBlkLen32) * SubBlkDataSize;
+
+            UnrolledLoop<NCols>([&](size_t i) {
+                int8x16_t bv[2];
+                LoadLowBitSubBlkWithZeroPoint<BlkBitWidth>(QuantBDataSubBlkPtr + i * StrideQuantBData, zp[i], bv);
+
+                dot[i] = vdotq_s32(dot[i], av0, bv[0]);
+                dot[i] = vdotq_s32(dot[i], av1, bv[1]);
+            });
+        }
+
+        UnrolledLoop<NCols>([&](size_t i) {
+            const float scale = a_scale * QuantBScaleColPtr[i * BlockCountK + k_blk_idx];
+            acc[i] = vfmaq_f32(acc[i], vcvtq_f32_s32(dot[i]), vdupq_n_f32(scale));
+        });
+
+        QuantABlkPtr += Q8BlkSize(BlkLen);
+    }
+
+    UnrolledLoop<NCols>([&](size_t i) {
+        SumPtr[i] = vaddvq_f32(acc[i]) + ((BiasPtr != nullptr) ? BiasPtr[i] : 0.0f);
+    });
+}
+
+template <size_t BlkBitWidth>
+size_t
+SQLowBitGemmKernel_CompInt8_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t NCols4 = 4;
+
+    const size_t StrideQuantA = BlockCountK * Q8BlkSize(BlkLen);
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t m = 0; m < CountM; ++m) {
+        const std::byte* QuantARowPtr = QuantA + m * StrideQuantA;
+        float* SumRowPtr = C + m * ldc;
+
+        size_t n = 0;
+        for (; n + NCols4 <= CountN; n += NCols4) {
+            SQLowBitGemm_CompInt8_Compute1xNCols<BlkBitWidth, NCols4>(
+                BlkLen, QuantARowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * BlockCountK,
+                ZeroPointColPtr(QuantBZeroPoint, n, StrideQuantBZeroPoint),
+                (Bias == nullptr) ? nullptr : Bias + n,
+                SumRowPtr + n, BlockCountK
+            );
+        }
+
+        for (; n < CountN; ++n) {
+            SQLowBitGemm_CompInt8_Compute1xNCols<BlkBitWidth, 1>(
+                BlkLen, QuantARowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * BlockCountK,
+                ZeroPointColPtr(QuantBZeroPoint, n, StrideQuantBZeroPoint),
+                (Bias == nullptr) ? nullptr : Bias + n,
+                SumRowPtr + n, BlockCountK
+            );
+        }
+    }
+
+    return CountM;
+}
+
+}  // namespace
+
+void
+SQLowBitGemmM1Kernel_CompFp32(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+)
+{
+    assert(BlkLen % SubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        SQLowBitGemmM1Kernel_CompFp32_Impl<2>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    } else {
+        assert(BlkBitWidth == 3);
+        SQLowBitGemmM1Kernel_CompFp32_Impl<3>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    }
+}
+
+void
+QLowBitBlkDequantBForSgemm_CompFp32(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    assert(BlkLen % SubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        QLowBitBlkDequantBForSgemm_CompFp32_Impl<2>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    } else {
+        assert(BlkBitWidth == 3);
+        QLowBitBlkDequantBForSgemm_CompFp32_Impl<3>(
+            BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+        );
+    }
+}
+
+size_t
+SQLowBitGemmKernel_CompInt8(
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const float* /*QuantAScale*/,
+    const float* /*ABlockSum*/,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    assert(BlkLen % SubBlkLen32 == 0);
+
+    if (BlkBitWidth == 2) {
+        return SQLowBitGemmKernel_CompInt8_Impl<2>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    }
+
+    assert(BlkBitWidth == 3);
+    return SQLowBitGemmKernel_CompInt8_Impl<3>(
+        BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+    );
+}
+
+}  // namespace sqnbitgemm_neon
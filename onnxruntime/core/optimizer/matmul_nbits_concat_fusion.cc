@@ -0,0 +1,401 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_concat_fusion.h"
+
+#include <optional>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// MatMulNBits op input indices.
+namespace InputIndex {
+constexpr size_t A = 0,
+                 B = 1,
+                 scales = 2,
+                 zero_points = 3,
+                 g_idx = 4,
+                 bias = 5;
+};
+
+bool HasInput(const Node& node, size_t index) {
+  const auto& input_defs = node.InputDefs();
+  return input_defs.size() > index && input_defs[index]->Exists();
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() ? attr->i() : default_value;
+}
+
+bool IsCandidate(const Graph& graph, const Node& node,
+                 const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain) ||
+      !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      HasInput(node, InputIndex::g_idx)) {
+    return false;
+  }
+
+  for (size_t index : {InputIndex::B, InputIndex::scales, InputIndex::zero_points, InputIndex::bias}) {
+    if (HasInput(node, index) && !graph_utils::IsConstantInitializer(graph, node.InputDefs()[index]->Name())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Checks that the weights of `a` and `b` can be concatenated along N.
+bool HaveSameConfig(const Node& a, const Node& b) {
+  if (a.InputDefs()[InputIndex::A] != b.InputDefs()[InputIndex::A] ||
+      a.GetExecutionProviderType() != b.GetExecutionProviderType()) {
+    return false;
+  }
+
+  for (const char* name : {"K", "bits", "block_size"}) {
+    if (GetIntAttribute(a, name, -1) != GetIntAttribute(b, name, -1)) {
+      return false;
+    }
+  }
+
+  if (GetIntAttribute(a, "accuracy_level", 0) != GetIntAttribute(b, "accuracy_level", 0)) {
+    return false;
+  }
+
+  for (size_t index : {InputIndex::zero_points, InputIndex::bias}) {
+    const bool has_input = HasInput(a, index);
+    if (has_input != HasInput(b, index) ||
+        (has_input && a.InputDefs()[index]->Type() != b.InputDefs()[index]->Type())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The initializers are concatenated along their first dimension, which is N (or N times the per-column size for
+// 1D inputs) for all MatMulNBits weight inputs.
+bool CanConcatInitializers(const Graph& graph, gsl::span<Node* const> nodes, size_t index) {
+  const auto* first = graph_utils::GetConstantInitializer(graph, nodes[0]->InputDefs()[index]->Name());
+  if (first == nullptr || first->dims_size() == 0) {
+    return false;
+  }
+
+  for (const Node* node : nodes.subspan(1)) {
+    const auto* tensor = graph_utils::GetConstantInitializer(graph, node->InputDefs()[index]->Name());
+    if (tensor == nullptr ||
+        tensor->data_type() != first->data_type() ||
+        tensor->dims_size() != first->dims_size()) {
+      return false;
+    }
+
+    for (int i = 1; i < first->dims_size(); ++i) {
+      if (tensor->dims(i) != first->dims(i)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+NodeArg& ConcatInitializers(Graph& graph, gsl::span<Node* const> nodes, size_t index) {
+  const auto* first = graph_utils::GetConstantInitializer(graph, nodes[0]->InputDefs()[index]->Name());
+
+  ONNX_NAMESPACE::TensorProto concat;
+  concat.set_name(graph.GenerateNodeArgName(nodes[0]->InputDefs()[index]->Name() + "_concat"));
+  concat.set_data_type(first->data_type());
+
+  int64_t dim0 = 0;
+  std::vector<uint8_t> data;
+  for (const Node* node : nodes) {
+    const auto* tensor = graph_utils::GetConstantInitializer(graph, node->InputDefs()[index]->Name());
+    Initializer initializer{*tensor, graph.ModelPath()};
+    const auto bytes = initializer.DataAsByteSpan();
+    data.insert(data.end(), bytes.begin(), bytes.end());
+    dim0 += tensor->dims(0);
+  }
+
+  concat.add_dims(dim0);
+  for (int i = 1; i < first->dims_size(); ++i) {
+    concat.add_dims(first->dims(i));
+  }
+  utils::SetRawDataInTensorProto(concat, data.data(), data.size());
+
+  return graph_utils::AddInitializer(graph, concat);
+}
+
+// Creates a MatMulNBits-like node of type `op_type` over the weights of `nodes` concatenated along N.
+Node& AddConcatenatedNode(Graph& graph, gsl::span<Node* const> nodes, const std::string& op_type,
+                          const std::vector<NodeArg*>& output_defs) {
+  const Node& first = *nodes[0];
+
+  NodeArg& empty = graph.GetOrCreateNodeArg("", nullptr);
+  std::vector<NodeArg*> input_defs(InputIndex::bias + 1, &empty);
+  input_defs[InputIndex::A] = first.MutableInputDefs()[InputIndex::A];
+  for (size_t index : {InputIndex::B, InputIndex::scales, InputIndex::zero_points, InputIndex::bias}) {
+    if (HasInput(first, index)) {
+      input_defs[index] = &ConcatInitializers(graph, nodes, index);
+    }
+  }
+  while (!input_defs.back()->Exists()) {
+    input_defs.pop_back();
+  }
+
+  int64_t N = 0;
+  for (const Node* node : nodes) {
+    N += GetIntAttribute(*node, "N", 0);
+  }
+
+  Node& fused = graph.AddNode(graph.GenerateNodeName(first.Name() + "/MatMulNBitsConcatFusion"),
+                              op_type,
+                              "fused MatMulNBits over concatenated weights",
+                              input_defs,
+                              output_defs,
+                              nullptr,
+                              kMSDomain);
+  fused.AddAttribute("K", GetIntAttribute(first, "K", 0));
+  fused.AddAttribute("N", N);
+  fused.AddAttribute("bits", GetIntAttribute(first, "bits", 0));
+  fused.AddAttribute("block_size", GetIntAttribute(first, "block_size", 0));
+  fused.AddAttribute("accuracy_level", GetIntAttribute(first, "accuracy_level", 0));
+  fused.SetExecutionProviderType(first.GetExecutionProviderType());
+
+  constexpr int a_index = static_cast<int>(InputIndex::A);
+  if (const Node::EdgeEnd* input_edge = graph_utils::GetInputEdge(first, a_index); input_edge != nullptr) {
+    graph.AddEdge(input_edge->GetNode().Index(), fused.Index(), input_edge->GetSrcArgIndex(), a_index);
+  }
+
+  return fused;
+}
+
+// Moves the output edges of `node` to output `output_index` of `replacement` and removes `node`.
+void ReplaceNode(Graph& graph, Node& node, Node& replacement, int output_index) {
+  for (const auto& edge : graph_utils::GraphEdge::GetNodeOutputEdges(node)) {
+    graph.AddEdge(replacement.Index(), edge.dst_node, output_index, edge.dst_arg_index);
+  }
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+}
+
+const Node* GetOnlyOutputNode(const Graph& graph, const Node& node) {
+  if (graph.NodeProducesGraphOutput(node) || node.GetOutputEdgesCount() != 1) {
+    return nullptr;
+  }
+  return &*node.OutputNodesBegin();
+}
+
+// Checks that `node` has exactly the inputs `a` and `b`, in any order.
+bool HasInputs(const Node& node, const NodeArg* a, const NodeArg* b) {
+  const auto& input_defs = node.InputDefs();
+  return input_defs.size() == 2 &&
+         ((input_defs[0] == a && input_defs[1] == b) || (input_defs[0] == b && input_defs[1] == a));
+}
+
+// Matches Mul(Mul(gate, Sigmoid(gate)), up) where gate and up are the outputs of `gate_node` and `up_node`.
+// Returns the final Mul node and adds the Sigmoid and the first Mul node to `activation_nodes`.
+// MatMulNBitsSiluMul multiplies its two halves element-wise, so the Mul nodes must not broadcast: both projections
+// must have the same N, K and block_size, and the Mul nodes must only read the projections and the Sigmoid.
+// As gate and up are computed from the same A, their outputs then have the same shape.
+Node* MatchSiluMul(Graph& graph, const Node& gate_node, const Node& up_node,
+                   InlinedVector<NodeIndex>& activation_nodes) {
+  if (graph.NodeProducesGraphOutput(gate_node) || gate_node.GetOutputEdgesCount() != 2) {
+    return nullptr;
+  }
+
+  for (const char* name : {"N", "K", "block_size"}) {
+    if (GetIntAttribute(gate_node, name, -1) != GetIntAttribute(up_node, name, -1)) {
+      return nullptr;
+    }
+  }
+
+  const Node* sigmoid = nullptr;
+  const Node* silu_mul = nullptr;
+  for (auto it = gate_node.OutputNodesBegin(); it != gate_node.OutputNodesEnd(); ++it) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Sigmoid", {6, 13})) {
+      sigmoid = &*it;
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Mul", {7, 13, 14})) {
+      silu_mul = &*it;
+    }
+  }
+
+  const NodeArg* gate = gate_node.OutputDefs()[0];
+  if (sigmoid == nullptr || silu_mul == nullptr || GetOnlyOutputNode(graph, *sigmoid) != silu_mul ||
+      !HasInputs(*silu_mul, gate, sigmoid->OutputDefs()[0])) {
+    return nullptr;
+  }
+
+  const Node* gate_up_mul = GetOnlyOutputNode(graph, *silu_mul);
+  if (gate_up_mul == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*gate_up_mul, "Mul", {7, 13, 14}) ||
+      GetOnlyOutputNode(graph, up_node) != gate_up_mul ||
+      !HasInputs(*gate_up_mul, silu_mul->OutputDefs()[0], up_node.OutputDefs()[0])) {
+    return nullptr;
+  }
+
+  for (const Node* node : {sigmoid, silu_mul, gate_up_mul}) {
+    if (node->GetExecutionProviderType() != gate_node.GetExecutionProviderType()) {
+      return nullptr;
+    }
+  }
+
+  activation_nodes.push_back(sigmoid->Index());
+  activation_nodes.push_back(silu_mul->Index());
+  return graph.GetNode(gate_up_mul->Index());
+}
+
+bool FuseSiluMul(Graph& graph, gsl::span<Node* const> nodes) {
+  if (nodes.size() != 2) {
+    return false;
+  }
+
+  for (size_t gate_index : {size_t{0}, size_t{1}}) {
+    Node* gate_node = nodes[gate_index];
+    Node* up_node = nodes[1 - gate_index];
+
+    InlinedVector<NodeIndex> activation_nodes;
+    Node* gate_up_mul = MatchSiluMul(graph, *gate_node, *up_node, activation_nodes);
+    if (gate_up_mul == nullptr) {
+      continue;
+    }
+
+    const std::vector<Node*> ordered_nodes{gate_node, up_node};
+    Node& fused = AddConcatenatedNode(graph, ordered_nodes, "MatMulNBitsSiluMul",
+                                      gate_up_mul->MutableOutputDefs());
+
+    ReplaceNode(graph, *gate_up_mul, fused, 0);
+    for (NodeIndex index : activation_nodes) {
+      Node* node = graph.GetNode(index);
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(index);
+    }
+    for (Node* node : ordered_nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+    }
+    return true;
+  }
+
+  return false;
+}
+
+bool FuseWithSplit(Graph& graph, gsl::span<Node* const> nodes) {
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_opset = domain_to_version.find(kOnnxDomain);
+  // Split with a negative axis requires opset 11
+  if (onnx_opset == domain_to_version.end() || onnx_opset->second < 11) {
+    return false;
+  }
+
+  std::vector<int64_t> split_sizes;
+  for (const Node* node : nodes) {
+    split_sizes.push_back(GetIntAttribute(*node, "N", 0));
+  }
+
+  // the element type matches the original outputs, the shape is left to shape inference
+  std::optional<ONNX_NAMESPACE::TypeProto> fused_output_type;
+  if (const auto* type = nodes[0]->OutputDefs()[0]->TypeAsProto(); type != nullptr) {
+    fused_output_type = *type;
+    fused_output_type->mutable_tensor_type()->clear_shape();
+  }
+  NodeArg& fused_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("matmul_nbits_concat"),
+                                                   fused_output_type ? &*fused_output_type : nullptr);
+  Node& fused = AddConcatenatedNode(graph, nodes, "MatMulNBits", {&fused_output});
+
+  std::vector<NodeArg*> split_inputs{&fused_output};
+  if (onnx_opset->second >= 13) {
+    ONNX_NAMESPACE::TensorProto split_tensor;
+    split_tensor.set_name(graph.GenerateNodeArgName("matmul_nbits_concat_split"));
+    split_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    split_tensor.add_dims(static_cast<int64_t>(split_sizes.size()));
+    for (int64_t size : split_sizes) {
+      split_tensor.add_int64_data(size);
+    }
+    split_inputs.push_back(&graph_utils::AddInitializer(graph, split_tensor));
+  }
+
+  std::vector<NodeArg*> split_outputs;
+  for (Node* node : nodes) {
+    split_outputs.push_back(node->MutableOutputDefs()[0]);
+  }
+
+  Node& split = graph.AddNode(graph.GenerateNodeName(nodes[0]->Name() + "/MatMulNBitsConcatFusion/Split"),
+                              "Split",
+                              "split the output of the fused MatMulNBits",
+                              split_inputs,
+                              split_outputs);
+  split.AddAttribute("axis", static_cast<int64_t>(-1));
+  if (onnx_opset->second < 13) {
+    split.AddAttribute("split", split_sizes);
+  }
+  split.SetExecutionProviderType(fused.GetExecutionProviderType());
+  graph.AddEdge(fused.Index(), split.Index(), 0, 0);
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    ReplaceNode(graph, *nodes[i], split, static_cast<int>(i));
+  }
+
+  return true;
+}
+
+}  // namespace
+
+Status MatMulNBitsConcatFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  int fused_count = 0;
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr)
+      continue;  // we removed the node as part of an earlier fusion
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsCandidate(graph, node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    std::vector<Node*> siblings{&node};
+    for (const Node* consumer : graph.GetConsumerNodes(node.InputDefs()[InputIndex::A]->Name())) {
+      if (consumer != nullptr && consumer->Index() != node.Index() &&
+          IsCandidate(graph, *consumer, GetCompatibleExecutionProviders()) &&
+          HaveSameConfig(node, *consumer)) {
+        siblings.push_back(graph.GetNode(consumer->Index()));
+      }
+    }
+
+    if (siblings.size() < 2) {
+      continue;
+    }
+
+    bool can_concat = true;
+    for (size_t index : {InputIndex::B, InputIndex::scales, InputIndex::zero_points, InputIndex::bias}) {
+      if (HasInput(node, index) && !CanConcatInitializers(graph, siblings, index)) {
+        can_concat = false;
+        break;
+      }
+    }
+
+    if (can_concat && (FuseSiluMul(graph, siblings) || FuseWithSplit(graph, siblings))) {
+      fused_count++;
+      modified = true;
+    }
+  }
+
+  if (fused_count > 0) {
+    LOGS(logger, INFO) << "Total fused MatMulNBits sibling groups: " << fused_count;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsConcatFusion
+Fuses sibling MatMulNBits nodes that consume the same input A into a single MatMulNBits node over the weights
+concatenated along N, so that A is read (and quantized, with accuracy_level 4) only once:
+- gate/up projections of a gated MLP, i.e. Mul(SiLU(MatMulNBits(A, gate)), MatMulNBits(A, up)) with SiLU expressed
+  as Mul(x, Sigmoid(x)), become a single MatMulNBitsSiluMul node.
+- any other group of siblings, e.g. the Q, K and V projections, become a MatMulNBits node followed by a Split.
+
+The siblings must have constant B, scales, zero_points and bias inputs, no g_idx input, and the same K, bits,
+block_size and accuracy_level.
+*/
+class MatMulNBitsConcatFusion : public GraphTransformer {
+ public:
+  MatMulNBitsConcatFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulNBitsConcatFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
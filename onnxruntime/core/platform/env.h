@@ -91,6 +91,14 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // If true, the pool is shared by inter-op tasks and intra-op parallel loops. Parallel loops then only enlist
+  // the threads that are not busy running an inter-op task (see ThreadPool::InterOpTaskScope).
+  bool unified_scheduling = false;
+
+  // If true and spinning is allowed, each worker tunes how long it spins before parking from the time it
+  // usually waits for work, instead of always spinning for a fixed number of iterations.
+  bool adaptive_spinning = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -149,6 +157,26 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// <summary>
+  /// Returns the logical processors of each NUMA node of the system, indexed by node id.
+  /// </summary>
+  /// <returns>Empty if the NUMA topology is not known on this platform</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodeProcessors() const {
+    return {};
+  }
+
+  /// <summary>
+  /// Asks the OS to place the physical pages backing [p, p + size) on the given NUMA node.
+  /// Only the pages that lie entirely within the range are affected. Must be called before the memory is
+  /// first touched to avoid migrating pages.
+  /// </summary>
+  virtual common::Status BindMemoryToNumaNode(void* p, size_t size, int numa_node) const {
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA memory placement is not supported on this platform");
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -194,6 +222,22 @@ class Env {
   virtual common::Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                            MappedMemoryPtr& mapped_memory) const = 0;
 
+  /**
+   * Asks the OS to read a range of the file into its page cache in the background.
+   * It returns without waiting for the data, a later read or mapping of the range
+   * only waits for the pages that are not in the cache yet.
+   * @param file_path The path to the file.
+   * @param offset The file offset from which to start prefetching.
+   * @param length The length in bytes to prefetch.
+   */
+  virtual common::Status PrefetchFileRange(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset,
+                                           size_t length) const {
+    ORT_UNUSED_PARAMETER(file_path);
+    ORT_UNUSED_PARAMETER(offset);
+    ORT_UNUSED_PARAMETER(length);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Prefetching files is not supported on this platform");
+  }
+
 #ifdef _WIN32
   /// \brief Returns true if the directory exists.
   virtual bool FolderExists(const std::wstring& path) const = 0;
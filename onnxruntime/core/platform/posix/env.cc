@@ -31,8 +31,10 @@ limitations under the License.
 #endif
 #include <unistd.h>
 
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <sstream>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -324,6 +326,67 @@ class PosixEnv : public Env {
 #endif
   }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override {
+    std::vector<LogicalProcessors> nodes;
+    for (int node = 0;; ++node) {
+      std::ifstream cpulist_file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      std::string cpulist;
+      if (!cpulist_file || !std::getline(cpulist_file, cpulist)) {
+        break;
+      }
+
+      // e.g. "0-15,32-47"
+      LogicalProcessors processors;
+      std::istringstream ranges(cpulist);
+      std::string range;
+      while (std::getline(ranges, range, ',')) {
+        if (range.empty()) {
+          continue;
+        }
+        const auto dash = range.find('-');
+        const int first = static_cast<int>(strtol(range.c_str(), nullptr, 10));
+        const int last = dash == std::string::npos ? first
+                                                   : static_cast<int>(strtol(range.c_str() + dash + 1, nullptr, 10));
+        for (int id = first; id <= last; ++id) {
+          processors.push_back(id);
+        }
+      }
+      nodes.push_back(std::move(processors));
+    }
+    return nodes;
+  }
+
+#if defined(SYS_mbind)
+  common::Status BindMemoryToNumaNode(void* p, size_t size, int numa_node) const override {
+    ORT_RETURN_IF_NOT(numa_node >= 0, "Invalid NUMA node ", numa_node);
+
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(p) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(p) + size) & ~(page_size - 1);
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    // values from linux/mempolicy.h. MPOL_PREFERRED falls back to other nodes when the node is full.
+    constexpr int kMpolPreferred = 1;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+    constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMaskWord + 1, 0);
+    node_mask[static_cast<size_t>(numa_node) / kBitsPerMaskWord] |= 1UL << (static_cast<size_t>(numa_node) % kBitsPerMaskWord);
+
+    // the kernel reads maxnode - 1 bits of the mask
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, node_mask.data(),
+                node_mask.size() * kBitsPerMaskWord + 1, kMpolMfMove) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mbind to NUMA node ", numa_node, " failed, error code: ", err_no,
+                             " error msg: ", err_msg);
+    }
+    return Status::OK();
+  }
+#endif
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -456,6 +519,44 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status PrefetchFileRange(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length) const override {
+    ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
+    ORT_RETURN_IF_NOT(offset >= 0, "offset < 0");
+
+    ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
+    if (!file_descriptor.IsValid()) {
+      return ReportSystemError("open", file_path);
+    }
+
+    if (length == 0)
+      return Status::OK();
+
+#if defined(__APPLE__)
+    // F_RDADVISE takes the length as an int
+    size_t total_bytes_advised = 0;
+    while (total_bytes_advised < length) {
+      constexpr size_t k_max_bytes_to_advise = 1 << 30;
+      const size_t bytes_to_advise = std::min(length - total_bytes_advised, k_max_bytes_to_advise);
+      radvisory advice{};
+      advice.ra_offset = static_cast<off_t>(offset + static_cast<FileOffsetType>(total_bytes_advised));
+      advice.ra_count = static_cast<int>(bytes_to_advise);
+      if (fcntl(file_descriptor.Get(), F_RDADVISE, &advice) == -1) {
+        return ReportSystemError("fcntl", file_path);
+      }
+      total_bytes_advised += bytes_to_advise;
+    }
+#else
+    // posix_fadvise returns the error instead of setting errno
+    const int result = posix_fadvise(file_descriptor.Get(), offset, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+    if (result != 0) {
+      errno = result;
+      return ReportSystemError("posix_fadvise", file_path);
+    }
+#endif
+
+    return Status::OK();
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto [err_no, err_msg] = GetErrnoInfo();
     std::ostringstream oss;
@@ -12,6 +12,9 @@ namespace onnxruntime {
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
 
+  // If non-negative, the memory of the allocators is placed on this NUMA node.
+  int numa_node{-1};
+
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
 
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/element_wise_broadcast.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+BroadcastPlan::BroadcastPlan(std::initializer_list<gsl::span<const int64_t>> input_shapes)
+    : input_count_(input_shapes.size()), output_size_(1) {
+  ORT_ENFORCE(input_count_ >= 1 && input_count_ <= kMaxInputs, "Unsupported broadcast input count: ", input_count_);
+
+  size_t rank = 0;
+  for (const auto& shape : input_shapes) {
+    rank = std::max(rank, shape.size());
+  }
+
+  // Dimension of each input along each output axis, with missing leading dimensions treated as 1.
+  InlinedVector<std::array<int64_t, kMaxInputs>> input_dims(rank);
+  size_t input = 0;
+  for (const auto& shape : input_shapes) {
+    const size_t offset = rank - shape.size();
+    for (size_t d = 0; d < rank; d++) {
+      input_dims[d][input] = d < offset ? 1 : shape[d - offset];
+    }
+    input++;
+  }
+
+  // Validate the axes innermost first, matching the order in which Broadcaster reports errors.
+  output_shape_.resize(rank);
+  for (size_t d = rank; d-- > 0;) {
+    const auto begin = input_dims[d].begin();
+    const auto end = begin + input_count_;
+    const int64_t largest = *std::max_element(begin, end);
+    const int64_t smallest = *std::min_element(begin, end);
+
+    if (smallest == 0) {
+      ORT_ENFORCE(largest <= 1, "Can broadcast 0 by 0 or 1. ", largest, " is invalid.");
+      output_shape_[d] = 0;
+    } else {
+      for (auto it = begin; it != end; ++it) {
+        const int64_t axis = *it;
+        ORT_ENFORCE(axis == 1 || axis == largest,
+                    "Attempting to broadcast an axis by a dimension other than 1. ", axis, " by ", largest);
+      }
+      output_shape_[d] = largest;
+    }
+    output_size_ *= static_cast<size_t>(output_shape_[d]);
+  }
+
+  if (output_size_ == 0) {
+    return;
+  }
+
+  // Collapse the output axes, outermost first. Axes of size 1 contribute nothing to the iteration and adjacent
+  // axes merge when every input has the same broadcast state along both.
+  InlinedVector<std::array<bool, kMaxInputs>> broadcasts;
+  for (size_t d = 0; d < rank; d++) {
+    if (output_shape_[d] == 1) {
+      continue;
+    }
+
+    std::array<bool, kMaxInputs> broadcast{};
+    for (size_t i = 0; i < input_count_; i++) {
+      broadcast[i] = input_dims[d][i] == 1;
+    }
+
+    if (!dims_.empty() && broadcasts.back() == broadcast) {
+      dims_.back() *= output_shape_[d];
+    } else {
+      dims_.push_back(output_shape_[d]);
+      broadcasts.push_back(broadcast);
+    }
+  }
+
+  if (dims_.empty()) {
+    // Every input holds a single element.
+    dims_.push_back(1);
+    for (size_t i = 0; i < input_count_; i++) {
+      strides_[i].push_back(1);
+    }
+    return;
+  }
+
+  // Element strides of each input, innermost first. A broadcast input stays on the same elements.
+  for (size_t i = 0; i < input_count_; i++) {
+    strides_[i].resize(dims_.size());
+    ptrdiff_t stride = 1;
+    for (size_t d = dims_.size(); d-- > 0;) {
+      if (broadcasts[d][i]) {
+        strides_[i][d] = 0;
+      } else {
+        strides_[i][d] = stride;
+        stride *= static_cast<ptrdiff_t>(dims_[d]);
+      }
+    }
+  }
+}
+
+}  // namespace onnxruntime
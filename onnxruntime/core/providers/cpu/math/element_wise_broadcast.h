@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Describes how the inputs of an element-wise operator map onto its output under numpy style broadcasting.
+//
+// Output dimensions of size 1 are dropped and adjacent dimensions are collapsed whenever every input either
+// broadcasts along both of them or along neither, so e.g. [N,C,H,W] + [1,C,1,1] is iterated as [N,C,H*W] with the
+// second input having strides [0,1,0]. The innermost collapsed dimension is the unit of work handed to the typed
+// kernels: each input is either contiguous along it (stride 1) or a scalar repeated along it (stride 0).
+class BroadcastPlan {
+ public:
+  static constexpr size_t kMaxInputs = 3;
+
+  explicit BroadcastPlan(std::initializer_list<gsl::span<const int64_t>> input_shapes);
+
+  gsl::span<const int64_t> OutputShape() const noexcept { return output_shape_; }
+  size_t OutputSize() const noexcept { return output_size_; }
+  size_t InputCount() const noexcept { return input_count_; }
+
+  // Element stride of the input along the innermost collapsed dimension, either 0 or 1.
+  ptrdiff_t InnerStride(size_t input) const noexcept { return strides_[input].back(); }
+
+  // Calls fn(offsets, output_offset, count) for each run of output elements in [first, last) that lies within a
+  // single row of the innermost collapsed dimension. offsets[i] is the element offset of input i for the first
+  // output element of the run.
+  template <typename Fn>
+  void ForEachRun(size_t first, size_t last, Fn&& fn) const {
+    const size_t rank = dims_.size();
+    const size_t inner = static_cast<size_t>(dims_[rank - 1]);
+
+    InlinedVector<int64_t> index(rank);
+    std::array<ptrdiff_t, kMaxInputs> offsets{};
+
+    size_t remainder = first;
+    for (size_t d = rank; d-- > 0;) {
+      index[d] = static_cast<int64_t>(remainder % static_cast<size_t>(dims_[d]));
+      remainder /= static_cast<size_t>(dims_[d]);
+      for (size_t i = 0; i < input_count_; i++) {
+        offsets[i] += static_cast<ptrdiff_t>(index[d]) * strides_[i][d];
+      }
+    }
+
+    size_t position = first;
+    for (;;) {
+      const size_t column = static_cast<size_t>(index[rank - 1]);
+      const size_t count = std::min(inner - column, last - position);
+      fn(offsets, position, count);
+      position += count;
+      if (position >= last) {
+        break;
+      }
+
+      // The run ended at the end of a row, so rewind the innermost dimension and step the outer ones.
+      for (size_t i = 0; i < input_count_; i++) {
+        offsets[i] -= static_cast<ptrdiff_t>(column) * strides_[i][rank - 1];
+      }
+      index[rank - 1] = 0;
+      for (size_t d = rank - 1; d-- > 0;) {
+        for (size_t i = 0; i < input_count_; i++) {
+          offsets[i] += strides_[i][d];
+        }
+        if (++index[d] < dims_[d]) {
+          break;
+        }
+        for (size_t i = 0; i < input_count_; i++) {
+          offsets[i] -= static_cast<ptrdiff_t>(dims_[d]) * strides_[i][d];
+        }
+        index[d] = 0;
+      }
+    }
+  }
+
+ private:
+  size_t input_count_;
+  TensorShapeVector output_shape_;
+  size_t output_size_;
+  // Collapsed output dimensions, outermost first, and the element strides of each input along them.
+  InlinedVector<int64_t> dims_;
+  std::array<InlinedVector<ptrdiff_t>, kMaxInputs> strides_;
+};
+
+// Applies a binary kernel to two broadcast inputs, splitting the output elements across the thread pool.
+//
+// The kernel provides the inner loops for the three layouts a run can have:
+//   Input0Scalar(T0 a, const T1* b, TOut* out, size_t n)
+//   Input1Scalar(const T0* a, T1 b, TOut* out, size_t n)
+//   General(const T0* a, const T1* b, TOut* out, size_t n)
+// The calls are resolved statically so the kernels are inlined into the run loop and vectorized per type.
+template <typename T0, typename T1, typename TOut, typename Kernel>
+void BroadcastBinaryLoop(const BroadcastPlan& plan, const T0* input0, const T1* input1, TOut* output,
+                         concurrency::ThreadPool* tp, double unit_cost, const Kernel& kernel) {
+  const size_t size = plan.OutputSize();
+  if (size == 0) {
+    return;
+  }
+
+  TensorOpCost cost{static_cast<double>(std::max(sizeof(T0), sizeof(T1))), static_cast<double>(sizeof(TOut)),
+                    unit_cost};
+
+  if (plan.InnerStride(0) == 0) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(size), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          plan.ForEachRun(static_cast<size_t>(first), static_cast<size_t>(last),
+                          [&](const auto& offsets, size_t output_offset, size_t n) {
+                            kernel.Input0Scalar(input0[offsets[0]], input1 + offsets[1], output + output_offset, n);
+                          });
+        });
+  } else if (plan.InnerStride(1) == 0) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(size), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          plan.ForEachRun(static_cast<size_t>(first), static_cast<size_t>(last),
+                          [&](const auto& offsets, size_t output_offset, size_t n) {
+                            kernel.Input1Scalar(input0 + offsets[0], input1[offsets[1]], output + output_offset, n);
+                          });
+        });
+  } else {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(size), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          plan.ForEachRun(static_cast<size_t>(first), static_cast<size_t>(last),
+                          [&](const auto& offsets, size_t output_offset, size_t n) {
+                            kernel.General(input0 + offsets[0], input1 + offsets[1], output + output_offset, n);
+                          });
+        });
+  }
+}
+
+// Applies a ternary kernel to three broadcast inputs, splitting the output elements across the thread pool.
+//
+// The kernel is called as kernel(a, a_stride, b, b_stride, c, c_stride, out, n) where each stride is 0 or 1.
+template <typename T0, typename T1, typename T2, typename TOut, typename Kernel>
+void BroadcastTernaryLoop(const BroadcastPlan& plan, const T0* input0, const T1* input1, const T2* input2,
+                          TOut* output, concurrency::ThreadPool* tp, double unit_cost, const Kernel& kernel) {
+  const size_t size = plan.OutputSize();
+  if (size == 0) {
+    return;
+  }
+
+  const ptrdiff_t stride0 = plan.InnerStride(0);
+  const ptrdiff_t stride1 = plan.InnerStride(1);
+  const ptrdiff_t stride2 = plan.InnerStride(2);
+
+  TensorOpCost cost{static_cast<double>(sizeof(T0) + sizeof(T1) + sizeof(T2)), static_cast<double>(sizeof(TOut)),
+                    unit_cost};
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(size), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        plan.ForEachRun(static_cast<size_t>(first), static_cast<size_t>(last),
+                        [&](const auto& offsets, size_t output_offset, size_t n) {
+                          kernel(input0 + offsets[0], stride0, input1 + offsets[1], stride1,
+                                 input2 + offsets[2], stride2, output + output_offset, n);
+                        });
+      });
+}
+
+// Broadcasts inputs 0 and 1 of the node and applies the binary kernel to produce output 0.
+template <typename T0, typename T1, typename TOut, typename Kernel>
+void BroadcastBinary(OpKernelContext& context, const Kernel& kernel, double unit_cost = 1.0) {
+  const Tensor& input0 = *context.Input<Tensor>(0);
+  const Tensor& input1 = *context.Input<Tensor>(1);
+
+  BroadcastPlan plan({input0.Shape().GetDims(), input1.Shape().GetDims()});
+  Tensor& output = *context.Output(0, TensorShape(plan.OutputShape()));
+
+  BroadcastBinaryLoop(plan, input0.Data<T0>(), input1.Data<T1>(), output.MutableData<TOut>(),
+                      context.GetOperatorThreadPool(), unit_cost, kernel);
+}
+
+// Broadcasts inputs 0, 1 and 2 of the node and applies the ternary kernel to produce output 0.
+template <typename T0, typename T1, typename T2, typename TOut, typename Kernel>
+void BroadcastTernary(OpKernelContext& context, const Kernel& kernel, double unit_cost = 1.0) {
+  const Tensor& input0 = *context.Input<Tensor>(0);
+  const Tensor& input1 = *context.Input<Tensor>(1);
+  const Tensor& input2 = *context.Input<Tensor>(2);
+
+  BroadcastPlan plan({input0.Shape().GetDims(), input1.Shape().GetDims(), input2.Shape().GetDims()});
+  Tensor& output = *context.Output(0, TensorShape(plan.OutputShape()));
+
+  BroadcastTernaryLoop(plan, input0.Data<T0>(), input1.Data<T1>(), input2.Data<T2>(), output.MutableData<TOut>(),
+                       context.GetOperatorThreadPool(), unit_cost, kernel);
+}
+
+}  // namespace onnxruntime
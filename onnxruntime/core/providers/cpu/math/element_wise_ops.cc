@@ -6,6 +6,7 @@
 #include "core/common/narrow.h"
 #include "core/framework/data_types_internal.h"
 #include "core/framework/math.h"
+#include "core/providers/cpu/math/element_wise_broadcast.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include <unsupported/Eigen/SpecialFunctions>
@@ -464,126 +465,196 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
                                      AllocateTensorFunc allocate_tensor,
                                      const ProcessBroadcastSpanFuncs& funcs);
 
+namespace {
+
+// Inner loops of the arithmetic operators over one run of output elements, vectorized by Eigen for each type.
+// Op combines an Eigen array with a scalar or another array.
+template <typename T, typename Op>
+struct EigenBinaryKernel {
+  void Input0Scalar(T a, const T* b, T* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<T>(out, count) = Op{}(a, ConstEigenVectorArrayMap<T>(b, count));
+  }
+
+  void Input1Scalar(const T* a, T b, T* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<T>(out, count) = Op{}(ConstEigenVectorArrayMap<T>(a, count), b);
+  }
+
+  void General(const T* a, const T* b, T* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<T>(out, count) = Op{}(ConstEigenVectorArrayMap<T>(a, count),
+                                               ConstEigenVectorArrayMap<T>(b, count));
+  }
+};
+
+struct AddOp {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a + b; }
+};
+
+struct SubOp {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a - b; }
+};
+
+struct MulOp {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a * b; }
+};
+
+struct DivOp {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const { return a / b; }
+};
+
+// Min and Max propagate NaN. Both are commutative, so a scalar operand is always placed on the right.
+template <bool is_min>
+struct MinMaxOp {
+  template <typename A, typename B>
+  auto operator()(const A& a, const B& b) const {
+    if constexpr (std::is_arithmetic_v<A> || std::is_same_v<A, Eigen::half>) {
+      return (*this)(b, a);
+    } else if constexpr (is_min) {
+      return a.template min<Eigen::PropagateNaN>(b);
+    } else {
+      return a.template max<Eigen::PropagateNaN>(b);
+    }
+  }
+};
+
+template <typename T, bool is_min>
+struct MinMaxKernel : EigenBinaryKernel<T, MinMaxOp<is_min>> {};
+
+// MLFloat16 is computed as Eigen::half, which has the same layout.
+template <bool is_min>
+struct MinMaxKernel<MLFloat16, is_min> {
+  void Input0Scalar(MLFloat16 a, const MLFloat16* b, MLFloat16* out, size_t n) const {
+    kernel.Input0Scalar(static_cast<Eigen::half>(a), reinterpret_cast<const Eigen::half*>(b),
+                        reinterpret_cast<Eigen::half*>(out), n);
+  }
+
+  void Input1Scalar(const MLFloat16* a, MLFloat16 b, MLFloat16* out, size_t n) const {
+    kernel.Input1Scalar(reinterpret_cast<const Eigen::half*>(a), static_cast<Eigen::half>(b),
+                        reinterpret_cast<Eigen::half*>(out), n);
+  }
+
+  void General(const MLFloat16* a, const MLFloat16* b, MLFloat16* out, size_t n) const {
+    kernel.General(reinterpret_cast<const Eigen::half*>(a), reinterpret_cast<const Eigen::half*>(b),
+                   reinterpret_cast<Eigen::half*>(out), n);
+  }
+
+  EigenBinaryKernel<Eigen::half, MinMaxOp<is_min>> kernel;
+};
+
+// Folds the inputs of a variadic operator with a binary kernel, e.g. Min(a, b, c) = Min(Min(a, b), c).
+// Each step broadcasts like BroadcastBinary and writes a temporary tensor, except the last one which writes output 0.
+template <typename T, typename Kernel>
+void BroadcastVariadic(OpKernelContext& context, int input_count, const Kernel& kernel) {
+  const auto& input0 = *context.Input<Tensor>(0);
+
+  // One item is trivial, just copy and exit
+  if (input_count == 1) {
+    auto& output = *context.Output(0, input0.Shape());
+    CopyCpuTensor(&input0, &output);
+    return;
+  }
+
+  TensorAllocator tensor_allocator(context);
+  std::unique_ptr<Tensor> temp_input;
+  std::unique_ptr<Tensor> temp_output;
+
+  for (int i = 0; i < input_count - 1; i++) {
+    const auto& tensor0 = temp_input ? *temp_input : input0;
+    const auto& tensor1 = *context.Input<Tensor>(i + 1);
+
+    BroadcastPlan plan({tensor0.Shape().GetDims(), tensor1.Shape().GetDims()});
+    const TensorShape output_shape(plan.OutputShape());
+
+    Tensor* p_output = nullptr;
+    if (i == input_count - 2) {
+      p_output = context.Output(0, output_shape);
+    } else {
+      temp_output = tensor_allocator.Allocate<T>(output_shape);
+      p_output = temp_output.get();
+    }
+
+    BroadcastBinaryLoop(plan, tensor0.Data<T>(), tensor1.Data<T>(), p_output->MutableData<T>(),
+                        context.GetOperatorThreadPool(), 1.0, kernel);
+
+    temp_input = std::move(temp_output);
+  }
+}
+
+}  // namespace
+
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
-  // BroadcastHelper received as argument may differ from 'helper' when parallelizing within a span
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() + per_iter_bh.EigenInput1<T>().array();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().array() + per_iter_bh.ScalarInput1<T>();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>() + per_iter_bh.EigenInput1<T>();
-      }};
-
-  UntypedBroadcastTwo(*context, funcs, 1.0f);
+  BroadcastBinary<T, T, T>(*context, EigenBinaryKernel<T, AddOp>{});
   return Status::OK();
 }
 
 template <typename T>
 Status Sub<T>::Compute(OpKernelContext* context) const {
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() - per_iter_bh.EigenInput1<T>().array();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().array() - per_iter_bh.ScalarInput1<T>();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>() - per_iter_bh.EigenInput1<T>();
-      }};
-
-  UntypedBroadcastTwo(*context, funcs, 1.0);
+  BroadcastBinary<T, T, T>(*context, EigenBinaryKernel<T, SubOp>{});
   return Status::OK();
 }
 
 template <typename T>
 Status Mul<T>::Compute(OpKernelContext* context) const {
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() * per_iter_bh.EigenInput1<T>().array();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().array() * per_iter_bh.ScalarInput1<T>();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().cwiseProduct(per_iter_bh.EigenInput1<T>());
-      }};
-
-  UntypedBroadcastTwo(*context, funcs, 1.0);
+  BroadcastBinary<T, T, T>(*context, EigenBinaryKernel<T, MulOp>{});
   return Status::OK();
 }
 
 template <typename T>
 Status Div<T>::Compute(OpKernelContext* context) const {
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.ScalarInput0<T>() / per_iter_bh.EigenInput1<T>().array();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().array() / per_iter_bh.ScalarInput1<T>();
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        per_iter_bh.OutputEigen<T>() = per_iter_bh.EigenInput0<T>().cwiseQuotient(per_iter_bh.EigenInput1<T>());
-      }};
-
-  UntypedBroadcastTwo(*context, funcs, 1.0);
+  BroadcastBinary<T, T, T>(*context, EigenBinaryKernel<T, DivOp>{});
   return Status::OK();
 }
 
 namespace pow_internal {
 
 template <typename T, typename E>
-void PowImpl(OpKernelContext& context) {
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        const T X = per_iter_bh.ScalarInput0<T>();
-        auto Y = per_iter_bh.SpanInput1<E>();
-        auto output = per_iter_bh.OutputSpan<T>();
-
-        std::transform(Y.begin(), Y.end(), output.begin(),
-                       [X](E y) {
-                         return static_cast<T>(std::pow(X, y));
-                       });
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto X = per_iter_bh.SpanInput0<T>();
-        const E Y = per_iter_bh.ScalarInput1<E>();
-        auto output = per_iter_bh.OutputSpan<T>();
+struct PowKernel {
+  void Input0Scalar(T X, const E* Y, T* output, size_t n) const {
+    std::transform(Y, Y + n, output,
+                   [X](E y) {
+                     return static_cast<T>(std::pow(X, y));
+                   });
+  }
 
-        // optimize for X^2 and X^3
-        if (Y == 2) {
-          std::transform(X.begin(), X.end(), output.begin(),
-                         [](T x) {
-                           return static_cast<T>(x * x);
-                         });
-
-        } else if (Y == 3) {
-          std::transform(X.begin(), X.end(), output.begin(),
-                         [](T x) {
-                           return static_cast<T>(x * x * x);
-                         });
-        } else {
-          std::transform(X.begin(), X.end(), output.begin(),
-                         [Y](T x) {
-                           return static_cast<T>(std::pow(x, Y));
-                         });
-        }
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto X = per_iter_bh.SpanInput0<T>();
-        auto Y = per_iter_bh.SpanInput1<E>();
-        auto output = per_iter_bh.OutputSpan<T>();
+  void Input1Scalar(const T* X, E Y, T* output, size_t n) const {
+    // optimize for X^2 and X^3
+    if (Y == 2) {
+      std::transform(X, X + n, output,
+                     [](T x) {
+                       return static_cast<T>(x * x);
+                     });
+
+    } else if (Y == 3) {
+      std::transform(X, X + n, output,
+                     [](T x) {
+                       return static_cast<T>(x * x * x);
+                     });
+    } else {
+      std::transform(X, X + n, output,
+                     [Y](T x) {
+                       return static_cast<T>(std::pow(x, Y));
+                     });
+    }
+  }
 
-        std::transform(X.begin(), X.end(), Y.begin(), output.begin(),
-                       [](T x, E y) {
-                         return static_cast<T>(std::pow(x, y));
-                       });
-      }};
+  void General(const T* X, const E* Y, T* output, size_t n) const {
+    std::transform(X, X + n, Y, output,
+                   [](T x, E y) {
+                     return static_cast<T>(std::pow(x, y));
+                   });
+  }
+};
 
-  UntypedBroadcastTwo(context, funcs, 1.0);
+template <typename T, typename E>
+void PowImpl(OpKernelContext& context) {
+  BroadcastBinary<T, E, T>(context, PowKernel<T, E>{});
 }
 
 template <typename B>
@@ -714,110 +785,15 @@ Status Min_6<float>::Compute(OpKernelContext* ctx) const {
 template <typename T>
 struct Min_8::ComputeImpl {
   Status operator()(const Min_8& inst, OpKernelContext* context) const {
-    const auto typed_allocator = [](const TensorAllocator& tensor_allocator, const TensorShape& shape) {
-      return tensor_allocator.Allocate<T>(shape);
-    };
-
-    ProcessBroadcastSpanFuncs funcs{
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput1<T>().array().template min<Eigen::PropagateNaN>(per_iter_bh.ScalarInput0<T>());
-        },
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput0<T>().array().template min<Eigen::PropagateNaN>(per_iter_bh.ScalarInput1<T>());
-        },
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput0<T>().array().template min<Eigen::PropagateNaN>(
-                  per_iter_bh.EigenInput1<T>().array());
-        }};
-
-    int input_count = inst.Node().InputArgCount().front();
-    UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
-
+    BroadcastVariadic<T>(*context, inst.Node().InputArgCount().front(), MinMaxKernel<T, true>{});
     return Status::OK();
   }
 };
 
-template <bool is_min>
-static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
-  const auto typed_allocator = [](const TensorAllocator& tensor_allocator, const TensorShape& shape) {
-    return tensor_allocator.Allocate<MLFloat16>(shape);
-  };
-
-  ProcessBroadcastSpanFuncs funcs{
-      [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.EigenInput1<MLFloat16>().rows();
-
-        const auto* input_1 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput1<MLFloat16>().data());
-        ConstEigenVectorArrayMap<Eigen::half> input_1_vec_map(input_1, num_elements);
-
-        auto* output = reinterpret_cast<Eigen::half*>(per_iter_bh.OutputEigen<MLFloat16>().data());
-        EigenVectorArrayMap<Eigen::half> output_vec_map(output, num_elements);
-
-        if (is_min) {
-          output_vec_map = input_1_vec_map.template min<Eigen::PropagateNaN>(
-              static_cast<Eigen::half>(per_iter_bh.ScalarInput0<MLFloat16>()));
-        } else {
-          output_vec_map = input_1_vec_map.template max<Eigen::PropagateNaN>(
-              static_cast<Eigen::half>(per_iter_bh.ScalarInput0<MLFloat16>()));
-        }
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.EigenInput0<MLFloat16>().rows();
-
-        const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
-        ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
-
-        auto* output = reinterpret_cast<Eigen::half*>(per_iter_bh.OutputEigen<MLFloat16>().data());
-        EigenVectorArrayMap<Eigen::half> output_vec_map(output, num_elements);
-
-        if (is_min) {
-          output_vec_map = input_0_vec_map.template min<Eigen::PropagateNaN>(
-              static_cast<Eigen::half>(per_iter_bh.ScalarInput1<MLFloat16>()));
-        } else {
-          output_vec_map = input_0_vec_map.template max<Eigen::PropagateNaN>(
-              static_cast<Eigen::half>(per_iter_bh.ScalarInput1<MLFloat16>()));
-        }
-      },
-      [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.EigenInput0<MLFloat16>().rows();
-
-        const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
-        ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
-
-        const auto* input_1 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput1<MLFloat16>().data());
-        ConstEigenVectorArrayMap<Eigen::half> input_1_vec_map(input_1, num_elements);
-
-        auto* output = reinterpret_cast<Eigen::half*>(per_iter_bh.OutputEigen<MLFloat16>().data());
-        EigenVectorArrayMap<Eigen::half> output_vec_map(output, num_elements);
-
-        if (is_min) {
-          output_vec_map = input_0_vec_map.template min<Eigen::PropagateNaN>(input_1_vec_map);
-        } else {
-          output_vec_map = input_0_vec_map.template max<Eigen::PropagateNaN>(input_1_vec_map);
-        }
-      }};
-
-  int input_count = inst.Node().InputArgCount().front();
-  UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
-
-  return Status::OK();
-}
-
 Status Min_8::Compute(OpKernelContext* context) const {
-  auto dt_type = context->Input<Tensor>(0)->GetElementType();
-
-  switch (dt_type) {
-    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
-      return MinMaxMLFloat16<true>(*this, context);
-      break;
-    default:
-      utils::MLTypeCallDispatcher<float, double, int32_t, uint32_t, int64_t, uint64_t>
-          t_disp(dt_type);
-      return t_disp.InvokeRet<Status, ComputeImpl>(*this, context);
-  }
+  utils::MLTypeCallDispatcher<float, double, MLFloat16, int32_t, uint32_t, int64_t, uint64_t>
+      t_disp(context->Input<Tensor>(0)->GetElementType());
+  return t_disp.InvokeRet<Status, ComputeImpl>(*this, context);
 }
 
 template <>
@@ -841,49 +817,15 @@ Status Max_6<float>::Compute(OpKernelContext* ctx) const {
 template <typename T>
 struct Max_8::ComputeImpl {
   Status operator()(const Max_8& inst, OpKernelContext* context) const {
-    const auto typed_allocator = [](const TensorAllocator& tensor_allocator, const TensorShape& shape) {
-      return tensor_allocator.Allocate<T>(shape);
-    };
-
-    ProcessBroadcastSpanFuncs funcs{
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput1<T>().array().template max<Eigen::PropagateNaN>(per_iter_bh.ScalarInput0<T>());
-        },
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput0<T>().array().template max<Eigen::PropagateNaN>(per_iter_bh.ScalarInput1<T>());
-        },
-        [](BroadcastHelper& per_iter_bh) {
-          per_iter_bh.OutputEigen<T>() =
-              per_iter_bh.EigenInput0<T>().array().template max<Eigen::PropagateNaN>(
-                  per_iter_bh.EigenInput1<T>().array());
-        }};
-
-    int input_count = inst.Node().InputArgCount().front();
-    // TODO: Parallelize across spans in UntypedBroadcastVariadic to avoid specific logic here
-    if (input_count == 2) {
-      UntypedBroadcastTwo(*context, funcs, 1.0);
-    } else {
-      UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
-    }
-
+    BroadcastVariadic<T>(*context, inst.Node().InputArgCount().front(), MinMaxKernel<T, false>{});
     return Status::OK();
   }
 };
 
 Status Max_8::Compute(OpKernelContext* context) const {
-  auto dt_type = context->Input<Tensor>(0)->GetElementType();
-
-  switch (dt_type) {
-    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
-      return MinMaxMLFloat16<false>(*this, context);
-      break;
-    default:
-      utils::MLTypeCallDispatcher<float, double, int32_t, uint32_t, int64_t, uint64_t>
-          t_disp(dt_type);
-      return t_disp.InvokeRet<Status, ComputeImpl>(*this, context);
-  }
+  utils::MLTypeCallDispatcher<float, double, MLFloat16, int32_t, uint32_t, int64_t, uint64_t>
+      t_disp(context->Input<Tensor>(0)->GetElementType());
+  return t_disp.InvokeRet<Status, ComputeImpl>(*this, context);
 }
 
 Status Not::Compute(OpKernelContext* context) const {
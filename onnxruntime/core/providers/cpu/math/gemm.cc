@@ -6,6 +6,7 @@
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/mlas/inc/mlas.h"
@@ -26,6 +27,8 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     double,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Gemm<double>);
+// The fp16 kernels are registered only when MlasHalfGemmSupported(),
+// see RegisterFp16GemmKernels in cpu_execution_provider.cc.
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     Gemm,
     7,
@@ -138,6 +141,83 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+bool GemmFastMathBfloat16Enabled(const ConfigOptions& config_options) {
+  const bool enabled = config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathBfloat16, "0") == "1" ||
+                       config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0") == "1";
+  return enabled && MlasBf16AccelerationSupported();
+}
+
+bool GemmPackBBfloat16(AllocatorPtr& alloc,
+                       const Tensor& tensor_b,
+                       bool trans_b,
+                       IAllocatorUniquePtr<void>& packed_b,
+                       size_t& packed_b_size,
+                       TensorShape& b_shape) {
+  // Only handle the common case of a 2D weight matrix. Additional matrices
+  // could be handled by stacking the packed buffers.
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  packed_b_size = MlasSBGemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = packed_b.get();
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  // The bfloat16 packing only reads B row major, so transpose it first. This is done once per weight.
+  const float* b_data = tensor_b.Data<float>();
+  std::vector<float> transposed_b;
+  if (trans_b) {
+    transposed_b.resize(K * N);
+    MlasTranspose(b_data, transposed_b.data(), N, K);
+    b_data = transposed_b.data();
+  }
+
+  MlasSBGemmConvertPackB(N, K, b_data, N, packed_b_data);
+  return true;
+}
+#endif
+
+// The MLAS half precision GEMM reads B as K x N, so a constant B of a Gemm with transB
+// set is transposed once here instead of falling back to Eigen on every run.
+static bool GemmTransposeBFp16(AllocatorPtr& alloc,
+                               const Tensor& tensor_b,
+                               IAllocatorUniquePtr<void>& packed_b,
+                               size_t& packed_b_size,
+                               TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+  b_shape = tensor_b.Shape();
+
+  const size_t N = static_cast<size_t>(b_shape[0]);
+  const size_t K = static_cast<size_t>(b_shape[1]);
+
+  packed_b_size = SafeInt<size_t>(N) * K * sizeof(MLFloat16);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  MlasTranspose(reinterpret_cast<const uint16_t*>(tensor_b.Data<MLFloat16>()),
+                static_cast<uint16_t*>(packed_b.get()), N, K);
+  return true;
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -199,30 +279,34 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 
   if (c_data == nullptr)
     beta = onnxruntime::MLFloat16::Zero;
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
-  bool support_mlas = false;
-  if (c_shape == nullptr) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 1 && (*c_shape)[0] == N) {
-    support_mlas = true;
-  } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
-    support_mlas = true;
-  }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
-    MLAS_HALF_GEMM_DATA_PARAMS data;
-    data.A = a_data;
-    data.lda = K;
-    data.B = b_data;
-    data.ldb = N;
-    data.C = y_data;
-    data.ldc = N;
-    if (c_shape != nullptr) {
-      data.Bias = c_data;
+  // MLAS computes A * B + Bias, with Bias a row vector broadcast to every row.
+  // A C of shape (N, 1) broadcasts along the other dimension so it is left to Eigen.
+  if (MlasHalfGemmSupported()) {
+    bool support_mlas = false;
+    if (c_shape == nullptr) {
+      support_mlas = true;
+    } else if (c_shape->NumDimensions() == 1 && (*c_shape)[0] == N) {
+      support_mlas = true;
+    } else if (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1 && (*c_shape)[1] == N) {
+      support_mlas = true;
+    }
+    if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 &&
+        (c_data == nullptr || beta.ToFloat() == 1.0)) {
+      MLAS_HALF_GEMM_DATA_PARAMS data;
+      data.A = a_data;
+      data.lda = K;
+      data.B = b_data;
+      data.ldb = N;
+      data.C = y_data;
+      data.ldc = N;
+      if (c_shape != nullptr) {
+        data.Bias = c_data;
+      }
+      MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
+      return;
     }
-    MlasHalfGemmBatch(M, N, K, 1, &data, thread_pool);
-    return;
   }
-#endif
+
   // Fallback to Eigen
   // Broadcast the bias as needed if bias is given
   GemmBroadcastBias(M, N, beta, c_data, c_shape, y_data);
@@ -263,7 +347,15 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+#if defined(MLAS_SBGEMM_SUPPORTED)
+    if (UseBfloat16PackedB(tensor.Shape())) {
+      is_packed = GemmPackBBfloat16(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+      packed_b_is_bf16_ = is_packed;
+    } else
+#endif
+    {
+      is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    }
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -273,18 +365,30 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   return Status::OK();
 }
 
-template <typename T>
-Status Gemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
-                                          int /*input_idx*/,
-                                          /*out*/ bool& used_shared_buffers) {
-  used_shared_buffers = false;
+template <>
+Status Gemm<MLFloat16>::PrePack(const Tensor& tensor, int input_idx,
+                                AllocatorPtr alloc, /*out*/ bool& is_packed,
+                                /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only a transposed B needs packing, MLAS reads a K x N B in place
+  if (input_idx == 1 && trans_B_ != CblasNoTrans && MlasHalfGemmSupported()) {
+    size_t packed_b_size;
+    is_packed = GemmTransposeBFp16(alloc, tensor, packed_b_, packed_b_size, b_shape_);
+    bool share_prepacked_weights = (prepacked_weights != nullptr);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_b_));
+      prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+    }
+  }
   return Status::OK();
 }
 
-template <>
-Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
-                                              int input_idx,
-                                              /*out*/ bool& used_shared_buffers) {
+// Only Gemm<float> and Gemm<MLFloat16> pack B, other types never get here.
+template <typename T>
+Status Gemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                          int input_idx,
+                                          /*out*/ bool& used_shared_buffers) {
   used_shared_buffers = false;
 
   if (input_idx == 1) {
@@ -294,6 +398,70 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::GetPrePackedBuffersToPersist(int /*input_idx*/,
+                                             /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const {
+  buffers.clear();
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::GetPrePackedBuffersToPersist(int input_idx,
+                                                 /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const {
+  buffers.clear();
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // only the fp32 packing is persisted
+  if (packed_b_is_bf16_) {
+    return Status::OK();
+  }
+#endif
+
+  if (input_idx == 1 && packed_b_) {
+    const bool trans_b = trans_B_ != CblasNoTrans;
+    const size_t K = static_cast<size_t>(trans_b ? b_shape_[1] : b_shape_[0]);
+    const size_t N = static_cast<size_t>(trans_b ? b_shape_[0] : b_shape_[1]);
+    buffers.emplace_back(static_cast<const uint8_t*>(packed_b_.get()), MlasGemmPackBSize(N, K));
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status Gemm<T>::UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                             gsl::span<const size_t> /*buffer_sizes*/,
+                                             const Tensor& /*tensor*/, int /*input_idx*/,
+                                             /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                 gsl::span<const size_t> buffer_sizes,
+                                                 const Tensor& tensor, int input_idx,
+                                                 /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // PrePack() would use the bfloat16 packing
+  if (input_idx == 1 && UseBfloat16PackedB(tensor.Shape())) {
+    return Status::OK();
+  }
+#endif
+
+  if (input_idx == 1 && prepacked_buffers.size() == 1 && tensor.Shape().NumDimensions() == 2) {
+    const bool trans_b = trans_B_ != CblasNoTrans;
+    const size_t K = static_cast<size_t>(trans_b ? tensor.Shape()[1] : tensor.Shape()[0]);
+    const size_t N = static_cast<size_t>(trans_b ? tensor.Shape()[0] : tensor.Shape()[1]);
+    if (buffer_sizes[0] == MlasGemmPackBSize(N, K)) {
+      used_persisted_buffers = true;
+      b_shape_ = tensor.Shape();
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -380,7 +548,10 @@ Status Gemm<MLFloat16>::Compute(OpKernelContext* context) const {
     ComputeGemm(trans_A_, trans_B_, M, N, K, static_cast<MLFloat16>(alpha_), A->Data<MLFloat16>(), B->Data<MLFloat16>(), static_cast<MLFloat16>(beta_),
                 c_data, c_shape, y_data, thread_pool);
   } else {
-    ORT_NOT_IMPLEMENTED("Prepacking of B is supported by MLAS half gemm API, but not implemented by this kernel yet");
+    // packed_b_ holds B transposed to K x N
+    ComputeGemm(trans_A_, CblasNoTrans, M, N, K, static_cast<MLFloat16>(alpha_), A->Data<MLFloat16>(),
+                static_cast<const MLFloat16*>(packed_b_.get()), static_cast<MLFloat16>(beta_),
+                c_data, c_shape, y_data, thread_pool);
   }
 
   ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
@@ -421,6 +592,40 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   if (B) {
     ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
                 c_data, c_shape, y_data, thread_pool);
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  } else if (packed_b_is_bf16_) {
+    // PrePack() only uses the bfloat16 packing when A is not transposed, alpha is 1 and K is not 0.
+    // A bias vector scaled by 1 is added by the kernel, any other C is broadcast to Y and the product
+    // added to it.
+    const bool bias_is_vector = c_shape != nullptr && beta_ == 1.0f && c_shape->Size() == N &&
+                                (c_shape->NumDimensions() == 1 ||
+                                 (c_shape->NumDimensions() == 2 && (*c_shape)[0] == 1));
+    const bool accumulate = c_data != nullptr && beta_ != 0.0f && !bias_is_vector;
+
+    IAllocatorUniquePtr<float> product;
+    if (accumulate) {
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+      product = IAllocator::MakeUniquePtr<float>(alloc, SafeInt<size_t>(M) * N);
+      GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+    }
+
+    MLAS_SBGEMM_DATA_PARAMS data;
+    data.AIsfp32 = true;
+    data.A = A->Data<float>();
+    data.lda = static_cast<size_t>(K);
+    data.B = packed_b_.get();
+    data.BIsfp32 = false;
+    data.C = accumulate ? product.get() : y_data;
+    data.ldc = static_cast<size_t>(N);
+    data.Bias = bias_is_vector ? c_data : nullptr;
+    MlasSBGemmBatch(static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), 1, &data, thread_pool);
+
+    if (accumulate) {
+      const auto y_size = narrow<Eigen::Index>(SafeInt<size_t>(M) * N);
+      EigenVectorArrayMap<float>(y_data, y_size) += ConstEigenVectorArrayMap<float>(product.get(), y_size);
+    }
+#endif
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
     if (K > 0) {
@@ -5,10 +5,14 @@
 
 #include "gemm_base.h"
 
+#include <type_traits>
+
 #include "core/framework/op_kernel.h"
 #include "core/common/common.h"
 #include "core/util/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/activation/activations.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
 
 namespace onnxruntime {
 
@@ -16,6 +20,11 @@ template <typename T>
 class Gemm : protected GemmBase, public OpKernel {
  public:
   Gemm(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {
+#if defined(MLAS_SBGEMM_SUPPORTED)
+    if constexpr (std::is_same<T, float>::value) {
+      use_fastmath_mode_ = GemmFastMathBfloat16Enabled(info.GetConfigOptions());
+    }
+#endif
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -28,6 +37,14 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status GetPrePackedBuffersToPersist(int input_idx,
+                                      /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const override;
+
+  Status UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      gsl::span<const size_t> buffer_sizes,
+                                      const Tensor& tensor, int input_idx,
+                                      /*out*/ bool& used_persisted_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
@@ -44,6 +61,22 @@ class Gemm : protected GemmBase, public OpKernel {
   // For fused gemm + activation
   std::unique_ptr<functors::ElementWiseRangedTransform<T>> activation_;
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // fastmath mode state
+  bool use_fastmath_mode_{false};
+  // packed_b_ holds B packed in bfloat16 for MlasSBGemmBatch
+  bool packed_b_is_bf16_{false};
+  // see MatMul<float>
+  static constexpr size_t kFastMathModeKernelsizeThreshold = 32;
+
+  // The bfloat16 kernel computes A * B + Bias, so it is only used when the rest of the op reduces to that.
+  bool UseBfloat16PackedB(const TensorShape& b_shape) const {
+    return use_fastmath_mode_ && trans_A_ == CblasNoTrans && alpha_ == 1.0f &&
+           b_shape.NumDimensions() == 2 &&
+           static_cast<size_t>(b_shape.Size()) >= kFastMathModeKernelsizeThreshold;
+  }
+#endif
+
   void ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const;
 };
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -14,4 +15,16 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+#if defined(MLAS_SBGEMM_SUPPORTED)
+// Whether the session enables the bfloat16 fastmath mode of MatMul and Gemm and the CPU supports it.
+bool GemmFastMathBfloat16Enabled(const ConfigOptions& config_options);
+
+bool GemmPackBBfloat16(AllocatorPtr& alloc,
+                       const Tensor& tensor_b,
+                       bool trans_b,
+                       IAllocatorUniquePtr<void>& packed_b,
+                       size_t& packed_b_size,
+                       TensorShape& b_shape);
+#endif
+
 };  // namespace onnxruntime
@@ -23,6 +23,15 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+// The fp16 kernels are registered only when MlasHalfGemmSupported(),
+// see RegisterFp16GemmKernels in cpu_execution_provider.cc.
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 // opset 9 supports more types
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
@@ -40,6 +49,14 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     9,
@@ -72,6 +89,13 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     13,
@@ -133,44 +157,53 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
-bool GemmPackBBfloat16(AllocatorPtr& alloc,
-                       const Tensor& tensor_b,
-                       bool trans_b,
-                       IAllocatorUniquePtr<void>& packed_b,
-                       size_t& packed_b_size,
-                       TensorShape& b_shape) {
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
-  if (tensor_b.Shape().NumDimensions() != 2) {
-    return false;
-  }
 
-  b_shape = tensor_b.Shape();
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  auto* y_data = y->MutableData<MLFloat16>();
+
+  if (helper.K() == 0) {
+    // When we have (M, 0, N) then the inputs are empty, but the output should
+    // be filled out with zeros.
+    std::fill_n(y_data, y->Shape().Size(), MLFloat16::Zero);
+    return Status::OK();
+  }
 
-  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
-  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+  const auto* a_data = a->Data<MLFloat16>();
+  const auto* b_data = b->Data<MLFloat16>();
 
-  packed_b_size = MlasSBGemmPackBSize(N, K);
-  if (packed_b_size == 0) {
-    return false;
+  // The kernel is only registered when MLAS has a vectorized half precision GEMM,
+  // so the inputs are used as is instead of being converted to fp32.
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
   }
+  MlasHalfGemmBatch(M, N, K, max_len, data.data(), thread_pool);
 
-  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
-  auto* packed_b_data = packed_b.get();
-
-  // Initialize memory to 0 as there could be some padding associated with pre-packed
-  // buffer memory and we don not want it uninitialized and generate different hashes
-  // if and when we try to cache this pre-packed buffer for sharing between sessions.
-  memset(packed_b_data, 0, packed_b_size);
-  MlasSBGemmConvertPackB(N,
-                         K,
-                         tensor_b.Data<float>(),
-                         trans_b ? K : N,
-                         packed_b_data);
-  return true;
+  return Status::OK();
 }
-#endif
 
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
@@ -180,7 +213,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -196,6 +229,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
 #endif
     {
       is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      packed_b_fp32_size_ = is_packed ? packed_b_size : 0;
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -220,6 +254,47 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::GetPrePackedBuffersToPersist(int input_idx,
+                                                   /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const {
+  buffers.clear();
+
+  if (input_idx == 1 && packed_b_ && packed_b_fp32_size_ != 0) {
+    buffers.emplace_back(static_cast<const uint8_t*>(packed_b_.get()), packed_b_fp32_size_);
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<float>::UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   gsl::span<const size_t> buffer_sizes,
+                                                   const Tensor& tensor, int input_idx,
+                                                   /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  const auto& b_shape = tensor.Shape();
+  if (input_idx != 1 || prepacked_buffers.size() != 1 || b_shape.NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // PrePack() would use the bfloat16 packing
+  if (use_fastmath_mode_ && (trans_b_attr_ == 0) &&
+      static_cast<size_t>(b_shape[0] * b_shape[1]) >= kFastMathModeKernelsizeThreshold) {
+    return Status::OK();
+  }
+#endif
+
+  const size_t K = static_cast<size_t>(trans_b_attr_ ? b_shape[1] : b_shape[0]);
+  const size_t N = static_cast<size_t>(trans_b_attr_ ? b_shape[0] : b_shape[1]);
+  if (buffer_sizes[0] == MlasGemmPackBSize(N, K)) {
+    used_persisted_buffers = true;
+    b_shape_ = b_shape;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -258,7 +333,7 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
@@ -5,6 +5,7 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
@@ -30,9 +31,10 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
-#if defined(__aarch64__) && defined(__linux__)
-    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
-    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
+#if defined(MLAS_SBGEMM_SUPPORTED)
+    // the bfloat16 kernel computes A * B, so transposing A and scaling are left to the fp32 kernel
+    use_fastmath_mode_ = GemmFastMathBfloat16Enabled(info.GetConfigOptions()) && trans_a_attr_ == 0 &&
+                         alpha_attr_ == 1.0f;
 #endif
   }
 
@@ -43,11 +45,21 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status GetPrePackedBuffersToPersist(int input_idx,
+                                      /*out*/ std::vector<gsl::span<const uint8_t>>& buffers) const override;
+
+  Status UsePersistedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      gsl::span<const size_t> buffer_sizes,
+                                      const Tensor& tensor, int input_idx,
+                                      /*out*/ bool& used_persisted_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // size of packed_b_ if it holds B packed in fp32, which is the only packing that can be persisted
+  size_t packed_b_fp32_size_{0};
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -56,7 +68,7 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
   // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
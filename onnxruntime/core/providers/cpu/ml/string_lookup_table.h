@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Read-only map from strings to values built once when a kernel is created.
+// It is an open addressing hash table with linear probing. The characters of all the keys are stored in one
+// buffer and a slot only holds the hash of its key, the position of the key in that buffer and its length:
+// a lookup compares the hashes first and only reads the characters of a key whose hash matches.
+// The table is at most half full so that a missing key is found after a few slots.
+template <typename TValue>
+class StringLookupTable {
+ public:
+  // Builds the table. If a key appears several times, the first value is kept unless keep_last is true.
+  void Build(gsl::span<const std::string> keys, gsl::span<const TValue> values, bool keep_last = false) {
+    ORT_ENFORCE(keys.size() == values.size(), "Keys and values must have the same length.");
+
+    size_t capacity = kMinCapacity;
+    while (capacity < keys.size() * 2) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    slots_.assign(capacity, Slot{0, kEmpty, 0});
+    values_.assign(capacity, TValue{});
+    keys_.clear();
+    size_ = 0;
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const std::string_view key = keys[i];
+      const uint64_t hash = Hash(key);
+      size_t index = static_cast<size_t>(hash) & mask_;
+      while (slots_[index].offset != kEmpty && !Matches(slots_[index], hash, key)) {
+        index = (index + 1) & mask_;
+      }
+      if (slots_[index].offset == kEmpty) {
+        ORT_ENFORCE(keys_.size() + key.size() < kEmpty, "The keys of the lookup table exceed 4GB.");
+        slots_[index] = Slot{hash, static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(key.size())};
+        keys_.insert(keys_.end(), key.begin(), key.end());
+        values_[index] = values[i];
+        ++size_;
+      } else if (keep_last) {
+        values_[index] = values[i];
+      }
+    }
+  }
+
+  size_t Size() const { return size_; }
+
+  // Returns the value of key, nullptr if the table does not contain it.
+  const TValue* Find(std::string_view key) const {
+    return Find(key, Hash(key));
+  }
+
+  // Writes to values[i] the value of keys[i] or default_value if the table does not contain it.
+  // The hashes of a group of keys are computed first and their slots prefetched, the lookups of that group then
+  // overlap the cache misses instead of waiting for each of them.
+  void FindBatch(gsl::span<const std::string> keys, gsl::span<TValue> values, const TValue& default_value) const {
+    ORT_ENFORCE(keys.size() == values.size(), "Keys and values must have the same length.");
+
+    if (slots_.size() <= kMinCapacity) {
+      // comparing a key with a few others is cheaper than hashing it.
+      for (size_t i = 0; i < keys.size(); ++i) {
+        const TValue* found = Scan(keys[i]);
+        values[i] = found == nullptr ? default_value : *found;
+      }
+      return;
+    }
+
+    uint64_t hashes[kBatchSize];
+    for (size_t begin = 0; begin < keys.size(); begin += kBatchSize) {
+      const size_t count = std::min(kBatchSize, keys.size() - begin);
+      for (size_t i = 0; i < count; ++i) {
+        hashes[i] = Hash(keys[begin + i]);
+        Prefetch(&slots_[static_cast<size_t>(hashes[i]) & mask_]);
+      }
+      for (size_t i = 0; i < count; ++i) {
+        const TValue* found = Find(keys[begin + i], hashes[i]);
+        values[begin + i] = found == nullptr ? default_value : *found;
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    // Position of the key in keys_, kEmpty if the slot is empty.
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kBatchSize = 16;
+  static constexpr size_t kMinCapacity = 8;
+
+  static uint64_t Hash(std::string_view key) {
+    return static_cast<uint64_t>(std::hash<std::string_view>{}(key));
+  }
+
+  static void Prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    ORT_UNUSED_PARAMETER(address);
+#endif
+  }
+
+  bool Matches(const Slot& slot, uint64_t hash, std::string_view key) const {
+    return slot.hash == hash && slot.length == key.size() &&
+           (key.empty() || std::memcmp(keys_.data() + slot.offset, key.data(), key.size()) == 0);
+  }
+
+  const TValue* Scan(std::string_view key) const {
+    for (size_t index = 0; index < slots_.size(); ++index) {
+      const Slot& slot = slots_[index];
+      if (slot.offset != kEmpty && slot.length == key.size() &&
+          (key.empty() || std::memcmp(keys_.data() + slot.offset, key.data(), key.size()) == 0)) {
+        return &values_[index];
+      }
+    }
+    return nullptr;
+  }
+
+  const TValue* Find(std::string_view key, uint64_t hash) const {
+    size_t index = static_cast<size_t>(hash) & mask_;
+    while (slots_[index].offset != kEmpty) {
+      if (Matches(slots_[index], hash, key)) {
+        return &values_[index];
+      }
+      index = (index + 1) & mask_;
+    }
+    return nullptr;
+  }
+
+  size_t mask_{0};
+  size_t size_{0};
+  std::vector<Slot> slots_{Slot{0, kEmpty, 0}};
+  // Value of the key in the slot with the same index.
+  std::vector<TValue> values_{TValue{}};
+  // Characters of all the keys.
+  std::vector<char> keys_;
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -74,6 +74,31 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   ORT_ENFORCE(coefficients_.size() > 0);
   weights_are_all_positive_ = std::all_of(coefficients_.cbegin(), coefficients_.cend(),
                                           [](float value) { return value >= 0.f; });
+
+  // the classifier comparing classes i and j combines the coefficients in row j - 1 for the support vectors of class i
+  // and the ones in row i for the support vectors of class j. with these coefficients gathered in one row per
+  // classifier, the scores of all the classifiers for all the batches come from a single GEMM.
+  if (mode_ == SVM_TYPE::SVM_SVC && class_count_ <= kMaxClassesForClassifierCoefficients &&
+      vectors_per_class_.size() == static_cast<size_t>(class_count_) &&
+      coefficients_.size() >= static_cast<size_t>((class_count_ - 1) * vector_count_)) {
+    const ptrdiff_t num_classifiers = class_count_ * (class_count_ - 1) / 2;
+    classifier_coefficients_.resize(SafeInt<size_t>(num_classifiers) * vector_count_, 0.f);
+
+    float* row = classifier_coefficients_.data();
+    for (ptrdiff_t i = 0; i < class_count_ - 1; i++) {
+      const ptrdiff_t start_index_i = narrow<ptrdiff_t>(starting_vector_[i]);
+      const ptrdiff_t class_i_support_count = narrow<ptrdiff_t>(vectors_per_class_[i]);
+      for (ptrdiff_t j = i + 1; j < class_count_; j++) {
+        const ptrdiff_t start_index_j = narrow<ptrdiff_t>(starting_vector_[j]);
+        const ptrdiff_t class_j_support_count = narrow<ptrdiff_t>(vectors_per_class_[j]);
+        std::copy_n(coefficients_.data() + vector_count_ * (j - 1) + start_index_i, class_i_support_count,
+                    row + start_index_i);
+        std::copy_n(coefficients_.data() + vector_count_ * i + start_index_j, class_j_support_count,
+                    row + start_index_j);
+        row += vector_count_;
+      }
+    }
+  }
 }
 
 template <typename LabelType>
@@ -189,7 +214,6 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
   auto final_scores = Z.MutableDataAsSpan<float>();
 
   std::vector<float> kernels_data;
-  std::vector<int64_t> votes_data;
 
   std::vector<float> classifier_scores_data;
   std::vector<float> probsp2_data;
@@ -217,103 +241,64 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
                               threadpool);
 
   } else {
-    gsl::span<float> classifier_scores;
-
-    // if we have one classifier, are writing directly to the final buffer,
-    // and will add an additional score in the results, leave a space between each classifier score so that
-    // we can parallelize the batch processing below.
-    int64_t num_slots_per_iteration = write_additional_scores >= 0 ? 2 : num_classifiers;
-
-    if (have_proba) {
-      // we will write num_batches * num_classifiers scores first, and transform those to num_batches * class_count_,
-      // so need to use a separate buffer for the first scoring.
-      classifier_scores_data.resize(num_batches * num_classifiers);
-      classifier_scores = gsl::make_span<float>(classifier_scores_data.data(), classifier_scores_data.size());
-    } else {
-      // we will write directly to the final scores buffer
-      // num_scores_per_batch = num_classifiers;
-      // assert(num_scores_per_batch == final_scores_per_batch);
-      classifier_scores = final_scores;
-    }
-
+    // the scores of the classifiers are written to a separate buffer first, they are either transformed to
+    // num_batches * class_count_ probabilities or copied to the final scores which may have an additional score
+    // per batch.
+    classifier_scores_data.resize(num_batches * num_classifiers);
     kernels_data.resize(num_batches * vector_count_);
-    votes_data.resize(num_batches * class_count_, 0);
-
-    auto kernels_span = gsl::make_span<float>(kernels_data.data(), kernels_data.size());
-    auto votes_span = gsl::make_span<int64_t>(votes_data.data(), votes_data.size());
 
     // combine the input data with the support vectors and apply the kernel type
     // output is {num_batches, vector_count_}
-    batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
+    batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_data,
                               threadpool);
 
-    for (int64_t n = 0; n < num_batches; n++) {
-      // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
-      // per class.
-      // coefficients: [num_classes - 1, vector_count_]
-      //
-      // e.g. say you have 3 classes, with 3 x 3 coefficients
-      //
-      // AA AB AC
-      // BA BB BC
-      // CA CB CC
-      //
-      // you can remove the diagonal line of items comparing a class with itself leaving one less row.
-      //
-      // BA AB AC
-      // CA CB BC
-      //
-      // for each class there is a coefficient per support vector, and a class has one or more support vectors.
-      //
-      // Combine the scores for the two combinations for two classes with their coefficient.
-      // e.g. AB combines with BA.
-      // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
-
-      auto cur_kernels = kernels_span.subspan(n * SafeInt<size_t>(vector_count_), onnxruntime::narrow<size_t>(vector_count_));
-      auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration), onnxruntime::narrow<size_t>(num_classifiers));
-      auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
-      auto scores_iter = cur_scores.begin();
-
-      size_t classifier_idx = 0;
-      for (int64_t i = 0; i < class_count_ - 1; i++) {
-        int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
-        int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
-        int64_t i_coeff_row_offset = vector_count_ * i;
-
-        for (int64_t j = i + 1; j < class_count_; j++) {
-          int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
-          int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
-          int64_t j_coeff_row_offset = vector_count_ * (j - 1);
-
-          double sum = 0;
-
-          const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
-          const float* val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_i)]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
-          val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_j)]);
-
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[classifier_idx++];
-
-          *scores_iter++ = static_cast<float>(sum);
-          ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
-        }
-      }
+    if (!classifier_coefficients_.empty()) {
+      // combine the kernels with the coefficients of each classifier and add rho_
+      // output is {num_batches, num_classifiers}
+      const TensorShape rho_shape({num_classifiers});
+      onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                            num_batches, num_classifiers, vector_count_,
+                                            1.f, kernels_data.data(), classifier_coefficients_.data(), 1.f,
+                                            rho_.data(), &rho_shape,
+                                            classifier_scores_data.data(),
+                                            threadpool);
     }
   }
 
   auto finalize_batch = [this, &final_scores, final_scores_per_batch,
                          have_proba, &probsp2_data, class_count_squared,
-                         &classifier_scores_data, num_classifiers, &votes_data, &Y,
+                         &classifier_scores_data, num_classifiers, &kernels_data, &Y,
                          num_scores_per_batch, write_additional_scores](ptrdiff_t idx) {
     int n = SafeInt<int32_t>(idx);  // convert to a usable sized type
     auto cur_scores = final_scores.subspan(n * SafeInt<size_t>(final_scores_per_batch), onnxruntime::narrow<size_t>(final_scores_per_batch));
 
+    float max_weight = 0;
+    int64_t maxclass = -1;
+
+    if (mode_ == SVM_TYPE::SVM_SVC) {
+      auto classifier_scores = gsl::make_span<float>(classifier_scores_data.data() + (n * num_classifiers),
+                                                     onnxruntime::narrow<size_t>(num_classifiers));
+      if (classifier_coefficients_.empty()) {
+        ComputeClassifierScores(gsl::make_span<const float>(kernels_data.data() + (n * vector_count_),
+                                                            onnxruntime::narrow<size_t>(vector_count_)),
+                                classifier_scores);
+      }
+
+      // each classifier votes for one of the two classes it compares
+      InlinedVector<int64_t> votes(onnxruntime::narrow<size_t>(class_count_), 0);
+      auto scores_iter = classifier_scores.begin();
+      for (int64_t i = 0; i < class_count_ - 1; i++) {
+        for (int64_t j = i + 1; j < class_count_; j++) {
+          ++votes[onnxruntime::narrow<size_t>(*scores_iter++ > 0 ? i : j)];
+        }
+      }
+      maxclass = std::distance(votes.begin(), std::max_element(votes.begin(), votes.end()));
+
+      if (!have_proba) {
+        std::copy(classifier_scores.begin(), classifier_scores.end(), cur_scores.begin());
+      }
+    }
+
     if (mode_ == SVM_TYPE::SVM_SVC && have_proba) {
       auto probsp2 = gsl::make_span<float>(probsp2_data.data() + (n * class_count_squared), onnxruntime::narrow<size_t>(class_count_squared));
 
@@ -338,13 +323,7 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
       multiclass_probability(class_count_, probsp2, cur_scores);
     }
 
-    float max_weight = 0;
-    int64_t maxclass = -1;
-    if (votes_data.size() > 0) {
-      auto votes = gsl::make_span<int64_t>(votes_data.data() + (n * class_count_), onnxruntime::narrow<size_t>(class_count_));
-      auto it_maxvotes = std::max_element(votes.begin(), votes.end());
-      maxclass = std::distance(votes.begin(), it_maxvotes);
-    } else {
+    if (mode_ != SVM_TYPE::SVM_SVC) {
       auto it_max_weight = std::max_element(cur_scores.begin(), cur_scores.end());
       maxclass = std::distance(cur_scores.begin(), it_max_weight);
       max_weight = *it_max_weight;
@@ -388,5 +367,59 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
   return Status::OK();
 }
 
+void SVMClassifier::ComputeClassifierScores(gsl::span<const float> kernels, gsl::span<float> scores) const {
+  // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
+  // per class.
+  // coefficients: [num_classes - 1, vector_count_]
+  //
+  // e.g. say you have 3 classes, with 3 x 3 coefficients
+  //
+  // AA AB AC
+  // BA BB BC
+  // CA CB CC
+  //
+  // you can remove the diagonal line of items comparing a class with itself leaving one less row.
+  //
+  // BA AB AC
+  // CA CB BC
+  //
+  // for each class there is a coefficient per support vector, and a class has one or more support vectors.
+  //
+  // Combine the scores for the two combinations for two classes with their coefficient.
+  // e.g. AB combines with BA.
+  // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
+  auto scores_iter = scores.begin();
+
+  size_t classifier_idx = 0;
+  for (int64_t i = 0; i < class_count_ - 1; i++) {
+    int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
+    int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
+    int64_t i_coeff_row_offset = vector_count_ * i;
+
+    for (int64_t j = i + 1; j < class_count_; j++) {
+      int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
+      int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
+      int64_t j_coeff_row_offset = vector_count_ * (j - 1);
+
+      double sum = 0;
+
+      const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
+      const float* val2 = &(kernels[onnxruntime::narrow<size_t>(start_index_i)]);
+      for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
+        sum += *val1 * *val2;
+
+      val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
+      val2 = &(kernels[onnxruntime::narrow<size_t>(start_index_j)]);
+
+      for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
+        sum += *val1 * *val2;
+
+      sum += rho_[classifier_idx++];
+
+      *scores_iter++ = static_cast<float>(sum);
+    }
+  }
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
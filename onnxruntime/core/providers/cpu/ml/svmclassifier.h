@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
@@ -38,29 +39,56 @@ class SVMCommon {
                           concurrency::ThreadPool* threadpool) const {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
-    if (kernel_type_ == KERNEL::RBF) {
+    if (kernel_type_ == KERNEL::RBF && m == 1) {
       T* cur_out = out.data();
-      const T* cur_batch = a.data();
 
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
+      // broadcast the support vectors against the k features. output is one value per support vector
+      for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
+        *cur_out++ = std::exp(-gamma_ * squared_distance(a.data(), b.data() + support_vector * k, k));
+      }
+    } else if (kernel_type_ == KERNEL::RBF) {
+      // ||a - b||^2 = ||a||^2 + ||b||^2 - 2 a.b so the distances between all the batches and all the support vectors
+      // come from a single GEMM.
+      std::vector<T> b_norms(onnxruntime::narrow<size_t>(n));
+      for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
+        b_norms[onnxruntime::narrow<size_t>(support_vector)] =
+            ConstEigenVectorMap<T>(b.data() + support_vector * k, k).squaredNorm();
+      }
 
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
+      // out = -2 a.b, the norms are added below
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 0.f,
+                                        nullptr, nullptr,
+                                        out.data(),
+                                        threadpool);
 
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
+      auto apply_rbf = [this, &a, &b, &out, &b_norms, n, k](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t batch = first; batch < last; ++batch) {
+          const T* cur_batch = a.data() + batch * k;
+          T* cur_out = out.data() + batch * n;
+          const T a_norm = ConstEigenVectorMap<T>(cur_batch, k).squaredNorm();
+
+          for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
+            const T norms = a_norm + b_norms[onnxruntime::narrow<size_t>(support_vector)];
+            T distance = cur_out[support_vector] + norms;
+            // the expansion loses the precision of a distance much smaller than the norms,
+            // which is when the kernel value matters the most. compute it directly in that case.
+            if (distance < norms * (1.f / 16)) {
+              distance = squared_distance(cur_batch, b.data() + support_vector * k, k);
+            }
+            cur_out[support_vector] = -gamma_ * distance;
           }
 
-          *cur_out++ = std::exp(-gamma_ * sum);
+          MlasComputeExp(cur_out, cur_out, onnxruntime::narrow<size_t>(n));
         }
+      };
 
-        cur_batch += k;  // move to start of next batch
-      }
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m,
+          TensorOpCost{static_cast<double>(k + n) * sizeof(T), static_cast<double>(n) * sizeof(T),
+                       static_cast<double>(k + n * 16)},
+          apply_rbf);
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -96,6 +124,16 @@ class SVMCommon {
   }
 
  private:
+  template <typename T>
+  static T squared_distance(const T* a, const T* b, ptrdiff_t k) {
+    T sum = 0.f;
+    for (ptrdiff_t feature = 0; feature < k; ++feature) {
+      T val = a[feature] - b[feature];
+      sum += val * val;
+    }
+    return sum;
+  }
+
   KERNEL kernel_type_;
   float gamma_{0.f};
   float coef0_{0.f};
@@ -113,6 +151,10 @@ class SVMClassifier final : public OpKernel, private SVMCommon {
 
  private:
   Status ComputeImpl(OpKernelContext& ctx, gsl::span<const float> x_data, const TensorShape& x_shape) const;
+  void ComputeClassifierScores(gsl::span<const float> kernels, gsl::span<float> scores) const;
+
+  // Above this number of classes, most coefficients of classifier_coefficients_ would be zeros.
+  static constexpr ptrdiff_t kMaxClassesForClassifierCoefficients = 8;
 
   bool weights_are_all_positive_;
   ptrdiff_t feature_count_;
@@ -126,6 +168,8 @@ class SVMClassifier final : public OpKernel, private SVMCommon {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  // coefficients_ expanded to one row of vector_count_ coefficients per classifier, empty if not used.
+  std::vector<float> classifier_coefficients_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
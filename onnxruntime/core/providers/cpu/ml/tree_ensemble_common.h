@@ -4,6 +4,8 @@
 #pragma once
 
 #include "tree_ensemble_aggregator.h"
+#include "tree_ensemble_flat.h"
+#include "tree_ensemble_quickscorer.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "tree_ensemble_helper.h"
@@ -47,6 +49,10 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  // Evaluate batches of rows if the ensemble allows it, nullptr otherwise.
+  // flat_ is only built if quick_scorer_ cannot be.
+  std::unique_ptr<TreeEnsembleQuickScorer<InputType, ThresholdType>> quick_scorer_;
+  std::unique_ptr<TreeEnsembleFlat<InputType, ThresholdType>> flat_;
 
  public:
   TreeEnsembleCommon() {}
@@ -86,6 +92,10 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
+  template <typename ENGINE, typename AGG>
+  void ComputeAggBlocks(concurrency::ThreadPool* ttp, const ENGINE& engine, const InputType* x_data, int64_t stride,
+                        int64_t N, OutputType* z_data, int64_t* label_data, const AGG& agg) const;
+
  private:
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
@@ -338,6 +348,15 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  quick_scorer_ = std::make_unique<TreeEnsembleQuickScorer<InputType, ThresholdType>>();
+  if (!quick_scorer_->Init(nodes_, roots_, same_mode_, has_missing_tracks_)) {
+    quick_scorer_.reset();
+    flat_ = std::make_unique<TreeEnsembleFlat<InputType, ThresholdType>>();
+    if (!flat_->Init(nodes_, roots_, same_mode_, max_feature_id_)) {
+      flat_.reset();
+    }
+  }
+
   return Status::OK();
 }
 
@@ -455,6 +474,17 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
+  if (N > 1) {
+    if (quick_scorer_ != nullptr) { /* batches of rows evaluated with QuickScorer */
+      ComputeAggBlocks(ttp, *quick_scorer_, x_data, stride, N, z_data, label_data, agg);
+      return;
+    }
+    if (flat_ != nullptr) { /* batches of rows going through the flat layout in lockstep */
+      ComputeAggBlocks(ttp, *flat_, x_data, stride, N, z_data, label_data, agg);
+      return;
+    }
+  }
+
   if (n_targets_or_classes_ == 1) {
     if (N == 1) {
       ScoreValue<ThresholdType> score = {0, 0};
@@ -669,6 +699,88 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename ENGINE, typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggBlocks(
+    concurrency::ThreadPool* ttp, const ENGINE& engine, const InputType* x_data, int64_t stride, int64_t N,
+    OutputType* z_data, int64_t* label_data, const AGG& agg) const {
+  constexpr size_t block_rows = ENGINE::kBlockRows;
+  const auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+  const bool parallel = N > parallel_N_ && max_num_threads > 1;
+
+  // Blocks are smaller than ENGINE::kBlockRows if that leaves threads idle.
+  size_t rows_per_block = block_rows;
+  if (parallel) {
+    const size_t n_threads = static_cast<size_t>(max_num_threads);
+    const size_t rows_per_thread = (onnxruntime::narrow<size_t>(N) + n_threads - 1) / n_threads;
+    rows_per_block = std::min(block_rows, rows_per_thread);
+  }
+  const size_t n_blocks = (onnxruntime::narrow<size_t>(N) + rows_per_block - 1) / rows_per_block;
+
+  // Every block of rows is evaluated on all trees, then predictions are aggregated tree by tree
+  // as the other sections do.
+  auto compute_blocks = [this, &engine, &agg, x_data, z_data, label_data, N, stride,
+                         rows_per_block](size_t begin, size_t end) {
+    const size_t n_trees = engine.GetTreeCount();
+    std::vector<uint64_t> workspace(engine.GetWorkspaceSize());
+    std::vector<const TreeNodeElement<ThresholdType>*> leaves(n_trees * block_rows);
+
+    if (n_targets_or_classes_ == 1) {
+      ScoreValue<ThresholdType> scores[block_rows];
+      for (size_t b = begin; b < end; ++b) {
+        const int64_t row = static_cast<int64_t>(b * rows_per_block);
+        const size_t n_rows = std::min(rows_per_block, static_cast<size_t>(N - row));
+        engine.ComputeLeaves(x_data + row * stride, stride, n_rows, leaves.data(), workspace.data());
+        for (size_t r = 0; r < n_rows; ++r) {
+          scores[r] = {0, 0};
+        }
+        for (size_t j = 0; j < n_trees; ++j) {
+          for (size_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction1(scores[r], *leaves[j * block_rows + r]);
+          }
+        }
+        for (size_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores1(z_data + row + r, scores[r],
+                              label_data == nullptr ? nullptr : (label_data + row + r));
+        }
+      }
+    } else {
+      std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(block_rows);
+      for (size_t b = begin; b < end; ++b) {
+        const int64_t row = static_cast<int64_t>(b * rows_per_block);
+        const size_t n_rows = std::min(rows_per_block, static_cast<size_t>(N - row));
+        engine.ComputeLeaves(x_data + row * stride, stride, n_rows, leaves.data(), workspace.data());
+        for (size_t r = 0; r < n_rows; ++r) {
+          // FinalizeScores may shrink the vector in the binary case.
+          scores[r].assign(onnxruntime::narrow<size_t>(n_targets_or_classes_), ScoreValue<ThresholdType>({0, 0}));
+        }
+        for (size_t j = 0; j < n_trees; ++j) {
+          for (size_t r = 0; r < n_rows; ++r) {
+            agg.ProcessTreeNodePrediction(scores[r], *leaves[j * block_rows + r], weights_);
+          }
+        }
+        for (size_t r = 0; r < n_rows; ++r) {
+          agg.FinalizeScores(scores[r], z_data + (row + static_cast<int64_t>(r)) * n_targets_or_classes_, -1,
+                             label_data == nullptr ? nullptr : (label_data + row + r));
+        }
+      }
+    }
+  };
+
+  if (!parallel || n_blocks == 1) {
+    compute_blocks(0, n_blocks);
+  } else {
+    auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_blocks));
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp,
+        num_threads,
+        [&compute_blocks, num_threads, n_blocks](ptrdiff_t batch_num) {
+          auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<ptrdiff_t>(n_blocks));
+          compute_blocks(static_cast<size_t>(work.start), static_cast<size_t>(work.end));
+        });
+  }
+}
+
 #define TREE_FIND_VALUE(CMP)                                                                           \
   if (has_missing_tracks_) {                                                                           \
     while (root->is_not_leaf()) {                                                                      \
@@ -0,0 +1,257 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <type_traits>
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Evaluates a tree ensemble stored as a structure of arrays.
+// The nodes of every tree are laid out breadth first, the two children of a node are then contiguous,
+// the true child first, and a node only stores the position of its first child. When the top levels of
+// a tree only contain branch nodes, the first child of the node at position i in these levels is at position
+// 2i+1 and the traversal computes it instead of loading it.
+// A node takes 2 bytes for the feature id, 4 bytes for the first child, 1 byte for the mode and the size
+// of the threshold instead of sizeof(TreeNodeElement).
+// A block of rows goes through the same tree in lockstep: every step moves each row one level down.
+// The traversals of the rows are independent and no branch depends on the data.
+// Inputs are compared with the thresholds in the type ProcessTreeNodeLeave compares them in.
+template <typename InputType, typename ThresholdType>
+class TreeEnsembleFlat {
+ public:
+  // Number of rows evaluated together, every tree is evaluated on all of them before the next one.
+  static constexpr size_t kBlockRows = 128;
+  // Number of rows going through a tree in lockstep.
+  static constexpr size_t kLockstepRows = 16;
+
+  // Builds the layout. It returns false if the branch nodes do not share the same mode, if a feature id does not
+  // fit in 16 bits or if the trees share too many nodes (which are duplicated in this layout).
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+            const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+            bool same_mode, int64_t max_feature_id);
+
+  size_t GetTreeCount() const { return trees_.size(); }
+
+  // This layout does not need any buffer.
+  size_t GetWorkspaceSize() const { return 0; }
+
+  // Stores the exit leaf of tree j for row r in leaves[j * kBlockRows + r] for the first n_rows <= kBlockRows rows
+  // starting at x_data.
+  void ComputeLeaves(const InputType* x_data, int64_t stride, size_t n_rows,
+                     const TreeNodeElement<ThresholdType>** leaves, uint64_t* workspace) const;
+
+ private:
+  // Type of the comparisons, the type of (x <= threshold) in ProcessTreeNodeLeave.
+  using CompareType = std::common_type_t<InputType, ThresholdType>;
+
+  struct FlatTree {
+    uint32_t root;
+    // Number of levels starting from the root which only contain branch nodes.
+    uint32_t complete_levels;
+  };
+
+  template <NODE_MODE mode>
+  void ComputeLeavesImpl(const InputType* x_data, int64_t stride, size_t n_rows,
+                         const TreeNodeElement<ThresholdType>** leaves) const;
+
+  // Mode of all branch nodes.
+  NODE_MODE mode_;
+  std::vector<uint16_t> feature_ids_;
+  std::vector<ThresholdType> thresholds_;
+  // Position of the first child of a branch node, the position of the node itself for a leaf.
+  std::vector<uint32_t> children_;
+  // Same flags as TreeNodeElement::flags.
+  std::vector<uint8_t> flags_;
+  // Node a leaf comes from, nullptr for branch nodes.
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves_;
+  std::vector<FlatTree> trees_;
+};
+
+template <typename InputType, typename ThresholdType>
+bool TreeEnsembleFlat<InputType, ThresholdType>::Init(
+    const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+    const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+    bool same_mode, int64_t max_feature_id) {
+  if (!same_mode || roots.empty() || max_feature_id > std::numeric_limits<uint16_t>::max()) {
+    return false;
+  }
+  // Shared nodes are duplicated, the layout is not used if that makes it much bigger.
+  const size_t max_nodes = std::min(nodes.size() * 2, static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
+
+  const auto first_branch = std::find_if(nodes.begin(), nodes.end(),
+                                         [](const TreeNodeElement<ThresholdType>& node) { return node.is_not_leaf(); });
+  if (first_branch == nodes.end()) {
+    return false;
+  }
+  mode_ = first_branch->mode();
+
+  feature_ids_.clear();
+  thresholds_.clear();
+  children_.clear();
+  flags_.clear();
+  leaves_.clear();
+  trees_.clear();
+  trees_.reserve(roots.size());
+
+  std::deque<const TreeNodeElement<ThresholdType>*> queue;
+  for (const TreeNodeElement<ThresholdType>* root : roots) {
+    FlatTree tree{static_cast<uint32_t>(feature_ids_.size()), 0};
+    // The top levels are complete as long as the first leaf is not reached, a level l contains the positions
+    // [2^l - 1, 2^(l+1) - 1) relative to the root.
+    bool complete = true;
+    size_t level_end = 1;
+    queue.push_back(root);
+    while (!queue.empty()) {
+      const TreeNodeElement<ThresholdType>* node = queue.front();
+      queue.pop_front();
+      const size_t position = feature_ids_.size();
+      if (position - tree.root == level_end) {
+        if (complete) {
+          ++tree.complete_levels;
+        }
+        level_end = level_end * 2 + 1;
+      }
+      if (position >= max_nodes) {
+        return false;
+      }
+
+      flags_.push_back(node->flags);
+      if (node->is_not_leaf()) {
+        feature_ids_.push_back(static_cast<uint16_t>(node->feature_id));
+        thresholds_.push_back(node->value_or_unique_weight);
+        children_.push_back(static_cast<uint32_t>(position + 1 + queue.size()));
+        leaves_.push_back(nullptr);
+        queue.push_back(node->truenode_or_weight.ptr);
+        queue.push_back(node + 1);
+      } else {
+        complete = false;
+        feature_ids_.push_back(0);
+        thresholds_.push_back(0);
+        children_.push_back(static_cast<uint32_t>(position));
+        leaves_.push_back(node);
+      }
+    }
+    trees_.push_back(tree);
+  }
+  return true;
+}
+
+// Returns the result of the test of a node, true for a leaf.
+template <NODE_MODE mode, typename T>
+inline bool FlatNodeTest(T x, T threshold, uint8_t flags) {
+  bool is_true;
+  switch (mode) {
+    case NODE_MODE::BRANCH_LEQ:
+      is_true = x <= threshold;
+      break;
+    case NODE_MODE::BRANCH_LT:
+      is_true = x < threshold;
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      is_true = x >= threshold;
+      break;
+    case NODE_MODE::BRANCH_GT:
+      is_true = x > threshold;
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      is_true = x == threshold;
+      break;
+    default:
+      is_true = x != threshold;
+      break;
+  }
+  // Bitwise operators avoid branches depending on the data.
+  return is_true | (((flags & MissingTrack::kTrue) != 0) & std::isnan(x)) | ((flags & NODE_MODE::LEAF) != 0);
+}
+
+template <typename InputType, typename ThresholdType>
+template <NODE_MODE mode>
+void TreeEnsembleFlat<InputType, ThresholdType>::ComputeLeavesImpl(
+    const InputType* x_data, int64_t stride, size_t n_rows, const TreeNodeElement<ThresholdType>** leaves) const {
+  const uint16_t* feature_ids = feature_ids_.data();
+  const ThresholdType* thresholds = thresholds_.data();
+  const uint32_t* children = children_.data();
+  const uint8_t* flags = flags_.data();
+
+  uint32_t positions[kLockstepRows];
+  for (size_t j = 0; j < trees_.size(); ++j) {
+    const uint32_t root = trees_[j].root;
+    const uint32_t complete_levels = trees_[j].complete_levels;
+
+    for (size_t row = 0; row < n_rows; row += kLockstepRows) {
+      const InputType* x_rows = x_data + static_cast<int64_t>(row) * stride;
+      const size_t lockstep_rows = std::min(kLockstepRows, n_rows - row);
+      for (size_t r = 0; r < lockstep_rows; ++r) {
+        positions[r] = root;
+      }
+
+      // Complete levels: the first child is computed, no row can be on a leaf.
+      for (uint32_t level = 0; level < complete_levels; ++level) {
+        for (size_t r = 0; r < lockstep_rows; ++r) {
+          const uint32_t i = positions[r];
+          const CompareType x = static_cast<CompareType>(x_rows[static_cast<int64_t>(r) * stride + feature_ids[i]]);
+          positions[r] = 2 * i - root + 2 -
+                         static_cast<uint32_t>(FlatNodeTest<mode>(x, static_cast<CompareType>(thresholds[i]), flags[i]));
+        }
+      }
+
+      // Remaining levels: rows on a leaf stay there until every row reaches one.
+      bool pending = true;
+      while (pending) {
+        pending = false;
+        for (size_t r = 0; r < lockstep_rows; ++r) {
+          const uint32_t i = positions[r];
+          const CompareType x = static_cast<CompareType>(x_rows[static_cast<int64_t>(r) * stride + feature_ids[i]]);
+          positions[r] = children[i] + 1 -
+                         static_cast<uint32_t>(FlatNodeTest<mode>(x, static_cast<CompareType>(thresholds[i]), flags[i]));
+          pending |= (flags[i] & NODE_MODE::LEAF) == 0;
+        }
+      }
+
+      for (size_t r = 0; r < lockstep_rows; ++r) {
+        leaves[j * kBlockRows + row + r] = leaves_[positions[r]];
+      }
+    }
+  }
+}
+
+template <typename InputType, typename ThresholdType>
+void TreeEnsembleFlat<InputType, ThresholdType>::ComputeLeaves(
+    const InputType* x_data, int64_t stride, size_t n_rows,
+    const TreeNodeElement<ThresholdType>** leaves, uint64_t* /*workspace*/) const {
+  switch (mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_LEQ>(x_data, stride, n_rows, leaves);
+      break;
+    case NODE_MODE::BRANCH_LT:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_LT>(x_data, stride, n_rows, leaves);
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_GTE>(x_data, stride, n_rows, leaves);
+      break;
+    case NODE_MODE::BRANCH_GT:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_GT>(x_data, stride, n_rows, leaves);
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_EQ>(x_data, stride, n_rows, leaves);
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      ComputeLeavesImpl<NODE_MODE::BRANCH_NEQ>(x_data, stride, n_rows, leaves);
+      break;
+    default:
+      ORT_THROW("Unexpected node mode ", static_cast<int>(mode_), ".");
+  }
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
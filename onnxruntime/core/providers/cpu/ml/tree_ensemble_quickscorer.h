@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "tree_ensemble_aggregator.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Evaluates a tree ensemble with the QuickScorer algorithm (Lucchese et al., SIGIR 2015).
+// The ensemble is traversed feature by feature instead of tree by tree. The leaves of every tree are numbered
+// from left to right and each tree keeps a bitvector of the leaves a row can still exit from.
+// A branch node whose test is false removes the leaves of its left subtree from that bitvector.
+// The thresholds of all the nodes testing a feature are sorted, the false nodes for a given value
+// are then a prefix of that list. Once every feature is processed, the exit leaf of a tree is the
+// leftmost leaf left in its bitvector.
+// Rows are processed by blocks (V-QuickScorer, Lucchese et al., SIGIR 2016). The bitvectors of a tree
+// for all the rows of a block are contiguous so that removing the leaves of a node is a loop on rows
+// the compiler vectorizes.
+// Inputs are compared with the thresholds in the type ProcessTreeNodeLeave compares them in, a double input is not
+// rounded to a float threshold.
+template <typename InputType, typename ThresholdType>
+class TreeEnsembleQuickScorer {
+ public:
+  // A leaf is a bit of a 64-bit bitvector.
+  static constexpr size_t kMaxLeaves = 64;
+  // Number of rows evaluated together.
+  static constexpr size_t kBlockRows = 8;
+
+  // Builds the engine. It returns false if the ensemble cannot be evaluated this way: every branch node must use the
+  // same comparison among BRANCH_LEQ, BRANCH_LT, BRANCH_GTE, BRANCH_GT, no node may track missing values, thresholds
+  // must be finite and every tree must be a tree (not a graph sharing nodes) with at most kMaxLeaves leaves.
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+            const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+            bool same_mode, bool has_missing_tracks);
+
+  size_t GetTreeCount() const { return leaf_offsets_.size(); }
+
+  // The bitvectors of every tree for a block of rows.
+  size_t GetWorkspaceSize() const { return leaf_offsets_.size() * kBlockRows; }
+
+  // Stores the exit leaf of tree j for row r in leaves[j * kBlockRows + r] for the first n_rows <= kBlockRows rows
+  // starting at x_data. workspace is a buffer of GetWorkspaceSize() elements.
+  void ComputeLeaves(const InputType* x_data, int64_t stride, size_t n_rows,
+                     const TreeNodeElement<ThresholdType>** leaves, uint64_t* workspace) const;
+
+ private:
+  // Type of the comparisons, the type of (x <= threshold) in ProcessTreeNodeLeave.
+  using CompareType = std::common_type_t<InputType, ThresholdType>;
+
+  struct FeatureNodes {
+    int64_t feature_id;
+    size_t begin;
+    size_t end;
+  };
+
+  struct Node {
+    ThresholdType threshold;
+    uint32_t tree_id;
+    uint64_t mask;
+  };
+
+  bool AddTree(const TreeNodeElement<ThresholdType>* node, uint32_t tree_id, const TreeNodeElement<ThresholdType>* base,
+               std::vector<bool>& visited, std::vector<std::pair<int64_t, Node>>& tree_nodes, size_t& n_leaves);
+
+  template <bool strict>
+  void ComputeBitvectors(const InputType* x_data, int64_t stride, size_t n_rows, uint64_t* bitvectors) const;
+
+  // The left child is the true branch for BRANCH_LEQ, BRANCH_LT and the false branch for BRANCH_GTE, BRANCH_GT
+  // which are evaluated as the negated test, a node is false if (threshold < x) or (threshold <= x) if not strict.
+  bool swap_children_;
+  bool strict_;
+  // Value replacing a missing value, it matches the branch the original test follows: the false branch.
+  CompareType missing_value_;
+  std::vector<FeatureNodes> features_;
+  std::vector<ThresholdType> thresholds_;
+  std::vector<uint32_t> tree_ids_;
+  std::vector<uint64_t> masks_;
+  std::vector<size_t> leaf_offsets_;
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves_;
+};
+
+inline uint32_t QuickScorerLowestBit(uint64_t bitvector) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, bitvector);
+  return static_cast<uint32_t>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(bitvector));
+#else
+  uint32_t index = 0;
+  while ((bitvector & 1) == 0) {
+    bitvector >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+template <typename InputType, typename ThresholdType>
+bool TreeEnsembleQuickScorer<InputType, ThresholdType>::Init(
+    const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+    const std::vector<TreeNodeElement<ThresholdType>*>& roots,
+    bool same_mode, bool has_missing_tracks) {
+  if (!same_mode || has_missing_tracks || roots.empty() ||
+      roots.size() > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+    return false;
+  }
+
+  const TreeNodeElement<ThresholdType>* first_branch = nullptr;
+  for (const auto& node : nodes) {
+    if (node.is_not_leaf()) {
+      first_branch = &node;
+      break;
+    }
+  }
+  if (first_branch == nullptr) {
+    return false;
+  }
+  switch (first_branch->mode()) {
+    case NODE_MODE::BRANCH_LEQ:
+      swap_children_ = false;
+      strict_ = true;
+      break;
+    case NODE_MODE::BRANCH_LT:
+      swap_children_ = false;
+      strict_ = false;
+      break;
+    case NODE_MODE::BRANCH_GT:
+      swap_children_ = true;
+      strict_ = true;
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      swap_children_ = true;
+      strict_ = false;
+      break;
+    default:
+      return false;
+  }
+  // A missing value fails every test. Its false branch is the right child of BRANCH_LEQ, BRANCH_LT nodes which
+  // +inf always goes to and the left child of BRANCH_GTE, BRANCH_GT nodes which -inf always goes to.
+  missing_value_ = swap_children_ ? -std::numeric_limits<CompareType>::infinity()
+                                  : std::numeric_limits<CompareType>::infinity();
+
+  std::vector<bool> visited(nodes.size(), false);
+  std::vector<std::pair<int64_t, Node>> tree_nodes;
+  leaf_offsets_.clear();
+  leaf_offsets_.reserve(roots.size());
+  leaves_.clear();
+  for (size_t j = 0; j < roots.size(); ++j) {
+    leaf_offsets_.push_back(leaves_.size());
+    size_t n_leaves = 0;
+    if (!AddTree(roots[j], static_cast<uint32_t>(j), nodes.data(), visited, tree_nodes, n_leaves)) {
+      return false;
+    }
+  }
+
+  // Sorts the nodes by feature then by threshold.
+  std::stable_sort(tree_nodes.begin(), tree_nodes.end(),
+                   [](const std::pair<int64_t, Node>& a, const std::pair<int64_t, Node>& b) {
+                     return a.first < b.first || (a.first == b.first && a.second.threshold < b.second.threshold);
+                   });
+
+  features_.clear();
+  thresholds_.resize(tree_nodes.size());
+  tree_ids_.resize(tree_nodes.size());
+  masks_.resize(tree_nodes.size());
+  for (size_t i = 0; i < tree_nodes.size(); ++i) {
+    if (features_.empty() || features_.back().feature_id != tree_nodes[i].first) {
+      features_.push_back({tree_nodes[i].first, i, i});
+    }
+    ++features_.back().end;
+    thresholds_[i] = tree_nodes[i].second.threshold;
+    tree_ids_[i] = tree_nodes[i].second.tree_id;
+    masks_[i] = tree_nodes[i].second.mask;
+  }
+  return true;
+}
+
+template <typename InputType, typename ThresholdType>
+bool TreeEnsembleQuickScorer<InputType, ThresholdType>::AddTree(
+    const TreeNodeElement<ThresholdType>* node, uint32_t tree_id, const TreeNodeElement<ThresholdType>* base,
+    std::vector<bool>& visited, std::vector<std::pair<int64_t, Node>>& tree_nodes, size_t& n_leaves) {
+  const size_t index = static_cast<size_t>(node - base);
+  if (visited[index]) {
+    // Nodes shared by several parents.
+    return false;
+  }
+  visited[index] = true;
+
+  if (!node->is_not_leaf()) {
+    if (n_leaves == kMaxLeaves) {
+      return false;
+    }
+    leaves_.push_back(node);
+    ++n_leaves;
+    return true;
+  }
+
+  if (!std::isfinite(node->value_or_unique_weight)) {
+    return false;
+  }
+
+  const TreeNodeElement<ThresholdType>* left = swap_children_ ? node + 1 : node->truenode_or_weight.ptr;
+  const TreeNodeElement<ThresholdType>* right = swap_children_ ? node->truenode_or_weight.ptr : node + 1;
+
+  const size_t left_begin = n_leaves;
+  if (!AddTree(left, tree_id, base, visited, tree_nodes, n_leaves)) {
+    return false;
+  }
+  const size_t left_end = n_leaves;
+
+  // The mask clears the bits of the leaves of the left subtree.
+  const uint64_t left_bits = (left_end - left_begin == kMaxLeaves)
+                                 ? ~uint64_t{0}
+                                 : ((uint64_t{1} << (left_end - left_begin)) - 1) << left_begin;
+  tree_nodes.push_back({node->feature_id, Node{node->value_or_unique_weight, tree_id, ~left_bits}});
+
+  return AddTree(right, tree_id, base, visited, tree_nodes, n_leaves);
+}
+
+template <typename InputType, typename ThresholdType>
+template <bool strict>
+void TreeEnsembleQuickScorer<InputType, ThresholdType>::ComputeBitvectors(
+    const InputType* x_data, int64_t stride, size_t n_rows, uint64_t* bitvectors) const {
+  std::fill(bitvectors, bitvectors + leaf_offsets_.size() * kBlockRows, ~uint64_t{0});
+
+  CompareType x[kBlockRows];
+  for (const FeatureNodes& feature : features_) {
+    // Rows past n_rows never make a node false.
+    CompareType x_max = -std::numeric_limits<CompareType>::infinity();
+    for (size_t r = 0; r < kBlockRows; ++r) {
+      if (r < n_rows) {
+        x[r] = static_cast<CompareType>(x_data[static_cast<int64_t>(r) * stride + feature.feature_id]);
+        if (std::isnan(x[r])) {
+          x[r] = missing_value_;
+        }
+      } else {
+        x[r] = -std::numeric_limits<CompareType>::infinity();
+      }
+      x_max = std::max(x_max, x[r]);
+    }
+
+    for (size_t i = feature.begin; i < feature.end; ++i) {
+      const CompareType threshold = static_cast<CompareType>(thresholds_[i]);
+      if (strict ? !(threshold < x_max) : !(threshold <= x_max)) {
+        // Thresholds are sorted, the following nodes are true for every row.
+        break;
+      }
+      const uint64_t mask = masks_[i];
+      uint64_t* bitvector = bitvectors + static_cast<size_t>(tree_ids_[i]) * kBlockRows;
+      for (size_t r = 0; r < kBlockRows; ++r) {
+        bitvector[r] &= (strict ? threshold < x[r] : threshold <= x[r]) ? mask : ~uint64_t{0};
+      }
+    }
+  }
+}
+
+template <typename InputType, typename ThresholdType>
+void TreeEnsembleQuickScorer<InputType, ThresholdType>::ComputeLeaves(
+    const InputType* x_data, int64_t stride, size_t n_rows,
+    const TreeNodeElement<ThresholdType>** leaves, uint64_t* workspace) const {
+  uint64_t* bitvectors = workspace;
+  if (strict_) {
+    ComputeBitvectors<true>(x_data, stride, n_rows, bitvectors);
+  } else {
+    ComputeBitvectors<false>(x_data, stride, n_rows, bitvectors);
+  }
+
+  for (size_t j = 0; j < leaf_offsets_.size(); ++j) {
+    const TreeNodeElement<ThresholdType>* const* tree_leaves = leaves_.data() + leaf_offsets_[j];
+    for (size_t r = 0; r < n_rows; ++r) {
+      leaves[j * kBlockRows + r] = tree_leaves[QuickScorerLowestBit(bitvectors[j * kBlockRows + r])];
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
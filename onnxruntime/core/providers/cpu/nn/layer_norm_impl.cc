@@ -17,7 +17,7 @@ namespace {
 
 template <typename T,
           typename U,
-          typename = std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>, void>>
+          typename = std::enable_if_t<std::is_same_v<T, double>, void>>
 void ComputeJob(
     const T* X_data,
     const T* scale_data,
@@ -75,6 +75,61 @@ void ComputeJob(
   }
 }
 
+// float and MLFloat16 rows are normalized by MLAS, which reads half precision rows directly and
+// converts them in cache sized chunks. scale and bias are single precision for both.
+template <typename T, typename U>
+void ComputeJobMlas(
+    const T* X_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const float* scale_float_ptr,
+    const float* bias_float_ptr,
+    float epsilon,
+    bool simplified,
+    T* Y_data,
+    U* mean_data,
+    U* inv_std_dev_data) {
+  const T* p_input = X_data + task_idx * norm_size;
+  T* p_output = Y_data + task_idx * norm_size;
+
+  float mean;
+  float inv_std_dev;
+  MlasLayerNormalization(p_input, static_cast<const T*>(nullptr), nullptr, scale_float_ptr, bias_float_ptr, p_output,
+                         static_cast<T*>(nullptr), static_cast<size_t>(norm_size), epsilon, simplified, &mean,
+                         &inv_std_dev);
+
+  if (mean_data != nullptr) {
+    mean_data[task_idx] = U(mean);
+  }
+
+  if (inv_std_dev_data != nullptr) {
+    inv_std_dev_data[task_idx] = U(inv_std_dev);
+  }
+}
+
+template <typename U>
+void ComputeJob(
+    const float* X_data,
+    const float* scale_data,
+    const float* bias_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const float* scale_float_ptr,
+    const float* bias_float_ptr,
+    float epsilon,
+    bool simplified,
+    float* Y_data,
+    U* mean_data,
+    U* inv_std_dev_data,
+    AllocatorPtr alloc) {
+  ORT_UNUSED_PARAMETER(scale_float_ptr);  // only used in MLFloat16 overload
+  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in MLFloat16 overload
+  ORT_UNUSED_PARAMETER(alloc);
+
+  ComputeJobMlas(X_data, task_idx, norm_size, scale_data, bias_data, epsilon, simplified, Y_data, mean_data,
+                 inv_std_dev_data);
+}
+
 template <typename U>
 void ComputeJob(
     const MLFloat16* X_data,
@@ -92,54 +147,10 @@ void ComputeJob(
     AllocatorPtr alloc) {
   ORT_UNUSED_PARAMETER(scale_data);  // only used in float/double overload
   ORT_UNUSED_PARAMETER(bias_data);   // only used in float/double overload
+  ORT_UNUSED_PARAMETER(alloc);
 
-  const MLFloat16* p_input = X_data + task_idx * norm_size;
-  MLFloat16* p_output = Y_data + task_idx * norm_size;
-
-  float mean(0.0f);
-  float mean_square(0.0f);
-
-  const size_t num_elems = static_cast<size_t>(norm_size);
-  IAllocatorUniquePtr<float> input_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  MlasConvertHalfToFloatBuffer(p_input, input_float_uptr.get(), num_elems);
-
-  IAllocatorUniquePtr<float> output_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  float* output_float_ptr = output_float_uptr.get();
-
-  const float* input_float_ptr = input_float_uptr.get();
-  for (size_t h = 0; h < num_elems; h++) {
-    output_float_ptr[h] = input_float_ptr[h];
-    mean += input_float_ptr[h];
-    mean_square += input_float_ptr[h] * input_float_ptr[h];
-  }
-
-  mean = mean / norm_size;
-  if (simplified) {
-    mean_square = sqrt(mean_square / norm_size + epsilon);
-  } else {
-    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-  }
-
-  for (size_t h = 0; h < num_elems; h++) {
-    if (simplified) {
-      output_float_ptr[h] = output_float_ptr[h] / mean_square * scale_float_ptr[h];
-    } else if (nullptr == bias_float_ptr) {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[h];
-    } else {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[h] + bias_float_ptr[h];
-    }
-  }
-
-  MlasConvertFloatToHalfBuffer(output_float_ptr, p_output, num_elems);
-
-  if (mean_data != nullptr) {
-    // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-    mean_data[task_idx] = MLFloat16(mean);
-  }
-
-  if (inv_std_dev_data != nullptr) {
-    inv_std_dev_data[task_idx] = MLFloat16(1 / mean_square);
-  }
+  ComputeJobMlas(X_data, task_idx, norm_size, scale_float_ptr, bias_float_ptr, epsilon, simplified, Y_data, mean_data,
+                 inv_std_dev_data);
 }
 
 void ConvertMLFloat16ToFloatIfNeeded(const Tensor& tensor, AllocatorPtr alloc, IAllocatorUniquePtr<float>& dest, bool& is_packed) {
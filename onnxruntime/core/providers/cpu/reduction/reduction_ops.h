@@ -16,6 +16,7 @@
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
 #include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
 #include <cmath>
 
 namespace onnxruntime {
@@ -151,6 +152,13 @@ inline bool reduce_isnan<int32_t>(int32_t) { return false; }
 template <>
 inline bool reduce_isnan<int64_t>(int64_t) { return false; }
 
+// Reduces the middle axis of a float tensor viewed as [outer, reduce, inner] with MLAS.
+inline void FastReduceMlas(MLAS_REDUCTION_KIND kind, const Tensor& input, int64_t outer, int64_t reduce,
+                           int64_t inner, Tensor& output, concurrency::ThreadPool* tp) {
+  MlasReduce(kind, input.Data<float>(), output.MutableData<float>(), onnxruntime::narrow<size_t>(outer),
+             onnxruntime::narrow<size_t>(reduce), onnxruntime::narrow<size_t>(inner), tp);
+}
+
 class ReduceAggregatorBase {
  public:
   // Fast reduction: see OptimizeShapeForFastReduce's comment.
@@ -231,51 +239,63 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
-          for (ptrdiff_t d = first; d < last; ++d) {
-            out[d] = aggall(data + d * stridei, stridei);
-          }
-        });
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasSumReduction, input, fast_shape[0], fast_shape[1], 1, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t d = first; d < last; ++d) {
+              out[d] = aggall(data + d * stridei, stridei);
+            }
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-
-    int64_t n_rows = fast_shape[0];
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          for (int64_t row = 1; row < n_rows; ++row) {
-            EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
-                data + row * N + begin, end - begin);
-          }
-        });
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasSumReduction, input, 1, fast_shape[0], fast_shape[1], output, tp);
+    } else {
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+
+      int64_t n_rows = fast_shape[0];
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            for (int64_t row = 1; row < n_rows; ++row) {
+              EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
+                  data + row * N + begin, end - begin);
+            }
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[2];
-    const T* data = input.Data<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    T* out = output.MutableData<T>();
-    std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [one, data, fast_shape, stridei, strideo, out, N](ptrdiff_t begin, ptrdiff_t last) {
-          for (ptrdiff_t d = begin; d < last; ++d) {
-            math::MatMul<T>(1, onnxruntime::narrow<ptrdiff_t>(N), onnxruntime::narrow<ptrdiff_t>(fast_shape[1]), one.data(), data + stridei * d, out + strideo * d, nullptr);
-          }
-        });
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasSumReduction, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+    } else {
+      int64_t N = fast_shape[2];
+      const T* data = input.Data<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      T* out = output.MutableData<T>();
+      std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [one, data, fast_shape, stridei, strideo, out, N](ptrdiff_t begin, ptrdiff_t last) {
+            for (ptrdiff_t d = begin; d < last; ++d) {
+              math::MatMul<T>(1, onnxruntime::narrow<ptrdiff_t>(N), onnxruntime::narrow<ptrdiff_t>(fast_shape[1]), one.data(), data + stridei * d, out + strideo * d, nullptr);
+            }
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -319,39 +339,51 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregatorSum<T>::FastReduceKR(input, fast_shape, output, tp);
-    // TODO: use MLAS or BLAS
-    T* out = output.MutableData<T>();
-    T* end = out + fast_shape[0];
-    for (; out != end; ++out) {
-      *out /= static_cast<T>(fast_shape[1]);
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMeanReduction, input, fast_shape[0], fast_shape[1], 1, output, tp);
+    } else {
+      ReduceAggregatorSum<T>::FastReduceKR(input, fast_shape, output, tp);
+      // TODO: use MLAS or BLAS
+      T* out = output.MutableData<T>();
+      T* end = out + fast_shape[0];
+      for (; out != end; ++out) {
+        *out /= static_cast<T>(fast_shape[1]);
+      }
     }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, output, tp);
-    // TODO: use MLAS or BLAS
-    T* out = output.MutableData<T>();
-    T* end = out + fast_shape[1];
-    for (; out != end; ++out) {
-      *out /= static_cast<T>(fast_shape[0]);
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMeanReduction, input, 1, fast_shape[0], fast_shape[1], output, tp);
+    } else {
+      ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, output, tp);
+      // TODO: use MLAS or BLAS
+      T* out = output.MutableData<T>();
+      T* end = out + fast_shape[1];
+      for (; out != end; ++out) {
+        *out /= static_cast<T>(fast_shape[0]);
+      }
     }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, output, tp);
-    int64_t strideo = fast_shape[2];
-    T* out = output.MutableData<T>();
-    T* begin;
-    T* end;
-    T div = static_cast<T>(fast_shape[1]);
-    for (int64_t d = 0; d < fast_shape[0]; ++d) {
-      begin = out + strideo * d;
-      end = begin + strideo;
-      for (; begin != end; ++begin) {
-        *begin /= div;
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMeanReduction, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+    } else {
+      ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, output, tp);
+      int64_t strideo = fast_shape[2];
+      T* out = output.MutableData<T>();
+      T* begin;
+      T* end;
+      T div = static_cast<T>(fast_shape[1]);
+      for (int64_t d = 0; d < fast_shape[0]; ++d) {
+        begin = out + strideo * d;
+        end = begin + strideo;
+        for (; begin != end; ++begin) {
+          *begin /= div;
+        }
       }
     }
   }
@@ -391,81 +423,93 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
-          if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-            EigenVectorMap<bool>(out + first, last - first) = ConstEigenMatrixMap<bool>(
-                                                                  data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                                  .cast<unsigned char>()
-                                                                  .colwise()
-                                                                  .maxCoeff()
-                                                                  .cast<bool>();
-          } else {
-            EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
-                                                               data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                               .colwise()
-                                                               .maxCoeff();
-          }
-        });
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMaximumReduction, input, fast_shape[0], fast_shape[1], 1, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+              EigenVectorMap<bool>(out + first, last - first) = ConstEigenMatrixMap<bool>(
+                                                                    data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                                    .cast<unsigned char>()
+                                                                    .colwise()
+                                                                    .maxCoeff()
+                                                                    .cast<bool>();
+            } else {
+              EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
+                                                                 data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                                 .colwise()
+                                                                 .maxCoeff();
+            }
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-                out[j] = out[j] || p[j];
-              } else {
-                if (out[j] < p[j])
-                  out[j] = p[j];
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMaximumReduction, input, 1, fast_shape[0], fast_shape[1], output, tp);
+    } else {
+      int64_t n_rows = fast_shape[0];
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            const T* p;
+            for (int64_t row = 1; row < n_rows; ++row) {
+              p = data + row * N;
+              for (int64_t j = begin; j < end; ++j) {
+                if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+                  out[j] = out[j] || p[j];
+                } else {
+                  if (out[j] < p[j])
+                    out[j] = p[j];
+                }
               }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-              EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<bool>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .cast<unsigned char>()
-                      .rowwise()
-                      .maxCoeff()
-                      .cast<bool>();
-            } else {
-              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<T>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .rowwise()
-                      .maxCoeff();
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMaximumReduction, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+            for (ptrdiff_t j = begin; j < end; ++j) {
+              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+                EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                    ConstEigenMatrixMap<bool>(
+                        data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                        .cast<unsigned char>()
+                        .rowwise()
+                        .maxCoeff()
+                        .cast<bool>();
+              } else {
+                EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                    ConstEigenMatrixMap<T>(
+                        data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                        .rowwise()
+                        .maxCoeff();
+              }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -601,81 +645,93 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
-          if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-            EigenVectorMap<bool>(out + first, last - first) = ConstEigenMatrixMap<bool>(
-                                                                  data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                                  .cast<unsigned char>()
-                                                                  .colwise()
-                                                                  .minCoeff()
-                                                                  .cast<bool>();
-          } else {
-            EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
-                                                               data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                               .colwise()
-                                                               .minCoeff();
-          }
-        });
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMinimumReduction, input, fast_shape[0], fast_shape[1], 1, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+              EigenVectorMap<bool>(out + first, last - first) = ConstEigenMatrixMap<bool>(
+                                                                    data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                                    .cast<unsigned char>()
+                                                                    .colwise()
+                                                                    .minCoeff()
+                                                                    .cast<bool>();
+            } else {
+              EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
+                                                                 data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                                 .colwise()
+                                                                 .minCoeff();
+            }
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-                out[j] = out[j] && p[j];
-              } else {
-                if (out[j] > p[j])
-                  out[j] = p[j];
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMinimumReduction, input, 1, fast_shape[0], fast_shape[1], output, tp);
+    } else {
+      int64_t n_rows = fast_shape[0];
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            const T* p;
+            for (int64_t row = 1; row < n_rows; ++row) {
+              p = data + row * N;
+              for (int64_t j = begin; j < end; ++j) {
+                if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+                  out[j] = out[j] && p[j];
+                } else {
+                  if (out[j] > p[j])
+                    out[j] = p[j];
+                }
               }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-              EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<bool>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .cast<unsigned char>()
-                      .rowwise()
-                      .minCoeff()
-                      .cast<bool>();
-            } else {
-              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<T>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .rowwise()
-                      .minCoeff();
+    if constexpr (std::is_same_v<T, float>) {
+      FastReduceMlas(MlasMinimumReduction, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+            for (ptrdiff_t j = begin; j < end; ++j) {
+              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+                EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                    ConstEigenMatrixMap<bool>(
+                        data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                        .cast<unsigned char>()
+                        .rowwise()
+                        .minCoeff()
+                        .cast<bool>();
+              } else {
+                EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                    ConstEigenMatrixMap<T>(
+                        data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                        .rowwise()
+                        .minCoeff();
+              }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -774,6 +830,30 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction, only implemented for float with MLAS.
+  static inline FastReduceKind WhichFastReduce() {
+    if constexpr (std::is_same_v<T, float>) {
+      return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK;
+    } else {
+      return FastReduceKind::kNone;
+    }
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceMlas(MlasLogSumExpReduction, input, fast_shape[0], fast_shape[1], 1, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceMlas(MlasLogSumExpReduction, input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    FastReduceMlas(MlasLogSumExpReduction, input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -22,6 +23,7 @@
 #include "core/framework/bfc_arena.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/external_data_prefetcher.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_def_builder.h"
@@ -244,6 +246,79 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// Returns the NUMA node the session should run on, or -1 if its threads and memory are not bound to a node.
+int SelectNumaNode(const std::string& numa_node_config, uint32_t session_id, const logging::Logger& logger) {
+  if (numa_node_config.empty() || numa_node_config == "-1") {
+    return -1;
+  }
+
+#if !defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
+  const auto numa_nodes = Env::Default().GetNumaNodeProcessors();
+  if (numa_nodes.size() < 2) {
+    LOGS(logger, INFO) << kOrtSessionOptionsConfigNumaNode
+                       << " is ignored as the system has a single NUMA node or its NUMA topology is unknown.";
+    return -1;
+  }
+
+  int numa_node = -1;
+  if (numa_node_config == "auto") {
+    // spread the sessions of the process over the nodes
+    numa_node = static_cast<int>(session_id % numa_nodes.size());
+  } else {
+    ORT_ENFORCE(TryParseStringWithClassicLocale(numa_node_config, numa_node) &&
+                    numa_node >= 0 && static_cast<size_t>(numa_node) < numa_nodes.size(),
+                "Invalid value for ", kOrtSessionOptionsConfigNumaNode, ": ", numa_node_config,
+                ". The system has ", numa_nodes.size(), " NUMA nodes.");
+  }
+  LOGS(logger, INFO) << "Binding the intra-op threads and the CPU memory of the session to NUMA node " << numa_node;
+  return numa_node;
+#else
+  ORT_UNUSED_PARAMETER(session_id);
+  LOGS(logger, INFO) << kOrtSessionOptionsConfigNumaNode << " is not supported in this build.";
+  return -1;
+#endif
+}
+
+#if !defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
+// Binds the threads of the intra-op thread pool to the physical cores of a NUMA node. Uses one thread per core
+// of the node unless the thread pool size is set explicitly.
+void SetNumaNodeAffinity(int numa_node, OrtThreadPoolParams& to) {
+  const auto numa_nodes = Env::Default().GetNumaNodeProcessors();
+  const auto& node_processors = numa_nodes[numa_node];
+
+  std::vector<LogicalProcessors> cores;
+  for (auto& core : Env::Default().GetDefaultThreadAffinities()) {
+    if (!core.empty() && std::all_of(core.begin(), core.end(), [&](int id) {
+          return std::find(node_processors.begin(), node_processors.end(), id) != node_processors.end();
+        })) {
+      cores.push_back(std::move(core));
+    }
+  }
+  if (cores.empty()) {
+    // the physical cores are not known, use each logical processor of the node as a core
+    for (int id : node_processors) {
+      cores.push_back({id});
+    }
+  }
+
+  if (to.thread_pool_size <= 0) {
+    to.thread_pool_size = static_cast<int>(cores.size());
+  }
+
+  // the calling thread takes the place of the first core and is not bound. processor ids start from 1 in the
+  // affinity string.
+  std::ostringstream affinity;
+  for (int i = 1; i < to.thread_pool_size; ++i) {
+    const auto& core = cores[static_cast<size_t>(i) % cores.size()];
+    affinity << (i > 1 ? ";" : "");
+    for (size_t j = 0; j < core.size(); ++j) {
+      affinity << (j > 0 ? "," : "") << core[j] + 1;
+    }
+  }
+  to.affinity_str = affinity.str();
+}
+#endif
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -489,6 +564,11 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
+    use_unified_thread_pool_ =
+        session_options_.execution_mode == ExecutionMode::ORT_PARALLEL && !external_intra_op_thread_pool_ &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUnifiedThreadPool, "0") == "1";
+    numa_node_ = SelectNumaNode(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaNode, ""),
+                                session_id_, *session_logger_);
     {
       if (!external_intra_op_thread_pool_) {
         bool allow_intra_op_spinning =
@@ -505,6 +585,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -515,9 +597,20 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+#if !defined(ORT_MINIMAL_BUILD) && !defined(ORT_EXTENDED_MINIMAL_BUILD)
+        if (numa_node_ >= 0) {
+          if (to.affinity_str.empty()) {
+            SetNumaNodeAffinity(numa_node_, to);
+          } else {
+            LOGS(*session_logger_, INFO) << "Intra-op thread affinities are set explicitly, "
+                                         << "the threads are not bound to NUMA node " << numa_node_;
+          }
+        }
+#endif
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
+        to.unified_scheduling = use_unified_thread_pool_;
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -527,7 +620,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
       }
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (use_unified_thread_pool_) {
+      LOGS(*session_logger_, INFO) << "Using the intra-op thread pool for inter-op parallelism";
+    } else if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
@@ -1364,12 +1459,35 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+static Status MapOrtModelBytes(const PathString& model_uri,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_bytes) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
+  ORT_RETURN_IF(num_bytes == 0, "Load model from ", ToUTF8String(model_uri), " failed. The file is empty.");
+
+  // the mapping starts at offset 0 of the file so it is page aligned, which keeps the alignment of the initializer
+  // data within the file
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_bytes));
+
+  bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
-        ORT_RETURN_IF_ERROR(
-            LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+        const auto use_mmap = session_options_.config_options.GetConfigOrDefault(
+                                  kOrtSessionOptionsConfigUseMmapForOrtModel, "0") == "1";
+        if (use_mmap) {
+          ORT_RETURN_IF_ERROR(
+              MapOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_mapped_bytes_));
+        } else {
+          ORT_RETURN_IF_ERROR(
+              LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+        }
         return Status::OK();
       });
 }
@@ -1475,11 +1593,13 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // if the model file was memory-mapped the initializers always use the mapped bytes, which is the point of mapping.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
           ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          (ort_format_model_mapped_bytes_ != nullptr ||
+           config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1");
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1705,6 +1825,7 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.numa_node = numa_node_;
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1787,6 +1908,24 @@ common::Status InferenceSession::Initialize() {
       return false;
     }();
 
+#if !defined(ORT_MINIMAL_BUILD) && !defined(DISABLE_EXTERNAL_INITIALIZERS) && !defined(__wasm__)
+    // read the external data of the initializers while the graph is being optimized
+    std::unique_ptr<ExternalDataPrefetcher> external_data_prefetcher;
+    if (!loading_ort_format) {
+      const auto prefetch_threads_config = session_options_.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsConfigExternalDataPrefetchThreads, "0");
+      int prefetch_threads = 0;
+      ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(prefetch_threads_config, prefetch_threads) &&
+                            prefetch_threads >= 0,
+                        "Invalid value for ", kOrtSessionOptionsConfigExternalDataPrefetchThreads, ": ",
+                        prefetch_threads_config);
+      if (prefetch_threads > 0) {
+        external_data_prefetcher = std::make_unique<ExternalDataPrefetcher>(graph, model_location_, prefetch_threads,
+                                                                            *session_logger_);
+      }
+    }
+#endif
+
     if (!loading_ort_format) {
 #if !defined(ORT_MINIMAL_BUILD)
       const auto minimal_build_opt_config_value = session_options_.config_options.GetConfigOrDefault(
@@ -2033,6 +2172,21 @@ common::Status InferenceSession::Initialize() {
                                              !saving_model,
                                              saving_ort_format));
 
+#if !defined(ORT_MINIMAL_BUILD) && !defined(DISABLE_EXTERNAL_INITIALIZERS) && !defined(__wasm__)
+    // loading the initializers only waited for the pages that were not read yet. this joins the threads that
+    // submitted the read requests. the time taken to load the initializers is recorded by the session state as the
+    // external_initializers_load event.
+    if (external_data_prefetcher) {
+      external_data_prefetcher->Wait();
+      const size_t bytes = external_data_prefetcher->BytesRequested();
+      const double request_ms =
+          std::chrono::duration<double, std::milli>(external_data_prefetcher->RequestDuration()).count();
+      LOGS(*session_logger_, INFO) << "Requested prefetch of " << bytes / (1024.0 * 1024.0)
+                                   << " MB of external initializer data in " << request_ms << " ms.";
+      external_data_prefetcher.reset();
+    }
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
@@ -2085,12 +2239,14 @@ common::Status InferenceSession::Initialize() {
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
+    ORT_RETURN_IF_ERROR_SESSIONID_(session_state_->PlanStaticMemoryPatterns());
 
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
       ort_format_model_bytes_ = gsl::span<const uint8_t>();
       std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+      ort_format_model_mapped_bytes_.reset();
     }
 
     // once the model is saved, we may remove unnecessary attributes for inference
@@ -2103,6 +2259,8 @@ common::Status InferenceSession::Initialize() {
         graph.DomainToVersionMap(), graph.Name(), model_->MetaData(),
         telemetry_.event_name_, execution_providers_.GetIds(), model_has_fp16_inputs, false);
 
+    ORT_RETURN_IF_ERROR_SESSIONID_(PrewarmMemoryPatterns());
+
     LOGS(*session_logger_, INFO) << "Session successfully initialized.";
   }
   ORT_CATCH(const NotImplementedException& ex) {
@@ -3010,6 +3168,107 @@ AllocatorPtr InferenceSession::GetAllocator(const OrtMemoryInfo& mem_info) const
   return session_state_->GetAllocator(mem_info);
 }
 
+common::Status InferenceSession::PrewarmMemoryPatterns() {
+  const std::string prewarm_config =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternPrewarmDims, "");
+  if (prewarm_config.empty()) {
+    return Status::OK();
+  }
+
+  if (!session_state_->GetEnableMemoryPattern()) {
+    LOGS(*session_logger_, WARNING) << kOrtSessionOptionsConfigMemoryPatternPrewarmDims
+                                    << " is ignored as memory pattern optimization is not enabled for this session.";
+    return Status::OK();
+  }
+
+  const Graph& graph = model_->MainGraph();
+  std::vector<std::string> output_names;
+  output_names.reserve(graph.GetOutputs().size());
+  for (const auto* output : graph.GetOutputs()) {
+    output_names.push_back(output->Name());
+  }
+
+  AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+
+  for (const auto& entry : utils::SplitString(prewarm_config, ";")) {
+    InlinedHashMap<std::string, int64_t> dim_values;
+    for (const auto& assignment : utils::SplitString(entry, ",")) {
+      const auto pos = assignment.find('=');
+      int64_t value = 0;
+      if (pos == std::string_view::npos ||
+          !TryParseStringWithClassicLocale(assignment.substr(pos + 1), value) || value < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid entry '", assignment, "' in ",
+                               kOrtSessionOptionsConfigMemoryPatternPrewarmDims, ". Expected <dim_param>=<value>.");
+      }
+      dim_values.insert_or_assign(std::string(assignment.substr(0, pos)), value);
+    }
+
+    NameMLValMap feeds;
+    bool has_empty_input = false;
+    for (const auto* input : graph.GetInputs()) {
+      const auto* input_type = input->TypeAsProto() ? DataTypeImpl::TypeFromProto(*input->TypeAsProto()) : nullptr;
+      const auto* input_shape = input->Shape();
+      if (!input_type || !input_type->IsTensorType() || !input_shape) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Graph input ", input->Name(),
+                               " must be a tensor with a known rank to warm up memory patterns.");
+      }
+
+      TensorShapeVector dims;
+      dims.reserve(input_shape->dim_size());
+      for (const auto& dim : input_shape->dim()) {
+        auto dim_value_it = dim.has_dim_param() ? dim_values.find(dim.dim_param()) : dim_values.end();
+        if (dim.has_dim_value()) {
+          dims.push_back(dim.dim_value());
+        } else if (dim_value_it != dim_values.end()) {
+          dims.push_back(dim_value_it->second);
+        } else {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unable to resolve the shape of graph input ",
+                                 input->Name(), " from '", entry, "' in ",
+                                 kOrtSessionOptionsConfigMemoryPatternPrewarmDims);
+        }
+      }
+
+      const TensorShape shape(dims);
+      if (shape.Size() == 0) {
+        has_empty_input = true;
+        break;
+      }
+
+      const auto* element_type = input_type->AsTensorType()->GetElementType();
+      OrtValue value;
+      Tensor::InitOrtValue(element_type, shape, cpu_allocator, value);
+      auto& tensor = *value.GetMutable<Tensor>();
+      // string tensors are default constructed to empty strings
+      if (!tensor.IsDataTypeString()) {
+        memset(tensor.MutableDataRaw(), 0, tensor.SizeInBytes());
+      }
+      feeds.emplace(input->Name(), std::move(value));
+    }
+
+    if (has_empty_input) {
+      // there is nothing to plan for inputs without elements
+      LOGS(*session_logger_, WARNING) << "Skipping '" << entry << "' in "
+                                      << kOrtSessionOptionsConfigMemoryPatternPrewarmDims
+                                      << " as it resolves to an input without elements.";
+      continue;
+    }
+
+    // Warming up is only an optimization. A shape the model cannot run with, e.g. because it does not satisfy a
+    // constraint between inputs that the symbolic dimensions do not express, is skipped instead of failing the session.
+    std::vector<OrtValue> fetches;
+    const auto run_status = Run(RunOptions(), feeds, output_names, &fetches);
+    if (!run_status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Unable to warm up memory patterns for '" << entry << "' in "
+                                      << kOrtSessionOptionsConfigMemoryPatternPrewarmDims << ": "
+                                      << run_status.ErrorMessage();
+      continue;
+    }
+    LOGS(*session_logger_, INFO) << "Warmed up memory patterns for '" << entry << "'";
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::ValidateAndParseShrinkArenaString(const std::string& ort_device_list,
                                                                    /*out*/ InlinedVector<AllocatorPtr>& arenas_to_shrink) const {
   arenas_to_shrink.reserve(5);  // Allocate some memory for the container (we are unlikely to see more than 5 memory arena shrink requests)
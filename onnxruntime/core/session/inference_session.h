@@ -29,6 +29,7 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -588,7 +589,9 @@ class InferenceSession {
 
   onnxruntime::concurrency::ThreadPool* GetInterOpThreadPoolToUse() const {
     if (session_options_.use_per_session_threads) {
-      if (external_inter_op_thread_pool_) {
+      if (use_unified_thread_pool_) {
+        return thread_pool_.get();
+      } else if (external_inter_op_thread_pool_) {
         return external_inter_op_thread_pool_;
       } else {
         return inter_op_thread_pool_.get();
@@ -699,6 +702,12 @@ class InferenceSession {
    */
   void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
 
+  /*
+   * Runs the model once per entry of the kOrtSessionOptionsConfigMemoryPatternPrewarmDims config value
+   * so that the memory patterns of those input shapes are cached before the first user request.
+   */
+  [[nodiscard]] common::Status PrewarmMemoryPatterns();
+
 #ifdef _WIN32
   void LogAllSessions();
 #endif
@@ -772,6 +781,12 @@ class InferenceSession {
   // If true, use the per session ones, or else the global threadpools.
   bool use_per_session_threads_;
 
+  // If true, thread_pool_ is also used as the inter-op thread pool and inter_op_thread_pool_ is not created.
+  bool use_unified_thread_pool_ = false;
+
+  // NUMA node the intra-op threads and the memory of the default CPU execution provider are bound to, or -1.
+  int numa_node_ = -1;
+
   KernelRegistryManager kernel_registry_manager_;
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -860,6 +875,11 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // This holds the mapping of the model file if the session was started with a model_uri and the session config
+  // option "session.use_mmap_for_ort_model" is "1". The initializers used on CPU refer to the mapped pages, so the
+  // mapping is kept until the InferenceSession goes away.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
   // Container to store pre-packed weights to share between sessions.
@@ -25,6 +25,14 @@ struct OrtThreadPoolParams {
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
 
+  // If it is true, the thread pool also runs the inter-op tasks and its parallel loops are limited to
+  // the threads that are not running one.
+  bool unified_scheduling = false;
+
+  // If it is true and allow_spinning is true, the threads adapt how long they spin before blocking
+  // to how long they usually wait for work.
+  bool adaptive_spinning = false;
+
   unsigned int stack_size = 0;
 
   // A utf-8 string of affinity settings, format be like:
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+#include "test/common/random_generator.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+#include "test/util/include/scoped_env_vars.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+struct GroupQueryAttentionTestParams {
+  int batch_size;
+  int sequence_length;
+  int num_heads;
+  int kv_num_heads;
+  int head_size;
+  std::vector<int> total_sequence_lengths;  // valid length of the present KV of each batch
+  int past_buffer_length = 0;               // 0 when there is no past input
+  int local_window_size = -1;
+  float softcap = 0.0f;
+  bool packed_qkv = false;
+};
+
+// Computes GroupQueryAttention the naive way: present K and V are the past followed by the new K and V,
+// and each query attends to the present positions allowed by the causal mask and the local window.
+void ComputeGroupQueryAttentionReference(const GroupQueryAttentionTestParams& p,
+                                         const std::vector<float>& query,       // B x S x N x H
+                                         const std::vector<float>& key,         // B x S x N_kv x H
+                                         const std::vector<float>& value,       // B x S x N_kv x H
+                                         const std::vector<float>& past_key,    // B x N_kv x P x H
+                                         const std::vector<float>& past_value,  // B x N_kv x P x H
+                                         int present_length,
+                                         std::vector<float>& output,          // B x S x N x H
+                                         std::vector<float>& present_key,     // B x N_kv x T x H
+                                         std::vector<float>& present_value) {  // B x N_kv x T x H
+  const int S = p.sequence_length;
+  const int H = p.head_size;
+  const int group_size = p.num_heads / p.kv_num_heads;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(H));
+
+  present_key.assign(static_cast<size_t>(p.batch_size) * p.kv_num_heads * present_length * H, 0.0f);
+  present_value.assign(present_key.size(), 0.0f);
+  output.assign(static_cast<size_t>(p.batch_size) * S * p.num_heads * H, 0.0f);
+
+  for (int b = 0; b < p.batch_size; b++) {
+    const int total_length = p.total_sequence_lengths[b];
+    const int past_length = total_length - S;
+
+    for (int kvh = 0; kvh < p.kv_num_heads; kvh++) {
+      for (int t = 0; t < total_length; t++) {
+        for (int h = 0; h < H; h++) {
+          const size_t present_index = ((static_cast<size_t>(b) * p.kv_num_heads + kvh) * present_length + t) * H + h;
+          if (t < past_length) {
+            const size_t past_index = ((static_cast<size_t>(b) * p.kv_num_heads + kvh) * p.past_buffer_length + t) * H + h;
+            present_key[present_index] = past_key[past_index];
+            present_value[present_index] = past_value[past_index];
+          } else {
+            const size_t input_index = ((static_cast<size_t>(b) * S + (t - past_length)) * p.kv_num_heads + kvh) * H + h;
+            present_key[present_index] = key[input_index];
+            present_value[present_index] = value[input_index];
+          }
+        }
+      }
+    }
+
+    std::vector<double> scores(total_length);
+    for (int n = 0; n < p.num_heads; n++) {
+      const int kvh = n / group_size;
+      const float* k = present_key.data() + (static_cast<size_t>(b) * p.kv_num_heads + kvh) * present_length * H;
+      const float* v = present_value.data() + (static_cast<size_t>(b) * p.kv_num_heads + kvh) * present_length * H;
+
+      for (int s = 0; s < S; s++) {
+        const float* q = query.data() + ((static_cast<size_t>(b) * S + s) * p.num_heads + n) * H;
+        float* out = output.data() + ((static_cast<size_t>(b) * S + s) * p.num_heads + n) * H;
+
+        const int position = past_length + s;
+        const int lo = p.local_window_size > 0 ? std::max(position - p.local_window_size, 0) : 0;
+        const int hi = position + 1;
+
+        double max_score = -std::numeric_limits<double>::infinity();
+        for (int t = lo; t < hi; t++) {
+          double score = 0.0;
+          for (int h = 0; h < H; h++) {
+            score += static_cast<double>(q[h]) * k[static_cast<size_t>(t) * H + h];
+          }
+          score *= scale;
+          if (p.softcap > 0.0f) {
+            score = p.softcap * std::tanh(score / p.softcap);
+          }
+          scores[t] = score;
+          max_score = std::max(max_score, score);
+        }
+
+        double sum = 0.0;
+        for (int t = lo; t < hi; t++) {
+          scores[t] = std::exp(scores[t] - max_score);
+          sum += scores[t];
+        }
+
+        for (int h = 0; h < H; h++) {
+          double acc = 0.0;
+          for (int t = lo; t < hi; t++) {
+            acc += scores[t] * v[static_cast<size_t>(t) * H + h];
+          }
+          out[h] = static_cast<float>(acc / sum);
+        }
+      }
+    }
+  }
+}
+
+void RunGroupQueryAttentionTest(const GroupQueryAttentionTestParams& p, bool disable_flash) {
+  const int64_t B = p.batch_size;
+  const int64_t S = p.sequence_length;
+  const int64_t H = p.head_size;
+  const int64_t P = p.past_buffer_length;
+  const int total_sequence_length = *std::max_element(p.total_sequence_lengths.begin(),
+                                                      p.total_sequence_lengths.end());
+  const int present_length = std::max(total_sequence_length, p.past_buffer_length);
+
+  RandomValueGenerator random{1234};
+  const std::vector<float> query = random.Uniform<float>(std::vector<int64_t>{B, S, p.num_heads * H}, -1.0f, 1.0f);
+  const std::vector<float> key = random.Uniform<float>(std::vector<int64_t>{B, S, p.kv_num_heads * H}, -1.0f, 1.0f);
+  const std::vector<float> value = random.Uniform<float>(std::vector<int64_t>{B, S, p.kv_num_heads * H}, -1.0f, 1.0f);
+  std::vector<float> past_key;
+  std::vector<float> past_value;
+  if (P > 0) {
+    past_key = random.Uniform<float>(std::vector<int64_t>{B, p.kv_num_heads, P, H}, -1.0f, 1.0f);
+    past_value = random.Uniform<float>(std::vector<int64_t>{B, p.kv_num_heads, P, H}, -1.0f, 1.0f);
+  }
+
+  std::vector<float> output;
+  std::vector<float> present_key;
+  std::vector<float> present_value;
+  ComputeGroupQueryAttentionReference(p, query, key, value, past_key, past_value, present_length,
+                                      output, present_key, present_value);
+
+  std::vector<int32_t> seqlens_k(p.total_sequence_lengths.begin(), p.total_sequence_lengths.end());
+  for (int32_t& seqlen : seqlens_k) {
+    seqlen -= 1;
+  }
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", p.num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", p.kv_num_heads);
+  test.AddAttribute<int64_t>("local_window_size", p.local_window_size);
+  test.AddAttribute<float>("softcap", p.softcap);
+
+  if (p.packed_qkv) {
+    // each token holds the query heads, then the key heads, then the value heads.
+    const int64_t q_hidden = p.num_heads * H;
+    const int64_t kv_hidden = p.kv_num_heads * H;
+    std::vector<float> packed_qkv;
+    packed_qkv.reserve(static_cast<size_t>(B * S * (q_hidden + 2 * kv_hidden)));
+    for (int64_t token = 0; token < B * S; token++) {
+      packed_qkv.insert(packed_qkv.end(), query.begin() + token * q_hidden, query.begin() + (token + 1) * q_hidden);
+      packed_qkv.insert(packed_qkv.end(), key.begin() + token * kv_hidden, key.begin() + (token + 1) * kv_hidden);
+      packed_qkv.insert(packed_qkv.end(), value.begin() + token * kv_hidden, value.begin() + (token + 1) * kv_hidden);
+    }
+    test.AddInput<float>("query", {B, S, q_hidden + 2 * kv_hidden}, packed_qkv);
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  } else {
+    test.AddInput<float>("query", {B, S, p.num_heads * H}, query);
+    test.AddInput<float>("key", {B, S, p.kv_num_heads * H}, key);
+    test.AddInput<float>("value", {B, S, p.kv_num_heads * H}, value);
+  }
+
+  if (P > 0) {
+    test.AddInput<float>("past_key", {B, p.kv_num_heads, P, H}, past_key);
+    test.AddInput<float>("past_value", {B, p.kv_num_heads, P, H}, past_value);
+  } else {
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddInput<int32_t>("seqlens_k", {B}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+
+  test.AddOutput<float>("output", {B, S, p.num_heads * H}, output);
+  test.AddOutput<float>("present_key", {B, p.kv_num_heads, present_length, H}, present_key);
+  test.AddOutput<float>("present_value", {B, p.kv_num_heads, present_length, H}, present_value);
+  test.SetOutputTolerance(1e-4f);
+
+  ScopedEnvironmentVariables scoped_env_vars{
+      EnvVarMap{{onnxruntime::contrib::attention::kDisableFlashAttention, disable_flash ? "1" : "0"}}};
+  test.ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+// Runs the flash attention path and the path that computes the whole attention probs.
+void RunGroupQueryAttentionTests(const GroupQueryAttentionTestParams& p) {
+  RunGroupQueryAttentionTest(p, false);
+  RunGroupQueryAttentionTest(p, true);
+}
+
+}  // namespace
+
+TEST(GroupQueryAttentionTest, Cpu_Prompt) {
+  RunGroupQueryAttentionTests({2, 5, 6, 2, 8, {5, 5}});
+  RunGroupQueryAttentionTests({1, 7, 8, 1, 16, {7}});
+  // as many key and value heads as query heads.
+  RunGroupQueryAttentionTests({2, 4, 4, 4, 8, {4, 4}});
+}
+
+TEST(GroupQueryAttentionTest, Cpu_Prompt_LocalWindow) {
+  RunGroupQueryAttentionTests({2, 9, 4, 2, 8, {9, 9}, 0, 3});
+  RunGroupQueryAttentionTests({1, 6, 6, 3, 8, {6}, 0, 1});
+}
+
+TEST(GroupQueryAttentionTest, Cpu_Prompt_Softcap) {
+  RunGroupQueryAttentionTests({2, 5, 4, 2, 8, {5, 5}, 0, -1, 0.5f});
+  RunGroupQueryAttentionTests({1, 8, 4, 1, 8, {8}, 0, 2, 1.0f});
+}
+
+TEST(GroupQueryAttentionTest, Cpu_Prompt_PackedQKV) {
+  RunGroupQueryAttentionTests({2, 5, 6, 2, 8, {5, 5}, 0, -1, 0.0f, true});
+  RunGroupQueryAttentionTests({1, 6, 4, 2, 16, {6}, 0, 2, 0.5f, true});
+}
+
+// Each batch has its own past length, the past buffer is longer than all of them.
+TEST(GroupQueryAttentionTest, Cpu_TokenGeneration) {
+  RunGroupQueryAttentionTests({3, 1, 6, 2, 8, {12, 5, 1}, 12});
+  RunGroupQueryAttentionTests({2, 1, 8, 2, 16, {9, 16}, 20});
+  RunGroupQueryAttentionTests({2, 1, 4, 4, 8, {7, 3}, 8, 3});
+  RunGroupQueryAttentionTests({2, 1, 4, 1, 8, {10, 4}, 10, 2, 0.5f});
+  RunGroupQueryAttentionTests({2, 1, 6, 3, 8, {8, 6}, 8, -1, 0.0f, true});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
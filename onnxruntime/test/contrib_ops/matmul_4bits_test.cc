@@ -3,6 +3,8 @@
 
 #ifndef ORT_MINIMAL_BUILD
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
 #include "gtest/gtest.h"
@@ -387,6 +389,122 @@ TEST(MatMulNBits, Float32_Accuracy4) {
   TestMatMulNBitsTyped<float, 100, 288, 1234, 16, 4>();
 }
 
+namespace {
+
+// Quantizes B (N x K, column-major blocks along K) with `bits` bits per value into the MatMulNBits bitstream
+// layout and runs the CPU kernel against a reference computed from the dequantized weights.
+void RunLowBitTest(int64_t bits, int64_t M, int64_t N, int64_t K, int64_t block_size, int64_t accuracy_level,
+                   bool has_zero_point) {
+  SCOPED_TRACE(::testing::Message() << "bits:" << bits << ", M:" << M << ", N:" << N << ", K:" << K
+                                    << ", block_size:" << block_size << ", accuracy_level:" << accuracy_level
+                                    << ", has_zero_point:" << has_zero_point);
+
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zp_bytes_per_col = (k_blocks * bits + 7) / 8;
+  const int max_q = (1 << bits) - 1;
+  const int default_zp = 1 << (bits - 1);
+
+  RandomValueGenerator random{1234};
+  std::vector<float> input0_vals(random.Gaussian<float>(AsSpan({M, K}), 0.0f, 0.25f));
+  std::vector<float> input1_f_vals(random.Gaussian<float>(AsSpan({N, K}), 0.0f, 0.25f));
+
+  std::vector<uint8_t> input1_vals(N * k_blocks * blob_size, 0);
+  std::vector<float> scales(N * k_blocks);
+  std::vector<uint8_t> zp(N * zp_bytes_per_col, 0);
+
+  auto set_bits = [bits](uint8_t* data, int64_t idx, int v) {
+    for (int64_t b = 0; b < bits; b++) {
+      const int64_t bit = idx * bits + b;
+      data[bit / 8] |= static_cast<uint8_t>(((v >> b) & 1) << (bit % 8));
+    }
+  };
+
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t kb = 0; kb < k_blocks; kb++) {
+      const int64_t k_begin = kb * block_size, k_end = std::min(K, k_begin + block_size);
+      float min_v = 0.0f, max_v = 0.0f;
+      for (int64_t k = k_begin; k < k_end; k++) {
+        min_v = std::min(min_v, input1_f_vals[n * K + k]);
+        max_v = std::max(max_v, input1_f_vals[n * K + k]);
+      }
+
+      float scale;
+      int zero_point;
+      if (has_zero_point) {
+        scale = (max_v - min_v) / max_q;
+        zero_point = scale == 0.0f ? 0 : std::clamp(static_cast<int>(std::round(-min_v / scale)), 0, max_q);
+        set_bits(zp.data() + n * zp_bytes_per_col, kb, zero_point);
+      } else {
+        scale = std::max(-min_v, max_v) / default_zp;
+        zero_point = default_zp;
+      }
+      scales[n * k_blocks + kb] = scale;
+
+      for (int64_t k = k_begin; k < k_end; k++) {
+        float& v = input1_f_vals[n * K + k];
+        const int q = scale == 0.0f
+                          ? zero_point
+                          : std::clamp(static_cast<int>(std::round(v / scale)) + zero_point, 0, max_q);
+        set_bits(input1_vals.data() + n * k_blocks * blob_size, k, q);
+        v = (q - zero_point) * scale;
+      }
+    }
+  }
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += input0_vals[m * K + k] * input1_f_vals[n * K + k];
+      }
+      expected_vals[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("accuracy_level", accuracy_level);
+
+  test.AddInput<float>("A", {M, K}, input0_vals, false);
+  test.AddInput<uint8_t>("B", {N, k_blocks, blob_size}, input1_vals, true);
+  test.AddInput<float>("scales", {N * k_blocks}, scales, true);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {N * zp_bytes_per_col}, zp, true);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  test.AddOptionalInputEdge<int32_t>();
+  test.AddOptionalInputEdge<float>();
+
+  test.AddOutput<float>("Y", {M, N}, expected_vals);
+  test.SetOutputAbsErr("Y", accuracy_level == 4 ? 0.1f : 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(execution_providers));
+  test.RunWithConfig();
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float32_LowBit) {
+  for (int64_t bits : {2, 3}) {
+    for (int64_t accuracy_level : {0, 4}) {
+      for (bool has_zero_point : {false, true}) {
+        RunLowBitTest(bits, 1, 288, 1024, 32, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 1, 33, 93, 64, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 100, 32, 256, 128, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 100, 288, 1234, 16, accuracy_level, has_zero_point);
+      }
+    }
+  }
+}
+
 #ifdef MLAS_TARGET_AMD64_IX86
 #if !defined(USE_DML)
 // Actual and expected difference is over 0.01 with DmlExecutionProvider.
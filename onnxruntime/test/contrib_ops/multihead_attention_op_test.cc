@@ -3,9 +3,11 @@
 
 #include "core/platform/env_var_utils.h"
 #include "gtest/gtest.h"
+#include "test/common/random_generator.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 #include "test/util/include/scoped_env_vars.h"
 #include "test/contrib_ops/attention_op_test_helper.h"
 
@@ -623,5 +625,79 @@ TEST(MultiHeadAttentionTest, DISABLED_CrossAttention_WithPastPassedInDirectly_No
   RunMultiHeadAttentionTests(data);
 }
 
+// Compares the CPU kernel with a naive attention, with inputs that take the flash attention path
+// (no bias, mask or past state) and with flash attention disabled.
+static void RunMultiHeadAttentionNaiveReferenceTest(int batch_size, int sequence_length, int kv_sequence_length,
+                                                    int num_heads, int qk_head_size, int v_head_size) {
+  const int64_t B = batch_size;
+  const int64_t S = sequence_length;
+  const int64_t L = kv_sequence_length;
+  const int64_t qk_hidden_size = static_cast<int64_t>(num_heads) * qk_head_size;
+  const int64_t v_hidden_size = static_cast<int64_t>(num_heads) * v_head_size;
+
+  RandomValueGenerator random{4321};
+  const std::vector<float> query = random.Uniform<float>(std::vector<int64_t>{B, S, qk_hidden_size}, -1.0f, 1.0f);
+  const std::vector<float> key = random.Uniform<float>(std::vector<int64_t>{B, L, qk_hidden_size}, -1.0f, 1.0f);
+  const std::vector<float> value = random.Uniform<float>(std::vector<int64_t>{B, L, v_hidden_size}, -1.0f, 1.0f);
+
+  const double scale = 1.0 / std::sqrt(static_cast<double>(qk_head_size));
+  std::vector<float> output(static_cast<size_t>(B * S * v_hidden_size));
+  std::vector<double> scores(kv_sequence_length);
+  for (int64_t b = 0; b < B; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      for (int64_t s = 0; s < S; s++) {
+        const float* q = query.data() + (b * S + s) * qk_hidden_size + n * qk_head_size;
+        double max_score = -std::numeric_limits<double>::infinity();
+        for (int64_t t = 0; t < L; t++) {
+          const float* k = key.data() + (b * L + t) * qk_hidden_size + n * qk_head_size;
+          double score = 0.0;
+          for (int h = 0; h < qk_head_size; h++) {
+            score += static_cast<double>(q[h]) * k[h];
+          }
+          scores[t] = score * scale;
+          max_score = std::max(max_score, scores[t]);
+        }
+        double sum = 0.0;
+        for (int64_t t = 0; t < L; t++) {
+          scores[t] = std::exp(scores[t] - max_score);
+          sum += scores[t];
+        }
+        float* out = output.data() + (b * S + s) * v_hidden_size + n * v_head_size;
+        for (int h = 0; h < v_head_size; h++) {
+          double acc = 0.0;
+          for (int64_t t = 0; t < L; t++) {
+            acc += scores[t] * value[(b * L + t) * v_hidden_size + n * v_head_size + h];
+          }
+          out[h] = static_cast<float>(acc / sum);
+        }
+      }
+    }
+  }
+
+  for (const char* disable_flash : {"0", "1"}) {
+    ScopedEnvironmentVariables scoped_env_vars{
+        EnvVarMap{{onnxruntime::contrib::attention::kDisableFlashAttention, disable_flash}}};
+    OpTester test("MultiHeadAttention", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+    test.AddInput<float>("query", {B, S, qk_hidden_size}, query);
+    test.AddInput<float>("key", {B, L, qk_hidden_size}, key);
+    test.AddInput<float>("value", {B, L, v_hidden_size}, value);
+    test.AddOutput<float>("output", {B, S, v_hidden_size}, output);
+    test.SetOutputTolerance(1e-4f);
+    test.ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  }
+}
+
+TEST(MultiHeadAttentionTest, SelfAttention_Cpu_NaiveReference) {
+  RunMultiHeadAttentionNaiveReferenceTest(2, 7, 7, 2, 16, 16);
+  RunMultiHeadAttentionNaiveReferenceTest(1, 33, 33, 4, 8, 8);
+}
+
+TEST(MultiHeadAttentionTest, CrossAttention_Cpu_NaiveReference) {
+  RunMultiHeadAttentionNaiveReferenceTest(2, 5, 9, 3, 8, 6);
+  RunMultiHeadAttentionNaiveReferenceTest(3, 1, 40, 2, 16, 24);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #include "test/providers/provider_test_utils.h"
 #include "core/util/qmath.h"
 #include "core/quantization/quantization.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 namespace test {
@@ -43,7 +44,8 @@ void RunQAttention(const std::vector<float>& input_data,
                    int number_of_heads,
                    bool is_unidirectional = false,
                    bool use_float16 = false,
-                   int input_hidden_size = 0) {
+                   int input_hidden_size = 0,
+                   bool use_int8_attention = false) {
   input_hidden_size = (input_hidden_size == 0) ? hidden_size : input_hidden_size;
 
   OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
@@ -120,6 +122,16 @@ void RunQAttention(const std::vector<float>& input_data,
     execution_providers.push_back(DefaultDnnlExecutionProvider());
   }
 
+  if (use_int8_attention) {
+    // The attention probabilities and V are quantized too, so the error is larger than that of fp32 attention.
+    tester.SetOutputTolerance(0.05f, 0.02f);
+    SessionOptions so;
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsQAttentionInt8Attention, "1"));
+    tester.Run(so, OpTester::ExpectResult::kExpectSuccess, "",
+               {kTensorrtExecutionProvider}, nullptr, &execution_providers);
+    return;
+  }
+
   tester.Run(OpTester::ExpectResult::kExpectSuccess, "",
              {kTensorrtExecutionProvider}, nullptr, &execution_providers);
 }
@@ -454,6 +466,123 @@ TEST(QAttentionTest, QAttentionBatch2) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+TEST(QAttentionTest, QAttentionBatch2_Int8Attention) {
+  int batch_size = 2;
+  int sequence_length = 2;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  std::vector<int32_t> mask_index_data = {2L, 1L};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      3.0f, 0.0f, 4.25f, 5.6499996185302734f,
+      3.0f, 0.0f, 4.2499995231628418f, 5.6499991416931152f};
+
+  quantization::Params<uint8_t> input_quant_params(/*scale=*/0.0f, /*zero_point=*/0);
+  quantization::Params<int8_t> weights_quant_params(/*scale=*/0.0f, /*zero_point=*/0);
+  RunQAttention<uint8_t, int8_t, EP::CPU>(
+      input_data, weight_data, bias_data, mask_index_data, output_data, input_quant_params, weights_quant_params,
+      batch_size, sequence_length, hidden_size, number_of_heads, false /*is_unidirectional*/, false /*use_float16*/,
+      0 /*input_hidden_size*/, true /*use_int8_attention*/);
+}
+
+// Runs QAttention on the CPU EP without mask and returns its output, computed with fp32 or int8 attention.
+static std::vector<float> RunQAttentionCpu(const std::vector<uint8_t>& input_data,
+                                           const std::vector<int8_t>& weight_data,
+                                           const std::vector<float>& bias_data,
+                                           float input_scale, uint8_t input_zero_point, float weight_scale,
+                                           int batch_size, int sequence_length, int hidden_size,
+                                           int number_of_heads, bool use_int8_attention) {
+  OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<int64_t> weights_dims = {hidden_size, static_cast<int64_t>(3 * hidden_size)};
+  std::vector<int64_t> bias_dims = {static_cast<int64_t>(3 * hidden_size)};
+
+  tester.AddInput<uint8_t>("input", input_dims, input_data);
+  tester.AddInput<int8_t>("weight", weights_dims, weight_data);
+  tester.AddInput<float>("bias", bias_dims, bias_data);
+  tester.AddInput<float>("input_scale", {1}, {input_scale});
+  tester.AddInput<float>("weight_scale", {1}, {weight_scale});
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<uint8_t>("input_zero_point", {1}, {input_zero_point});
+  tester.AddInput<int8_t>("weight_zero_point", {1}, {0});
+
+  // the output is returned to the caller instead of being verified here
+  tester.AddOutput<float>("output", input_dims, std::vector<float>(input_data.size()));
+  std::vector<float> output;
+  tester.SetCustomOutputVerifier([&output](const std::vector<OrtValue>& fetches, const std::string& /*provider*/) {
+    const auto& output_tensor = fetches[0].Get<Tensor>();
+    const auto output_data = output_tensor.DataAsSpan<float>();
+    output.assign(output_data.begin(), output_data.end());
+  });
+
+  SessionOptions so;
+  if (use_int8_attention) {
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsQAttentionInt8Attention, "1"));
+  }
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  return output;
+}
+
+// Compares the int8 attention with the fp32 attention at sizes where the quantized GEMMs run their full kernels.
+// Each input row has a single non zero value, so Q, K and V follow the uniform weights and have many values close to
+// their quantization range. The products of such operands overflow int16 pair sums, e.g. in the U8S8 kernels of x64
+// CPUs without VNNI, which would move the outputs by much more than the tolerance.
+TEST(QAttentionTest, QAttentionInt8AttentionMatchesFp32Attention) {
+  constexpr int batch_size = 2;
+  constexpr int sequence_length = 64;
+  constexpr int hidden_size = 64;
+  constexpr int number_of_heads = 2;
+
+  constexpr float input_scale = 0.02f;
+  constexpr uint8_t input_zero_point = 128;
+  constexpr float weight_scale = 0.01f;
+
+  RandomValueGenerator random{1234};
+  std::vector<uint8_t> input_data(batch_size * sequence_length * hidden_size, input_zero_point);
+  for (int row = 0; row < batch_size * sequence_length; row++) {
+    input_data[row * hidden_size + (row * 7) % hidden_size] = 255;
+  }
+  const std::vector<int64_t> weights_dims = {hidden_size, 3 * hidden_size};
+  const std::vector<int64_t> bias_dims = {3 * hidden_size};
+  const std::vector<int8_t> weight_data = random.Uniform<int8_t>(weights_dims, -127, 127);
+  const std::vector<float> bias_data = random.Uniform<float>(bias_dims, -0.5f, 0.5f);
+
+  const std::vector<float> fp32_output =
+      RunQAttentionCpu(input_data, weight_data, bias_data, input_scale, input_zero_point, weight_scale,
+                       batch_size, sequence_length, hidden_size, number_of_heads, false /*use_int8_attention*/);
+  const std::vector<float> int8_output =
+      RunQAttentionCpu(input_data, weight_data, bias_data, input_scale, input_zero_point, weight_scale,
+                       batch_size, sequence_length, hidden_size, number_of_heads, true /*use_int8_attention*/);
+
+  // the outputs are within about 3.5, the quantization error stays below about 0.1
+  ASSERT_EQ(fp32_output.size(), int8_output.size());
+  for (size_t i = 0; i < fp32_output.size(); i++) {
+    ASSERT_NEAR(int8_output[i], fp32_output[i], 0.2f) << "i=" << i;
+  }
+}
+
 // ONEDNN EP only support 2D raw mask
 #ifdef USE_DNNL
 TEST(QAttentionTest, QAttentionDNNLBatch2) {
@@ -302,6 +302,56 @@ TEST(FlatbufferUtilsTest, ExternalWriteReadWithLoadInitializers) {
   }
 }
 
+// tests that raw data that can be used in place is aligned, and is used in place when requested
+TEST(FlatbufferUtilsTest, InPlaceRawDataIsAligned) {
+  auto initializers = CreateInitializers();
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+
+  std::vector<flatbuffers::Offset<fbs::Tensor>> fbs_tensors;
+  for (const auto& initializer : initializers) {
+    flatbuffers::Offset<fbs::Tensor> fbs_tensor;
+    ASSERT_STATUS_OK(SaveInitializerOrtFormat(builder, initializer, std::filesystem::path(), fbs_tensor, nullptr));
+    fbs_tensors.push_back(fbs_tensor);
+  }
+
+  auto fbs_tensors_offset = builder.CreateVector(fbs_tensors);
+  fbs::test::TestDataBuilder tdb(builder);
+  tdb.add_initializers(fbs_tensors_offset);
+  builder.Finish(tdb.Finish());
+
+  // copy to a buffer aligned like a memory-mapped file
+  auto fb_data = builder.GetBufferSpan();
+  std::vector<uint64_t> aligned_buffer((fb_data.size() + kInPlaceRawDataAlignment) / sizeof(uint64_t));
+  auto* aligned_data = reinterpret_cast<uint8_t*>(aligned_buffer.data());
+  aligned_data += (kInPlaceRawDataAlignment - reinterpret_cast<uintptr_t>(aligned_data) % kInPlaceRawDataAlignment) %
+                  kInPlaceRawDataAlignment;
+  std::copy(fb_data.begin(), fb_data.end(), aligned_data);
+
+  const auto* test_data = fbs::test::GetTestData(aligned_data);
+  OrtFormatLoadOptions options;
+  options.can_use_flatbuffer_for_initializers = true;
+
+  size_t num_in_place = 0;
+  for (const auto* fbs_tensor : *test_data->initializers()) {
+    const auto* raw_data = fbs_tensor->raw_data();
+    if (raw_data == nullptr || raw_data->size() < kMinimumSizeForInPlaceRawData) {
+      continue;
+    }
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(raw_data->Data()) % kInPlaceRawDataAlignment, 0u)
+        << fbs_tensor->name()->str();
+
+    ONNX_NAMESPACE::TensorProto initializer;
+    ASSERT_STATUS_OK(LoadInitializerOrtFormat(*fbs_tensor, initializer, options));
+    EXPECT_EQ(initializer.data_location(), ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL)
+        << fbs_tensor->name()->str();
+    ++num_in_place;
+  }
+
+  ASSERT_GT(num_in_place, 0u);
+}
+
 #ifdef ENABLE_TRAINING_APIS
 // tests method that loads to OrtTensor (used when loading a checkpoint into a checkpoint state)
 TEST(FlatbufferUtilsTest, ExternalWriteReadWithLoadOrtTensor) {
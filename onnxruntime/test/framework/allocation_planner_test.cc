@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -133,6 +134,13 @@ class ParallelPlannerTestContext : public SequentialPlannerTestContext {
   bool GetEnableMemoryReuse() const override { return false; }
 };
 
+class CriticalPathPlannerTestContext : public ParallelPlannerTestContext {
+ public:
+  CriticalPathPlannerTestContext(ShapeMap* shape_map) : ParallelPlannerTestContext(shape_map) {
+  }
+  bool IsCriticalPathSchedulingEnabled() const override { return true; }
+};
+
 class PlannerTest : public ::testing::Test {
  private:
   void index(const std::string& name, int& out) {
@@ -166,6 +174,8 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<SessionState> state_;
   ShapeMap shape_map_;
   std::optional<SequentialExecutionPlan> plan_;
+  bool parallel_execution_ = false;
+  bool critical_path_scheduling_ = false;
 
  public:
   PlannerTest()
@@ -306,7 +316,14 @@ class PlannerTest : public ::testing::Test {
     status = state_->FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager, {}, remove_initializers);
 
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    std::unique_ptr<SequentialPlannerTestContext> test_context;
+    if (critical_path_scheduling_) {
+      test_context = std::make_unique<CriticalPathPlannerTestContext>(&shape_map_);
+    } else if (parallel_execution_) {
+      test_context = std::make_unique<ParallelPlannerTestContext>(&shape_map_);
+    } else {
+      test_context = std::make_unique<SequentialPlannerTestContext>(&shape_map_);
+    }
     plan_.emplace();
 
     class MockStreamHandleRegsitry : public IStreamCommandHandleRegistry {
@@ -337,7 +354,7 @@ class PlannerTest : public ::testing::Test {
           {},
           {},
           state_->GetOrtValueNameIdxMap(),
-          test_context,
+          *test_context,
 #ifdef ORT_ENABLE_STREAM
           MockStreamHandleRegsitry(),
 #endif
@@ -387,6 +404,11 @@ class PlannerTest : public ::testing::Test {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
   std::unique_ptr<::onnxruntime::KernelDef>& GetStdKernel() { return std_kernel_; }
+  // selects the planner context used by CreatePlan
+  void SetParallelExecution(bool critical_path_scheduling) {
+    parallel_execution_ = true;
+    critical_path_scheduling_ = critical_path_scheduling;
+  }
 #ifdef USE_CUDA
   void MemcpyToHostInCuda_TransposeInCudaAndCpu(const char* partitionConfigFile = nullptr) {
     std::unique_ptr<::onnxruntime::KernelDef> cudaKernel = KernelDefBuilder().SetName("MemcpyToHost").Provider(kCudaExecutionProvider).SetDefaultOutputMemoryType(OrtMemTypeCPUOutput).Build();
@@ -448,6 +470,71 @@ TEST_F(PlannerTest, ChainTest) {
   CheckFreed(3, {X});
 }
 
+// Returns the reference count of the release action of the named value and the nodes that release it.
+static std::pair<int, std::vector<NodeIndex>> GetRelease(const SequentialExecutionPlan& plan,
+                                                         const SessionState& state, const std::string& name) {
+  int ort_value_idx;
+  ORT_THROW_IF_ERROR(state.GetOrtValueNameIdxMap().GetIdx(name, ort_value_idx));
+  std::pair<int, std::vector<NodeIndex>> release{0, {}};
+  for (size_t action_idx = 0; action_idx < plan.release_actions.size(); ++action_idx) {
+    if (plan.release_actions[action_idx].value_index != static_cast<size_t>(ort_value_idx)) {
+      continue;
+    }
+    release.first = static_cast<int>(plan.release_actions[action_idx].ref_count);
+    for (NodeIndex node_index = 0; node_index < plan.node_release_list.size(); ++node_index) {
+      const auto& actions = plan.node_release_list[node_index];
+      if (std::find(actions.begin(), actions.end(), action_idx) != actions.end()) {
+        release.second.push_back(node_index);
+      }
+    }
+  }
+  return release;
+}
+
+// In parallel mode the nodes of a stream still run in order, so a value with several consumers in the stream is
+// released after the last of them.
+TEST_F(PlannerTest, ParallelExecutionReleaseAfterLastConsumer) {
+  std::string X("X"), Y("Y"), Z1("Z1"), Z2("Z2");
+
+  AddNormalNode(X, Y);
+  AddNormalNode(Y, Z1);
+  AddNormalNode(Y, Z2);
+
+  Shape shape1{50, 100};
+  auto shape = &shape1.value;
+  SetShape({{X, shape}, {Y, shape}, {Z1, shape}, {Z2, shape}});
+
+  SetParallelExecution(/*critical_path_scheduling*/ false);
+  CreatePlan();
+
+  auto release = GetRelease(GetPlan(), GetState(), Y);
+  EXPECT_EQ(release.first, 1);
+  ASSERT_EQ(release.second.size(), 1U);
+  EXPECT_NE(release.second[0], NodeIndex{0});
+}
+
+// Critical path scheduling runs the nodes of a stream out of order, so every consumer releases the value by
+// reference count.
+TEST_F(PlannerTest, CriticalPathSchedulingReleaseByRefCount) {
+  std::string X("X"), Y("Y"), Z1("Z1"), Z2("Z2");
+
+  AddNormalNode(X, Y);
+  AddNormalNode(Y, Z1);
+  AddNormalNode(Y, Z2);
+
+  Shape shape1{50, 100};
+  auto shape = &shape1.value;
+  SetShape({{X, shape}, {Y, shape}, {Z1, shape}, {Z2, shape}});
+
+  SetParallelExecution(/*critical_path_scheduling*/ true);
+  CreatePlan();
+
+  auto release = GetRelease(GetPlan(), GetState(), Y);
+  EXPECT_EQ(release.first, 2);
+  std::sort(release.second.begin(), release.second.end());
+  EXPECT_EQ(release.second, (std::vector<NodeIndex>{1, 2}));
+}
+
 /* InputOutputTest: Test that:
 (a) All inputs are classified as kPreExisting,
 (b) All outer scope node args are classified as kPreExisting,
@@ -6,7 +6,10 @@
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <condition_variable>
 #include <cstdlib>
+#include <mutex>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +310,208 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, ThreadLocalCache) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_local_cache_max_bytes*/ 16 * 1024);
+
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  // served from the cache of this thread
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p1, p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_local_cache_hits, 1);
+  EXPECT_EQ(stats.num_thread_local_cache_misses, 1);
+  EXPECT_EQ(stats.num_allocs, 1) << "cache hits do not reach the arena";
+
+  // large allocations bypass the cache
+  void* p_large = a.Alloc(1024 * 1024);
+  a.Free(p_large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_local_cache_misses, 1);
+
+  // chunks freed on another thread are handed back to the cache that allocated them, which returns them to the arena
+  std::thread([&a, p2]() { a.Free(p2); }).join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // overflow of the cache returns chunks to the arena
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 32; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_use, 16 * 1024);
+  EXPECT_GT(stats.bytes_in_use, 0);
+
+  // Shrink drains all the caches so the regions can be released
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadLocalCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_local_cache_max_bytes*/ 64 * 1024);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&a, t]() {
+      std::vector<char*> ptrs;
+      for (int i = 0; i < 1000; ++i) {
+        const size_t size = 64 + ((i * 37 + t) % 4096);
+        auto* p = static_cast<char*>(a.Alloc(size));
+        memset(p, t, size);
+        ptrs.push_back(p);
+        if (ptrs.size() > 16) {
+          a.Free(ptrs.front());
+          ptrs.erase(ptrs.begin());
+        }
+      }
+      for (char* p : ptrs) {
+        a.Free(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0) << "caches of the exited threads are returned to the arena";
+  EXPECT_GT(stats.num_thread_local_cache_hits, 0);
+}
+
+TEST(BFCArenaTest, ThreadLocalCacheThreadChurn) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_local_cache_max_bytes*/ 64 * 1024);
+
+  a.Free(a.Alloc(512));
+  ASSERT_EQ(a.NumThreadLocalCaches(), 1u);
+  for (int round = 0; round < 50; ++round) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&a]() {
+        for (int i = 0; i < 100; ++i) {
+          void* p = a.Alloc(256 + 64 * (i % 8));
+          a.Free(p);
+        }
+      });
+    }
+    if (round % 10 == 0) {
+      // Shrink waits for the other threads to stop using their caches
+      EXPECT_EQ(a.Shrink(), Status::OK());
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(a.NumThreadLocalCaches(), 1u) << "caches of the exited threads are removed from the arena";
+  }
+
+  // the exited threads returned their chunks, Shrink returns the ones of this thread
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadLocalCacheShrinkDrainsOtherThreads) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_local_cache_max_bytes*/ 16 * 1024);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool cached = false;
+  bool shrunk = false;
+  void* shared = nullptr;
+
+  std::thread thread([&]() {
+    a.Free(a.Alloc(1000));
+    a.Free(a.Alloc(800));
+    shared = a.Alloc(2000);
+    std::unique_lock<std::mutex> lock(mutex);
+    cached = true;
+    cv.notify_all();
+    cv.wait(lock, [&]() { return shrunk; });
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return cached; });
+  }
+
+  AllocatorStats stats;
+  a.Free(a.Alloc(1000));
+  a.GetStats(&stats);
+  // summed over the caches of both threads
+  EXPECT_EQ(stats.num_thread_local_cache_hits, 1);
+  EXPECT_EQ(stats.num_thread_local_cache_misses, 3);
+
+  // the chunk allocated by the other thread is handed back to its cache
+  a.Free(shared);
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0) << "the cache of the other thread is drained although it is still running";
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    shrunk = true;
+    cv.notify_all();
+  }
+  thread.join();
+
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_local_cache_hits, 1) << "the counts of exited threads are kept";
+  EXPECT_EQ(stats.num_thread_local_cache_misses, 3);
+}
+
+// A thread that outlives the arena it cached chunks for must not touch it on exit.
+TEST(BFCArenaTest, ThreadLocalCacheOutlivesArena) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool freed = false;
+  bool arena_destroyed = false;
+
+  auto arena = std::make_unique<BFCArena>(
+      std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+      BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+      BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+      /*thread_local_cache_max_bytes*/ 16 * 1024);
+
+  std::thread thread([&]() {
+    arena->Free(arena->Alloc(1000));
+    std::unique_lock<std::mutex> lock(mutex);
+    freed = true;
+    cv.notify_all();
+    cv.wait(lock, [&]() { return arena_destroyed; });
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return freed; });
+    EXPECT_EQ(arena->NumThreadLocalCaches(), 1u);
+    arena.reset();
+    arena_destroyed = true;
+    cv.notify_all();
+  }
+  thread.join();
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
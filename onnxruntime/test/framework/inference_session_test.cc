@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -19,6 +20,7 @@
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/external_data_prefetcher.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
@@ -29,6 +31,7 @@
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -55,6 +58,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -3008,5 +3012,282 @@ TEST(InferenceSessionTests, InterThreadPoolWithDenormalAsZero) {
 }
 #endif
 
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+TEST(InferenceSessionTests, PrefetchExternalInitializerData) {
+  const ORTCHAR_T* model_path = ORT_TSTR("testdata/conv_qdq_external_ini.onnx");
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  const Graph& graph = model->MainGraph();
+
+  size_t expected_bytes = 0;
+  for (const auto& entry : graph.GetAllInitializedTensors()) {
+    if (utils::HasExternalData(*entry.second)) {
+      std::basic_string<ORTCHAR_T> file_path;
+      FileOffsetType offset = 0;
+      size_t length = 0;
+      ASSERT_STATUS_OK(utils::GetExtDataFileLocationFromTensorProto(model_path, *entry.second, file_path, offset,
+                                                                    length));
+      expected_bytes += length;
+    }
+  }
+  ASSERT_GT(expected_bytes, 0u);
+
+  // nothing is requested where the OS has no prefetch hint.
+  if (!Env::Default().PrefetchFileRange(ORT_TSTR("testdata/conv_qdq_external_ini.bin"), 0, 1).IsOK()) {
+    expected_bytes = 0;
+  }
+
+  {
+    ExternalDataPrefetcher prefetcher(graph, model_path, 4, DefaultLoggingManager().DefaultLogger());
+    prefetcher.Wait();
+    EXPECT_EQ(prefetcher.BytesRequested(), expected_bytes);
+  }
+
+  // the session loads the same initializers after the prefetch and records the time taken to load them
+  TemporaryDirectory tmp_dir{ORT_TSTR("prefetch_external_initializer_data_tmp_dir")};
+  SessionOptions so;
+  so.session_logid = "PrefetchExternalInitializerData";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("profile"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigExternalDataPrefetchThreads, "2"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_path));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  std::ifstream profile(session.EndProfiling());
+  ASSERT_TRUE(profile);
+  const std::string profile_data{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  EXPECT_NE(profile_data.find("external_initializers_load"), std::string::npos);
+  // the initializers are kept on CPU, so their data is memory-mapped rather than read
+  EXPECT_NE(profile_data.find(R"("read_bytes" : "0")"), std::string::npos);
+  EXPECT_NE(profile_data.find("mapped_bytes"), std::string::npos);
+
+  so.enable_profiling = false;
+
+  so.session_logid = "PrefetchExternalInitializerDataInvalidConfig";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigExternalDataPrefetchThreads, "-1"));
+  InferenceSession invalid_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(invalid_session.Load(model_path));
+  ASSERT_FALSE(invalid_session.Initialize().IsOK());
+}
+
+// The initializers of the branches of an If node are prefetched too.
+TEST(InferenceSessionTests, PrefetchExternalInitializerDataInSubgraphs) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("prefetch_external_data_in_subgraphs_tmp_dir")};
+  const PathString model_path = ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("model.onnx"));
+  const PathString data_path = ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("model.bin"));
+  const std::vector<float> data = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f};
+  {
+    std::ofstream data_file(data_path, std::ios::binary);
+    data_file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+    ASSERT_TRUE(data_file.good());
+  }
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  // each branch returns an initializer stored in one half of the data file.
+  auto make_branch = [&](const std::string& name, int64_t offset) {
+    ONNX_NAMESPACE::GraphProto branch;
+    branch.set_name(name);
+    auto* initializer = branch.add_initializer();
+    initializer->set_name(name + "_weight");
+    initializer->add_dims(4);
+    initializer->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    initializer->set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+    auto add_external_data = [&](const std::string& key, const std::string& value) {
+      auto* entry = initializer->add_external_data();
+      entry->set_key(key);
+      entry->set_value(value);
+    };
+    add_external_data("location", "model.bin");
+    add_external_data("offset", std::to_string(offset));
+    add_external_data("length", std::to_string(4 * sizeof(float)));
+
+    auto* node = branch.add_node();
+    node->set_op_type("Identity");
+    node->add_input(name + "_weight");
+    node->add_output(name + "_output");
+    auto* output = branch.add_output();
+    output->set_name(name + "_output");
+    *output->mutable_type() = float_tensor;
+    return branch;
+  };
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  auto* opset = model_proto.add_opset_import();
+  opset->set_domain(kOnnxDomain);
+  opset->set_version(13);
+
+  auto* main_graph = model_proto.mutable_graph();
+  main_graph->set_name("main");
+  auto* input = main_graph->add_input();
+  input->set_name("cond");
+  input->mutable_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_BOOL);
+  input->mutable_type()->mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto* output = main_graph->add_output();
+  output->set_name("output");
+  *output->mutable_type() = float_tensor;
+
+  auto* if_node = main_graph->add_node();
+  if_node->set_op_type("If");
+  if_node->add_input("cond");
+  if_node->add_output("output");
+  auto* then_branch = if_node->add_attribute();
+  then_branch->set_name("then_branch");
+  then_branch->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH);
+  *then_branch->mutable_g() = make_branch("then", 0);
+  auto* else_branch = if_node->add_attribute();
+  else_branch->set_name("else_branch");
+  else_branch->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH);
+  *else_branch->mutable_g() = make_branch("else", 4 * sizeof(float));
+
+  {
+    std::ofstream model_file(model_path, std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_file));
+  }
+
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path, model, nullptr, DefaultLoggingManager().DefaultLogger()));
+  ASSERT_TRUE(model->MainGraph().GetAllInitializedTensors().empty());
+
+  size_t expected_bytes = data.size() * sizeof(float);
+  if (!Env::Default().PrefetchFileRange(data_path.c_str(), 0, 1).IsOK()) {
+    expected_bytes = 0;
+  }
+
+  {
+    ExternalDataPrefetcher prefetcher(model->MainGraph(), model_path, 2, DefaultLoggingManager().DefaultLogger());
+    prefetcher.Wait();
+    EXPECT_EQ(prefetcher.BytesRequested(), expected_bytes);
+  }
+
+  SessionOptions so;
+  so.session_logid = "PrefetchExternalInitializerDataInSubgraphs";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigExternalDataPrefetchThreads, "2"));
+  InferenceSession session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_path));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  OrtValue cond;
+  CreateMLValue<bool>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1}, {false}, &cond);
+  NameMLValMap feeds{{"cond", cond}};
+  std::vector<std::string> output_names{"output"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, output_names, &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(result.begin(), result.end()), std::vector<float>(data.begin() + 4, data.end()));
+}
+#endif
+
+// With a static shape model the activation memory is planned during Initialize, so the first Run already places the
+// intermediate values in the planned block instead of allocating each of them.
+TEST(InferenceSessionTests, StaticMemoryPatternUsedOnFirstRun) {
+  constexpr int kNumBranches = 8;
+  constexpr int64_t kNumElements = 64;
+
+  onnxruntime::Model model("static_memory_plan", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kNumElements);
+
+  // the branch outputs are all alive until the Sum so none of them can reuse the buffer of another
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> sum_inputs;
+  for (int i = 0; i < kNumBranches; ++i) {
+    auto& abs_arg = graph.GetOrCreateNodeArg("abs_" + std::to_string(i), &float_tensor);
+    graph.AddNode("abs_node_" + std::to_string(i), "Abs", "", {&input_arg}, {&abs_arg});
+    sum_inputs.push_back(&abs_arg);
+  }
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum_node", "Sum", "", sum_inputs, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  std::vector<float> input(kNumElements);
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    input[i] = static_cast<float>(i - kNumElements / 2);
+  }
+  OrtValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {kNumElements}, input,
+                       &input_value);
+
+  // runs a new session once and returns the number of CPU allocations made by the Run, or -1 if the CPU allocator
+  // is not an arena and does not count them.
+  auto run_first = [&](bool enable_mem_pattern, bool static_memory_plan, std::vector<float>& output,
+                       int64_t& num_allocs) {
+    SessionOptions so;
+    so.session_logid = "StaticMemoryPatternUsedOnFirstRun";
+    // keep the identical branches from being merged
+    so.graph_optimization_level = TransformerLevel::Default;
+    so.enable_mem_pattern = enable_mem_pattern;
+    if (static_memory_plan) {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlan, "1"));
+    }
+
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+
+    if (static_memory_plan) {
+      // the pattern is available before anything ran
+      const auto& session_state = session.GetSessionState();
+      int input_idx = 0;
+      ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("X", input_idx));
+      std::vector<OrtValue> tensor_inputs{input_value};
+      std::vector<int> feed_idxs{input_idx};
+      const InlinedHashMap<int, TensorShape>* inferred_shapes = nullptr;
+      auto mem_patterns = session_state.GetMemoryPatternGroup(tensor_inputs, feed_idxs, inferred_shapes);
+      ASSERT_NE(mem_patterns, nullptr);
+      ASSERT_EQ(mem_patterns->patterns.size(), 1u);
+      EXPECT_GE(mem_patterns->patterns[0].PeakSize(), kNumBranches * kNumElements * sizeof(float));
+    }
+
+    auto cpu_allocator = session.GetAllocator(OrtMemoryInfo(CPU, OrtArenaAllocator));
+    ASSERT_NE(cpu_allocator, nullptr);
+    const bool is_arena = cpu_allocator->Info().alloc_type == OrtArenaAllocator;
+    AllocatorStats stats_before;
+    cpu_allocator->GetStats(&stats_before);
+
+    NameMLValMap feeds{{"X", input_value}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+    auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    output.assign(result.begin(), result.end());
+
+    AllocatorStats stats_after;
+    cpu_allocator->GetStats(&stats_after);
+    num_allocs = is_arena ? stats_after.num_allocs - stats_before.num_allocs : -1;
+  };
+
+  std::vector<float> static_output;
+  int64_t static_num_allocs = 0;
+  run_first(/*enable_mem_pattern*/ true, /*static_memory_plan*/ true, static_output, static_num_allocs);
+
+  std::vector<float> expected_output;
+  int64_t expected_num_allocs = 0;
+  run_first(/*enable_mem_pattern*/ false, /*static_memory_plan*/ false, expected_output, expected_num_allocs);
+
+  ASSERT_EQ(static_output.size(), input.size());
+  EXPECT_EQ(static_output, expected_output);
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(static_output[i], kNumBranches * std::abs(input[i]));
+  }
+
+  if (static_num_allocs >= 0 && expected_num_allocs >= 0) {
+    // one block for all the branch outputs instead of one allocation for each of them
+    EXPECT_LT(static_num_allocs, expected_num_allocs);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
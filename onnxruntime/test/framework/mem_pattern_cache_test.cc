@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+namespace {
+
+OrtValue MakeInput(std::initializer_list<int64_t> dims) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  OrtValue value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape(dims), allocator, value);
+  return value;
+}
+
+MemoryPatternGroup MakePatternGroup(size_t peak_size) {
+  MemPatternPlanner planner{/*using_counters*/ false};
+  planner.TraceAllocation(0, peak_size);
+  MemoryPatternGroup group;
+  group.locations.push_back(OrtDevice());
+  group.patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+
+}  // namespace
+
+TEST(MemoryPatternCacheTest, ParseBucketPolicy) {
+  MemoryPatternBucketPolicy policy;
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("", policy));
+  EXPECT_FALSE(policy.IsBucketed());
+  EXPECT_EQ(policy.GetBucket(37), 37);
+
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("pow2", policy));
+  EXPECT_TRUE(policy.IsBucketed());
+  EXPECT_EQ(policy.GetBucket(1), 1);
+  EXPECT_EQ(policy.GetBucket(37), 64);
+  EXPECT_EQ(policy.GetBucket(64), 64);
+
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("16,48,128", policy));
+  EXPECT_TRUE(policy.IsBucketed());
+  EXPECT_EQ(policy.GetBucket(3), 16);
+  EXPECT_EQ(policy.GetBucket(17), 48);
+  EXPECT_EQ(policy.GetBucket(128), 128);
+  EXPECT_EQ(policy.GetBucket(129), 129);
+
+  EXPECT_FALSE(MemoryPatternBucketPolicy::Parse("16,8", policy).IsOK());
+  EXPECT_FALSE(MemoryPatternBucketPolicy::Parse("16,abc", policy).IsOK());
+  EXPECT_FALSE(MemoryPatternBucketPolicy::Parse("0", policy).IsOK());
+}
+
+TEST(MemoryPatternCacheTest, ExactModeDoesNotReplace) {
+  MemoryPatternCache cache{MemoryPatternBucketPolicy{}, 0};
+  std::vector<OrtValue> inputs{MakeInput({1, 30})};
+  const auto key = cache.CalculateKey(inputs);
+
+  EXPECT_EQ(cache.Find(key, inputs), nullptr);
+  auto inserted = cache.Insert(key, inputs, MakePatternGroup(256));
+  auto second = cache.Insert(key, inputs, MakePatternGroup(512));
+  EXPECT_EQ(inserted, second);
+  EXPECT_EQ(cache.Find(key, inputs), inserted);
+  EXPECT_EQ(cache.TotalBytes(), 256u);
+
+  std::vector<OrtValue> other_inputs{MakeInput({1, 31})};
+  EXPECT_NE(cache.CalculateKey(other_inputs), key);
+}
+
+TEST(MemoryPatternCacheTest, ExactModeEvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache{MemoryPatternBucketPolicy{}, 512};
+
+  std::vector<OrtValue> a{MakeInput({1, 30})};
+  std::vector<OrtValue> b{MakeInput({1, 31})};
+  const auto key_a = cache.CalculateKey(a);
+  const auto key_b = cache.CalculateKey(b);
+
+  auto a_patterns = cache.Insert(key_a, a, MakePatternGroup(256));
+  cache.Insert(key_b, b, MakePatternGroup(384));
+  EXPECT_EQ(cache.NumEntries(), 1u);
+  EXPECT_EQ(cache.TotalBytes(), 384u);
+  EXPECT_EQ(cache.Find(key_a, a), nullptr);
+  EXPECT_NE(cache.Find(key_b, b), nullptr);
+
+  // the evicted pattern stays valid for whoever still holds it
+  EXPECT_EQ(a_patterns->patterns[0].PeakSize(), 256u);
+}
+
+TEST(MemoryPatternCacheTest, BucketedModeSharesAndGrowsEntries) {
+  MemoryPatternBucketPolicy policy;
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("pow2", policy));
+  MemoryPatternCache cache{std::move(policy), 0};
+
+  std::vector<OrtValue> small{MakeInput({1, 40})};
+  std::vector<OrtValue> smaller{MakeInput({1, 36})};
+  std::vector<OrtValue> large{MakeInput({1, 60})};
+  const auto key = cache.CalculateKey(small);
+  ASSERT_EQ(cache.CalculateKey(smaller), key);
+  ASSERT_EQ(cache.CalculateKey(large), key);
+
+  auto small_patterns = cache.Insert(key, small, MakePatternGroup(160));
+  EXPECT_EQ(cache.Find(key, smaller), small_patterns);
+
+  // inputs larger than the traced ones are a miss so a larger layout gets traced
+  EXPECT_EQ(cache.Find(key, large), nullptr);
+  auto large_patterns = cache.Insert(key, large, MakePatternGroup(240));
+  EXPECT_NE(large_patterns, small_patterns);
+  EXPECT_EQ(cache.Find(key, small), large_patterns);
+  EXPECT_EQ(cache.NumEntries(), 1u);
+  EXPECT_EQ(cache.TotalBytes(), 240u);
+
+  // the previously handed out pattern stays valid
+  EXPECT_EQ(small_patterns->patterns[0].PeakSize(), 160u);
+}
+
+TEST(MemoryPatternCacheTest, BucketedModeReplacesEntryTracedForOtherDims) {
+  MemoryPatternBucketPolicy policy;
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("pow2", policy));
+  MemoryPatternCache cache{std::move(policy), 0};
+
+  std::vector<OrtValue> wide{MakeInput({33, 40})};
+  std::vector<OrtValue> tall{MakeInput({40, 33})};
+  const auto key = cache.CalculateKey(wide);
+  ASSERT_EQ(cache.CalculateKey(tall), key);
+
+  auto wide_patterns = cache.Insert(key, wide, MakePatternGroup(256));
+  EXPECT_EQ(cache.Find(key, tall), nullptr);
+
+  // the new layout replaces the cached one even though it is smaller, as neither covers the inputs of the other
+  auto tall_patterns = cache.Insert(key, tall, MakePatternGroup(192));
+  EXPECT_NE(tall_patterns, wide_patterns);
+  EXPECT_EQ(cache.Find(key, tall), tall_patterns);
+  EXPECT_EQ(cache.Find(key, wide), nullptr);
+  EXPECT_EQ(cache.TotalBytes(), 192u);
+
+  // inputs covered by the cached layout keep it
+  std::vector<OrtValue> covered{MakeInput({36, 33})};
+  EXPECT_EQ(cache.Insert(key, covered, MakePatternGroup(512)), tall_patterns);
+  EXPECT_EQ(cache.TotalBytes(), 192u);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternBucketPolicy policy;
+  ASSERT_STATUS_OK(MemoryPatternBucketPolicy::Parse("32,64,128", policy));
+  MemoryPatternCache cache{std::move(policy), 1024};
+
+  std::vector<OrtValue> a{MakeInput({1, 32})};
+  std::vector<OrtValue> b{MakeInput({1, 64})};
+  std::vector<OrtValue> c{MakeInput({1, 128})};
+  const auto key_a = cache.CalculateKey(a);
+  const auto key_b = cache.CalculateKey(b);
+  const auto key_c = cache.CalculateKey(c);
+
+  cache.Insert(key_a, a, MakePatternGroup(400));
+  cache.Insert(key_b, b, MakePatternGroup(400));
+  // make b the least recently used
+  ASSERT_NE(cache.Find(key_a, a), nullptr);
+
+  cache.Insert(key_c, c, MakePatternGroup(400));
+  EXPECT_EQ(cache.NumEntries(), 2u);
+  EXPECT_EQ(cache.TotalBytes(), 800u);
+  EXPECT_NE(cache.Find(key_a, a), nullptr);
+  EXPECT_EQ(cache.Find(key_b, b), nullptr);
+  EXPECT_NE(cache.Find(key_c, c), nullptr);
+
+  // an entry larger than the budget is still kept as the most recently used one
+  std::vector<OrtValue> d{MakeInput({1, 256})};
+  const auto key_d = cache.CalculateKey(d);
+  cache.Insert(key_d, d, MakePatternGroup(2048));
+  EXPECT_EQ(cache.NumEntries(), 1u);
+  EXPECT_NE(cache.Find(key_d, d), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,11 +1,24 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/session_state.h"
+#include "core/graph/model.h"
+#include "core/platform/threadpool.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 
 #include "gtest/gtest.h"
 
@@ -76,6 +89,70 @@ struct TestOp {
   }
 };
 
+// Test kernel that copies its input and runs a parallel loop with one iteration per thread of the intra-op pool.
+// Each iteration waits, up to a deadline, for all the iterations to run at the same time and records the largest
+// number of iterations it saw running concurrently.
+struct ParallelLoopOp {
+  static constexpr const char* OpName = "ParallelLoopOp";
+  static constexpr const char* OpDomain = "testing";
+
+  static std::atomic<int> max_concurrency;
+
+  static ONNX_NAMESPACE::OpSchema OpSchema() {
+    ONNX_NAMESPACE::OpSchema schema;
+    schema.SetDoc("Copy the input while running a parallel loop.")
+        .SetName(OpName)
+        .SetDomain(OpDomain)
+        .SinceVersion(10)
+        .Input(0, "X", "Input.", "T", OpSchema::Single)
+        .Output(0, "Y", "Copy of the input.", "T", OpSchema::Single)
+        .TypeConstraint("T", {"tensor(float)"}, "Type of the input and output");
+    return schema;
+  }
+
+  class OpKernelImpl final : public OpKernel {
+   public:
+    OpKernelImpl(const OpKernelInfo& info) : OpKernel{info} {}
+
+    Status Compute(OpKernelContext* ctx) const override {
+      const Tensor& X = *ctx->Input<Tensor>(0);
+      Tensor* Y = ctx->Output(0, X.Shape());
+      memcpy(Y->MutableDataRaw(), X.DataRaw(), X.SizeInBytes());
+
+      auto* tp = ctx->GetOperatorThreadPool();
+      const int num_iterations = concurrency::ThreadPool::DegreeOfParallelism(tp);
+      std::atomic<int> active{0};
+      concurrency::ThreadPool::TrySimpleParallelFor(tp, num_iterations, [&](std::ptrdiff_t) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        int seen = ++active;
+        while (seen < num_iterations && std::chrono::steady_clock::now() < deadline) {
+          std::this_thread::yield();
+          seen = std::max(seen, active.load());
+        }
+        int current = max_concurrency.load();
+        while (seen > current && !max_concurrency.compare_exchange_weak(current, seen)) {
+        }
+        --active;
+      });
+
+      return Status::OK();
+    }
+  };
+
+  static KernelDefBuilder KernelDef() {
+    KernelDefBuilder def;
+    def.SetName(OpName)
+        .SetDomain(OpDomain)
+        .SinceVersion(10)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .Provider(onnxruntime::kCpuExecutionProvider);
+
+    return def;
+  }
+};
+
+std::atomic<int> ParallelLoopOp::max_concurrency{0};
+
 // test that the status from TestOp is correctly returned from InferenceSession::Run
 TEST(ParallelExecutor, TestStatusPropagation) {
   auto registry = std::make_shared<CustomRegistry>();
@@ -117,6 +194,184 @@ TEST(ParallelExecutor, TestStatusPropagation) {
   }
 }
 
+// same as TestStatusPropagation with the nodes scheduled by critical path
+TEST(ParallelExecutor, TestStatusPropagationWithCriticalPathScheduling) {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  ASSERT_STATUS_OK(registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11));
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename TestOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = TestOp::KernelDef();
+  ASSERT_STATUS_OK(registry->RegisterCustomKernel(kernel_def, kernel_create_fn));
+
+  onnxruntime::SessionOptions so;
+  so.session_logid = "TestStatusPropagationWithCriticalPathScheduling";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCriticalPathScheduling, "1"));
+
+  {  // test success
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*success*/ 0});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr);
+  }
+
+  {  // test failure
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider}, nullptr,
+               nullptr);
+  }
+
+  {  // test exception
+    OpTester tester{"TestOp", 10, TestOp::OpDomain};
+    tester.AddCustomOpRegistry(registry);
+
+    tester.AddInput<int64_t>("action", {1}, {/*exception*/ 2});
+    tester.AddOutput<int64_t>("action_out", {1}, {0});
+    tester.Run(so, OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider},
+               nullptr, nullptr);
+  }
+}
+
+// run a graph with many independent branches that all consume the graph input and are joined at the end.
+// the input has to stay alive until every branch ran, whatever order the branches run in, and the outputs of
+// branches running concurrently must not share memory even if memory patterns are requested.
+TEST(ParallelExecutor, CriticalPathSchedulingWideGraph) {
+  constexpr int kNumBranches = 8;
+
+  onnxruntime::Model model("wide_graph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<NodeArg*> sum_inputs;
+  for (int i = 0; i < kNumBranches; ++i) {
+    const auto suffix = std::to_string(i);
+    auto& abs_arg = graph.GetOrCreateNodeArg("abs_" + suffix, &float_tensor);
+    auto& neg_arg = graph.GetOrCreateNodeArg("neg_" + suffix, &float_tensor);
+    graph.AddNode("abs_node_" + suffix, "Abs", "", {&input_arg}, {&abs_arg});
+    graph.AddNode("neg_node_" + suffix, "Neg", "", {&abs_arg}, {&neg_arg});
+    sum_inputs.push_back(&neg_arg);
+  }
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum_node", "Sum", "", sum_inputs, {&output_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.session_logid = "CriticalPathSchedulingWideGraph";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  // keep the identical branches from being merged
+  so.graph_optimization_level = TransformerLevel::Default;
+  so.enable_mem_pattern = true;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCriticalPathScheduling, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlan, "1"));
+
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* schedule = session.GetSessionState().GetCriticalPathSchedule();
+  ASSERT_NE(schedule, nullptr);
+  EXPECT_FALSE(session.GetSessionState().GetEnableMemoryPattern());
+  ASSERT_EQ(schedule->NumNodes(), static_cast<size_t>(2 * kNumBranches + 1));
+  EXPECT_EQ(schedule->Roots().size(), static_cast<size_t>(kNumBranches));
+
+  std::vector<float> input{-1.f, 2.f, -3.f, 4.f, -5.f, 6.f};
+  OrtValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 3}, input, &input_value);
+  NameMLValMap feeds{{"X", input_value}};
+
+  for (int run = 0; run < 10; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+    auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(output.size(), input.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+      EXPECT_EQ(output[i], -kNumBranches * std::abs(input[i]));
+    }
+  }
+}
+
+// with a unified thread pool, a chain of nodes scheduled by critical path must leave the pool threads to the
+// parallel loops of the kernels instead of holding them with idle helpers.
+TEST(ParallelExecutor, CriticalPathSchedulingUnifiedThreadPool) {
+  constexpr int kNumNodes = 3;
+  constexpr int kNumThreads = 4;
+
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{ParallelLoopOp::OpSchema()};
+  ASSERT_STATUS_OK(registry->RegisterOpSet(schemas, ParallelLoopOp::OpDomain, 10, 11));
+  KernelCreateFn kernel_create_fn = [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) { out = std::make_unique<typename ParallelLoopOp::OpKernelImpl>(info); return Status::OK(); };
+  auto kernel_def = ParallelLoopOp::KernelDef();
+  ASSERT_STATUS_OK(registry->RegisterCustomKernel(kernel_def, kernel_create_fn));
+
+  IOnnxRuntimeOpSchemaRegistryList custom_schema_registries = {registry->GetOpschemaRegistry()};
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 12}, {ParallelLoopOp::OpDomain, 10}};
+  onnxruntime::Model model("unified_chain", false, ModelMetaData(), PathString(), custom_schema_registries,
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  NodeArg* input_arg = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  for (int i = 0; i < kNumNodes; ++i) {
+    const auto suffix = std::to_string(i);
+    auto& output_arg = graph.GetOrCreateNodeArg(i + 1 == kNumNodes ? "Y" : "chain_" + suffix, &float_tensor);
+    graph.AddNode("node_" + suffix, ParallelLoopOp::OpName, "", {input_arg}, {&output_arg}, nullptr,
+                  ParallelLoopOp::OpDomain);
+    input_arg = &output_arg;
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  so.session_logid = "CriticalPathSchedulingUnifiedThreadPool";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.intra_op_param.thread_pool_size = kNumThreads;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCriticalPathScheduling, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUnifiedThreadPool, "1"));
+
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.RegisterCustomRegistry(registry));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+  ASSERT_NE(session.GetSessionState().GetCriticalPathSchedule(), nullptr);
+  ASSERT_EQ(concurrency::ThreadPool::DegreeOfParallelism(session.GetSessionState().GetThreadPool()), kNumThreads);
+
+  std::vector<float> input{1.f, 2.f, 3.f};
+  OrtValue input_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3}, input, &input_value);
+  NameMLValMap feeds{{"X", input_value}};
+
+  ParallelLoopOp::max_concurrency = 0;
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+  auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_TRUE(std::equal(output.begin(), output.end(), input.begin(), input.end()));
+
+  // every thread of the pool ran an iteration of the loop of the same node at the same time
+  EXPECT_EQ(ParallelLoopOp::max_concurrency.load(), kNumThreads);
+}
+
 class ParallelExecutorThreadPoolTest : public testing::TestWithParam<int> {
 };
 
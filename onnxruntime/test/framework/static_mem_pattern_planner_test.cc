@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(StaticMemPatternPlannerTest, ReusesMemoryOfBuffersWithDisjointLifetimes) {
+  StaticMemPatternPlanner planner;
+  // a chain where each buffer is released after the next one is produced
+  planner.AddBuffer(0, 256, 0, 1);
+  planner.AddBuffer(1, 128, 1, 2);
+  planner.AddBuffer(2, 256, 2, 3);
+
+  const auto pattern = planner.GenerateMemPattern();
+  EXPECT_EQ(pattern.PeakSize(), 384u);
+
+  const auto* block_0 = pattern.GetBlock(0);
+  const auto* block_1 = pattern.GetBlock(1);
+  const auto* block_2 = pattern.GetBlock(2);
+  ASSERT_NE(block_0, nullptr);
+  ASSERT_NE(block_1, nullptr);
+  ASSERT_NE(block_2, nullptr);
+
+  // buffers 0 and 2 are never live at the same time so they share a block
+  EXPECT_EQ(block_0->offset_, block_2->offset_);
+  EXPECT_EQ(block_1->offset_, 256u);
+  EXPECT_EQ(block_1->size_, 128u);
+}
+
+TEST(StaticMemPatternPlannerTest, PlacesBufferInBestFittingGap) {
+  StaticMemPatternPlanner planner;
+  planner.AddBuffer(0, 512, 0, 4);
+  planner.AddBuffer(1, 256, 0, 1);
+  planner.AddBuffer(2, 200, 2, 4);
+  planner.AddBuffer(3, 128, 0, 4);
+  planner.AddBuffer(4, 48, 2, 2);
+
+  const auto pattern = planner.GenerateMemPattern();
+  // buffer 2 reuses the block of buffer 1, which leaves a 56 byte gap below buffer 3
+  EXPECT_EQ(pattern.GetBlock(1)->offset_, 512u);
+  EXPECT_EQ(pattern.GetBlock(2)->offset_, 512u);
+  EXPECT_EQ(pattern.GetBlock(3)->offset_, 768u);
+  EXPECT_EQ(pattern.GetBlock(4)->offset_, 712u);
+  EXPECT_EQ(pattern.PeakSize(), 896u);
+}
+
+TEST(StaticMemPatternPlannerTest, LiveBuffersNeverOverlap) {
+  StaticMemPatternPlanner planner;
+  constexpr int kNumBuffers = 64;
+  for (int i = 0; i < kNumBuffers; ++i) {
+    const size_t start = static_cast<size_t>(i % 7);
+    planner.AddBuffer(i, static_cast<size_t>(64 * (1 + (i * 37) % 11)), start, start + static_cast<size_t>(i % 5));
+  }
+  planner.AddBuffer(kNumBuffers, 0, 0, 20);
+
+  const auto pattern = planner.GenerateMemPattern();
+  ASSERT_EQ(pattern.GetPatternsMap().size(), static_cast<size_t>(kNumBuffers + 1));
+  EXPECT_EQ(pattern.GetBlock(kNumBuffers)->size_, 0u);
+
+  for (int i = 0; i < kNumBuffers; ++i) {
+    const size_t start_i = static_cast<size_t>(i % 7);
+    const size_t end_i = start_i + static_cast<size_t>(i % 5);
+    const auto& block_i = *pattern.GetBlock(i);
+    EXPECT_LE(block_i.offset_ + block_i.size_, pattern.PeakSize());
+
+    for (int j = i + 1; j < kNumBuffers; ++j) {
+      const size_t start_j = static_cast<size_t>(j % 7);
+      const size_t end_j = start_j + static_cast<size_t>(j % 5);
+      if (start_i > end_j || start_j > end_i) {
+        continue;
+      }
+
+      const auto& block_j = *pattern.GetBlock(j);
+      EXPECT_TRUE(block_i.offset_ + block_i.size_ <= block_j.offset_ ||
+                  block_j.offset_ + block_j.size_ <= block_i.offset_)
+          << "buffers " << i << " and " << j << " are live at the same time but overlap in memory";
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
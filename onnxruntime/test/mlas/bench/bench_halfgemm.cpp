@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <numeric>
+
+static const std::vector<std::string> halfgemm_bench_arg_names = {"M", "N", "K"};
+
+static std::vector<MLAS_FP16> RandomHalfVector(size_t size) {
+  auto values = RandomVectorUniform(size, -1.0f, 1.0f);
+  std::vector<MLAS_FP16> halves(size);
+  MlasConvertFloatToHalfBuffer(values.data(), halves.data(), size);
+  return halves;
+}
+
+void HALFGEMM(benchmark::State& state, bool with_bias) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  if (!MlasHalfGemmSupported()) {
+    state.SkipWithError("half precision GEMM is not accelerated on this CPU");
+    return;
+  }
+
+  auto A = RandomHalfVector(M * K);
+  auto B = RandomHalfVector(N * K);
+  auto Bias = RandomHalfVector(N);
+  std::vector<MLAS_FP16> C(M * N);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  MLAS_HALF_GEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.B = B.data();
+  data.ldb = N;
+  data.C = C.data();
+  data.ldc = N;
+  data.Bias = with_bias ? Bias.data() : nullptr;
+
+  MlasHalfGemmBatch(M, N, K, 1, &data, tp.get());
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &data, tp.get());
+  }
+}
+
+static void HalfGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  b->ArgsProduct({{1}, {63, 255, 1023}, {63, 255, 1023}});
+  b->ArgsProduct({{63, 255, 1023}, {1}, {63, 255, 1023}});
+  b->ArgsProduct({{63, 255, 1023}, {63, 255, 1023}, {1}});
+}
+
+static void HalfGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  b->ArgsProduct({{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_Bias, true)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, GEMV, false)->Apply(HalfGemmSizeWithOne)->UseRealTime();
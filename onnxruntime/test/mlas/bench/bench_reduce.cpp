@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+
+static const std::vector<std::string> reduce_bench_arg_names = {"Outer", "Reduce", "Inner", "Threads"};
+
+void REDUCE(benchmark::State& state, MLAS_REDUCTION_KIND kind) {
+  if (state.range(0) <= 0) throw std::invalid_argument("Outer must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("Reduce must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("Inner must greater than 0!");
+  const size_t outer = static_cast<size_t>(state.range(0));
+  const size_t reduce = static_cast<size_t>(state.range(1));
+  const size_t inner = static_cast<size_t>(state.range(2));
+  const int threads = static_cast<int>(state.range(3));
+
+  auto input = RandomVectorUniform(outer * reduce * inner, -4.0f, 4.0f);
+  std::vector<float> output(outer * inner);
+
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp;
+  if (threads > 1) {
+    OrtThreadPoolParams tpo;
+    tpo.thread_pool_size = threads;
+    tpo.auto_set_affinity = true;
+    tp = onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                    tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP);
+  }
+
+  MlasReduce(kind, input.data(), output.data(), outer, reduce, inner, tp.get());
+
+  for (auto _ : state) {
+    MlasReduce(kind, input.data(), output.data(), outer, reduce, inner, tp.get());
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(input.size() * sizeof(float)));
+}
+
+// Contiguous reductions of the last axis (KR) and strided reductions of the
+// first (RK) or a middle axis (KRK).
+static void ReduceSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(reduce_bench_arg_names);
+  for (int threads : {1, 8}) {
+    b->Args({4096, 768, 1, threads});
+    b->Args({64, 65536, 1, threads});
+    b->Args({1, 4096, 768, threads});
+    b->Args({1, 65536, 64, threads});
+    b->Args({32, 512, 768, threads});
+    b->Args({128, 49, 256, threads});
+    b->Args({256, 64, 3, threads});
+  }
+}
+
+BENCHMARK_CAPTURE(REDUCE, Sum, MlasSumReduction)->Apply(ReduceSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REDUCE, Mean, MlasMeanReduction)->Apply(ReduceSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REDUCE, Max, MlasMaximumReduction)->Apply(ReduceSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REDUCE, Min, MlasMinimumReduction)->Apply(ReduceSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REDUCE, LogSumExp, MlasLogSumExpReduction)->Apply(ReduceSizes)->UseRealTime();
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <numeric>
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+static const std::vector<std::string> sbgemm_bench_arg_names = {"M", "N", "K"};
+
+void SBGEMM(benchmark::State& state, bool pack_b, bool with_bias) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  if (!MlasBf16AccelerationSupported()) {
+    state.SkipWithError("bfloat16 GEMM is not supported on this CPU");
+    return;
+  }
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  auto Bias = RandomVectorUniform(static_cast<size_t>(N), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<uint8_t> B_packed;
+
+  MLAS_SBGEMM_DATA_PARAMS data;
+  data.AIsfp32 = true;
+  data.A = A.data();
+  data.lda = K;
+  data.C = C.data();
+  data.ldc = N;
+  data.Bias = with_bias ? Bias.data() : nullptr;
+
+  if (pack_b) {
+    B_packed.resize(MlasSBGemmPackBSize(N, K));
+    MlasSBGemmConvertPackB(N, K, B.data(), N, B_packed.data());
+    data.B = B_packed.data();
+    data.BIsfp32 = false;
+  } else {
+    data.B = B.data();
+    data.ldb = N;
+    data.BIsfp32 = true;
+  }
+
+  MlasSBGemmBatch(M, N, K, 1, &data, tp.get());
+
+  for (auto _ : state) {
+    MlasSBGemmBatch(M, N, K, 1, &data, tp.get());
+  }
+}
+
+static void SBGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  b->ArgsProduct({{1}, {63, 255, 1023}, {63, 255, 1023}});
+  b->ArgsProduct({{63, 255, 1023}, {1}, {63, 255, 1023}});
+  b->ArgsProduct({{63, 255, 1023}, {63, 255, 1023}, {1}});
+}
+
+static void SBGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  b->ArgsProduct({{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(SBGEMM, NORMAL, false, false)->Apply(SBGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, NORMAL_Bias, false, true)->Apply(SBGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, GEMV, false, false)->Apply(SBGemmSizeWithOne)->UseRealTime();
+
+BENCHMARK_CAPTURE(SBGEMM, PACKB, true, false)->Apply(SBGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, PACKB_Bias, true, true)->Apply(SBGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, PACKB_GEMV, true, false)->Apply(SBGemmSizeWithOne)->UseRealTime();
+
+static void SBGemmLLMSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  b->ArgsProduct({{1, 1024, 2048}, {4096, 11008}, {4096, 11008}});
+}
+
+BENCHMARK_CAPTURE(SBGEMM, LLM, true, false)->Apply(SBGemmLLMSizeProducts)->UseRealTime();
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
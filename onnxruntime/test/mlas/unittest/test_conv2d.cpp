@@ -3,6 +3,146 @@
 
 #include "test_conv2d.h"
 #include "test_conv2d_fixture.h"
+#include "core/mlas/lib/mlasi.h"
+
+#if defined(MLAS_TARGET_AMD64) && !defined(__APPLE__) && !defined(ORT_MINIMAL_BUILD)
+
+//
+// Tests the AMX kernel of the symmetric quantized convolution with unsigned
+// inputs. The test selects the AMX dispatch explicitly, which the platform
+// enables only if both the processor and the operating system support AMX.
+//
+class MlasConvSymAmxTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint8_t> BufferInput;
+  MatrixGuardBuffer<int8_t> BufferFilter;
+  MatrixGuardBuffer<int8_t> BufferPackedFilter;
+  MatrixGuardBuffer<uint8_t> BufferOutput;
+
+  void Test(size_t InputChannels, size_t OutputChannels, size_t KernelSize, size_t OutputCount, bool PerChannelScale) {
+    const size_t PackedFilterSize = MlasConvSymPackWSize(1, InputChannels, OutputChannels, KernelSize, false);
+    ASSERT_NE(PackedFilterSize, size_t{0});
+
+    std::default_random_engine generator(static_cast<unsigned>(InputChannels * OutputChannels + OutputCount));
+    std::uniform_int_distribution<int> input_distribution(0, 255);
+    std::uniform_int_distribution<int> filter_distribution(-127, 127);
+
+    //
+    // Convolutions with a single kernel position read the input pixels
+    // directly, the others through an indirection buffer of random pixels.
+    //
+
+    const bool InputDirect = (KernelSize == 1);
+    const size_t PixelCount = InputDirect ? OutputCount : 23;
+
+    uint8_t* Input = BufferInput.GetBuffer(PixelCount * InputChannels);
+    for (size_t i = 0; i < PixelCount * InputChannels; i++) {
+      Input[i] = static_cast<uint8_t>(input_distribution(generator));
+    }
+
+    std::vector<const void*> Indirection(OutputCount * KernelSize);
+    std::uniform_int_distribution<size_t> pixel_distribution(0, PixelCount - 1);
+    for (size_t i = 0; i < Indirection.size(); i++) {
+      Indirection[i] = InputDirect ? Input + i * InputChannels : Input + pixel_distribution(generator) * InputChannels;
+    }
+
+    // the filter is [OutputChannels, InputChannels, KernelSize]
+    int8_t* Filter = BufferFilter.GetBuffer(OutputChannels * InputChannels * KernelSize);
+    for (size_t i = 0; i < OutputChannels * InputChannels * KernelSize; i++) {
+      Filter[i] = static_cast<int8_t>(filter_distribution(generator));
+    }
+
+    int8_t* PackedFilter = BufferPackedFilter.GetBuffer(PackedFilterSize);
+    MlasConvSymPackW(1, InputChannels, OutputChannels, KernelSize, Filter, PackedFilter, PackedFilterSize, false);
+
+    std::vector<int32_t> Bias(OutputChannels);
+    std::vector<float> Scale(OutputChannels);
+    std::uniform_int_distribution<int32_t> bias_distribution(-20000, 20000);
+    std::uniform_real_distribution<float> scale_distribution(0.5f, 1.5f);
+    const float BaseScale = 64.0f / (10000.0f * std::sqrt(float(InputChannels * KernelSize)));
+    for (size_t oc = 0; oc < OutputChannels; oc++) {
+      Bias[oc] = bias_distribution(generator);
+      Scale[oc] = BaseScale * scale_distribution(generator);
+    }
+
+    constexpr int32_t OutputZeroPoint = 117;
+
+    uint8_t* Output = BufferOutput.GetBuffer(OutputCount * OutputChannels, true);
+
+    MLAS_CONV_SYM_PARAMS Params = {};
+    Params.InputDirect = InputDirect ? Input : nullptr;
+    Params.InputIndirection = InputDirect ? nullptr : Indirection.data();
+    Params.Filter = PackedFilter;
+    Params.Output = Output;
+    Params.InputChannels = InputChannels;
+    Params.OutputChannels = OutputChannels;
+    Params.OutputCount = OutputCount;
+    Params.KernelSize = KernelSize;
+    Params.Bias = Bias.data();
+    Params.Scale = Scale.data();
+    Params.PerChannelScale = PerChannelScale;
+    Params.OutputZeroPoint = OutputZeroPoint;
+    Params.InputIsSigned = false;
+
+    MlasConvSym(Params);
+
+    for (size_t m = 0; m < OutputCount; m++) {
+      for (size_t oc = 0; oc < OutputChannels; oc++) {
+        int32_t Accumulator = Bias[oc];
+        for (size_t k = 0; k < KernelSize; k++) {
+          const uint8_t* pixel = static_cast<const uint8_t*>(Indirection[m * KernelSize + k]);
+          for (size_t ic = 0; ic < InputChannels; ic++) {
+            Accumulator += int32_t(pixel[ic]) * int32_t(Filter[(oc * InputChannels + ic) * KernelSize + k]);
+          }
+        }
+
+        float Value = float(Accumulator) * (PerChannelScale ? Scale[oc] : Scale[0]);
+        Value = std::min(std::max(Value, float(0 - OutputZeroPoint)), float(255 - OutputZeroPoint));
+        const int32_t Expected = int32_t(std::nearbyint(Value)) + OutputZeroPoint;
+
+        ASSERT_EQ(int32_t(Output[m * OutputChannels + oc]), Expected)
+            << " InputChannels=" << InputChannels << " OutputChannels=" << OutputChannels
+            << " KernelSize=" << KernelSize << " OutputCount=" << OutputCount
+            << " PerChannelScale=" << PerChannelScale << " m=" << m << " oc=" << oc;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("ConvSymAmx");
+    return suite_name.c_str();
+  }
+
+  static bool IsAmxEnabled() {
+    return GetMlasPlatform().GemmU8S8Dispatch == &MlasGemmU8S8DispatchAmx;
+  }
+
+  void ExecuteShort(void) override {
+    const MLAS_CONV_SYM_DISPATCH* Dispatch = GetMlasPlatform().ConvSymU8S8Dispatch;
+    GetMlasPlatform().ConvSymU8S8Dispatch = &MlasConvSymDispatchAmx;
+
+    //
+    // Cover partial tiles along the input channels (not a multiple of 64),
+    // partial blocks of 16 output channels, more than the 64 output channels
+    // of one kernel call and fewer than 16 output pixels.
+    //
+
+    for (size_t InputChannels : {4, 60, 64, 68, 132}) {
+      for (size_t OutputChannels : {16, 20, 36, 64, 84}) {
+        for (size_t KernelSize : {1, 9}) {
+          for (size_t OutputCount : {1, 5, 16, 21, 37}) {
+            Test(InputChannels, OutputChannels, KernelSize, OutputCount, OutputChannels % 8 == 4);
+          }
+        }
+      }
+    }
+
+    GetMlasPlatform().ConvSymU8S8Dispatch = Dispatch;
+  }
+};
+
+#endif
 
 static size_t Conv2dRegistLongExecute() {
   size_t count = MlasLongExecuteTests<MlasConv2DTest<false>>::RegisterLongExecute();
@@ -20,6 +160,15 @@ static size_t Conv2dRegistShortExecute() {
   return count;
 }
 
+static size_t ConvSymAmxRegistShortExecute() {
+#if defined(MLAS_TARGET_AMD64) && !defined(__APPLE__) && !defined(ORT_MINIMAL_BUILD)
+  if (MlasConvSymAmxTest::IsAmxEnabled()) {
+    return MlasDirectShortExecuteTests<MlasConvSymAmxTest>::RegisterShortExecute();
+  }
+#endif
+  return 0;
+}
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
-  return is_short_execute ? Conv2dRegistShortExecute() : Conv2dRegistLongExecute();
+  return is_short_execute ? Conv2dRegistShortExecute() + ConvSymAmxRegistShortExecute() : Conv2dRegistLongExecute();
 });
@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Compares MlasFlashAttention with a naive attention that computes the whole
+// score matrix. The block sizes are small so that the query blocks span
+// several heads of a group and the last block of K and V is partial.
+//
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorkspace;
+  MLAS_THREADPOOL* threadpool_;
+
+  struct Params {
+    int batch_size;
+    int num_heads;
+    int kv_num_heads;
+    int q_sequence_length;
+    int kv_sequence_length;
+    int qk_head_size;
+    int v_head_size;
+    int q_block_size;
+    int kv_block_size;
+    bool is_causal = false;
+    int local_window_size = -1;
+    float softcap = 0.0f;
+    std::vector<int> kv_sequence_lengths = {};
+    size_t query_padding = 0;  // extra elements between batches of the query
+  };
+
+  static std::string ToString(const Params& p) {
+    std::stringstream ss;
+    ss << "B" << p.batch_size << "/N" << p.num_heads << "/Nkv" << p.kv_num_heads << "/S" << p.q_sequence_length
+       << "/T" << p.kv_sequence_length << "/Hqk" << p.qk_head_size << "/Hv" << p.v_head_size << "/Br" << p.q_block_size
+       << "/Bc" << p.kv_block_size << "/causal" << p.is_causal << "/window" << p.local_window_size
+       << "/softcap" << p.softcap << "/kv_lengths" << p.kv_sequence_lengths.size();
+    return ss.str();
+  }
+
+  void ReferenceAttention(const Params& p, size_t query_batch_stride, float scale,
+                          const float* Query, const float* Key, const float* Value, float* Output) {
+    const int group_size = p.num_heads / p.kv_num_heads;
+    std::vector<double> scores(p.kv_sequence_length);
+
+    for (int b = 0; b < p.batch_size; b++) {
+      const int kv_length = p.kv_sequence_lengths.empty() ? p.kv_sequence_length : p.kv_sequence_lengths[b];
+      const int causal_offset = std::max(kv_length - p.q_sequence_length, 0);
+
+      for (int n = 0; n < p.num_heads; n++) {
+        const int kv_head = n / group_size;
+        const float* k = Key + (size_t(b) * p.kv_num_heads + kv_head) * p.kv_sequence_length * p.qk_head_size;
+        const float* v = Value + (size_t(b) * p.kv_num_heads + kv_head) * p.kv_sequence_length * p.v_head_size;
+
+        for (int s = 0; s < p.q_sequence_length; s++) {
+          const float* q = Query + b * query_batch_stride + (size_t(n) * p.q_sequence_length + s) * p.qk_head_size;
+          float* out = Output + ((size_t(b) * p.q_sequence_length + s) * p.num_heads + n) * p.v_head_size;
+
+          int lo = 0;
+          int hi = kv_length;
+          if (p.is_causal) {
+            const int position = causal_offset + s;
+            hi = std::min(position + 1, kv_length);
+            if (p.local_window_size >= 0) {
+              lo = std::max(position - p.local_window_size, 0);
+            }
+          }
+
+          std::fill_n(out, p.v_head_size, 0.0f);
+          if (lo >= hi) {
+            continue;
+          }
+
+          double max_score = -std::numeric_limits<double>::infinity();
+          for (int j = lo; j < hi; j++) {
+            double dot = 0.0;
+            for (int h = 0; h < p.qk_head_size; h++) {
+              dot += double(q[h]) * double(k[size_t(j) * p.qk_head_size + h]);
+            }
+            double score = dot * scale;
+            if (p.softcap > 0.0f) {
+              score = p.softcap * std::tanh(score / p.softcap);
+            }
+            scores[j] = score;
+            max_score = std::max(max_score, score);
+          }
+
+          double sum = 0.0;
+          for (int j = lo; j < hi; j++) {
+            scores[j] = std::exp(scores[j] - max_score);
+            sum += scores[j];
+          }
+
+          for (int h = 0; h < p.v_head_size; h++) {
+            double acc = 0.0;
+            for (int j = lo; j < hi; j++) {
+              acc += scores[j] * double(v[size_t(j) * p.v_head_size + h]);
+            }
+            out[h] = float(acc / sum);
+          }
+        }
+      }
+    }
+  }
+
+  void Test(const Params& p) {
+    const size_t query_batch_stride = size_t(p.num_heads) * p.q_sequence_length * p.qk_head_size + p.query_padding;
+    const size_t query_size = query_batch_stride * p.batch_size;
+    const size_t key_size = size_t(p.batch_size) * p.kv_num_heads * p.kv_sequence_length * p.qk_head_size;
+    const size_t value_size = size_t(p.batch_size) * p.kv_num_heads * p.kv_sequence_length * p.v_head_size;
+    const size_t output_size = size_t(p.batch_size) * p.q_sequence_length * p.num_heads * p.v_head_size;
+
+    float* Query = BufferQuery.GetBuffer(query_size);
+    float* Key = BufferKey.GetBuffer(key_size);
+    float* Value = BufferValue.GetBuffer(value_size);
+    float* Output = BufferOutput.GetBuffer(output_size);
+    float* OutputReference = BufferOutputReference.GetBuffer(output_size);
+
+    std::default_random_engine generator(static_cast<unsigned>(query_size + key_size));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+    for (size_t i = 0; i < query_size; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < key_size; i++) {
+      Key[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < value_size; i++) {
+      Value[i] = distribution(generator);
+    }
+    std::fill_n(Output, output_size, std::numeric_limits<float>::quiet_NaN());
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(p.qk_head_size));
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = p.batch_size;
+    args.num_heads = p.num_heads;
+    args.kv_num_heads = p.kv_num_heads;
+    args.q_sequence_length = p.q_sequence_length;
+    args.kv_sequence_length = p.kv_sequence_length;
+    args.qk_head_size = p.qk_head_size;
+    args.v_head_size = p.v_head_size;
+    args.q_block_size = p.q_block_size;
+    args.kv_block_size = p.kv_block_size;
+    args.scale = scale;
+    args.softcap = p.softcap;
+    args.is_causal = p.is_causal;
+    args.local_window_size = p.local_window_size;
+    args.thread_count = Threaded ? 8 : 1;
+    args.buffer_size_per_thread = (size_t(p.q_block_size) * 2 + size_t(p.q_block_size) * p.kv_block_size +
+                                   size_t(p.q_block_size) * p.v_head_size) *
+                                  sizeof(float);
+    args.buffer = BufferWorkspace.GetBuffer(args.buffer_size_per_thread * args.thread_count / sizeof(float));
+    args.query_batch_stride = query_batch_stride;
+    args.kv_sequence_lengths = p.kv_sequence_lengths.empty() ? nullptr : p.kv_sequence_lengths.data();
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+
+    MlasFlashAttention(&args, threadpool_);
+    ReferenceAttention(p, query_batch_stride, scale, Query, Key, Value, OutputReference);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t i = 0; i < output_size; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << ToString(p) << " @" << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    // multi-head attention, q and kv blocks that do not divide the sequences.
+    Test({2, 3, 3, 5, 7, 8, 6, 4, 3});
+    Test({1, 2, 2, 17, 33, 16, 16, 8, 8});
+
+    // grouped query attention, the query blocks span the heads of a group.
+    Test({2, 6, 2, 5, 9, 8, 8, 4, 4});
+    Test({2, 8, 1, 3, 11, 4, 4, 5, 4});
+
+    // causal prompt.
+    Test({2, 4, 2, 7, 7, 8, 8, 3, 2, true});
+    Test({1, 6, 3, 13, 13, 16, 16, 8, 5, true});
+
+    // causal with a longer key sequence, e.g. a prompt appended to a KV cache.
+    Test({2, 4, 2, 4, 10, 8, 8, 3, 3, true});
+
+    // local window.
+    Test({2, 4, 2, 9, 9, 8, 8, 4, 2, true, 3});
+    Test({1, 4, 1, 6, 20, 8, 8, 5, 4, true, 0});
+    Test({1, 2, 2, 16, 16, 8, 8, 16, 4, true, 5});
+
+    // softcap, with and without causal masking.
+    Test({2, 4, 2, 5, 9, 8, 8, 4, 4, false, -1, 1.5f});
+    Test({2, 4, 4, 6, 6, 8, 8, 3, 4, true, 2, 0.5f});
+
+    // token generation over a KV cache longer than the valid keys of each batch.
+    Test({3, 4, 2, 1, 37, 8, 8, 2, 8, true, -1, 0.0f, {37, 20, 1}});
+    Test({2, 8, 2, 1, 64, 16, 16, 4, 16, true, 7, 2.0f, {64, 9}});
+
+    // prompt over a KV cache with per batch lengths, one of which is empty.
+    Test({3, 4, 2, 3, 12, 8, 8, 4, 5, true, -1, 0.0f, {12, 5, 0}});
+
+    // query batches further apart than their size, as in packed QKV.
+    Test({2, 4, 2, 3, 8, 8, 8, 4, 3, true, -1, 0.0f, {8, 6}, 2 * 3 * 8 * 2});
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
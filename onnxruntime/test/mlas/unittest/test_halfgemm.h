@@ -17,6 +17,7 @@ Abstract:
 #pragma once
 
 #include "test_fp16.h"
+#include "core/mlas/lib/mlasi.h"
 
 /**
  * @brief Test class for half precision GEMM
@@ -34,6 +35,20 @@ class MlasHalfGemmTest : public MlasTestBase {
   MatrixGuardBuffer<float> BufferCReference;
   MatrixGuardBuffer<float> BufferFloatC;
   MLAS_THREADPOOL* threadpool_;
+  const bool accumulate_fp32_;
+
+  //
+  // The x64 F16C kernel has no half precision arithmetic, it accumulates in
+  // single precision and rounds to half precision only when it stores C.
+  // The other kernels accumulate in half precision.
+  //
+  static bool KernelAccumulatesFp32() {
+#if defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().HalfGemmDispatch == &MlasHalfGemmDispatchAvx2;
+#else
+    return false;
+#endif
+  }
 
   void* PackB(size_t N, size_t K, const BType* B, size_t ldb) {
     size_t PackedBSize = MlasHalfGemmPackBSize(N, K, std::is_same<BType, float>::value);
@@ -131,14 +146,22 @@ class MlasHalfGemmTest : public MlasTestBase {
             float sum = 0.0f;
             if (k == 0 && Bias != nullptr) {
               sum = float(Bias[n]);
+            } else if (k != 0 && accumulate_fp32_) {
+              // the single precision kernel resumes from the rounded partial result.
+              sum = *c;
             }
             for (size_t kk = 0; kk < std::min(KStride, K - k); kk++) {
-              MLFp16 down(float(*b) * float(*a) + sum);
-              sum = float(down);
+              if (accumulate_fp32_) {
+                sum += float(*b) * float(*a);
+              } else {
+                MLFp16 down(float(*b) * float(*a) + sum);
+                sum = float(down);
+              }
               b += N;
               a += 1;
             }
-            if (k == 0) {
+            sum = float(MLFp16(sum));
+            if (k == 0 || accumulate_fp32_) {
               *c = sum;
             } else {
               MLFp16 d(sum + *c);
@@ -154,7 +177,7 @@ class MlasHalfGemmTest : public MlasTestBase {
   }
 
  public:
-  MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+  MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr), accumulate_fp32_(KernelAccumulatesFp32()) {}
 
   void Test(size_t M, size_t N, size_t K, size_t BatchSize, bool withBias) {
     const AType* A = BufferA.GetFilledBuffer(K * M * BatchSize + 16, SmallFloatFill<AType>);
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+// T is float or MLFp16, the test helper type with the layout of MLAS_FP16.
+template <typename T>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  using MlasType = std::conditional_t<std::is_same_v<T, float>, float, MLAS_FP16>;
+
+  MatrixGuardBuffer<T> BufferInput;
+  MatrixGuardBuffer<T> BufferSkip;
+  MatrixGuardBuffer<float> BufferSkipBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<T> BufferOutput;
+  MatrixGuardBuffer<T> BufferSkipOutput;
+
+  static float ToFloat(T Value) {
+    if constexpr (std::is_same_v<T, float>) {
+      return Value;
+    } else {
+      return Value.ToFloat();
+    }
+  }
+
+  void Test(size_t D, bool HasSkip, bool HasSkipBias, bool HasBias, bool Simplified) {
+    T* Input = BufferInput.GetBuffer(D);
+    T* Skip = HasSkip ? BufferSkip.GetBuffer(D) : nullptr;
+    float* SkipBias = HasSkipBias ? BufferSkipBias.GetBuffer(D) : nullptr;
+    float* Scale = BufferScale.GetBuffer(D);
+    float* Bias = HasBias ? BufferBias.GetBuffer(D) : nullptr;
+    T* Output = BufferOutput.GetBuffer(D);
+    T* SkipOutput = (HasSkip || HasSkipBias) ? BufferSkipOutput.GetBuffer(D) : nullptr;
+
+    std::default_random_engine generator(static_cast<unsigned>(D));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t d = 0; d < D; d++) {
+      Input[d] = T(distribution(generator) + 1.0f);
+      if (Skip != nullptr) {
+        Skip[d] = T(distribution(generator));
+      }
+      if (SkipBias != nullptr) {
+        SkipBias[d] = distribution(generator);
+      }
+      Scale[d] = distribution(generator);
+      if (Bias != nullptr) {
+        Bias[d] = distribution(generator);
+      }
+    }
+
+    constexpr float Epsilon = 1e-5f;
+    float Mean;
+    float InvStdDev;
+    MlasLayerNormalization(reinterpret_cast<const MlasType*>(Input), reinterpret_cast<const MlasType*>(Skip),
+                           SkipBias, Scale, Bias,
+                           reinterpret_cast<MlasType*>(Output), reinterpret_cast<MlasType*>(SkipOutput),
+                           D, Epsilon, Simplified, &Mean, &InvStdDev);
+
+    std::vector<double> Values(D);
+    double Sum = 0.0;
+    double SumSquare = 0.0;
+    for (size_t d = 0; d < D; d++) {
+      double v = ToFloat(Input[d]);
+      if (Skip != nullptr) {
+        v += ToFloat(Skip[d]);
+      }
+      if (SkipBias != nullptr) {
+        v += SkipBias[d];
+      }
+      Values[d] = v;
+      Sum += v;
+      SumSquare += v * v;
+    }
+
+    const double MeanReference = Sum / D;
+    const double Variance = Simplified ? SumSquare / D : SumSquare / D - MeanReference * MeanReference;
+    const double InvStdDevReference = 1.0 / std::sqrt(Variance + Epsilon);
+
+    constexpr float Tolerance = std::is_same_v<T, float> ? 1e-4f : 1e-2f;
+
+    ASSERT_NEAR(InvStdDev, InvStdDevReference, 1e-4 * InvStdDevReference) << " D=" << D;
+    if (!Simplified) {
+      ASSERT_NEAR(Mean, MeanReference, 1e-4) << " D=" << D;
+    }
+
+    for (size_t d = 0; d < D; d++) {
+      double Expected = (Values[d] - (Simplified ? 0.0 : MeanReference)) * InvStdDevReference * Scale[d];
+      if (Bias != nullptr && !Simplified) {
+        Expected += Bias[d];
+      }
+      ASSERT_NEAR(ToFloat(Output[d]), Expected, Tolerance * (1.0 + std::fabs(Expected)))
+          << " D=" << D << " d=" << d << " Skip=" << HasSkip << " SkipBias=" << HasSkipBias
+          << " Bias=" << HasBias << " Simplified=" << Simplified;
+      if (SkipOutput != nullptr) {
+        ASSERT_NEAR(ToFloat(SkipOutput[d]), Values[d], Tolerance * (1.0 + std::fabs(Values[d])))
+            << " D=" << D << " d=" << d;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::is_same_v<T, float> ? "LayerNorm_Fp32" : "LayerNorm_Fp16");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t d : {1, 3, 4, 15, 64, 255, 256, 257, 768, 1000, 4096}) {
+      for (int mask = 0; mask < 16; mask++) {
+        Test(d, (mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0, (mask & 8) != 0);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<float>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLFp16>>::RegisterShortExecute();
+  }
+  return count;
+});
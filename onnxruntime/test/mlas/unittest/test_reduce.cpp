@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static const char* KindName(MLAS_REDUCTION_KIND Kind) {
+    switch (Kind) {
+      case MlasSumReduction:
+        return "Sum";
+      case MlasMeanReduction:
+        return "Mean";
+      case MlasMaximumReduction:
+        return "Maximum";
+      case MlasMinimumReduction:
+        return "Minimum";
+      default:
+        return "LogSumExp";
+    }
+  }
+
+  static double Reference(MLAS_REDUCTION_KIND Kind, const float* Input, size_t ReduceCount, size_t InnerCount) {
+    double Value = Input[0];
+    switch (Kind) {
+      case MlasSumReduction:
+      case MlasMeanReduction:
+        for (size_t r = 1; r < ReduceCount; r++) {
+          Value += Input[r * InnerCount];
+        }
+        return (Kind == MlasMeanReduction) ? Value / ReduceCount : Value;
+
+      case MlasMaximumReduction:
+        for (size_t r = 1; r < ReduceCount; r++) {
+          Value = std::max(Value, double(Input[r * InnerCount]));
+        }
+        return Value;
+
+      case MlasMinimumReduction:
+        for (size_t r = 1; r < ReduceCount; r++) {
+          Value = std::min(Value, double(Input[r * InnerCount]));
+        }
+        return Value;
+
+      default: {
+        double Maximum = Input[0];
+        for (size_t r = 1; r < ReduceCount; r++) {
+          Maximum = std::max(Maximum, double(Input[r * InnerCount]));
+        }
+        double Sum = 0.0;
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Sum += std::exp(Input[r * InnerCount] - Maximum);
+        }
+        return std::log(Sum) + Maximum;
+      }
+    }
+  }
+
+  void Test(MLAS_REDUCTION_KIND Kind, size_t OuterCount, size_t ReduceCount, size_t InnerCount,
+            MLAS_THREADPOOL* threadpool) {
+    const size_t InputSize = OuterCount * ReduceCount * InnerCount;
+    const size_t OutputSize = OuterCount * InnerCount;
+
+    float* Input = BufferInput.GetBuffer(InputSize);
+    float* Output = BufferOutput.GetBuffer(OutputSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputSize));
+    std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+    for (size_t i = 0; i < InputSize; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    MlasReduce(Kind, Input, Output, OuterCount, ReduceCount, InnerCount, threadpool);
+
+    for (size_t o = 0; o < OuterCount; o++) {
+      for (size_t i = 0; i < InnerCount; i++) {
+        const float* Column = Input + o * ReduceCount * InnerCount + i;
+        const double Expected = Reference(Kind, Column, ReduceCount, InnerCount);
+
+        //
+        // The tolerance of sums grows with the magnitude of the summed values.
+        //
+
+        double Tolerance = 1e-5 * (1.0 + std::fabs(Expected));
+        if (Kind == MlasSumReduction || Kind == MlasMeanReduction) {
+          double AbsoluteSum = 0.0;
+          for (size_t r = 0; r < ReduceCount; r++) {
+            AbsoluteSum += std::fabs(Column[r * InnerCount]);
+          }
+          Tolerance += 1e-6 * ((Kind == MlasMeanReduction) ? AbsoluteSum / ReduceCount : AbsoluteSum);
+        }
+
+        ASSERT_NEAR(Output[o * InnerCount + i], Expected, Tolerance)
+            << " Kind=" << KindName(Kind) << " Outer=" << OuterCount << " Reduce=" << ReduceCount
+            << " Inner=" << InnerCount << " o=" << o << " i=" << i;
+      }
+    }
+  }
+
+  void TestLogSumExpInfinity(MLAS_THREADPOOL* threadpool) {
+    constexpr size_t ReduceCount = 37;
+    constexpr size_t ColumnCount = 4;
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+    float Columns[ReduceCount * ColumnCount];
+    float Rows[ColumnCount * ReduceCount];
+    float Output[ColumnCount];
+
+    //
+    // Column 0 is all negative infinity, column 1 has a positive infinity,
+    // column 2 has a negative infinity among finite values and column 3 has
+    // a positive infinity and a NaN.
+    //
+
+    for (size_t r = 0; r < ReduceCount; r++) {
+      Columns[r * ColumnCount + 0] = -Infinity;
+      Columns[r * ColumnCount + 1] = float(r);
+      Columns[r * ColumnCount + 2] = float(r);
+      Columns[r * ColumnCount + 3] = float(r);
+    }
+    Columns[3 * ColumnCount + 1] = Infinity;
+    Columns[5 * ColumnCount + 2] = -Infinity;
+    Columns[7 * ColumnCount + 3] = Infinity;
+    Columns[20 * ColumnCount + 3] = std::numeric_limits<float>::quiet_NaN();
+
+    double Sum = 0.0;
+    for (size_t r = 0; r < ReduceCount; r++) {
+      if (r != 5) {
+        Sum += std::exp(double(r) - (ReduceCount - 1));
+      }
+    }
+    const double Expected2 = std::log(Sum) + (ReduceCount - 1);
+
+    //
+    // The strided path reduces the columns, the contiguous path reduces the
+    // same values stored as rows.
+    //
+
+    for (size_t r = 0; r < ReduceCount; r++) {
+      for (size_t c = 0; c < ColumnCount; c++) {
+        Rows[c * ReduceCount + r] = Columns[r * ColumnCount + c];
+      }
+    }
+
+    for (bool Strided : {true, false}) {
+      if (Strided) {
+        MlasReduce(MlasLogSumExpReduction, Columns, Output, 1, ReduceCount, ColumnCount, threadpool);
+      } else {
+        MlasReduce(MlasLogSumExpReduction, Rows, Output, ColumnCount, ReduceCount, 1, threadpool);
+      }
+
+      ASSERT_EQ(Output[0], -Infinity) << " Strided=" << Strided;
+      ASSERT_EQ(Output[1], Infinity) << " Strided=" << Strided;
+      ASSERT_NEAR(Output[2], Expected2, 1e-5) << " Strided=" << Strided;
+      ASSERT_TRUE(std::isnan(Output[3])) << " Strided=" << Strided;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (int kind = 0; kind < MlasReductionKindCount; kind++) {
+      for (size_t OuterCount : {1, 3}) {
+        for (size_t ReduceCount : {1, 2, 3, 5, 16, 33, 257}) {
+          for (size_t InnerCount : {1, 2, 4, 7, 64, 255, 256, 300}) {
+            Test(MLAS_REDUCTION_KIND(kind), OuterCount, ReduceCount, InnerCount, nullptr);
+            Test(MLAS_REDUCTION_KIND(kind), OuterCount, ReduceCount, InnerCount, GetMlasThreadPool());
+          }
+        }
+      }
+      Test(MLAS_REDUCTION_KIND(kind), 1, 100000, 1, GetMlasThreadPool());
+      Test(MLAS_REDUCTION_KIND(kind), 1000, 64, 1, GetMlasThreadPool());
+      Test(MLAS_REDUCTION_KIND(kind), 1, 64, 1000, GetMlasThreadPool());
+      Test(MLAS_REDUCTION_KIND(kind), 16, 128, 1030, GetMlasThreadPool());
+    }
+
+    TestLogSumExpInfinity(nullptr);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute();
+  }
+  return count;
+});
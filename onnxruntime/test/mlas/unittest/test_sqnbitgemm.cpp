@@ -17,6 +17,19 @@ Abstract:
 #include "test_util.h"
 #include "mlas_q4.h"
 #include "mlas_qnbit.h"
+#include "core/mlas/lib/mlasi.h"
+
+#if defined(MLAS_TARGET_AMD64) && !defined(__APPLE__) && !defined(ORT_MINIMAL_BUILD)
+#define MLAS_SQNBITGEMM_TEST_AMX
+
+//
+// The platform enables AMX only if both the processor and the operating system
+// support it. The AMX tests then select the AMX dispatch explicitly.
+//
+static bool IsAmxEnabled() {
+  return GetMlasPlatform().GemmU8S8Dispatch == &MlasGemmU8S8DispatchAmx;
+}
+#endif
 
 static constexpr const char* ComputeTypeName(MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType) {
   switch (ComputeType) {
@@ -84,6 +97,85 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     MlasSQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, ComputeType, &params, Workspace, Threadpool);
   }
 
+  //
+  // Quantized B values and zero points are stored as little-endian bit streams, as in the MatMulNBits inputs.
+  // For 4-bit values this is the same layout as produced by MlasQuantizeBlockwise().
+  //
+
+  static uint8_t GetQuantBValue(const uint8_t* Data, size_t Idx) {
+    const size_t bit_offset = Idx * BlkBitWidth;
+    uint32_t bits = Data[bit_offset / 8];
+    if (bit_offset % 8 + BlkBitWidth > 8) {
+      bits |= static_cast<uint32_t>(Data[bit_offset / 8 + 1]) << 8;
+    }
+    return static_cast<uint8_t>((bits >> (bit_offset % 8)) & ((1u << BlkBitWidth) - 1));
+  }
+
+  static void SetQuantBValue(uint8_t* Data, size_t Idx, uint8_t Value) {
+    const size_t bit_offset = Idx * BlkBitWidth;
+    const uint32_t bits = static_cast<uint32_t>(Value) << (bit_offset % 8);
+    Data[bit_offset / 8] |= static_cast<uint8_t>(bits & 0xFF);
+    if (bit_offset % 8 + BlkBitWidth > 8) {
+      Data[bit_offset / 8 + 1] |= static_cast<uint8_t>(bits >> 8);
+    }
+  }
+
+  static uint8_t GetQuantBZeroPoint(const uint8_t* QuantBZeroPoint, size_t BlockCountK, size_t n, size_t k_blk) {
+    if (QuantBZeroPoint == nullptr) {
+      return static_cast<uint8_t>(1 << (BlkBitWidth - 1));
+    }
+    const size_t zp_col_size = (BlockCountK * BlkBitWidth + 7) / 8;
+    return GetQuantBValue(QuantBZeroPoint + n * zp_col_size, k_blk);
+  }
+
+  /**
+   * @brief Quantizes B (K x N, row major) column-wise for bit widths not supported by MlasQuantizeBlockwise().
+   */
+  void QuantizeB(size_t N, size_t K, const float* B,
+                 uint8_t* QuantBData, float* QuantBScale, uint8_t* QuantBZeroPoint) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t zp_col_size = (BlockCountK * BlkBitWidth + 7) / 8;
+    constexpr int range_max = (1 << BlkBitWidth) - 1;
+
+    std::fill_n(QuantBData, N * BlockCountK * BlkLen * BlkBitWidth / 8, uint8_t{0});
+    if (QuantBZeroPoint != nullptr) {
+      std::fill_n(QuantBZeroPoint, N * zp_col_size, uint8_t{0});
+    }
+
+    for (size_t n = 0; n < N; ++n) {
+      for (size_t k = 0, k_blk = 0; k < K; k += BlkLen, ++k_blk) {
+        const size_t k_blk_len = std::min(K - k, BlkLen);
+
+        float vmin = 0.0f, vmax = 0.0f, amax = 0.0f;
+        for (size_t kk = 0; kk < k_blk_len; ++kk) {
+          const float b = B[(k + kk) * N + n];
+          vmin = std::min(vmin, b);
+          vmax = std::max(vmax, b);
+          amax = std::max(amax, fabsf(b));
+        }
+
+        float scale;
+        int zp;
+        if (QuantBZeroPoint != nullptr) {
+          scale = (vmax - vmin) / range_max;
+          zp = scale != 0.0f ? static_cast<int>(std::clamp(roundf(-vmin / scale), 0.0f, float(range_max))) : 0;
+          SetQuantBValue(QuantBZeroPoint + n * zp_col_size, k_blk, static_cast<uint8_t>(zp));
+        } else {
+          zp = 1 << (BlkBitWidth - 1);
+          scale = amax / zp;
+        }
+        const float scale_reciprocal = scale != 0.0f ? 1.0f / scale : 0.0f;
+        QuantBScale[n * BlockCountK + k_blk] = scale;
+
+        for (size_t kk = 0; kk < BlkLen; ++kk) {
+          const float b = kk < k_blk_len ? B[(k + kk) * N + n] : 0.0f;
+          const int q = std::clamp(static_cast<int>(roundf(b * scale_reciprocal)) + zp, 0, range_max);
+          SetQuantBValue(QuantBData, n * BlockCountK * BlkLen + k + kk, static_cast<uint8_t>(q));
+        }
+      }
+    }
+  }
+
   void QuantizeA(size_t M, size_t K, const float* A, int8_t* QuantAData, float* QuantAScale) {
     const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
     const size_t lda = K;
@@ -142,20 +234,13 @@ class MlasSQNBitGemmTest : public MlasTestBase {
 
           const float b_scale = QuantBScale[n * BlockCountK + k_blk];
 
-          static_assert(BlkBitWidth == 4, "only implemented for 4-bit quantized B");
-
-          uint8_t b_zp = 8;
-          if (QuantBZeroPoint != nullptr) {
-            const uint8_t b_zp_byte = QuantBZeroPoint[n * ((BlockCountK + 1) / 2) + k_blk / 2];
-            b_zp = (k_blk & 1) ? (b_zp_byte >> 4) : (b_zp_byte & 0x0F);
-          }
+          const uint8_t b_zp = GetQuantBZeroPoint(QuantBZeroPoint, BlockCountK, n, k_blk);
 
           int32_t qsum = 0;
 
           for (size_t kk = 0; kk < k_blk_len; ++kk) {
             const int8_t qa = QuantAData[m * BlockCountK * BlkLen + k + kk];
-            const uint8_t qb_byte = QuantBData[(n * BlockCountK * BlkLen + k + kk) / 2];
-            const int8_t qb = ((kk & 1) == 1 ? (qb_byte >> 4) : (qb_byte & 0x0F)) - b_zp;
+            const int8_t qb = GetQuantBValue(QuantBData, n * BlockCountK * BlkLen + k + kk) - b_zp;
             qsum += qa * qb;
           }
 
@@ -177,9 +262,21 @@ class MlasSQNBitGemmTest : public MlasTestBase {
                                   const float* Bias,
                                   float* C) {
     float* DequantizedBData = BufferDequantizedB.GetBuffer(K * N);
-    MlasDequantizeBlockwise<float, BlkBitWidth>(
-        DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
-        static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    if constexpr (BlkBitWidth == 4) {
+      MlasDequantizeBlockwise<float, BlkBitWidth>(
+          DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
+          static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    } else {
+      const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+      for (size_t n = 0; n < N; ++n) {
+        for (size_t k = 0; k < K; ++k) {
+          const size_t k_blk = k / BlkLen;
+          const int qb = GetQuantBValue(QuantBData, n * BlockCountK * BlkLen + k) -
+                         GetQuantBZeroPoint(QuantBZeroPoint, BlockCountK, n, k_blk);
+          DequantizedBData[n * K + k] = qb * QuantBScale[n * BlockCountK + k_blk];
+        }
+      }
+    }
     // Note: DequantizedBData is in column major layout.
 
     for (size_t m = 0; m < M; m++) {
@@ -244,7 +341,7 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     uint8_t* QuantBData = nullptr;
     float* QuantBScale = nullptr;
     uint8_t* QuantBZeroPoint = nullptr;
-    {
+    if constexpr (BlkBitWidth == 4) {
       size_t QuantBDataSizeInBytes, QuantBScaleSize, QuantBZeroPointSizeInBytes;
       MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, BlkLen, /* columnwise */ true,
                                         static_cast<int>(K), static_cast<int>(N),
@@ -262,6 +359,16 @@ class MlasSQNBitGemmTest : public MlasTestBase {
                                                 static_cast<int>(K), static_cast<int>(N),
                                                 static_cast<int>(N),
                                                 GetMlasThreadPool());
+    } else {
+      const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+      QuantBData = BufferQuantBData.GetBuffer(N * BlockCountK * BlkLen * BlkBitWidth / 8);
+      QuantBScale = BufferQuantBScale.GetBuffer(N * BlockCountK);
+      if (!Symmetric) {
+        QuantBZeroPoint = BufferQuantBZeroPoint.GetBuffer(N * ((BlockCountK * BlkBitWidth + 7) / 8));
+      }
+
+      QuantizeB(N, K, B, QuantBData, QuantBScale, QuantBZeroPoint);
     }
 
     void* Workspace = nullptr;
@@ -325,24 +432,36 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
  public:
   explicit SQNBitGemmShortExecuteTest(size_t M, size_t N, size_t K,
                                       MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
-                                      bool WithThreadpool, bool Symmetric, bool WithBias)
+                                      bool WithThreadpool, bool Symmetric, bool WithBias, bool ForceAmx)
       : M_(M),
         N_(N),
         K_(K),
         ComputeType_(ComputeType),
         WithThreadpool_(WithThreadpool),
         Symmetric_(Symmetric),
-        WithBias_(WithBias) {
+        WithBias_(WithBias),
+        ForceAmx_(ForceAmx) {
   }
 
   void TestBody() override {
+#if defined(MLAS_SQNBITGEMM_TEST_AMX)
+    const MLAS_SQNBIT_GEMM_DISPATCH* Dispatch = GetMlasPlatform().SQNBitGemmDispatch;
+    if (ForceAmx_) {
+      GetMlasPlatform().SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAmx;
+    }
+#endif
+
     MlasTestFixture<MlasSQNBitGemmTest<BlkBitWidth, BlkLen>>::mlas_tester->Test(
         M_, N_, K_, ComputeType_, WithThreadpool_, Symmetric_, WithBias_);
+
+#if defined(MLAS_SQNBITGEMM_TEST_AMX)
+    GetMlasPlatform().SQNBitGemmDispatch = Dispatch;
+#endif
   }
 
   static size_t RegisterSingleTest(size_t M, size_t N, size_t K,
                                    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
-                                   bool WithThreadpool, bool Symmetric, bool WithBias) {
+                                   bool WithThreadpool, bool Symmetric, bool WithBias, bool ForceAmx = false) {
     size_t tests_registered = 0;
 
     if (MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen, ComputeType)) {
@@ -351,7 +470,8 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
          << "/isSymmetric" << Symmetric
          << "/M" << M << "xN" << N << "xK" << K
          << "/hasBias" << WithBias
-         << "/computeType" << ComputeTypeName(ComputeType);
+         << "/computeType" << ComputeTypeName(ComputeType)
+         << (ForceAmx ? "/Amx" : "");
       auto test_name = ss.str();
 
       testing::RegisterTest(
@@ -364,7 +484,7 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
           // Important to use the fixture type as the return type here.
           [=]() -> MlasTestFixture<MlasSQNBitGemmTest<BlkBitWidth, BlkLen>>* {
             return new SQNBitGemmShortExecuteTest(
-                M, N, K, ComputeType, WithThreadpool, Symmetric, WithBias);
+                M, N, K, ComputeType, WithThreadpool, Symmetric, WithBias, ForceAmx);
           });
 
       tests_registered += 1;
@@ -411,13 +531,35 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
       }
     }
 
+#if defined(MLAS_SQNBITGEMM_TEST_AMX)
+    //
+    // The AMX kernel computes blocks of 16 rows with tiles and the rows left
+    // over with AVX512-VNNI. Cover both, partial groups of 16 columns and a
+    // partial last block along K.
+    //
+    if (BlkBitWidth == 4 && IsAmxEnabled()) {
+      for (bool WithThreadpool : {false, true}) {
+        for (bool Symmetric : {false, true}) {
+          for (size_t M : {16, 17, 33}) {
+            for (size_t N : {1, 15, 17, 40}) {
+              for (size_t K : {size_t{1}, BlkLen, BlkLen * 3 + 5}) {
+                tests_registered += RegisterSingleTest(M, N, K, CompInt8, WithThreadpool, Symmetric, N % 2 == 1,
+                                                       /* ForceAmx */ true);
+              }
+            }
+          }
+        }
+      }
+    }
+#endif
+
     return tests_registered;
   }
 
  private:
   size_t M_, N_, K_;
   MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType_;
-  bool WithThreadpool_, Symmetric_, WithBias_;
+  bool WithThreadpool_, Symmetric_, WithBias_, ForceAmx_;
 };
 
 static size_t SQNBitGemmRegisterAllShortExecuteTests() {
@@ -428,6 +570,12 @@ static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   count += SQNBitGemmShortExecuteTest<4, 64>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 128>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 256>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 128>::RegisterShortExecuteTests();
 
   return count;
 }
@@ -0,0 +1,137 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/element_wise_broadcast.h"
+#include "core/util/math_cpuonly.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+// Input shapes of the broadcasting patterns commonly seen in models.
+struct BroadcastCase {
+  const char* name;
+  std::vector<int64_t> shape0;
+  std::vector<int64_t> shape1;
+};
+
+const std::vector<BroadcastCase> broadcast_cases = {
+    {"same_shape", {64, 128, 768}, {64, 128, 768}},
+    {"scalar", {64, 128, 768}, {}},
+    {"nchw_per_channel", {8, 64, 56, 56}, {1, 64, 1, 1}},
+    {"bsh_bias", {8, 512, 768}, {768}},
+    {"row_vector", {4096, 1024}, {4096, 1}},
+    {"outer_product", {2048, 1}, {1, 2048}},
+    {"small_inner", {65536, 3}, {1, 3}},
+};
+
+struct AddKernel {
+  void Input0Scalar(float a, const float* b, float* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<float>(out, count) = a + ConstEigenVectorArrayMap<float>(b, count);
+  }
+  void Input1Scalar(const float* a, float b, float* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<float>(out, count) = ConstEigenVectorArrayMap<float>(a, count) + b;
+  }
+  void General(const float* a, const float* b, float* out, size_t n) const {
+    const auto count = static_cast<ptrdiff_t>(n);
+    EigenVectorArrayMap<float>(out, count) =
+        ConstEigenVectorArrayMap<float>(a, count) + ConstEigenVectorArrayMap<float>(b, count);
+  }
+};
+
+struct WhereKernel {
+  void operator()(const bool* condition, ptrdiff_t condition_stride, const float* x, ptrdiff_t x_stride,
+                  const float* y, ptrdiff_t y_stride, float* out, size_t n) const {
+    for (size_t i = 0; i < n; i++) {
+      const float x_value = x[i * x_stride];
+      const float y_value = y[i * y_stride];
+      out[i] = condition[i * condition_stride] ? x_value : y_value;
+    }
+  }
+};
+
+size_t ShapeSize(const std::vector<int64_t>& shape) {
+  size_t size = 1;
+  for (int64_t dim : shape) {
+    size *= static_cast<size_t>(dim);
+  }
+  return size;
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateBenchmarkThreadPool(int threads) {
+  if (threads <= 1) {
+    return nullptr;
+  }
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = threads;
+  tpo.auto_set_affinity = true;
+  return concurrency::CreateThreadPool(&Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP);
+}
+
+}  // namespace
+
+static void BM_BroadcastAdd(benchmark::State& state) {
+  const BroadcastCase& broadcast_case = broadcast_cases[static_cast<size_t>(state.range(0))];
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(1)));
+
+  BroadcastPlan plan({broadcast_case.shape0, broadcast_case.shape1});
+  float* input0 = GenerateArrayWithRandomValue<float>(ShapeSize(broadcast_case.shape0), -1, 1);
+  float* input1 = GenerateArrayWithRandomValue<float>(ShapeSize(broadcast_case.shape1), -1, 1);
+  float* output = (float*)aligned_alloc(sizeof(float) * plan.OutputSize(), 64);
+
+  for (auto _ : state) {
+    BroadcastBinaryLoop(plan, input0, input1, output, tp.get(), 1.0, AddKernel{});
+  }
+
+  state.SetLabel(broadcast_case.name);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(plan.OutputSize() * sizeof(float)));
+  aligned_free(input0);
+  aligned_free(input1);
+  aligned_free(output);
+}
+
+static void BM_BroadcastWhere(benchmark::State& state) {
+  const BroadcastCase& broadcast_case = broadcast_cases[static_cast<size_t>(state.range(0))];
+  auto tp = CreateBenchmarkThreadPool(static_cast<int>(state.range(1)));
+
+  // The condition takes the second shape and X and Y the first.
+  BroadcastPlan plan({broadcast_case.shape1, broadcast_case.shape0, broadcast_case.shape0});
+  const size_t condition_size = ShapeSize(broadcast_case.shape1);
+  std::unique_ptr<bool[]> condition = std::make_unique<bool[]>(condition_size);
+  for (size_t i = 0; i < condition_size; i++) {
+    condition[i] = (i % 3) == 0;
+  }
+  float* x = GenerateArrayWithRandomValue<float>(ShapeSize(broadcast_case.shape0), -1, 1);
+  float* y = GenerateArrayWithRandomValue<float>(ShapeSize(broadcast_case.shape0), -1, 1);
+  float* output = (float*)aligned_alloc(sizeof(float) * plan.OutputSize(), 64);
+
+  for (auto _ : state) {
+    BroadcastTernaryLoop(plan, condition.get(), x, y, output, tp.get(), 1.0, WhereKernel{});
+  }
+
+  state.SetLabel(broadcast_case.name);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(plan.OutputSize() * sizeof(float)));
+  aligned_free(x);
+  aligned_free(y);
+  aligned_free(output);
+}
+
+static void BroadcastArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"Case", "Threads"});
+  for (int threads : {1, 8}) {
+    for (size_t i = 0; i < broadcast_cases.size(); i++) {
+      b->Args({static_cast<int64_t>(i), threads});
+    }
+  }
+}
+
+BENCHMARK(BM_BroadcastAdd)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_BroadcastWhere)->Apply(BroadcastArgs)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
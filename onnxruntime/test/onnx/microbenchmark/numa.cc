@@ -0,0 +1,104 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <core/mlas/inc/mlas.h>
+#include <core/platform/env.h>
+#include <core/platform/threadpool.h>
+#include <core/util/thread_utils.h>
+
+#include <sstream>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace onnxruntime;
+using namespace onnxruntime::concurrency;
+
+#if defined(__linux__) && !defined(__ANDROID__)
+
+// Runs SGEMM on the threads of NUMA node 0 with the matrices placed on node 0 (local) or on the last node
+// (remote). The gap between the two shows the cost of the cross-socket traffic that the session.numa_node
+// option avoids by binding the intra-op threads and the CPU allocator of a session to the same node.
+static void BM_NumaSgemm(benchmark::State& state) {
+  const bool local = state.range(0) != 0;
+  const size_t dim = static_cast<size_t>(state.range(1));
+
+  const auto numa_nodes = Env::Default().GetNumaNodeProcessors();
+  if (numa_nodes.size() < 2) {
+    state.SkipWithError("requires a system with multiple NUMA nodes");
+    return;
+  }
+  const auto& compute_node = numa_nodes.front();
+  const int memory_node = local ? 0 : static_cast<int>(numa_nodes.size() - 1);
+
+  // bind the calling thread and the pool threads to node 0
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (auto id : compute_node) {
+    CPU_SET(id, &cpuset);
+  }
+  cpu_set_t original_cpuset;
+  pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &original_cpuset);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = static_cast<int>(compute_node.size());
+  std::ostringstream affinity;
+  for (size_t i = 1; i < compute_node.size(); ++i) {
+    affinity << (i > 1 ? ";" : "") << compute_node[i] + 1;
+  }
+  tpo.affinity_str = affinity.str();
+  std::unique_ptr<ThreadPool> tp(CreateThreadPool(&Env::Default(), tpo, ThreadPoolType::INTRA_OP));
+
+  // bind the matrices before they are first touched
+  const size_t bytes = dim * dim * sizeof(float);
+  float* a = static_cast<float*>(aligned_alloc(bytes, 4096));
+  float* b = static_cast<float*>(aligned_alloc(bytes, 4096));
+  float* c = static_cast<float*>(aligned_alloc(bytes, 4096));
+  for (float* p : {a, b, c}) {
+    auto status = Env::Default().BindMemoryToNumaNode(p, bytes, memory_node);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+    }
+  }
+  for (size_t i = 0; i < dim * dim; ++i) {
+    a[i] = static_cast<float>(i % 7) * 0.5f;
+    b[i] = static_cast<float>(i % 5) * 0.25f;
+    c[i] = 0.f;
+  }
+
+  MLAS_SGEMM_DATA_PARAMS params;
+  params.A = a;
+  params.lda = dim;
+  params.B = b;
+  params.ldb = dim;
+  params.C = c;
+  params.ldc = dim;
+  params.alpha = 1.f;
+  params.beta = 0.f;
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, CblasNoTrans, dim, dim, dim, params, tp.get());
+    benchmark::DoNotOptimize(c);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(3 * bytes));
+  state.counters["GFLOPS"] = benchmark::Counter(2.0 * dim * dim * dim * static_cast<double>(state.iterations()) / 1e9,
+                                                benchmark::Counter::kIsRate);
+
+  tp.reset();
+  aligned_free(a);
+  aligned_free(b);
+  aligned_free(c);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &original_cpuset);
+}
+
+BENCHMARK(BM_NumaSgemm)
+    ->ArgNames({"local", "dim"})
+    ->ArgsProduct({{1, 0}, {512, 1024, 2048}})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMillisecond);
+
+#endif
@@ -0,0 +1,87 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <unordered_map>
+
+#include "core/providers/cpu/ml/string_lookup_table.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+// Category names of a string feature, and a batch of values of that feature where about one value in four is not a
+// known category.
+struct StringLookupData {
+  std::vector<std::string> keys;
+  std::vector<int64_t> values;
+  std::vector<std::string> inputs;
+};
+
+StringLookupData CreateStringLookupData(int64_t n_keys, int64_t n_inputs) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> dist(0, n_keys * 4 / 3);
+  StringLookupData data;
+  for (int64_t i = 0; i < n_keys; ++i) {
+    data.keys.push_back("category_" + std::to_string(i));
+    data.values.push_back(i);
+  }
+  for (int64_t i = 0; i < n_inputs; ++i) {
+    data.inputs.push_back("category_" + std::to_string(dist(gen)));
+  }
+  return data;
+}
+
+}  // namespace
+
+static void BM_StringLookupUnorderedMap(benchmark::State& state) {
+  const StringLookupData data = CreateStringLookupData(state.range(0), 1 << 16);
+  std::unordered_map<std::string, int64_t> map;
+  for (size_t i = 0; i < data.keys.size(); ++i) {
+    map[data.keys[i]] = data.values[i];
+  }
+  std::vector<int64_t> output(data.inputs.size());
+
+  for (auto _ : state) {
+    const auto map_end = map.end();
+    for (size_t i = 0; i < data.inputs.size(); ++i) {
+      auto found = map.find(data.inputs[i]);
+      output[i] = found == map_end ? -1 : found->second;
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(data.inputs.size()));
+}
+
+BENCHMARK(BM_StringLookupUnorderedMap)
+    ->ArgNames({"Keys"})
+    ->Arg(4)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+static void BM_StringLookupTable(benchmark::State& state) {
+  const StringLookupData data = CreateStringLookupData(state.range(0), 1 << 16);
+  ml::StringLookupTable<int64_t> table;
+  table.Build(data.keys, data.values);
+  std::vector<int64_t> output(data.inputs.size());
+
+  for (auto _ : state) {
+    table.FindBatch(data.inputs, output, -1);
+    benchmark::DoNotOptimize(output.data());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(data.inputs.size()));
+}
+
+BENCHMARK(BM_StringLookupTable)
+    ->ArgNames({"Keys"})
+    ->Arg(4)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Arg(1000000)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -0,0 +1,129 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+// Attributes of a random ensemble of regression trees shaped like the ones LightGBM produces.
+struct TreeEnsembleAttributes {
+  std::vector<int64_t> nodes_treeids;
+  std::vector<int64_t> nodes_nodeids;
+  std::vector<int64_t> nodes_featureids;
+  std::vector<std::string> nodes_modes;
+  std::vector<float> nodes_values;
+  std::vector<int64_t> nodes_truenodeids;
+  std::vector<int64_t> nodes_falsenodeids;
+  std::vector<int64_t> target_treeids;
+  std::vector<int64_t> target_nodeids;
+  std::vector<int64_t> target_ids;
+  std::vector<float> target_weights;
+};
+
+int64_t AddRandomNode(TreeEnsembleAttributes& attributes, std::mt19937& gen, int64_t tree_id, int64_t& n_nodes,
+                      int64_t n_leaves, int64_t n_features) {
+  const int64_t node_id = n_nodes++;
+  const size_t pos = attributes.nodes_treeids.size();
+  attributes.nodes_treeids.push_back(tree_id);
+  attributes.nodes_nodeids.push_back(node_id);
+  attributes.nodes_truenodeids.push_back(0);
+  attributes.nodes_falsenodeids.push_back(0);
+  if (n_leaves == 1) {
+    attributes.nodes_featureids.push_back(0);
+    attributes.nodes_modes.push_back("LEAF");
+    attributes.nodes_values.push_back(0);
+    attributes.target_treeids.push_back(tree_id);
+    attributes.target_nodeids.push_back(node_id);
+    attributes.target_ids.push_back(0);
+    attributes.target_weights.push_back(std::uniform_real_distribution<float>(-1.f, 1.f)(gen));
+    return node_id;
+  }
+  attributes.nodes_featureids.push_back(std::uniform_int_distribution<int64_t>(0, n_features - 1)(gen));
+  attributes.nodes_modes.push_back("BRANCH_LEQ");
+  attributes.nodes_values.push_back(std::normal_distribution<float>(0.f, 1.f)(gen));
+  const int64_t n_true_leaves = std::uniform_int_distribution<int64_t>(1, n_leaves - 1)(gen);
+  const int64_t true_node = AddRandomNode(attributes, gen, tree_id, n_nodes, n_true_leaves, n_features);
+  const int64_t false_node = AddRandomNode(attributes, gen, tree_id, n_nodes, n_leaves - n_true_leaves, n_features);
+  attributes.nodes_truenodeids[pos] = true_node;
+  attributes.nodes_falsenodeids[pos] = false_node;
+  return node_id;
+}
+
+TreeEnsembleAttributes CreateRandomTreeEnsemble(int64_t n_trees, int64_t max_leaves, int64_t n_features) {
+  std::mt19937 gen(0);
+  TreeEnsembleAttributes attributes;
+  for (int64_t tree_id = 0; tree_id < n_trees; ++tree_id) {
+    int64_t n_nodes = 0;
+    AddRandomNode(attributes, gen, tree_id, n_nodes, std::uniform_int_distribution<int64_t>(2, max_leaves)(gen),
+                  n_features);
+  }
+  return attributes;
+}
+
+class BenchmarkTreeEnsemble : public ml::detail::TreeEnsembleCommon<float, float, float> {
+ public:
+  // engine: 0 walks the nodes, 1 uses QuickScorer, 2 uses the flat layout.
+  void Build(const TreeEnsembleAttributes& attributes, int64_t engine) {
+    ORT_THROW_IF_ERROR(TreeEnsembleCommon<float, float, float>::Init(
+        80, 128, 50, "SUM", {}, {}, 1, attributes.nodes_falsenodeids, attributes.nodes_featureids, {}, {}, {},
+        attributes.nodes_modes, attributes.nodes_nodeids, attributes.nodes_treeids, attributes.nodes_truenodeids,
+        attributes.nodes_values, {}, "NONE", attributes.target_ids, attributes.target_nodeids,
+        attributes.target_treeids, attributes.target_weights, {}));
+    if (engine == 1) {
+      ORT_ENFORCE(quick_scorer_ != nullptr, "The ensemble cannot be evaluated with QuickScorer.");
+      return;
+    }
+    quick_scorer_.reset();
+    flat_.reset();
+    if (engine == 2) {
+      flat_ = std::make_unique<ml::detail::TreeEnsembleFlat<float, float>>();
+      ORT_ENFORCE(flat_->Init(nodes_, roots_, same_mode_, max_feature_id_), "The ensemble cannot be flattened.");
+    }
+  }
+
+  void Compute(const Tensor* X, Tensor* Y) const {
+    ComputeAgg(nullptr, X, Y, nullptr,
+               ml::detail::TreeAggregatorSum<float, float, float>(roots_.size(), n_targets_or_classes_,
+                                                                  post_transform_, base_values_));
+  }
+};
+
+}  // namespace
+
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  const int64_t batch_size = state.range(0);
+  const int64_t engine = state.range(1);
+  constexpr int64_t n_trees = 2000;
+  constexpr int64_t max_leaves = 31;
+  constexpr int64_t n_features = 100;
+
+  BenchmarkTreeEnsemble ensemble;
+  ensemble.Build(CreateRandomTreeEnsemble(n_trees, max_leaves, n_features), engine);
+
+  auto alloc = std::make_shared<CPUAllocator>();
+  Tensor X(DataTypeImpl::GetType<float>(), TensorShape({batch_size, n_features}), alloc);
+  Tensor Y(DataTypeImpl::GetType<float>(), TensorShape({batch_size, 1}), alloc);
+  float* x_data = X.MutableData<float>();
+  std::mt19937 gen(1);
+  std::normal_distribution<float> dist(0.f, 1.f);
+  for (int64_t i = 0; i < batch_size * n_features; ++i) {
+    x_data[i] = dist(gen);
+  }
+
+  for (auto _ : state) {
+    ensemble.Compute(&X, &Y);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * batch_size);
+}
+
+BENCHMARK(BM_TreeEnsembleRegressor)
+    ->ArgNames({"BatchSize", "Engine"})
+    ->ArgsProduct({{1, 8, 64, 1024, 10000}, {0, 1, 2}})
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -56,6 +56,7 @@
 #include "core/optimizer/label_encoder_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
+#include "core/optimizer/matmul_nbits_concat_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
@@ -7827,6 +7828,99 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, MatMulNBitsConcatFusion) {
+  constexpr int64_t M = 3, K = 64, block_size = 32, bits = 4;
+  constexpr int64_t k_blocks = K / block_size;
+  constexpr int64_t blob_size = block_size * bits / 8;
+
+  auto add_matmul_nbits = [&](ModelTestBuilder& builder, NodeArg* A, int64_t N, bool has_zero_point) {
+    auto* B = builder.MakeInitializer<uint8_t>({N, k_blocks, blob_size}, uint8_t{0}, uint8_t{255});
+    auto* scales = builder.MakeInitializer<float>({N * k_blocks}, 0.01f, 0.02f);
+    std::vector<NodeArg*> inputs{A, B, scales};
+    if (has_zero_point) {
+      inputs.push_back(builder.MakeInitializer<uint8_t>({N * ((k_blocks + 1) / 2)}, uint8_t{0}, uint8_t{255}));
+    }
+
+    auto* output = builder.MakeIntermediate();
+    auto& node = builder.AddNode("MatMulNBits", inputs, {output}, kMSDomain);
+    node.AddAttribute("K", K);
+    node.AddAttribute("N", N);
+    node.AddAttribute("block_size", block_size);
+    node.AddAttribute("bits", bits);
+    node.AddAttribute("accuracy_level", int64_t{4});
+    return output;
+  };
+
+  for (bool has_zero_point : {false, true}) {
+    SCOPED_TRACE(MakeString("has_zero_point:", has_zero_point));
+
+    // gate/up projections of a gated MLP
+    auto build_mlp = [&](ModelTestBuilder& builder) {
+      auto* A = builder.MakeInput<float>({M, K}, -1.0f, 1.0f);
+      auto* gate = add_matmul_nbits(builder, A, 48, has_zero_point);
+      auto* up = add_matmul_nbits(builder, A, 48, has_zero_point);
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* silu_out = builder.MakeIntermediate();
+      builder.AddNode("Sigmoid", {gate}, {sigmoid_out});
+      builder.AddNode("Mul", {gate, sigmoid_out}, {silu_out});
+      builder.AddNode("Mul", {silu_out, up}, {builder.MakeOutput()});
+    };
+
+    auto check_mlp = [](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulNBitsSiluMul"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 0);
+      EXPECT_EQ(op_to_count["Sigmoid"], 0);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+    };
+
+    TransformerTester(build_mlp, check_mlp, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                      1e-4, 1e-4, std::make_unique<MatMulNBitsConcatFusion>());
+
+    // the up projection is broadcast against a gate projection with N = 1, the Mul nodes are kept and the
+    // projections are only concatenated
+    auto build_broadcast_mlp = [&](ModelTestBuilder& builder) {
+      auto* A = builder.MakeInput<float>({M, K}, -1.0f, 1.0f);
+      auto* gate = add_matmul_nbits(builder, A, 1, has_zero_point);
+      auto* up = add_matmul_nbits(builder, A, 3, has_zero_point);
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* silu_out = builder.MakeIntermediate();
+      builder.AddNode("Sigmoid", {gate}, {sigmoid_out});
+      builder.AddNode("Mul", {gate, sigmoid_out}, {silu_out});
+      builder.AddNode("Mul", {silu_out, up}, {builder.MakeOutput()});
+    };
+
+    auto check_broadcast_mlp = [](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulNBitsSiluMul"], 0);
+      EXPECT_EQ(op_to_count["Sigmoid"], 1);
+      EXPECT_EQ(op_to_count["Mul"], 2);
+    };
+
+    TransformerTester(build_broadcast_mlp, check_broadcast_mlp, TransformerLevel::Level1, TransformerLevel::Level2,
+                      13, 1e-4, 1e-4, std::make_unique<MatMulNBitsConcatFusion>());
+
+    // Q, K and V projections
+    auto build_qkv = [&](ModelTestBuilder& builder) {
+      auto* A = builder.MakeInput<float>({M, K}, -1.0f, 1.0f);
+      for (int64_t N : {32, 16, 16}) {
+        builder.AddNode("Identity", {add_matmul_nbits(builder, A, N, has_zero_point)}, {builder.MakeOutput()});
+      }
+    };
+
+    auto check_qkv = [](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 1);
+      EXPECT_EQ(op_to_count["Split"], 1);
+    };
+
+    for (int opset : {12, 13}) {
+      TransformerTester(build_qkv, check_qkv, TransformerLevel::Level1, TransformerLevel::Level2, opset,
+                        1e-4, 1e-4, std::make_unique<MatMulNBitsConcatFusion>());
+    }
+  }
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
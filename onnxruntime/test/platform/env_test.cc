@@ -4,6 +4,7 @@
 #include "core/platform/env.h"
 
 #include <fstream>
+#include <set>
 
 #include "gtest/gtest.h"
 
@@ -53,5 +54,25 @@ TEST(PlatformEnvTest, GetErrnoInfo) {
 #pragma warning(pop)
 #endif
 }
+
+TEST(PlatformEnvTest, NumaNodeProcessors) {
+  const auto& env = Env::Default();
+  const auto numa_nodes = env.GetNumaNodeProcessors();
+
+  // each logical processor belongs to at most one node
+  std::set<int> processors;
+  for (const auto& node : numa_nodes) {
+    for (int id : node) {
+      EXPECT_GE(id, 0);
+      EXPECT_TRUE(processors.insert(id).second) << "processor " << id << " is listed in more than one NUMA node";
+    }
+  }
+
+  if (!numa_nodes.empty()) {
+    // placing memory that is not a whole page or spans no whole page is a no-op
+    char small_buffer[16];
+    EXPECT_STATUS_OK(env.BindMemoryToNumaNode(small_buffer, sizeof(small_buffer), 0));
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
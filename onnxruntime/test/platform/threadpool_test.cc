@@ -12,8 +12,12 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <regex>
+#include <set>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -510,6 +514,135 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+TEST(ThreadPoolTest, TestUnifiedSchedulingSkipsBusyWorkers) {
+  ThreadOptions to;
+  to.unified_scheduling = true;
+  // the main thread and 3 workers
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 4, true);
+
+  // occupy 2 of the workers with inter-op tasks
+  constexpr int kNumBusyTasks = 2;
+  std::atomic<int> num_started{0};
+  std::atomic<int> num_finished{0};
+  std::atomic<bool> release{false};
+  for (int i = 0; i < kNumBusyTasks; ++i) {
+    ThreadPool::Schedule(tp.get(), [&]() {
+      ThreadPool::InterOpTaskScope task_scope(tp.get());
+      num_started++;
+      while (!release) {
+        std::this_thread::yield();
+      }
+      num_finished++;
+    });
+  }
+  while (num_started != kNumBusyTasks) {
+    std::this_thread::yield();
+  }
+
+  TestData test_data(1000);
+  std::set<std::thread::id> thread_ids;
+  ThreadPool::TrySimpleParallelFor(tp.get(), 1000, [&](std::ptrdiff_t i) {
+    std::lock_guard<onnxruntime::OrtMutex> lock(test_data.mutex);
+    test_data.data[i]++;
+    thread_ids.insert(std::this_thread::get_id());
+  });
+  ValidateTestData(test_data);
+  // only the main thread and the idle worker may run the loop
+  EXPECT_LE(thread_ids.size(), 2u);
+
+  release = true;
+  while (num_finished != kNumBusyTasks) {
+    std::this_thread::yield();
+  }
+
+  // the loop can use all of the pool again
+  auto test_data_after = CreateTestData(1000);
+  ThreadPool::TrySimpleParallelFor(tp.get(), 1000, [&](std::ptrdiff_t i) { IncrementElement(*test_data_after, i); });
+  ValidateTestData(*test_data_after);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  ThreadOptions to;
+  to.adaptive_spinning = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 4, true);
+
+  ThreadPool::StartProfiling(tp.get());
+  // bursts of work separated by pauses long enough for the workers to block
+  for (int burst = 0; burst < 5; ++burst) {
+    for (int loop = 0; loop < 10; ++loop) {
+      auto test_data = CreateTestData(1000);
+      ThreadPool::TrySimpleParallelFor(tp.get(), 1000, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+      ValidateTestData(*test_data);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  auto profile = ThreadPool::StopProfiling(tp.get());
+
+#if !defined(ORT_MINIMAL_BUILD)
+  for (const char* counter : {"\"spin_us\"", "\"park_us\"", "\"work_us\""}) {
+    EXPECT_NE(profile.find(counter), std::string::npos) << counter << " is missing from " << profile;
+  }
+#endif
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+// run tasks of a known duration separated by a known pause and check the time the workers report
+TEST(ThreadPoolTest, TestAdaptiveSpinningCounters) {
+  static constexpr int kNumTasks = 3;
+  static constexpr auto kTaskDuration = std::chrono::milliseconds(20);
+  static constexpr auto kPause = std::chrono::milliseconds(100);
+
+  ThreadOptions to;
+  to.adaptive_spinning = true;
+  // 3 workers
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 4, true);
+
+  auto run_tasks = [&tp]() {
+    std::atomic<int> num_finished{0};
+    for (int i = 0; i < kNumTasks; ++i) {
+      ThreadPool::Schedule(tp.get(), [&num_finished]() {
+        std::this_thread::sleep_for(kTaskDuration);
+        num_finished++;
+      });
+    }
+    while (num_finished != kNumTasks) {
+      std::this_thread::yield();
+    }
+  };
+
+  ThreadPool::StartProfiling(tp.get());
+  run_tasks();
+  // the workers run out of work and park during the pause, then the next tasks wake them up
+  std::this_thread::sleep_for(kPause);
+  run_tasks();
+  // let the workers record the end of the last tasks
+  std::this_thread::sleep_for(kPause);
+  auto profile = ThreadPool::StopProfiling(tp.get());
+
+  uint64_t num_run = 0;
+  uint64_t spin_us = 0;
+  uint64_t park_us = 0;
+  uint64_t work_us = 0;
+  std::regex counters_regex(
+      "\"num_run\": ([0-9]+), \"spin_us\": ([0-9]+), \"park_us\": ([0-9]+), \"work_us\": ([0-9]+)");
+  for (std::sregex_iterator it(profile.begin(), profile.end(), counters_regex), end; it != end; ++it) {
+    num_run += std::stoull((*it)[1].str());
+    spin_us += std::stoull((*it)[2].str());
+    park_us += std::stoull((*it)[3].str());
+    work_us += std::stoull((*it)[4].str());
+  }
+
+  const uint64_t task_us = std::chrono::duration_cast<std::chrono::microseconds>(kTaskDuration).count();
+  const uint64_t pause_us = std::chrono::duration_cast<std::chrono::microseconds>(kPause).count();
+  EXPECT_EQ(num_run, 2u * kNumTasks) << profile;
+  EXPECT_GE(work_us, 2u * kNumTasks * task_us) << profile;
+  // each worker that ran one of the second tasks waited through the pause, and spins at most 1ms of it
+  EXPECT_GE(park_us, pause_us / 2) << profile;
+  // a worker spins at most once per task it receives, plus once before it parks for the last time
+  EXPECT_LE(spin_us, (num_run + 3) * 10 * 1000) << profile;
+}
+#endif
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
@@ -7,6 +7,7 @@
 #include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/common/dnnl_op_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/util/include/default_providers.h"
 
@@ -25,7 +26,7 @@ const constexpr auto run_with_tunable_op = &run_options;
 
 }  // namespace
 
-// Only CUDA, ROCM, CoreML and XNNPack kernels have float 16 support
+// The CPU kernel supports float 16 only when MlasHalfGemmSupported(), see GemmFloat16_Cpu for its tests.
 TEST(GemmOpTest, GemmNoTrans_f16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -125,7 +126,7 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
   }
 }
 
-// Only CUDA, ROCM and CoreML kernels have float 16 support
+// The CPU kernel supports float 16 only when MlasHalfGemmSupported(), see GemmFloat16_Cpu for its tests.
 TEST(GemmOpTest, GemmTransB_f16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -172,6 +173,98 @@ TEST(GemmOpTest, GemmTransB_f16) {
   }
 }
 
+// Runs a float 16 Gemm of shape (5, 9) x (9, 7) on the CPU EP and checks it against a float reference.
+// c_dims empty means there is no C. The inputs are small multiples of powers of two so every partial sum is exact
+// in float 16 and the result is the same whether the kernel accumulates in float 16 or in float.
+static void RunGemmFloat16CpuTest(bool trans_a, bool trans_b, float alpha, float beta,
+                                  const std::vector<int64_t>& c_dims, bool b_is_initializer = false) {
+  constexpr int64_t M = 5;
+  constexpr int64_t N = 7;
+  constexpr int64_t K = 9;
+
+  std::vector<float> A(M * K);
+  std::vector<float> B(K * N);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<float>(static_cast<int>(i * 7 % 11) - 5) * 0.125f;
+  }
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(static_cast<int>(i * 5 % 13) - 6) * 0.0625f;
+  }
+  int64_t c_size = 1;
+  for (int64_t dim : c_dims) {
+    c_size *= dim;
+  }
+  std::vector<float> C(c_dims.empty() ? 0 : c_size);
+  for (size_t i = 0; i < C.size(); ++i) {
+    C[i] = static_cast<float>(static_cast<int>(i * 3 % 7) - 3) * 0.25f;
+  }
+
+  // C is broadcast to (M, N) with its dimensions aligned to the right.
+  const int64_t c_rows = c_dims.size() == 2 ? c_dims[0] : 1;
+  const int64_t c_cols = c_dims.empty() ? 1 : c_dims.back();
+
+  std::vector<float> Y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; ++k) {
+        const float a = trans_a ? A[k * M + m] : A[m * K + k];
+        const float b = trans_b ? B[n * K + k] : B[k * N + n];
+        sum += a * b;
+      }
+      Y[m * N + n] = alpha * sum;
+      if (!C.empty()) {
+        Y[m * N + n] += beta * C[(c_rows == 1 ? 0 : m) * c_cols + (c_cols == 1 ? 0 : n)];
+      }
+    }
+  }
+
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transA", static_cast<int64_t>(trans_a));
+  test.AddAttribute("transB", static_cast<int64_t>(trans_b));
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddInput<MLFloat16>("A", trans_a ? std::vector<int64_t>{K, M} : std::vector<int64_t>{M, K}, ToFloat16(A));
+  test.AddInput<MLFloat16>("B", trans_b ? std::vector<int64_t>{N, K} : std::vector<int64_t>{K, N}, ToFloat16(B),
+                           b_is_initializer);
+  if (!C.empty()) {
+    test.AddInput<MLFloat16>("C", c_dims, ToFloat16(C));
+  }
+  test.AddOutput<MLFloat16>("Y", {M, N}, ToFloat16(Y));
+  test.SetOutputTolerance(0.005f);
+
+  size_t number_of_pre_packed_weights = 0;
+  test.ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig(&number_of_pre_packed_weights);
+  // A constant transposed B is transposed once when the session is created.
+  EXPECT_EQ(number_of_pre_packed_weights, static_cast<size_t>(b_is_initializer && trans_b ? 1 : 0));
+}
+
+TEST(GemmOpTest, GemmFloat16_Cpu) {
+  if (!MlasHalfGemmSupported()) {
+    GTEST_SKIP() << "Skipping because the CPU has no half precision GEMM acceleration";
+  }
+
+  for (bool trans_a : {false, true}) {
+    for (bool trans_b : {false, true}) {
+      // MLAS computes the cases without transposes, alpha == 1 and a bias row, the others fall back to Eigen.
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {1, 7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {5, 1});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {5, 7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {1});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 0.5f, 1.0f, {7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 2.0f, {1, 7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, -1.5f, 0.5f, {5, 7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 0.0f, {5, 7});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 2.0f, 0.0f, {});
+      RunGemmFloat16CpuTest(trans_a, trans_b, 1.0f, 1.0f, {7}, true);
+      RunGemmFloat16CpuTest(trans_a, trans_b, 0.5f, -1.0f, {5, 1}, true);
+    }
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(GemmOpTest, GemmNoTrans_bfloat16) {
 #ifdef USE_CUDA
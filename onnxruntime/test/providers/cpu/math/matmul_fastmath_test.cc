@@ -2,6 +2,7 @@
 // Copyright 2023 Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // Licensed under the MIT License.
 
+#include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -11,7 +12,7 @@
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 
 namespace onnxruntime {
 namespace test {
@@ -145,7 +146,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     SessionOptions so;
     ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-        kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+        kOrtSessionOptionsMlasGemmFastMathBfloat16, "1"));
 
     test.ConfigExcludeEps(excluded_providers)
         .Config(run_with_tunable_op)
@@ -154,7 +155,7 @@ void RunMatMulTest(int32_t opset_version, bool is_a_constant, bool is_b_constant
 
     if (disable_fastmath) {
       ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-          kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0"));
+          kOrtSessionOptionsMlasGemmFastMathBfloat16, "0"));
 
       test.ConfigExcludeEps(excluded_providers)
           .Config(run_with_tunable_op)
@@ -237,7 +238,7 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights_FastMath) {
   // Set up B as a shared initializer to be shared between sessions
   ASSERT_EQ(so.AddInitializer("B", &b), Status::OK());
   ASSERT_STATUS_OK(so.config_options.AddConfigEntry(
-      kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "1"));
+      kOrtSessionOptionsMlasGemmFastMathBfloat16, "1"));
 
   // We want all sessions running using this OpTester to be able to share pre-packed weights if applicable
   test.EnableSharingOfPrePackedWeightsAcrossSessions();
@@ -295,6 +296,58 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights_FastMath) {
 
 #endif
 
+// B is an initializer so Gemm pre-packs it in bfloat16. Covers a transposed B and both the bias vector
+// handled by the kernel and a C matrix added afterwards.
+TEST(MathOpTest, GemmFloatInitializer_FastMath) {
+  constexpr int64_t M = 4, N = 8, K = 6;
+  std::vector<float> a_vals(M * K), b_vals(N * K), c_vector(N), c_matrix(M * N);
+  for (size_t i = 0; i < a_vals.size(); ++i) a_vals[i] = static_cast<float>(i % 5) - 2.0f;
+  for (size_t i = 0; i < b_vals.size(); ++i) b_vals[i] = static_cast<float>(i % 3) * 0.5f;
+  for (size_t i = 0; i < c_vector.size(); ++i) c_vector[i] = static_cast<float>(i);
+  for (size_t i = 0; i < c_matrix.size(); ++i) c_matrix[i] = static_cast<float>(i % 7);
+
+  // inputs are exact in bfloat16, so the results match the fp32 reference
+  auto reference = [&](const std::vector<float>& c, bool c_is_vector, float beta) {
+    std::vector<float> y(M * N);
+    for (int64_t m = 0; m < M; ++m) {
+      for (int64_t n = 0; n < N; ++n) {
+        float sum = beta * (c_is_vector ? c[n] : c[m * N + n]);
+        for (int64_t k = 0; k < K; ++k) {
+          sum += a_vals[m * K + k] * b_vals[n * K + k];
+        }
+        y[m * N + n] = sum;
+      }
+    }
+    return y;
+  };
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasGemmFastMathBfloat16, "1"));
+
+  auto run = [&](const std::vector<float>& c, bool c_is_vector, float beta) {
+    OpTester test("Gemm", 13);
+    test.AddAttribute("transA", static_cast<int64_t>(0));
+    test.AddAttribute("transB", static_cast<int64_t>(1));
+    test.AddAttribute("alpha", 1.0f);
+    test.AddAttribute("beta", beta);
+    test.AddInput<float>("A", {M, K}, a_vals);
+    test.AddInput<float>("B", {N, K}, b_vals, true);
+    if (c_is_vector) {
+      test.AddInput<float>("C", {N}, c);
+    } else {
+      test.AddInput<float>("C", {M, N}, c);
+    }
+    test.AddOutput<float>("Y", {M, N}, reference(c, c_is_vector, beta));
+    test.Config(so)
+        .ConfigEp(DefaultCpuExecutionProvider())
+        .RunWithConfig();
+  };
+
+  run(c_vector, true, 1.0f);
+  run(c_vector, true, 2.0f);
+  run(c_matrix, false, 1.0f);
+}
+
 // Dummy run to disable the FastMath mode for the current session
 TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
   RunMatMulTest<uint64_t>(9, false, false, true);
@@ -302,4 +355,4 @@ TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
 
 }  // namespace test
 }  // namespace onnxruntime
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
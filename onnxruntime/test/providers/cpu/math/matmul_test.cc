@@ -9,6 +9,7 @@
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace test {
@@ -229,6 +230,16 @@ TEST(MathOpTest, MatMulFloat16) {
 }
 #endif
 
+// The CPU EP registers the fp16 MatMul kernel only when MLAS has a vectorized half precision GEMM
+TEST(MathOpTest, MatMulFloat16_Cpu) {
+  if (!MlasHalfGemmSupported()) {
+    GTEST_SKIP() << "Skipping because the CPU has no half precision GEMM acceleration";
+  }
+  RunMatMulTest<MLFloat16>(7, false, false);
+  RunMatMulTest<MLFloat16>(14, false, false);
+  RunMatMulTest<MLFloat16>(14, false, true);
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
@@ -276,6 +287,13 @@ TEST(MathOpTest, MatMulZeroKInt32Type) {
   RunMatMulZeroKTest<int32_t>();
 }
 
+TEST(MathOpTest, MatMulZeroKFloat16Type) {
+  if (!MlasHalfGemmSupported()) {
+    GTEST_SKIP() << "Skipping because the CPU has no half precision GEMM acceleration";
+  }
+  RunMatMulZeroKTest<MLFloat16>();
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(COREML_ENABLE_MLPROGRAM) || defined(USE_XNNPACK)
 TEST(MathOpTest, MatMul_Float16) {
 #ifdef USE_CUDA
@@ -64,6 +64,40 @@ TEST(LabelEncoder, StringToIntOpset2) {
   test.Run();
 }
 
+TEST(LabelEncoder, ManyStringKeysOpset2) {
+  // enough keys and inputs for the lookups to be done in several groups, with an empty key and a duplicated key
+  // whose first value is kept.
+  std::vector<std::string> keys{"", "AA"};
+  std::vector<std::int64_t> values{-1, 0};
+  for (std::int64_t i = 0; i < 100; ++i) {
+    keys.push_back("key_" + std::to_string(i));
+    values.push_back(i);
+  }
+  keys.push_back("AA");
+  values.push_back(1);
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (std::int64_t i = 0; i < 150; i += 3) {
+    input.push_back("key_" + std::to_string(i));
+    output.push_back(i < 100 ? i : 5566);
+  }
+  input.insert(input.end(), {"", "AA", "key_", "key_1000"});
+  output.insert(output.end(), {-1, 0, 5566, 5566});
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)5566);
+
+  const std::vector<std::int64_t> dims{static_cast<std::int64_t>(input.size())};
+  test.AddInput<std::string>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 TEST(LabelEncoder, IntToStringOpset2) {
   std::vector<std::int64_t> dims{1, 5};
 
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <random>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -263,5 +265,89 @@ TEST(MLOpTest, SVMClassifierLinear) {
   test.Run();
 }
 
+// Random RBF classifier evaluated on a batch of rows, some of them equal to support vectors.
+// The expected outputs come from a direct evaluation of every classifier.
+static void RunSVMClassifierRBFBatchTest(int64_t class_count, int64_t num_batches) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  constexpr int64_t feature_count = 4;
+  constexpr float gamma = 0.1f;
+  std::default_random_engine gen(3);
+  std::uniform_real_distribution<float> dist(-2.f, 2.f);
+
+  std::vector<int64_t> classes, vectors_per_class;
+  int64_t vector_count = 0;
+  for (int64_t c = 0; c < class_count; ++c) {
+    classes.push_back(c);
+    vectors_per_class.push_back(1 + c % 3);
+    vector_count += vectors_per_class.back();
+  }
+  std::vector<float> support_vectors(vector_count * feature_count);
+  for (auto& v : support_vectors) v = dist(gen);
+  std::vector<float> coefficients((class_count - 1) * vector_count);
+  for (auto& v : coefficients) v = dist(gen);
+  std::vector<float> rho(class_count * (class_count - 1) / 2);
+  for (auto& v : rho) v = dist(gen) * 0.1f;
+
+  std::vector<float> X(num_batches * feature_count);
+  for (int64_t n = 0; n < num_batches; ++n) {
+    for (int64_t f = 0; f < feature_count; ++f) {
+      X[n * feature_count + f] = n % 5 == 0 ? support_vectors[(n % vector_count) * feature_count + f] : dist(gen);
+    }
+  }
+
+  std::vector<int64_t> predictions;
+  std::vector<float> scores;
+  for (int64_t n = 0; n < num_batches; ++n) {
+    std::vector<double> kernels(vector_count);
+    for (int64_t v = 0; v < vector_count; ++v) {
+      double sum = 0;
+      for (int64_t f = 0; f < feature_count; ++f) {
+        const double d = X[n * feature_count + f] - support_vectors[v * feature_count + f];
+        sum += d * d;
+      }
+      kernels[v] = std::exp(-gamma * sum);
+    }
+    std::vector<int64_t> votes(class_count, 0);
+    int64_t classifier = 0;
+    for (int64_t i = 0, start_i = 0; i < class_count - 1; start_i += vectors_per_class[i++]) {
+      for (int64_t j = i + 1, start_j = start_i + vectors_per_class[i]; j < class_count;
+           start_j += vectors_per_class[j++]) {
+        double sum = rho[classifier++];
+        for (int64_t v = start_i; v < start_i + vectors_per_class[i]; ++v) {
+          sum += coefficients[(j - 1) * vector_count + v] * kernels[v];
+        }
+        for (int64_t v = start_j; v < start_j + vectors_per_class[j]; ++v) {
+          sum += coefficients[i * vector_count + v] * kernels[v];
+        }
+        scores.push_back(static_cast<float>(sum));
+        ++votes[sum > 0 ? i : j];
+      }
+    }
+    predictions.push_back(std::max_element(votes.begin(), votes.end()) - votes.begin());
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", std::vector<float>{gamma, 0.f, 3.f});
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {num_batches, feature_count}, X);
+  test.AddOutput<int64_t>("Y", {num_batches}, predictions);
+  test.AddOutput<float>("Z", {num_batches, static_cast<int64_t>(rho.size())}, scores);
+
+  test.Run();
+}
+
+TEST(MLOpTest, SVMClassifierRBFBatch) {
+  // the scores of the classifiers come from a GEMM
+  RunSVMClassifierRBFBatchTest(3, 37);
+  // too many classes for that, the scores are computed for each batch
+  RunSVMClassifierRBFBatchTest(10, 37);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <functional>
+#include <random>
+#include <type_traits>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -760,5 +764,161 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+// Random trees whose thresholds and inputs are drawn from a small grid so that inputs often equal thresholds.
+// Batches of rows are evaluated with QuickScorer or the flat layout, the expected outputs come from a walk of every tree.
+// Double inputs are also moved off the grid by less than the float rounding of the thresholds, a batch must compare
+// them in double as a single row does, every row is then also evaluated alone.
+template <typename T>
+void GenRandomTreesAndRunTest(const std::string& mode, int64_t n_targets, int64_t n_obs, int max_leaves = 16,
+                              bool missing_tracks = false) {
+  constexpr int64_t n_trees = 20;
+  constexpr int64_t n_features = 3;
+  std::default_random_engine gen(17);
+  std::uniform_int_distribution<int> grid(-4, 4);
+
+  std::vector<int64_t> nodes_treeids, nodes_nodeids, nodes_featureids, nodes_truenodeids, nodes_falsenodeids,
+      nodes_missing_value_tracks_true;
+  std::vector<std::string> nodes_modes;
+  std::vector<float> nodes_values;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+
+  std::function<int64_t(int64_t, int64_t&, int)> add_node = [&](int64_t tree_id, int64_t& n_nodes, int n_leaves) {
+    const int64_t node_id = n_nodes++;
+    const size_t pos = nodes_nodeids.size();
+    nodes_treeids.push_back(tree_id);
+    nodes_nodeids.push_back(node_id);
+    nodes_truenodeids.push_back(0);
+    nodes_falsenodeids.push_back(0);
+    nodes_missing_value_tracks_true.push_back(missing_tracks ? (node_id % 2) : 0);
+    if (n_leaves == 1) {
+      nodes_featureids.push_back(0);
+      nodes_modes.push_back("LEAF");
+      nodes_values.push_back(0.f);
+      for (int64_t k = 0; k < n_targets; ++k) {
+        target_treeids.push_back(tree_id);
+        target_nodeids.push_back(node_id);
+        target_ids.push_back(k);
+        target_weights.push_back(static_cast<float>(grid(gen)));
+      }
+      return node_id;
+    }
+    nodes_featureids.push_back(std::uniform_int_distribution<int64_t>(0, n_features - 1)(gen));
+    nodes_modes.push_back(mode);
+    nodes_values.push_back(grid(gen) * 0.5f);
+    const int n_true_leaves = std::uniform_int_distribution<int>(1, n_leaves - 1)(gen);
+    nodes_truenodeids[pos] = add_node(tree_id, n_nodes, n_true_leaves);
+    nodes_falsenodeids[pos] = add_node(tree_id, n_nodes, n_leaves - n_true_leaves);
+    return node_id;
+  };
+  for (int64_t tree_id = 0; tree_id < n_trees; ++tree_id) {
+    int64_t n_nodes = 0;
+    add_node(tree_id, n_nodes, std::uniform_int_distribution<int>(2, max_leaves)(gen));
+  }
+
+  std::vector<T> X(static_cast<size_t>(n_obs * n_features));
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = (i % 11 == 5) ? std::numeric_limits<T>::quiet_NaN() : static_cast<T>(grid(gen) * 0.5f);
+    if constexpr (std::is_same_v<T, double>) {
+      X[i] += static_cast<T>(static_cast<int>(i % 3) - 1) * static_cast<T>(1e-9);
+    }
+  }
+
+  std::vector<float> Y(static_cast<size_t>(n_obs * n_targets), 0.f);
+  for (int64_t i = 0; i < n_obs; ++i) {
+    for (size_t root = 0; root < nodes_nodeids.size(); ++root) {
+      if (nodes_nodeids[root] != 0) continue;
+      size_t node = root;
+      while (nodes_modes[node] != "LEAF") {
+        const T x = X[static_cast<size_t>(i * n_features + nodes_featureids[node])];
+        const float threshold = nodes_values[node];
+        const bool is_true = (mode == "BRANCH_LEQ"   ? x <= threshold
+                              : mode == "BRANCH_LT"  ? x < threshold
+                              : mode == "BRANCH_GTE" ? x >= threshold
+                              : mode == "BRANCH_GT"  ? x > threshold
+                              : mode == "BRANCH_EQ"  ? x == threshold
+                                                     : x != threshold) ||
+                             (nodes_missing_value_tracks_true[node] == 1 && std::isnan(x));
+        node = root + static_cast<size_t>(is_true ? nodes_truenodeids[node] : nodes_falsenodeids[node]);
+      }
+      for (size_t t = 0; t < target_nodeids.size(); ++t) {
+        if (target_treeids[t] == nodes_treeids[root] && target_nodeids[t] == nodes_nodeids[node]) {
+          Y[static_cast<size_t>(i * n_targets + target_ids[t])] += target_weights[t];
+        }
+      }
+    }
+  }
+
+  auto run_test = [&](int64_t first_row, int64_t n_rows) {
+    OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+    test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+    test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+    test.AddAttribute("nodes_treeids", nodes_treeids);
+    test.AddAttribute("nodes_nodeids", nodes_nodeids);
+    test.AddAttribute("nodes_featureids", nodes_featureids);
+    test.AddAttribute("nodes_values", nodes_values);
+    test.AddAttribute("nodes_modes", nodes_modes);
+    if (missing_tracks) {
+      test.AddAttribute("nodes_missing_value_tracks_true", nodes_missing_value_tracks_true);
+    }
+    test.AddAttribute("target_treeids", target_treeids);
+    test.AddAttribute("target_nodeids", target_nodeids);
+    test.AddAttribute("target_ids", target_ids);
+    test.AddAttribute("target_weights", target_weights);
+    test.AddAttribute("n_targets", n_targets);
+
+    test.AddInput<T>("X", {n_rows, n_features},
+                     std::vector<T>(X.begin() + first_row * n_features, X.begin() + (first_row + n_rows) * n_features));
+    test.AddOutput<float>("Y", {n_rows, n_targets},
+                          std::vector<float>(Y.begin() + first_row * n_targets,
+                                             Y.begin() + (first_row + n_rows) * n_targets));
+    test.Run();
+  };
+
+  run_test(0, n_obs);
+  if constexpr (std::is_same_v<T, double>) {
+    for (int64_t i = 0; i < n_obs; ++i) {
+      run_test(i, 1);
+    }
+  }
+}
+
+TEST(MLOpTest, TreeRegressorQuickScorer) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT"}) {
+    GenRandomTreesAndRunTest<float>(mode, 1, 37);
+    GenRandomTreesAndRunTest<float>(mode, 2, 37);
+    // Parallelized by blocks of rows.
+    GenRandomTreesAndRunTest<float>(mode, 1, 203);
+  }
+}
+
+// Double inputs within float rounding of the thresholds.
+TEST(MLOpTest, TreeRegressorQuickScorerDouble) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT"}) {
+    GenRandomTreesAndRunTest<double>(mode, 1, 37);
+    GenRandomTreesAndRunTest<double>(mode, 2, 37);
+  }
+}
+
+TEST(MLOpTest, TreeRegressorFlatLayout) {
+  // Missing values tracked by some nodes or trees with more than 64 leaves cannot be evaluated with QuickScorer.
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT", "BRANCH_EQ", "BRANCH_NEQ"}) {
+    GenRandomTreesAndRunTest<float>(mode, 1, 37, 16, true);
+    GenRandomTreesAndRunTest<float>(mode, 2, 37, 16, true);
+    GenRandomTreesAndRunTest<float>(mode, 1, 203, 16, true);
+  }
+  GenRandomTreesAndRunTest<float>("BRANCH_LEQ", 1, 37, 100);
+  GenRandomTreesAndRunTest<float>("BRANCH_LEQ", 2, 203, 100);
+}
+
+// Double inputs within float rounding of the thresholds.
+TEST(MLOpTest, TreeRegressorFlatLayoutDouble) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT", "BRANCH_EQ", "BRANCH_NEQ"}) {
+    GenRandomTreesAndRunTest<double>(mode, 1, 37, 16, true);
+    GenRandomTreesAndRunTest<double>(mode, 2, 37, 16, true);
+  }
+  GenRandomTreesAndRunTest<double>("BRANCH_LEQ", 1, 37, 100);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -146,5 +146,20 @@ TEST(WhereOpTest, BroadcastWithScalar) {
   test.Run();
 }
 
+TEST(WhereOpTest, BroadcastAllInputs) {
+  // each input broadcasts along a different axis
+  OpTester test{kOpName, kOpVersion};
+
+  test.AddInput<bool>("condition", {2, 1, 1}, {true, false});
+  test.AddInput<float>("X", {1, 3, 1}, {1.0f, 0.0f, 3.0f});
+  test.AddInput<float>("Y", {1, 1, 2}, {-1.0f, -2.0f});
+
+  test.AddOutput<float>("output", {2, 3, 2},
+                        {1.0f, 1.0f, 0.0f, 0.0f, 3.0f, 3.0f,
+                         -1.0f, -2.0f, -1.0f, -2.0f, -1.0f, -2.0f});
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime